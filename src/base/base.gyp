@@ -47,6 +47,7 @@
         'run_level.cc',
         'scheduler.cc',
         'stopwatch.cc',
+        'thread_pool.cc',
         'timer.cc',
         'unnamed_event.cc',
         'update_util.cc',
@@ -116,12 +117,14 @@
       'sources': [
         '<(gen_out_dir)/character_set.h',
         '<(gen_out_dir)/version_def.h',
+        'cpu_features.cc',
         'debug.cc',
         'file_stream.cc',
         'file_util.cc',
         'flags.cc',
         'hash.cc',
         'init.cc',
+        'latency_histogram.cc',
         'logging.cc',
         'mmap.cc',
         'mutex.cc',
@@ -81,9 +81,12 @@
       'sources': [
         'clock_mock_test.cc',
         'codegen_bytearray_stream_test.cc',
+        'cpu_features_test.cc',
         'cpu_stats_test.cc',
+        'latency_histogram_test.cc',
         'process_mutex_test.cc',
         'stopwatch_test.cc',
+        'thread_pool_test.cc',
         'timer_test.cc',
         'unnamed_event_test.cc',
         'update_util_test.cc',
@@ -125,6 +128,7 @@
       'type': 'executable',
       'sources': [
         'bitarray_test.cc',
+        'fingerprint_set_test.cc',
         'flags_test.cc',
         'iterator_adapter_test.cc',
         'logging_test.cc',
@@ -264,6 +268,59 @@
         'base.gyp:encryptor',
       ],
     },
+    {
+      'target_name': 'thread_pool_benchmark',
+      'type': 'executable',
+      'sources': [
+        'thread_pool_benchmark.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+      ],
+    },
+    {
+      'target_name': 'number_util_benchmark',
+      'type': 'executable',
+      'sources': [
+        'number_util_benchmark.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+        'benchmark_util',
+      ],
+    },
+    {
+      'target_name': 'util_benchmark',
+      'type': 'executable',
+      'sources': [
+        'util_benchmark.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+        'benchmark_util',
+      ],
+    },
+    {
+      'target_name': 'hash_benchmark',
+      'type': 'executable',
+      'sources': [
+        'hash_benchmark.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+      ],
+    },
+    {
+      'target_name': 'encryptor_benchmark',
+      'type': 'executable',
+      'sources': [
+        'encryptor_benchmark.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+        'base.gyp:encryptor',
+      ],
+    },
     # init_test.cc is separated from all other base_core_test because it
     # calls finalizers.
     {
@@ -308,6 +365,16 @@
         'test_size': 'small',
       },
     },
+    {
+      'target_name': 'benchmark_util',
+      'type': 'static_library',
+      'sources': [
+        'benchmark_util.cc',
+      ],
+      'dependencies': [
+        'base.gyp:base',
+      ],
+    },
     {
       'target_name': 'scheduler_stub',
       'type': 'static_library',
@@ -0,0 +1,262 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "base/benchmark_util.h"
+
+#ifdef OS_WIN
+#include <windows.h>
+#define PSAPI_VERSION 1  // for <psapi.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif  // OS_WIN
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "base/file_stream.h"
+#include "base/logging.h"
+#include "base/util.h"
+
+namespace {
+
+volatile uint64 g_allocation_count = 0;
+
+inline void CountAllocation() {
+#ifdef OS_WIN
+  ::InterlockedIncrement64(
+      reinterpret_cast<volatile LONGLONG *>(&g_allocation_count));
+#else
+  __sync_fetch_and_add(&g_allocation_count, 1);
+#endif  // OS_WIN
+}
+
+void *CountedAllocate(size_t size) {
+  CountAllocation();
+  void *ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == NULL) {
+    // Mozc is built without exceptions.  LOG(FATAL) is not used since it
+    // allocates.
+    abort();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+// Replaces the global allocation functions to count the allocations.
+void *operator new(size_t size) {
+  return CountedAllocate(size);
+}
+
+void *operator new[](size_t size) {
+  return CountedAllocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) throw() {
+  CountAllocation();
+  return malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) throw() {
+  CountAllocation();
+  return malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *ptr) throw() {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+  free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) throw() {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) throw() {
+  free(ptr);
+}
+
+namespace mozc {
+
+BenchmarkRecorder::BenchmarkRecorder(const string &name)
+    : name_(name), num_allocations_(0), start_allocation_count_(0) {}
+
+BenchmarkRecorder::~BenchmarkRecorder() {}
+
+void BenchmarkRecorder::Start() {
+  DCHECK(!stopwatch_.IsRunning());
+  start_allocation_count_ = GetAllocationCount();
+  stopwatch_.Reset();
+  stopwatch_.Start();
+}
+
+void BenchmarkRecorder::Stop() {
+  DCHECK(stopwatch_.IsRunning());
+  stopwatch_.Stop();
+  num_allocations_ += GetAllocationCount() - start_allocation_count_;
+  samples_usec_.push_back(
+      static_cast<uint64>(stopwatch_.GetElapsedMicroseconds()));
+  sorted_samples_usec_.clear();
+}
+
+uint64 BenchmarkRecorder::GetPercentileUsec(double percentile) const {
+  if (samples_usec_.empty()) {
+    return 0;
+  }
+  if (sorted_samples_usec_.empty()) {
+    sorted_samples_usec_ = samples_usec_;
+    sort(sorted_samples_usec_.begin(), sorted_samples_usec_.end());
+  }
+  percentile = max(0.0, min(100.0, percentile));
+  // Nearest-rank method.
+  const size_t size = sorted_samples_usec_.size();
+  size_t rank = static_cast<size_t>(percentile * size / 100.0 + 0.5);
+  rank = max(static_cast<size_t>(1), min(size, rank));
+  return sorted_samples_usec_[rank - 1];
+}
+
+double BenchmarkRecorder::GetMeanUsec() const {
+  if (samples_usec_.empty()) {
+    return 0.0;
+  }
+  double total = 0.0;
+  for (size_t i = 0; i < samples_usec_.size(); ++i) {
+    total += samples_usec_[i];
+  }
+  return total / samples_usec_.size();
+}
+
+double BenchmarkRecorder::GetAllocationsPerOperation() const {
+  if (samples_usec_.empty()) {
+    return 0.0;
+  }
+  return static_cast<double>(num_allocations_) / samples_usec_.size();
+}
+
+// static
+void BenchmarkRecorder::PrintHeader(ostream *os) {
+  DCHECK(os);
+  *os << "#name\toperations\tp50_usec\tp95_usec\tp99_usec\tmax_usec"
+      << "\tmean_usec\tallocations_per_operation\tpeak_rss_kb" << endl;
+}
+
+void BenchmarkRecorder::Print(ostream *os) const {
+  DCHECK(os);
+  *os << name_ << "\t" << size() << "\t"
+      << GetPercentileUsec(50) << "\t"
+      << GetPercentileUsec(95) << "\t"
+      << GetPercentileUsec(99) << "\t"
+      << GetPercentileUsec(100) << "\t"
+      << Util::StringPrintf("%.1f\t%.1f", GetMeanUsec(),
+                            GetAllocationsPerOperation()) << "\t"
+      << GetPeakResidentSetSize() / 1024 << endl;
+}
+
+// static
+uint64 BenchmarkRecorder::GetAllocationCount() {
+  return g_allocation_count;
+}
+
+// static
+uint64 BenchmarkRecorder::GetPeakResidentSetSize() {
+#if defined(OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters = { sizeof(counters) };
+  if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters,
+                              sizeof(counters))) {
+    return 0;
+  }
+  return counters.PeakWorkingSetSize;
+#elif defined(__native_client__)
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef OS_MACOSX
+  // In bytes on Mac.
+  return static_cast<uint64>(usage.ru_maxrss);
+#else
+  // In kilobytes on Linux.
+  return static_cast<uint64>(usage.ru_maxrss) * 1024;
+#endif  // OS_MACOSX
+#endif  // OS_WIN, __native_client__
+}
+
+// static
+bool BenchmarkCorpus::LoadKeys(const string &filename, vector<string> *keys) {
+  DCHECK(keys);
+  keys->clear();
+  InputFileStream ifs(filename.c_str());
+  if (!ifs.good()) {
+    LOG(ERROR) << "Cannot open: " << filename;
+    return false;
+  }
+  string line;
+  vector<string> columns;
+  while (!getline(ifs, line).fail()) {
+    Util::ChopReturns(&line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    columns.clear();
+    Util::SplitStringAllowEmpty(line, "\t", &columns);
+    const string &key = columns.size() > 1 ? columns[1] : columns[0];
+    if (!key.empty()) {
+      keys->push_back(key);
+    }
+  }
+  return true;
+}
+
+// static
+void BenchmarkCorpus::MakeLongInputs(const vector<string> &keys,
+                                     size_t min_chars,
+                                     vector<string> *inputs) {
+  DCHECK(inputs);
+  inputs->clear();
+  string input;
+  size_t num_chars = 0;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    input.append(keys[i]);
+    num_chars += Util::CharsLen(keys[i]);
+    if (num_chars >= min_chars) {
+      inputs->push_back(input);
+      input.clear();
+      num_chars = 0;
+    }
+  }
+}
+
+}  // namespace mozc
@@ -0,0 +1,131 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Helpers for the benchmark executables which replay input corpora.
+//
+// BenchmarkRecorder measures each operation (typically a keystroke) and
+// reports the latency percentiles, the number of heap allocations per
+// operation and the peak RSS of the process as one TSV line, so that the
+// results of different runs can be compared by scripts:
+//
+//   BenchmarkRecorder::PrintHeader(&cout);
+//   BenchmarkRecorder recorder("SendKey/sentences");
+//   for (...) {
+//     recorder.Start();
+//     handler.EvalCommand(&command);
+//     recorder.Stop();
+//   }
+//   recorder.Print(&cout);
+//
+// BenchmarkCorpus builds the reproducible input sets which the benchmarks
+// replay.
+//
+// Heap allocations are counted by replacing the global operator new, so
+// linking this library into a production binary is not allowed.
+
+#ifndef MOZC_BASE_BENCHMARK_UTIL_H_
+#define MOZC_BASE_BENCHMARK_UTIL_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/port.h"
+#include "base/stopwatch.h"
+
+namespace mozc {
+
+class BenchmarkRecorder {
+ public:
+  explicit BenchmarkRecorder(const string &name);
+  ~BenchmarkRecorder();
+
+  const string &name() const { return name_; }
+
+  // Measures one operation between Start() and Stop().
+  void Start();
+  void Stop();
+
+  // Number of the measured operations.
+  size_t size() const { return samples_usec_.size(); }
+
+  // Returns the latency of the |percentile| (0-100) th operation.
+  // Returns 0 when nothing has been measured.
+  uint64 GetPercentileUsec(double percentile) const;
+
+  double GetMeanUsec() const;
+  double GetAllocationsPerOperation() const;
+
+  // Prints the columns of Print() as a TSV line starting with "#".
+  static void PrintHeader(ostream *os);
+
+  // Prints the name, the number of operations, p50/p95/p99/max and mean
+  // latencies in microseconds, allocations per operation and the peak RSS
+  // in KB as a TSV line.
+  void Print(ostream *os) const;
+
+  // Number of the calls of the global operator new in this process.
+  static uint64 GetAllocationCount();
+
+  // Peak resident set size of this process in bytes, or 0 if unknown.
+  static uint64 GetPeakResidentSetSize();
+
+ private:
+  const string name_;
+  vector<uint64> samples_usec_;
+  mutable vector<uint64> sorted_samples_usec_;
+  uint64 num_allocations_;
+  uint64 start_allocation_count_;
+  Stopwatch stopwatch_;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkRecorder);
+};
+
+class BenchmarkCorpus {
+ public:
+  // Loads the keys in |filename| into |keys|.  Empty lines and lines
+  // starting with "#" are skipped.  A line of a TSV file is
+  // "<label>\t<key>\t..." like the files of the quality regression test, so
+  // the second column is used as the key when a line has more than one
+  // column.
+  static bool LoadKeys(const string &filename, vector<string> *keys);
+
+  // Concatenates the consecutive |keys| until each input has at least
+  // |min_chars| characters, which emulates long realtime conversion inputs.
+  static void MakeLongInputs(const vector<string> &keys, size_t min_chars,
+                             vector<string> *inputs);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BenchmarkCorpus);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_BENCHMARK_UTIL_H_
@@ -0,0 +1,77 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MOZC_BASE_CANCELLATION_FLAG_H_
+#define MOZC_BASE_CANCELLATION_FLAG_H_
+
+#include "base/mutex.h"
+#include "base/port.h"
+
+namespace mozc {
+
+// A flag shared between a thread running a long task and threads which want
+// to abandon it.  The task polls IsCancelled() at its own checkpoints.
+//
+// Usage:
+// CancellationFlag flag;
+// // worker thread
+// while (!flag.IsCancelled()) { DoSomeWork(); }
+// // another thread
+// flag.Cancel();
+class CancellationFlag {
+ public:
+  CancellationFlag() : cancelled_(false) {}
+  ~CancellationFlag() {}
+
+  void Cancel() {
+    scoped_lock l(&mutex_);
+    cancelled_ = true;
+  }
+
+  // Makes the flag reusable for the next task.
+  void Reset() {
+    scoped_lock l(&mutex_);
+    cancelled_ = false;
+  }
+
+  bool IsCancelled() const {
+    scoped_lock l(&mutex_);
+    return cancelled_;
+  }
+
+ private:
+  mutable Mutex mutex_;
+  bool cancelled_;
+
+  DISALLOW_COPY_AND_ASSIGN(CancellationFlag);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_CANCELLATION_FLAG_H_
@@ -0,0 +1,125 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "base/cpu_features.h"
+
+#ifdef MOZC_X86_SIMD_AVAILABLE
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif  // _MSC_VER
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+#include "base/singleton.h"
+
+namespace mozc {
+namespace {
+
+class CPUFeaturesImpl {
+ public:
+  CPUFeaturesImpl()
+      : has_sse2_(false),
+        has_ssse3_(false),
+        has_sse41_(false),
+        has_aesni_(false),
+        has_sha_(false) {
+#ifdef MOZC_X86_SIMD_AVAILABLE
+    uint32 regs[4];  // EAX, EBX, ECX and EDX
+    CPUID(0, regs);
+    const uint32 max_leaf = regs[0];
+    if (max_leaf >= 1) {
+      CPUID(1, regs);
+      has_sse2_ = (regs[3] & (1 << 26)) != 0;
+      has_ssse3_ = (regs[2] & (1 << 9)) != 0;
+      has_sse41_ = (regs[2] & (1 << 19)) != 0;
+      has_aesni_ = (regs[2] & (1 << 25)) != 0;
+    }
+    if (max_leaf >= 7) {
+      CPUID(7, regs);
+      has_sha_ = (regs[1] & (1 << 29)) != 0;
+    }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+  }
+
+  bool has_sse2() const { return has_sse2_; }
+  bool has_ssse3() const { return has_ssse3_; }
+  bool has_sse41() const { return has_sse41_; }
+  bool has_aesni() const { return has_aesni_; }
+  bool has_sha() const { return has_sha_; }
+
+ private:
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  // Executes CPUID with |leaf| and sub-leaf 0.
+  static void CPUID(uint32 leaf, uint32 regs[4]) {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), 0);
+    for (size_t i = 0; i < 4; ++i) {
+      regs[i] = static_cast<uint32>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif  // _MSC_VER
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+  bool has_sse2_;
+  bool has_ssse3_;
+  bool has_sse41_;
+  bool has_aesni_;
+  bool has_sha_;
+
+  DISALLOW_COPY_AND_ASSIGN(CPUFeaturesImpl);
+};
+
+}  // namespace
+
+bool CPUFeatures::HasSSE2() {
+  return Singleton<CPUFeaturesImpl>::get()->has_sse2();
+}
+
+bool CPUFeatures::HasSSSE3() {
+  return Singleton<CPUFeaturesImpl>::get()->has_ssse3();
+}
+
+bool CPUFeatures::HasSSE41() {
+  return Singleton<CPUFeaturesImpl>::get()->has_sse41();
+}
+
+bool CPUFeatures::HasAESNI() {
+  return Singleton<CPUFeaturesImpl>::get()->has_aesni();
+}
+
+bool CPUFeatures::HasSHA() {
+  return Singleton<CPUFeaturesImpl>::get()->has_sha();
+}
+
+}  // namespace mozc
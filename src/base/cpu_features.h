@@ -0,0 +1,97 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Detects the instruction set extensions of the running CPU so that
+// performance critical code can dispatch to an accelerated implementation at
+// runtime and fall back to the portable one on other CPUs.
+//
+// Usage:
+//   #ifdef MOZC_X86_SIMD_AVAILABLE
+//   MOZC_TARGET_FEATURES("aes")
+//   void DoSomethingWithAESNI() { ... }
+//   #endif
+//
+//   void DoSomething() {
+//   #ifdef MOZC_X86_SIMD_AVAILABLE
+//     if (CPUFeatures::HasAESNI()) {
+//       DoSomethingWithAESNI();
+//       return;
+//     }
+//   #endif
+//     DoSomethingPortably();
+//   }
+
+#ifndef MOZC_BASE_CPU_FEATURES_H_
+#define MOZC_BASE_CPU_FEATURES_H_
+
+#include "base/port.h"
+
+// Defined when x86 intrinsics can be compiled regardless of the compiler
+// options, i.e., when the extensions can be used after the runtime check.
+#if (defined(__x86_64__) || defined(__i386__) || \
+     defined(_M_X64) || defined(_M_IX86)) && !defined(__native_client__)
+#define MOZC_X86_SIMD_AVAILABLE
+#endif
+
+// Enables the instruction set extensions for a function so that it can use
+// their intrinsics without changing the compiler options of the whole file.
+// Visual C++ doesn't need it.
+#if defined(MOZC_X86_SIMD_AVAILABLE) && defined(__GNUC__)
+#define MOZC_TARGET_FEATURES(features) __attribute__((target(features)))
+#else
+#define MOZC_TARGET_FEATURES(features)
+#endif
+
+namespace mozc {
+
+class CPUFeatures {
+ public:
+  // SSE2, e.g., PMOVMSKB.  Always true on x86-64.
+  static bool HasSSE2();
+
+  // Supplemental SSE3, e.g., PSHUFB.
+  static bool HasSSSE3();
+
+  // SSE4.1, e.g., PEXTRD.
+  static bool HasSSE41();
+
+  // AES-NI, e.g., AESENC.
+  static bool HasAESNI();
+
+  // Intel SHA extensions, e.g., SHA1RNDS4.
+  static bool HasSHA();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(CPUFeatures);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_CPU_FEATURES_H_
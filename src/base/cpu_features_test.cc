@@ -0,0 +1,94 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "base/cpu_features.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/file_stream.h"
+#include "base/util.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+TEST(CPUFeaturesTest, NoExtensionsWithoutX86) {
+#ifndef MOZC_X86_SIMD_AVAILABLE
+  EXPECT_FALSE(CPUFeatures::HasSSE2());
+  EXPECT_FALSE(CPUFeatures::HasSSSE3());
+  EXPECT_FALSE(CPUFeatures::HasSSE41());
+  EXPECT_FALSE(CPUFeatures::HasAESNI());
+  EXPECT_FALSE(CPUFeatures::HasSHA());
+#endif  // MOZC_X86_SIMD_AVAILABLE
+}
+
+TEST(CPUFeaturesTest, SSE2OnX64) {
+#if defined(__x86_64__) || defined(_M_X64)
+  EXPECT_TRUE(CPUFeatures::HasSSE2());
+#endif  // __x86_64__ || _M_X64
+}
+
+#if defined(MOZC_X86_SIMD_AVAILABLE) && defined(OS_LINUX) && \
+    !defined(OS_ANDROID)
+// The kernel reports the features detected by CPUID in /proc/cpuinfo.
+TEST(CPUFeaturesTest, SameAsProcCpuinfo) {
+  InputFileStream ifs("/proc/cpuinfo");
+  if (!ifs) {
+    LOG(WARNING) << "/proc/cpuinfo is not available";
+    return;
+  }
+
+  set<string> flags;
+  string line;
+  while (getline(ifs, line)) {
+    if (!Util::StartsWith(line, "flags")) {
+      continue;
+    }
+    const size_t colon = line.find(':');
+    ASSERT_NE(string::npos, colon);
+    vector<string> tokens;
+    Util::SplitStringUsing(line.substr(colon + 1), " ", &tokens);
+    flags.insert(tokens.begin(), tokens.end());
+    break;
+  }
+  ASSERT_FALSE(flags.empty());
+
+  EXPECT_EQ(flags.count("sse2") > 0, CPUFeatures::HasSSE2());
+  EXPECT_EQ(flags.count("ssse3") > 0, CPUFeatures::HasSSSE3());
+  EXPECT_EQ(flags.count("sse4_1") > 0, CPUFeatures::HasSSE41());
+  EXPECT_EQ(flags.count("aes") > 0, CPUFeatures::HasAESNI());
+  EXPECT_EQ(flags.count("sha_ni") > 0, CPUFeatures::HasSHA());
+}
+#endif  // MOZC_X86_SIMD_AVAILABLE && OS_LINUX && !OS_ANDROID
+
+}  // namespace
+}  // namespace mozc
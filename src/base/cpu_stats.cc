@@ -41,6 +41,10 @@
 #include <sys/time.h>
 #endif  // OS_MACOSX
 
+#if defined(OS_LINUX) && !defined(__native_client__)
+#include <unistd.h>
+#endif  // OS_LINUX && !__native_client__
+
 #include "base/logging.h"
 #include "base/port.h"
 
@@ -211,8 +215,17 @@ size_t CPUStats::GetNumberOfProcessors() const {
 #endif  // OS_MACOSX
 
 #ifdef OS_LINUX
+#ifdef __native_client__
   // Not implemented
   return 1;
+#else  // __native_client__
+  const long num_processors = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT
+  if (num_processors < 1) {
+    LOG(ERROR) << "sysconf(_SC_NPROCESSORS_ONLN) failed";
+    return static_cast<size_t>(1);
+  }
+  return static_cast<size_t>(num_processors);
+#endif  // __native_client__
 #endif  // OS_LINUX
 }
 }  // namespace mozc
@@ -0,0 +1,216 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Small benchmark code to measure the throughput of the obfuscation used by
+// Encryptor, i.e., AES256/CBC and SHA1 key derivation, for each
+// implementation available on the running CPU.
+//
+// Usage:
+//   encryptor_benchmark --data_size=1048576 --iterations=10
+
+#include <iostream>  // NOLINT
+#include <string>
+
+#include "base/cpu_features.h"
+#include "base/encryptor.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/stopwatch.h"
+#include "base/unverified_aes256.h"
+#include "base/unverified_sha1.h"
+#include "base/util.h"
+
+DEFINE_int32(data_size, 1024 * 1024, "size of the data in bytes.");
+DEFINE_int32(iterations, 10, "number of iterations for each measurement.");
+
+namespace mozc {
+namespace internal {
+namespace {
+
+// Exposes each implementation.
+class BenchmarkAES256 : public UnverifiedAES256 {
+ public:
+  using UnverifiedAES256::TransformCBCPortable;
+  using UnverifiedAES256::InverseTransformCBCPortable;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  using UnverifiedAES256::TransformCBCWithAESNI;
+  using UnverifiedAES256::InverseTransformCBCWithAESNI;
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BenchmarkAES256);
+};
+
+class BenchmarkSHA1 : public UnverifiedSHA1 {
+ public:
+  using UnverifiedSHA1::MakeDigestPortable;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  using UnverifiedSHA1::MakeDigestWithSHAExtensions;
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BenchmarkSHA1);
+};
+
+typedef void (*TransformFunc)(const uint8 (&key)[UnverifiedAES256::kKeyBytes],
+                              const uint8 (&iv)[UnverifiedAES256::kBlockBytes],
+                              uint8 *buffer,
+                              size_t block_count);
+typedef string (*DigestFunc)(StringPiece source);
+
+void Report(const string &name, int64 elapsed_usec, size_t total_bytes) {
+  const double mb_per_sec = elapsed_usec == 0 ? 0.0 :
+      static_cast<double>(total_bytes) / elapsed_usec;
+  cout << name << ": "
+       << Util::StringPrintf("%.1f MB/s (%.3f msec for %d bytes)",
+                             mb_per_sec, elapsed_usec / 1000.0,
+                             static_cast<int>(total_bytes))
+       << endl;
+}
+
+void BenchmarkTransform(const string &name, TransformFunc transform,
+                        string *data) {
+  uint8 key[UnverifiedAES256::kKeyBytes];
+  uint8 iv[UnverifiedAES256::kBlockBytes];
+  Util::GetRandomSequence(reinterpret_cast<char *>(key), sizeof(key));
+  Util::GetRandomSequence(reinterpret_cast<char *>(iv), sizeof(iv));
+  const size_t block_count = data->size() / UnverifiedAES256::kBlockBytes;
+
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    transform(key, iv, reinterpret_cast<uint8 *>(&(*data)[0]), block_count);
+  }
+  stopwatch.Stop();
+  Report(name, stopwatch.GetElapsedMicroseconds(),
+         data->size() * FLAGS_iterations);
+}
+
+void BenchmarkDigest(const string &name, DigestFunc digest,
+                     const string &data) {
+  string result;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    result = digest(data);
+  }
+  stopwatch.Stop();
+  Report(name, stopwatch.GetElapsedMicroseconds(),
+         data.size() * FLAGS_iterations);
+  CHECK_EQ(UnverifiedSHA1::MakeDigest(data), result);
+}
+
+void BenchmarkEncryptor(const string &data) {
+  const int kNumKeys = 10000;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int i = 0; i < kNumKeys; ++i) {
+    Encryptor::Key key;
+    CHECK(key.DeriveFromPassword("password", "salt"));
+  }
+  stopwatch.Stop();
+  cout << "Encryptor::Key::DeriveFromPassword: "
+       << Util::StringPrintf(
+              "%.3f usec/call",
+              static_cast<double>(stopwatch.GetElapsedMicroseconds()) /
+              kNumKeys)
+       << endl;
+
+  Encryptor::Key key;
+  CHECK(key.DeriveFromPassword("password", "salt"));
+  string buf = data;
+  stopwatch = Stopwatch::StartNew();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    CHECK(Encryptor::EncryptString(key, &buf));
+    CHECK(Encryptor::DecryptString(key, &buf));
+  }
+  stopwatch.Stop();
+  CHECK_EQ(data, buf);
+  Report("Encryptor::EncryptString + DecryptString",
+         stopwatch.GetElapsedMicroseconds(),
+         2 * data.size() * FLAGS_iterations);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  using mozc::internal::BenchmarkAES256;
+  using mozc::internal::BenchmarkSHA1;
+  using mozc::internal::UnverifiedAES256;
+
+  CHECK_GT(FLAGS_data_size, 0);
+  CHECK_GT(FLAGS_iterations, 0);
+  const size_t size = (FLAGS_data_size + UnverifiedAES256::kBlockBytes - 1) /
+      UnverifiedAES256::kBlockBytes * UnverifiedAES256::kBlockBytes;
+  string data(size, '\0');
+  mozc::Util::GetRandomSequence(&data[0], data.size());
+
+  cout << "AES-NI: "
+       << (mozc::CPUFeatures::HasAESNI() ? "available" : "unavailable")
+       << endl;
+  cout << "SHA extensions: "
+       << (mozc::CPUFeatures::HasSHA() ? "available" : "unavailable")
+       << endl;
+
+  string buf = data;
+  mozc::internal::BenchmarkTransform(
+      "AES256 CBC encryption (portable)",
+      BenchmarkAES256::TransformCBCPortable, &buf);
+  mozc::internal::BenchmarkTransform(
+      "AES256 CBC decryption (portable)",
+      BenchmarkAES256::InverseTransformCBCPortable, &buf);
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (mozc::CPUFeatures::HasAESNI()) {
+    mozc::internal::BenchmarkTransform(
+        "AES256 CBC encryption (AES-NI)",
+        BenchmarkAES256::TransformCBCWithAESNI, &buf);
+    mozc::internal::BenchmarkTransform(
+        "AES256 CBC decryption (AES-NI)",
+        BenchmarkAES256::InverseTransformCBCWithAESNI, &buf);
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+  mozc::internal::BenchmarkDigest(
+      "SHA1 (portable)", BenchmarkSHA1::MakeDigestPortable, data);
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (mozc::CPUFeatures::HasSHA() && mozc::CPUFeatures::HasSSSE3() &&
+      mozc::CPUFeatures::HasSSE41()) {
+    mozc::internal::BenchmarkDigest(
+        "SHA1 (SHA extensions)",
+        BenchmarkSHA1::MakeDigestWithSHAExtensions, data);
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+  mozc::internal::BenchmarkEncryptor(data);
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MOZC_BASE_FINGERPRINT_SET_H_
+#define MOZC_BASE_FINGERPRINT_SET_H_
+
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/util.h"
+
+namespace mozc {
+
+// A set of 64-bit fingerprints used for duplicate detection of strings, e.g.,
+// candidate values.  Compared with set<string>, this class neither copies nor
+// compares the strings, and it doesn't allocate memory once the table has
+// grown enough: the table is an open addressing (linear probing) array kept at
+// most half full, and Clear() just invalidates all the slots by bumping an
+// epoch counter.  Thus a long-lived instance can be cleared for each request
+// and reused without any allocation.
+//
+// Note that two different strings are treated as the same if their
+// fingerprints collide.  The probability is negligible for the number of
+// elements this class is designed for (up to several thousands).
+//
+// Usage:
+//   FingerprintSet seen;
+//   for (...) {
+//     if (!seen.Insert(candidate.value)) {
+//       continue;  // Duplicate.
+//     }
+//     ...
+//   }
+class FingerprintSet {
+ public:
+  FingerprintSet() : size_(0), epoch_(1) {}
+
+  // Preallocates the table so that |expected_size| elements can be inserted
+  // without rehashing.
+  explicit FingerprintSet(size_t expected_size) : size_(0), epoch_(1) {
+    Reserve(expected_size);
+  }
+
+  ~FingerprintSet() {}
+
+  // Inserts |fingerprint|.  Returns true if it was not in the set.
+  bool Insert(uint64 fingerprint) {
+    if (2 * (size_ + 1) > slots_.size()) {
+      Reserve(size_ + 1);
+    }
+    Slot *slot = &slots_[FindIndex(fingerprint)];
+    if (slot->epoch == epoch_) {
+      return false;
+    }
+    slot->fingerprint = fingerprint;
+    slot->epoch = epoch_;
+    ++size_;
+    return true;
+  }
+
+  // Inserts the fingerprint of |key|.  Returns true if it was not in the set.
+  bool Insert(const string &key) {
+    return Insert(Util::FingerprintV2(key));
+  }
+
+  bool Contains(uint64 fingerprint) const {
+    if (size_ == 0) {
+      return false;
+    }
+    return slots_[FindIndex(fingerprint)].epoch == epoch_;
+  }
+
+  bool Contains(const string &key) const {
+    return Contains(Util::FingerprintV2(key));
+  }
+
+  // Removes all the elements.  The table is kept for reuse.
+  void Clear() {
+    size_ = 0;
+    if (++epoch_ == 0) {
+      // The epoch counter wrapped around.  Invalidate all the slots
+      // explicitly so that stale slots aren't treated as live.
+      for (size_t i = 0; i < slots_.size(); ++i) {
+        slots_[i].epoch = 0;
+      }
+      epoch_ = 1;
+    }
+  }
+
+  // Grows the table so that |expected_size| elements can be inserted without
+  // rehashing.
+  void Reserve(size_t expected_size) {
+    size_t table_size = kMinTableSize;
+    while (table_size < 2 * expected_size) {
+      table_size *= 2;
+    }
+    if (table_size > slots_.size()) {
+      Rehash(table_size);
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+ private:
+  // A slot is live iff its epoch equals |epoch_|.
+  struct Slot {
+    uint64 fingerprint;
+    uint32 epoch;
+  };
+
+  static const size_t kMinTableSize = 16;
+
+  // Returns the index of the slot holding |fingerprint| or the empty slot
+  // where it should be inserted.  The table must have at least one empty slot.
+  size_t FindIndex(uint64 fingerprint) const {
+    DCHECK(!slots_.empty());
+    const size_t mask = slots_.size() - 1;
+    size_t index = static_cast<size_t>(fingerprint) & mask;
+    while (slots_[index].epoch == epoch_ &&
+           slots_[index].fingerprint != fingerprint) {
+      index = (index + 1) & mask;
+    }
+    return index;
+  }
+
+  // Reallocates the table with |table_size| slots, which must be a power of
+  // two, and reinserts the live elements.
+  void Rehash(size_t table_size) {
+    DCHECK_EQ(0, table_size & (table_size - 1));
+    DCHECK_GE(table_size, 2 * size_);
+    vector<Slot> old_slots(table_size);
+    old_slots.swap(slots_);
+    const uint32 old_epoch = epoch_;
+    // New slots are zero-initialized, i.e., empty for any epoch >= 1.
+    epoch_ = 1;
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (old_slots[i].epoch == old_epoch) {
+        Slot *slot = &slots_[FindIndex(old_slots[i].fingerprint)];
+        slot->fingerprint = old_slots[i].fingerprint;
+        slot->epoch = epoch_;
+      }
+    }
+  }
+
+  vector<Slot> slots_;
+  size_t size_;
+  uint32 epoch_;
+
+  DISALLOW_COPY_AND_ASSIGN(FingerprintSet);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_FINGERPRINT_SET_H_
@@ -0,0 +1,125 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "base/fingerprint_set.h"
+
+#include <set>
+#include <string>
+
+#include "base/port.h"
+#include "base/util.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+TEST(FingerprintSetTest, InsertAndContains) {
+  FingerprintSet seen;
+  EXPECT_TRUE(seen.empty());
+  EXPECT_FALSE(seen.Contains("foo"));
+
+  EXPECT_TRUE(seen.Insert("foo"));
+  EXPECT_TRUE(seen.Insert("bar"));
+  EXPECT_FALSE(seen.Insert("foo"));
+  EXPECT_TRUE(seen.Insert(""));
+  EXPECT_FALSE(seen.Insert(""));
+  EXPECT_EQ(3, seen.size());
+  EXPECT_FALSE(seen.empty());
+
+  EXPECT_TRUE(seen.Contains("foo"));
+  EXPECT_TRUE(seen.Contains("bar"));
+  EXPECT_TRUE(seen.Contains(""));
+  EXPECT_FALSE(seen.Contains("baz"));
+  EXPECT_TRUE(seen.Contains(Util::FingerprintV2("bar")));
+}
+
+TEST(FingerprintSetTest, RawFingerprints) {
+  FingerprintSet seen;
+  // Zero and fingerprints sharing the lower bits are valid elements.
+  const uint64 kFingerprints[] = {
+    0, 1, 16, 32, GG_ULONGLONG(0x100000000), GG_ULONGLONG(0xffffffffffffffff),
+  };
+  for (size_t i = 0; i < arraysize(kFingerprints); ++i) {
+    EXPECT_FALSE(seen.Contains(kFingerprints[i]));
+    EXPECT_TRUE(seen.Insert(kFingerprints[i]));
+  }
+  for (size_t i = 0; i < arraysize(kFingerprints); ++i) {
+    EXPECT_TRUE(seen.Contains(kFingerprints[i]));
+    EXPECT_FALSE(seen.Insert(kFingerprints[i]));
+  }
+  EXPECT_EQ(arraysize(kFingerprints), seen.size());
+}
+
+TEST(FingerprintSetTest, Clear) {
+  FingerprintSet seen;
+  for (int n = 0; n < 3; ++n) {
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(seen.Insert(Util::StringPrintf("%d-%d", n, i)));
+    }
+    EXPECT_EQ(100, seen.size());
+    seen.Clear();
+    EXPECT_TRUE(seen.empty());
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_FALSE(seen.Contains(Util::StringPrintf("%d-%d", n, i)));
+    }
+  }
+}
+
+TEST(FingerprintSetTest, Reserve) {
+  FingerprintSet seen(1000);
+  seen.Insert("foo");
+  seen.Reserve(10);
+  seen.Reserve(5000);
+  EXPECT_EQ(1, seen.size());
+  EXPECT_TRUE(seen.Contains("foo"));
+}
+
+TEST(FingerprintSetTest, SameAsSet) {
+  FingerprintSet seen;
+  set<string> expected;
+  for (int n = 0; n < 10; ++n) {
+    seen.Clear();
+    expected.clear();
+    const int num_keys = 1 << n;
+    for (int i = 0; i < 4 * num_keys; ++i) {
+      const string key = Util::StringPrintf(
+          "%d", Util::Random(num_keys));
+      EXPECT_EQ(expected.insert(key).second, seen.Insert(key)) << key;
+      EXPECT_EQ(expected.size(), seen.size());
+    }
+    for (int i = 0; i < 2 * num_keys; ++i) {
+      const string key = Util::StringPrintf("%d", i);
+      EXPECT_EQ(expected.find(key) != expected.end(), seen.Contains(key))
+          << key;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mozc
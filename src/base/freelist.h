@@ -30,6 +30,7 @@
 #ifndef MOZC_BASE_FREELIST_H_
 #define MOZC_BASE_FREELIST_H_
 
+#include <algorithm>
 #include <vector>
 #include "base/port.h"
 
@@ -47,7 +48,8 @@ namespace mozc {
 template <class T> class FreeList {
  public:
   explicit FreeList(size_t size)
-      : current_index_(0), chunk_index_(0), size_(size) {
+      : current_index_(0), chunk_index_(0), high_water_chunk_count_(0),
+        size_(size) {
   }
 
   ~FreeList() {
@@ -56,6 +58,10 @@ template <class T> class FreeList {
     }
   }
 
+  // Makes all the objects available again while keeping the allocated
+  // chunks, so that the next Alloc() calls don't hit the heap.  Note that
+  // the objects are handed out again as they are; they are not
+  // re-constructed.
   void Reset() {
     chunk_index_ = current_index_ = 0;
   }
@@ -66,9 +72,43 @@ template <class T> class FreeList {
     }
     if (pool_.size() > 1) {
       pool_.resize(1);
+      chunk_sizes_.resize(1);
     }
     current_index_ = 0;
     chunk_index_ = 0;
+    high_water_chunk_count_ = 0;
+  }
+
+  // Deletes the chunks which have not been used since the last call of
+  // Shrink(), i.e. the ones above the high-water mark.  Objects currently
+  // handed out are never in those chunks, so they stay valid.  All the
+  // chunks are deleted if nothing has been allocated since Reset() and the
+  // last Shrink().
+  void Shrink() {
+    const size_t keep = max(high_water_chunk_count_, used_chunk_count());
+    for (size_t i = keep; i < pool_.size(); ++i) {
+      delete [] pool_[i];
+    }
+    if (pool_.size() > keep) {
+      pool_.resize(keep);
+      chunk_sizes_.resize(keep);
+    }
+    high_water_chunk_count_ = used_chunk_count();
+  }
+
+  // Returns the number of chunks currently allocated.
+  size_t chunk_count() const {
+    return pool_.size();
+  }
+
+  // Appends all the objects in the allocated chunks to |objects|, whether
+  // they are handed out or not.
+  void GetAllObjects(vector<T *> *objects) {
+    for (size_t i = 0; i < pool_.size(); ++i) {
+      for (size_t j = 0; j < chunk_sizes_[i]; ++j) {
+        objects->push_back(pool_[i] + j);
+      }
+    }
   }
 
   T* Alloc() {
@@ -83,10 +123,12 @@ template <class T> class FreeList {
 
     if (chunk_index_ == pool_.size()) {
       pool_.push_back(new T[size_]);
+      chunk_sizes_.push_back(size_);
     }
 
     T* r = pool_[chunk_index_] + current_index_;
     current_index_ += len;
+    high_water_chunk_count_ = max(high_water_chunk_count_, chunk_index_ + 1);
     return r;
   }
 
@@ -95,9 +137,20 @@ template <class T> class FreeList {
   }
 
  private:
+  // Returns the number of chunks up to the last object handed out.
+  size_t used_chunk_count() const {
+    if (chunk_index_ == 0 && current_index_ == 0) {
+      return 0;
+    }
+    return chunk_index_ + 1;
+  }
+
   vector<T *> pool_;
+  // Parallel to |pool_|.
+  vector<size_t> chunk_sizes_;
   size_t current_index_;
   size_t chunk_index_;
+  size_t high_water_chunk_count_;
   size_t size_;
 
   DISALLOW_COPY_AND_ASSIGN(FreeList);
@@ -116,6 +169,25 @@ template <class T> class ObjectPool {
     freelist_.Free();
   }
 
+  // Releases all the objects at once without deleting the chunks.
+  void Reset() {
+    released_.clear();
+    freelist_.Reset();
+  }
+
+  void Shrink() {
+    freelist_.Shrink();
+  }
+
+  size_t chunk_count() const {
+    return freelist_.chunk_count();
+  }
+
+  // See FreeList::GetAllObjects().
+  void GetAllObjects(vector<T *> *objects) {
+    freelist_.GetAllObjects(objects);
+  }
+
   T* Alloc() {
     if (!released_.empty()) {
       T *result = released_.back();
@@ -29,6 +29,7 @@
 
 #include <string.h>
 #include <string>
+#include "base/logging.h"
 #include "base/util.h"
 
 namespace mozc {
@@ -36,6 +37,70 @@ namespace {
 const uint32 kFingerPrint32Seed = 0xfd12deff;
 const uint32 kFingerPrintSeed0 = 0x6d6f;
 const uint32 kFingerPrintSeed1 = 0x7a63;
+
+// Constants of FingerprintV2.  kV2Multiplier is the one of MurmurHash64A and
+// kV2Final* are the ones of the finalizer of MurmurHash3.
+const uint64 kFingerprintV2Seed = GG_ULONGLONG(0x6d6f7a6366703276);
+const uint64 kV2Multiplier = GG_ULONGLONG(0xc6a4a7935bd1e995);
+const uint64 kV2Final0 = GG_ULONGLONG(0xff51afd7ed558ccd);
+const uint64 kV2Final1 = GG_ULONGLONG(0xc4ceb9fe1a85ec53);
+
+// Loads 8 bytes in little endian regardless of the byte order of the
+// platform so that the fingerprints can be persisted.  Compilers merge this
+// into a single load on little endian platforms.
+inline uint64 LoadUint64(const char *str) {
+  const uint8 *p = reinterpret_cast<const uint8 *>(str);
+  return static_cast<uint64>(p[0]) |
+         (static_cast<uint64>(p[1]) << 8) |
+         (static_cast<uint64>(p[2]) << 16) |
+         (static_cast<uint64>(p[3]) << 24) |
+         (static_cast<uint64>(p[4]) << 32) |
+         (static_cast<uint64>(p[5]) << 40) |
+         (static_cast<uint64>(p[6]) << 48) |
+         (static_cast<uint64>(p[7]) << 56);
+}
+
+// Loads the last |length| (< 8) bytes in the same order as LoadUint64.
+inline uint64 LoadPartialUint64(const char *str, size_t length) {
+  const uint8 *p = reinterpret_cast<const uint8 *>(str);
+  uint64 result = 0;
+  switch (length) {
+    case 7:
+      result |= static_cast<uint64>(p[6]) << 48;
+      FALLTHROUGH_INTENDED;
+    case 6:
+      result |= static_cast<uint64>(p[5]) << 40;
+      FALLTHROUGH_INTENDED;
+    case 5:
+      result |= static_cast<uint64>(p[4]) << 32;
+      FALLTHROUGH_INTENDED;
+    case 4:
+      result |= static_cast<uint64>(p[3]) << 24;
+      FALLTHROUGH_INTENDED;
+    case 3:
+      result |= static_cast<uint64>(p[2]) << 16;
+      FALLTHROUGH_INTENDED;
+    case 2:
+      result |= static_cast<uint64>(p[1]) << 8;
+      FALLTHROUGH_INTENDED;
+    case 1:
+      result |= static_cast<uint64>(p[0]);
+      break;
+  }
+  return result;
+}
+
+// Mixes one word into |hash| in the same way as MurmurHash64A.
+inline uint64 MixV2(uint64 hash, uint64 word) {
+  word *= kV2Multiplier;
+  word ^= word >> 47;
+  word *= kV2Multiplier;
+  return (hash ^ word) * kV2Multiplier;
+}
+
+inline uint64 RotateV2(uint64 value, int shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
 }  // namespace
 
 #define mix(a,b,c) { \
@@ -164,4 +229,65 @@ uint64 Util::FingerprintWithSeed(const char *str, size_t length, uint32 seed) {
   return result;
 }
 
+uint64 Util::FingerprintV2(const string &key) {
+  return FingerprintV2WithSeed(key.data(), key.size(), kFingerprintV2Seed);
+}
+
+uint64 Util::FingerprintV2(const char *str, size_t length) {
+  return FingerprintV2WithSeed(str, length, kFingerprintV2Seed);
+}
+
+uint64 Util::FingerprintV2WithSeed(const string &key, uint64 seed) {
+  return FingerprintV2WithSeed(key.data(), key.size(), seed);
+}
+
+// Two independent lanes of 8 bytes are mixed per round so that the
+// multiplications of them can run in parallel.  Unlike Fingerprint(), the
+// input is read word by word and hashed only once for 64 bits.
+uint64 Util::FingerprintV2WithSeed(const char *str, size_t length,
+                                   uint64 seed) {
+  uint64 h0 = seed ^ (static_cast<uint64>(length) * kV2Multiplier);
+  uint64 h1 = RotateV2(seed, 32) ^ kV2Final0;
+  size_t len = length;
+
+  while (len >= 16) {
+    h0 = MixV2(h0, LoadUint64(str));
+    h1 = MixV2(h1, LoadUint64(str + 8));
+    str += 16;
+    len -= 16;
+  }
+  if (len >= 8) {
+    h0 = MixV2(h0, LoadUint64(str));
+    str += 8;
+    len -= 8;
+  }
+  if (len > 0) {
+    h1 = MixV2(h1, LoadPartialUint64(str, len));
+  }
+
+  uint64 result = h0 ^ RotateV2(h1, 29);
+  result ^= result >> 33;
+  result *= kV2Final0;
+  result ^= result >> 33;
+  result *= kV2Final1;
+  result ^= result >> 33;
+  // Same as Fingerprint(), 0 and 1 are never returned.
+  if (result < 2) {
+    result ^= GG_ULONGLONG(0x130f9bef94a0a928);
+  }
+  return result;
+}
+
+uint64 Util::FingerprintWithVersion(FingerprintVersion version,
+                                    const char *str, size_t length) {
+  switch (version) {
+    case FINGERPRINT_V1:
+      return Fingerprint(str, length);
+    case FINGERPRINT_V2:
+      return FingerprintV2(str, length);
+  }
+  LOG(DFATAL) << "Unknown fingerprint version: " << version;
+  return Fingerprint(str, length);
+}
+
 }  // namespace mozc
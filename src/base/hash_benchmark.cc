@@ -0,0 +1,92 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Small benchmark code to compare the throughput of the versions of the
+// 64bit fingerprint, see Util::FingerprintVersion, for the key lengths
+// typical to Mozc (readings and values of a few characters) and for long
+// inputs.
+//
+// Usage:
+//   hash_benchmark --iterations=1000000
+
+#include <iostream>  // NOLINT
+#include <string>
+
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+
+DEFINE_int32(iterations, 1000000, "number of iterations for each key size.");
+
+namespace mozc {
+namespace {
+
+void Benchmark(Util::FingerprintVersion version, const string &data,
+               size_t key_size) {
+  // Keys start at different offsets to include unaligned reads.
+  const size_t num_offsets = data.size() - key_size + 1;
+  uint64 sink = 0;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    sink += Util::FingerprintWithVersion(
+        version, data.data() + i % num_offsets, key_size);
+  }
+  stopwatch.Stop();
+  const int64 elapsed_usec = stopwatch.GetElapsedMicroseconds();
+  const double total_bytes = static_cast<double>(key_size) * FLAGS_iterations;
+  cout << Util::StringPrintf(
+              "V%d %5d bytes: %8.1f MB/s %8.1f nsec/key",
+              static_cast<int>(version), static_cast<int>(key_size),
+              elapsed_usec == 0 ? 0.0 : total_bytes / elapsed_usec,
+              elapsed_usec * 1000.0 / FLAGS_iterations)
+       << endl;
+  VLOG(1) << sink;
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  const size_t kKeySizes[] = {3, 6, 9, 15, 24, 48, 256, 4096};
+  string data(kKeySizes[arraysize(kKeySizes) - 1] + 64, '\0');
+  mozc::Util::GetRandomSequence(&data[0], data.size());
+
+  for (size_t i = 0; i < arraysize(kKeySizes); ++i) {
+    mozc::Benchmark(mozc::Util::FINGERPRINT_V1, data, kKeySizes[i]);
+    mozc::Benchmark(mozc::Util::FINGERPRINT_V2, data, kKeySizes[i]);
+  }
+  return 0;
+}
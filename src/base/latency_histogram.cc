@@ -0,0 +1,263 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "base/latency_histogram.h"
+
+#ifdef OS_WIN
+#include <windows.h>
+#endif  // OS_WIN
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "base/logging.h"
+#include "base/mutex.h"
+#include "base/singleton.h"
+#include "base/util.h"
+
+namespace mozc {
+namespace {
+
+inline void AtomicAdd(volatile uint64 *target, uint64 value) {
+#ifdef OS_WIN
+  ::InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG *>(target),
+                             static_cast<LONGLONG>(value));
+#else
+  __sync_fetch_and_add(target, value);
+#endif  // OS_WIN
+}
+
+// Returns floor(log2(value)) for |value| > 0.
+inline int FloorLog2(uint64 value) {
+  DCHECK_GT(value, 0);
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(value);
+#else
+  int result = 0;
+  for (int shift = 32; shift > 0; shift >>= 1) {
+    if (value >= (static_cast<uint64>(1) << shift)) {
+      value >>= shift;
+      result += shift;
+    }
+  }
+  return result;
+#endif  // __GNUC__
+}
+
+const int kNumLinearBuckets = 16;
+const int kLinearBucketBits = 4;  // kNumLinearBuckets == 1 << 4
+const int kSubBucketBits = 2;     // 4 sub-buckets per power of two
+
+class LatencyHistogramRegistry {
+ public:
+  LatencyHistogramRegistry() {}
+  ~LatencyHistogramRegistry() {
+    for (map<string, LatencyHistogram *>::iterator it = histograms_.begin();
+         it != histograms_.end(); ++it) {
+      delete it->second;
+    }
+  }
+
+  LatencyHistogram *Get(const string &name) {
+    scoped_lock l(&mutex_);
+    LatencyHistogram **histogram = &histograms_[name];
+    if (*histogram == NULL) {
+      *histogram = new LatencyHistogram(name);
+    }
+    return *histogram;
+  }
+
+  void GetAll(vector<LatencyHistogram *> *histograms) {
+    scoped_lock l(&mutex_);
+    histograms->clear();
+    for (map<string, LatencyHistogram *>::const_iterator it =
+             histograms_.begin(); it != histograms_.end(); ++it) {
+      histograms->push_back(it->second);
+    }
+  }
+
+ private:
+  Mutex mutex_;
+  map<string, LatencyHistogram *> histograms_;
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyHistogramRegistry);
+};
+
+}  // namespace
+
+uint64 LatencyHistogram::Snapshot::GetPercentileUsec(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64 rank = static_cast<uint64>(
+      max(0.0, min(100.0, percentile)) / 100.0 * (count - 1));
+  uint64 seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i].count;
+    if (seen > rank) {
+      return buckets[i].lower_bound_usec;
+    }
+  }
+  return buckets.empty() ? 0 : buckets.back().lower_bound_usec;
+}
+
+LatencyHistogram::LatencyHistogram(const string &name)
+    : name_(name) {
+  Reset();
+}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+void LatencyHistogram::Record(uint64 usec) {
+  AtomicAdd(&buckets_[GetBucketIndex(usec)], 1);
+  AtomicAdd(&count_, 1);
+  AtomicAdd(&total_usec_, usec);
+}
+
+void LatencyHistogram::Reset() {
+  count_ = 0;
+  total_usec_ = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    buckets_[i] = 0;
+  }
+}
+
+void LatencyHistogram::GetSnapshot(Snapshot *snapshot) const {
+  DCHECK(snapshot);
+  snapshot->name = name_;
+  snapshot->buckets.clear();
+  // Sums up the buckets instead of reading |count_| so that the percentiles
+  // computed from the snapshot are consistent with its buckets.
+  snapshot->count = 0;
+  snapshot->total_usec = total_usec_;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    const uint64 count = buckets_[i];
+    if (count == 0) {
+      continue;
+    }
+    Bucket bucket;
+    bucket.lower_bound_usec = GetBucketLowerBound(i);
+    bucket.count = count;
+    snapshot->buckets.push_back(bucket);
+    snapshot->count += count;
+  }
+}
+
+// static
+int LatencyHistogram::GetBucketIndex(uint64 usec) {
+  if (usec < kNumLinearBuckets) {
+    return static_cast<int>(usec);
+  }
+  const int exponent = FloorLog2(usec);
+  const int sub_bucket = static_cast<int>(
+      (usec >> (exponent - kSubBucketBits)) & ((1 << kSubBucketBits) - 1));
+  return kNumLinearBuckets +
+      ((exponent - kLinearBucketBits) << kSubBucketBits) + sub_bucket;
+}
+
+// static
+uint64 LatencyHistogram::GetBucketLowerBound(int index) {
+  DCHECK_GE(index, 0);
+  DCHECK_LT(index, kNumBuckets);
+  if (index < kNumLinearBuckets) {
+    return static_cast<uint64>(index);
+  }
+  const int offset = index - kNumLinearBuckets;
+  const int exponent = (offset >> kSubBucketBits) + kLinearBucketBits;
+  const uint64 sub_bucket = offset & ((1 << kSubBucketBits) - 1);
+  return ((static_cast<uint64>(1) << kSubBucketBits) + sub_bucket)
+      << (exponent - kSubBucketBits);
+}
+
+// static
+LatencyHistogram *LatencyHistogram::Get(const string &name) {
+  return Singleton<LatencyHistogramRegistry>::get()->Get(name);
+}
+
+// static
+void LatencyHistogram::GetAllSnapshots(vector<Snapshot> *snapshots) {
+  DCHECK(snapshots);
+  vector<LatencyHistogram *> histograms;
+  Singleton<LatencyHistogramRegistry>::get()->GetAll(&histograms);
+  snapshots->resize(histograms.size());
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    histograms[i]->GetSnapshot(&(*snapshots)[i]);
+  }
+}
+
+// static
+void LatencyHistogram::ResetAll() {
+  vector<LatencyHistogram *> histograms;
+  Singleton<LatencyHistogramRegistry>::get()->GetAll(&histograms);
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    histograms[i]->Reset();
+  }
+}
+
+// static
+string LatencyHistogram::DumpAllAsText() {
+  vector<Snapshot> snapshots;
+  GetAllSnapshots(&snapshots);
+  ostringstream os;
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    const Snapshot &snapshot = snapshots[i];
+    if (snapshot.count == 0) {
+      continue;
+    }
+    os << snapshot.name
+       << " count=" << snapshot.count
+       << " mean=" << snapshot.total_usec / snapshot.count
+       << " p50=" << snapshot.GetPercentileUsec(50)
+       << " p95=" << snapshot.GetPercentileUsec(95)
+       << " p99=" << snapshot.GetPercentileUsec(99)
+       << " max=" << snapshot.buckets.back().lower_bound_usec
+       << " (usec)" << endl;
+  }
+  return os.str();
+}
+
+ScopedLatencyTimer::ScopedLatencyTimer(LatencyHistogram *histogram)
+    : histogram_(histogram),
+      start_ticks_(histogram == NULL ? 0 : Util::GetTicks()) {}
+
+ScopedLatencyTimer::~ScopedLatencyTimer() {
+  if (histogram_ == NULL) {
+    return;
+  }
+  const uint64 elapsed_ticks = Util::GetTicks() - start_ticks_;
+  const uint64 frequency = Util::GetFrequency();
+  if (frequency == 0) {
+    return;
+  }
+  histogram_->Record(elapsed_ticks * 1000000 / frequency);
+}
+
+}  // namespace mozc
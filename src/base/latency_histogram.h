@@ -0,0 +1,139 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Always-on latency histograms for hot code paths.
+//
+// Each histogram keeps a fixed array of log-linear buckets: values below 16
+// microseconds get one bucket each, and every power of two above that is
+// split into four sub-buckets, so the relative error of a bucket is at most
+// 25%.  Record() only touches a few integers with atomic adds, so it can be
+// called from any thread without taking a lock.
+//
+// Usage:
+// class Foo {
+//  public:
+//   Foo() : bar_histogram_(LatencyHistogram::Get("Foo::Bar")) {}
+//   void Bar() {
+//     ScopedLatencyTimer timer(bar_histogram_);
+//     ...
+//   }
+//  private:
+//   LatencyHistogram *bar_histogram_;
+// };
+//
+// LatencyHistogram::Get() takes a lock, so cache the returned pointer rather
+// than calling it for every measurement.
+
+#ifndef MOZC_BASE_LATENCY_HISTOGRAM_H_
+#define MOZC_BASE_LATENCY_HISTOGRAM_H_
+
+#include <string>
+#include <vector>
+
+#include "base/port.h"
+
+namespace mozc {
+
+class LatencyHistogram {
+ public:
+  // 16 linear buckets + 4 sub-buckets for each exponent in [4, 63].
+  static const int kNumBuckets = 16 + (64 - 4) * 4;
+
+  struct Bucket {
+    uint64 lower_bound_usec;
+    uint64 count;
+  };
+
+  struct Snapshot {
+    string name;
+    uint64 count;
+    uint64 total_usec;
+    // Only non-empty buckets, in ascending order of |lower_bound_usec|.
+    vector<Bucket> buckets;
+
+    Snapshot() : count(0), total_usec(0) {}
+
+    // Returns the lower bound of the bucket which contains the |percentile|
+    // (0-100) th sample.  Returns 0 when no sample has been recorded.
+    uint64 GetPercentileUsec(double percentile) const;
+  };
+
+  explicit LatencyHistogram(const string &name);
+  ~LatencyHistogram();
+
+  const string &name() const { return name_; }
+
+  void Record(uint64 usec);
+  void Reset();
+
+  // The result is not an atomic view of all buckets; samples recorded
+  // concurrently may or may not be included.
+  void GetSnapshot(Snapshot *snapshot) const;
+
+  static int GetBucketIndex(uint64 usec);
+  static uint64 GetBucketLowerBound(int index);
+
+  // Returns the histogram registered as |name|, creating it on first use.
+  // The returned object lives until the process exits.
+  static LatencyHistogram *Get(const string &name);
+
+  // Snapshots of all the registered histograms, sorted by name.
+  static void GetAllSnapshots(vector<Snapshot> *snapshots);
+  static void ResetAll();
+
+  // Human readable dump of all the registered histograms for logging.
+  static string DumpAllAsText();
+
+ private:
+  const string name_;
+  volatile uint64 count_;
+  volatile uint64 total_usec_;
+  volatile uint64 buckets_[kNumBuckets];
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+// Records the lifetime of this object to |histogram|.  |histogram| can be
+// NULL, in which case nothing is measured.
+class ScopedLatencyTimer {
+ public:
+  explicit ScopedLatencyTimer(LatencyHistogram *histogram);
+  ~ScopedLatencyTimer();
+
+ private:
+  LatencyHistogram *histogram_;
+  uint64 start_ticks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedLatencyTimer);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,191 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "base/latency_histogram.h"
+
+#include <string>
+#include <vector>
+
+#include "base/clock_mock.h"
+#include "base/scoped_ptr.h"
+#include "base/thread.h"
+#include "base/util.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+TEST(LatencyHistogramTest, BucketIndex) {
+  // Linear buckets.
+  for (uint64 usec = 0; usec < 16; ++usec) {
+    EXPECT_EQ(usec, LatencyHistogram::GetBucketIndex(usec));
+    EXPECT_EQ(usec, LatencyHistogram::GetBucketLowerBound(usec));
+  }
+
+  // [16, 20), [20, 24), [24, 28), [28, 32), [32, 40), ...
+  EXPECT_EQ(16, LatencyHistogram::GetBucketIndex(16));
+  EXPECT_EQ(16, LatencyHistogram::GetBucketIndex(19));
+  EXPECT_EQ(17, LatencyHistogram::GetBucketIndex(20));
+  EXPECT_EQ(19, LatencyHistogram::GetBucketIndex(31));
+  EXPECT_EQ(20, LatencyHistogram::GetBucketIndex(32));
+  EXPECT_EQ(20, LatencyHistogram::GetBucketIndex(39));
+  EXPECT_EQ(21, LatencyHistogram::GetBucketIndex(40));
+  EXPECT_EQ(LatencyHistogram::kNumBuckets - 1,
+            LatencyHistogram::GetBucketIndex(~static_cast<uint64>(0)));
+
+  // Lower bounds are strictly increasing and consistent with the index.
+  for (int i = 1; i < LatencyHistogram::kNumBuckets; ++i) {
+    const uint64 lower_bound = LatencyHistogram::GetBucketLowerBound(i);
+    EXPECT_LT(LatencyHistogram::GetBucketLowerBound(i - 1), lower_bound);
+    EXPECT_EQ(i, LatencyHistogram::GetBucketIndex(lower_bound));
+    EXPECT_EQ(i - 1, LatencyHistogram::GetBucketIndex(lower_bound - 1));
+  }
+}
+
+TEST(LatencyHistogramTest, RecordAndSnapshot) {
+  LatencyHistogram histogram("test");
+  for (uint64 usec = 1; usec <= 100; ++usec) {
+    histogram.Record(usec);
+  }
+
+  LatencyHistogram::Snapshot snapshot;
+  histogram.GetSnapshot(&snapshot);
+  EXPECT_EQ("test", snapshot.name);
+  EXPECT_EQ(100, snapshot.count);
+  EXPECT_EQ(5050, snapshot.total_usec);
+  uint64 total_count = 0;
+  for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+    EXPECT_NE(0, snapshot.buckets[i].count);
+    total_count += snapshot.buckets[i].count;
+  }
+  EXPECT_EQ(100, total_count);
+
+  EXPECT_EQ(1, snapshot.GetPercentileUsec(0));
+  EXPECT_EQ(48, snapshot.GetPercentileUsec(50));  // 50 is in [48, 56).
+  EXPECT_EQ(96, snapshot.GetPercentileUsec(100));  // 100 is in [96, 112).
+
+  histogram.Reset();
+  histogram.GetSnapshot(&snapshot);
+  EXPECT_EQ(0, snapshot.count);
+  EXPECT_EQ(0, snapshot.total_usec);
+  EXPECT_TRUE(snapshot.buckets.empty());
+  EXPECT_EQ(0, snapshot.GetPercentileUsec(50));
+}
+
+TEST(LatencyHistogramTest, Registry) {
+  LatencyHistogram *histogram = LatencyHistogram::Get("LatencyHistogramTest");
+  EXPECT_EQ(histogram, LatencyHistogram::Get("LatencyHistogramTest"));
+  EXPECT_NE(histogram, LatencyHistogram::Get("LatencyHistogramTest2"));
+  EXPECT_EQ("LatencyHistogramTest", histogram->name());
+
+  LatencyHistogram::ResetAll();
+  histogram->Record(10);
+
+  vector<LatencyHistogram::Snapshot> snapshots;
+  LatencyHistogram::GetAllSnapshots(&snapshots);
+  bool found = false;
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    if (snapshots[i].name == "LatencyHistogramTest") {
+      EXPECT_EQ(1, snapshots[i].count);
+      EXPECT_EQ(10, snapshots[i].total_usec);
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+
+  const string dump = LatencyHistogram::DumpAllAsText();
+  EXPECT_NE(string::npos, dump.find("LatencyHistogramTest count=1"));
+  // Empty histograms are omitted.
+  EXPECT_EQ(string::npos, dump.find("LatencyHistogramTest2"));
+}
+
+TEST(LatencyHistogramTest, ScopedLatencyTimer) {
+  scoped_ptr<ClockMock> clock_mock(new ClockMock(0, 0));
+  clock_mock->SetFrequency(1000000000uLL);  // 1GHz
+  Util::SetClockHandler(clock_mock.get());
+
+  LatencyHistogram histogram("timer");
+  {
+    ScopedLatencyTimer timer(&histogram);
+    clock_mock->PutClockForwardByTicks(250000);  // 250 usec
+  }
+  {
+    // NULL is allowed and ignored.
+    ScopedLatencyTimer timer(NULL);
+  }
+  Util::SetClockHandler(NULL);
+
+  LatencyHistogram::Snapshot snapshot;
+  histogram.GetSnapshot(&snapshot);
+  EXPECT_EQ(1, snapshot.count);
+  EXPECT_EQ(250, snapshot.total_usec);
+}
+
+class RecordThread : public Thread {
+ public:
+  RecordThread(LatencyHistogram *histogram, int num_records)
+      : histogram_(histogram), num_records_(num_records) {}
+
+  virtual void Run() {
+    for (int i = 0; i < num_records_; ++i) {
+      histogram_->Record(i % 1000);
+    }
+  }
+
+ private:
+  LatencyHistogram *histogram_;
+  const int num_records_;
+};
+
+TEST(LatencyHistogramTest, ConcurrentRecord) {
+  const int kNumThreads = 4;
+  const int kNumRecords = 10000;
+  LatencyHistogram histogram("concurrent");
+  vector<RecordThread *> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(new RecordThread(&histogram, kNumRecords));
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i]->Start();
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+
+  LatencyHistogram::Snapshot snapshot;
+  histogram.GetSnapshot(&snapshot);
+  EXPECT_EQ(kNumThreads * kNumRecords, snapshot.count);
+  EXPECT_EQ(kNumThreads * (kNumRecords / 1000) * (999 * 1000 / 2),
+            snapshot.total_usec);
+}
+
+}  // namespace
+}  // namespace mozc
@@ -292,34 +292,39 @@ bool NumberUtil::ArabicToKanji(StringPiece input_num,
 
   // If given number needs higher ranks than our expectations,
   // we don't convert it.
-  if (arraysize(kNumKanjiBiggerRanks) * kDigitsInBigRank < input_num.size()) {
+  const size_t kMaxDigits = arraysize(kNumKanjiBiggerRanks) * kDigitsInBigRank;
+  if (kMaxDigits < input_num.size()) {
     return false;
   }
 
-  // Fill '0' in the beginning of input_num to make its length
-  // (N * kDigitsInBigRank).
-  const int filled_zero_num = (kDigitsInBigRank -
-      (input_num.size() % kDigitsInBigRank)) % kDigitsInBigRank;
-  string input(filled_zero_num, kAsciiZero);
-  input_num.AppendToString(&input);
-
-  // Segment into kDigitsInBigRank-digits pieces
-  vector<string> ranked_numbers;
-  for (int i = static_cast<int>(input.size()) - kDigitsInBigRank; i >= 0;
-       i -= kDigitsInBigRank) {
-    ranked_numbers.push_back(input.substr(i, kDigitsInBigRank));
+  // Fill 0 in the beginning of the digits to make its length
+  // (N * kDigitsInBigRank), so that the digits are segmented into
+  // kDigitsInBigRank-digits pieces in place.  digits[0] is the most
+  // significant digit.
+  const size_t rank_size =
+      (input_num.size() + kDigitsInBigRank - 1) / kDigitsInBigRank;
+  const size_t filled_zero_num = rank_size * kDigitsInBigRank -
+      input_num.size();
+  uint8 digits[kMaxDigits];
+  fill(digits, digits + filled_zero_num, 0);
+  for (size_t i = 0; i < input_num.size(); ++i) {
+    digits[filled_zero_num + i] = static_cast<uint8>(input_num[i] - kAsciiZero);
   }
-  const size_t rank_size = ranked_numbers.size();
+
+  // Each digit is at most a 3-byte character and a 3-byte rank.
+  string result;
+  result.reserve(input_num.size() * 6 + rank_size * 3);
 
   for (size_t variation_index = 0;
        variation_index < arraysize(kKanjiVariations); ++variation_index) {
     const NumberStringVariation &variation = kKanjiVariations[variation_index];
-    const char *const *const digits = variation.digits;
+    const char *const *const digit_table = variation.digits;
     const NumberString::Style style = variation.style;
-
-    if (rank_size == 1 &&
+    const bool is_arabic =
         (style == NumberString::NUMBER_ARABIC_AND_KANJI_HALFWIDTH ||
-         style == NumberString::NUMBER_ARABIC_AND_KANJI_FULLWIDTH)) {
+         style == NumberString::NUMBER_ARABIC_AND_KANJI_FULLWIDTH);
+
+    if (rank_size == 1 && is_arabic) {
       continue;
     }
 
@@ -333,37 +338,36 @@ bool NumberUtil::ArabicToKanji(StringPiece input_num,
       bigger_ranks = kNumKanjiBiggerRanks;
     }
 
-    // TODO(peria): Bring |result| out if it improves the performance.
-    string result;
+    result.clear();
 
     // Converts each segment, and merges them with rank Kanjis.
     for (int rank = rank_size - 1; rank >= 0; --rank) {
-      const string &segment = ranked_numbers[rank];
-      string segment_result;
+      const uint8 *segment =
+          digits + (rank_size - 1 - rank) * kDigitsInBigRank;
+      const size_t segment_begin = result.size();
       bool leading = true;
-      for (size_t i = 0; i < segment.size(); ++i) {
-        if (leading && segment[i] == kAsciiZero) {
+      for (size_t i = 0; i < kDigitsInBigRank; ++i) {
+        if (leading && segment[i] == 0) {
           continue;
         }
 
         leading = false;
-        if (style == NumberString::NUMBER_ARABIC_AND_KANJI_HALFWIDTH ||
-            style == NumberString::NUMBER_ARABIC_AND_KANJI_FULLWIDTH) {
-          segment_result += digits[segment[i] - kAsciiZero];
+        if (is_arabic) {
+          result.append(digit_table[segment[i]]);
         } else {
-          if (segment[i] == kAsciiZero) {
+          if (segment[i] == 0) {
             continue;
           }
           // In "大字" style, "壱" is also required on every rank.
           if (style == NumberString::NUMBER_OLD_KANJI ||
-              i == kDigitsInBigRank - 1 || segment[i] != kAsciiOne) {
-            segment_result += digits[segment[i] - kAsciiZero];
+              i == kDigitsInBigRank - 1 || segment[i] != 1) {
+            result.append(digit_table[segment[i]]);
           }
-          segment_result += ranks[kDigitsInBigRank - i];
+          result.append(ranks[kDigitsInBigRank - i]);
         }
       }
-      if (!segment_result.empty()) {
-        result += segment_result + bigger_ranks[rank];
+      if (result.size() != segment_begin) {
+        result.append(bigger_ranks[rank]);
       }
     }
 
@@ -384,13 +388,17 @@ bool NumberUtil::ArabicToKanji(StringPiece input_num,
       }
 
       // for single kanji
-      if (input == "0010") {
-        // "拾"
-        output->push_back(NumberString("\xE6\x8B\xBE", description, style));
-      }
-      if (input == "1000") {
-        // "阡"
-        output->push_back(NumberString("\xE9\x98\xA1", description, style));
+      if (rank_size == 1) {
+        const uint8 kTen[kDigitsInBigRank] = {0, 0, 1, 0};
+        const uint8 kThousand[kDigitsInBigRank] = {1, 0, 0, 0};
+        if (memcmp(digits, kTen, sizeof(kTen)) == 0) {
+          // "拾"
+          output->push_back(NumberString("\xE6\x8B\xBE", description, style));
+        }
+        if (memcmp(digits, kThousand, sizeof(kThousand)) == 0) {
+          // "阡"
+          output->push_back(NumberString("\xE9\x98\xA1", description, style));
+        }
       }
     }
   }
@@ -434,11 +442,13 @@ bool NumberUtil::ArabicToSeparatedArabic(
     return false;
   }
 
+  // Each digit, separator and point is at most a 3-byte character.
+  string result;
+  result.reserve(input_num.size() * 3 + integer.size());
   for (size_t i = 0; i < arraysize(kNumDigitsVariations); ++i) {
     const NumberStringVariation &variation = kNumDigitsVariations[i];
     const char *const *const digits = variation.digits;
-    // TODO(peria): Bring |result| out if it improves the performance.
-    string result;
+    result.clear();
 
     // integral part
     for (StringPiece::size_type j = 0; j < integer.size(); ++j) {
@@ -490,10 +500,12 @@ bool NumberUtil::ArabicToWideArabic(
     return false;
   }
 
+  // Each digit is at most a 3-byte character.
+  string result;
+  result.reserve(input_num.size() * 3);
   for (size_t i = 0; i < arraysize(kSingleDigitsVariations); ++i) {
     const NumberStringVariation &variation = kSingleDigitsVariations[i];
-    // TODO(peria): Bring |result| out if it improves the performance.
-    string result;
+    result.clear();
     for (StringPiece::size_type j = 0; j < input_num.size(); ++j) {
       result.append(
           variation.digits[static_cast<int>(input_num[j] - kAsciiZero)]);
@@ -613,15 +625,18 @@ bool NumberUtil::ArabicToOtherRadixes(
 
   // Binary
   if (n > 1) {
-    string binary;
+    // 64 digits with "0b" prefix.
+    char binary[64 + 2];
+    char *const binary_end = binary + arraysize(binary);
+    char *begin = binary_end;
     for (uint64 num = n; num; num >>= 1) {
-      binary.push_back(kAsciiZero + static_cast<char>(num & 0x1));
+      *--begin = kAsciiZero + static_cast<char>(num & 0x1);
     }
-    // "b0" will be "0b" in head of |binary|
-    binary.append("b0");
-    reverse(binary.begin(), binary.end());
+    *--begin = 'b';
+    *--begin = kAsciiZero;
     // "2進数"
-    output->push_back(NumberString(binary, "2\xE9\x80\xB2\xE6\x95\xB0",
+    output->push_back(NumberString(StringPiece(begin, binary_end - begin),
+                                   "2\xE9\x80\xB2\xE6\x95\xB0",
                                    NumberString::NUMBER_BIN));
   }
 
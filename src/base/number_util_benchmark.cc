@@ -0,0 +1,140 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Microbenchmark of the number conversions which NumberRewriter runs for
+// every numeric candidate.  Each operation converts one input into all the
+// forms in the same way as NumberRewriter does.  Kanji inputs are
+// normalized by NumberUtil::NormalizeNumbers beforehand.
+//
+// The results are printed as TSV lines, see BenchmarkRecorder.
+//
+// Usage:
+//   number_util_benchmark --iterations=100000
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/number_util.h"
+#include "base/port.h"
+
+DEFINE_int32(iterations, 100000, "number of iterations for each input set.");
+
+namespace mozc {
+namespace {
+
+const char *kShortNumbers[] = {
+  "0", "1", "7", "10", "12", "20", "100", "365", "1000", "2015",
+};
+
+const char *kLongNumbers[] = {
+  "12345678", "100000000", "1234567890", "9876543210987",
+  "18446744073709551615", "12345678901234567890",
+};
+
+const char *kDecimalNumbers[] = {
+  "0.5", "3.14159", "1234567.891", "100000.0001",
+};
+
+const char *kKanjiNumbers[] = {
+  // "2千五百", "二十", "百二十三", "一億二千三百四十五万六千七百八十九",
+  // "十万", "3億5千万"
+  "2\xE5\x8D\x83\xE4\xBA\x94\xE7\x99\xBE",
+  "\xE4\xBA\x8C\xE5\x8D\x81",
+  "\xE7\x99\xBE\xE4\xBA\x8C\xE5\x8D\x81\xE4\xB8\x89",
+  "\xE4\xB8\x80\xE5\x84\x84\xE4\xBA\x8C\xE5\x8D\x83\xE4\xB8\x89\xE7\x99\xBE"
+  "\xE5\x9B\x9B\xE5\x8D\x81\xE4\xBA\x94\xE4\xB8\x87\xE5\x85\xAD\xE5\x8D\x83"
+  "\xE4\xB8\x83\xE7\x99\xBE\xE5\x85\xAB\xE5\x8D\x81\xE4\xB9\x9D",
+  "\xE5\x8D\x81\xE4\xB8\x87",
+  "3\xE5\x84\x84""5\xE5\x8D\x83\xE4\xB8\x87",
+};
+
+void ConvertToAllForms(const string &arabic,
+                       vector<NumberUtil::NumberString> *output) {
+  NumberUtil::ArabicToWideArabic(arabic, output);
+  NumberUtil::ArabicToSeparatedArabic(arabic, output);
+  NumberUtil::ArabicToKanji(arabic, output);
+  NumberUtil::ArabicToOtherForms(arabic, output);
+  NumberUtil::ArabicToOtherRadixes(arabic, output);
+}
+
+void RunArabic(const string &name, const char **inputs, size_t size) {
+  const vector<string> arabics(inputs, inputs + size);
+  BenchmarkRecorder recorder("NumberUtil::ArabicTo*/" + name);
+  vector<NumberUtil::NumberString> output;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    const string &arabic = arabics[n % arabics.size()];
+    output.clear();
+    recorder.Start();
+    ConvertToAllForms(arabic, &output);
+    recorder.Stop();
+  }
+  recorder.Print(&cout);
+}
+
+void RunKanji(const string &name, const char **inputs, size_t size) {
+  const vector<string> kanjis(inputs, inputs + size);
+  BenchmarkRecorder recorder("NumberUtil::NormalizeNumbers+ArabicTo*/" + name);
+  vector<NumberUtil::NumberString> output;
+  string kanji_output, arabic_output;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    const string &kanji = kanjis[n % kanjis.size()];
+    output.clear();
+    recorder.Start();
+    if (NumberUtil::NormalizeNumbers(kanji, true, &kanji_output,
+                                     &arabic_output)) {
+      ConvertToAllForms(arabic_output, &output);
+    }
+    recorder.Stop();
+  }
+  recorder.Print(&cout);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  mozc::RunArabic("short", mozc::kShortNumbers,
+                  arraysize(mozc::kShortNumbers));
+  mozc::RunArabic("long", mozc::kLongNumbers, arraysize(mozc::kLongNumbers));
+  mozc::RunArabic("decimal", mozc::kDecimalNumbers,
+                  arraysize(mozc::kDecimalNumbers));
+  mozc::RunKanji("kanji", mozc::kKanjiNumbers,
+                 arraysize(mozc::kKanjiNumbers));
+  return 0;
+}
@@ -1224,6 +1224,14 @@ TEST(NumberUtilTest, ArabicToOtherRadixesTest) {
   EXPECT_FALSE(NumberUtil::ArabicToOtherRadixes(arabic, &output));
   ASSERT_EQ(output.size(), 0);
 
+  arabic = "18446744073709551615";  // UINT64_MAX
+  output.clear();
+  EXPECT_TRUE(NumberUtil::ArabicToOtherRadixes(arabic, &output));
+  ASSERT_EQ(output.size(), 3);
+  EXPECT_EQ("0xffffffffffffffff", output[0].value);
+  EXPECT_EQ("01777777777777777777777", output[1].value);
+  EXPECT_EQ("0b" + string(64, '1'), output[2].value);
+
   arabic = "18446744073709551616";  // UINT64_MAX + 1
   output.clear();
   EXPECT_FALSE(NumberUtil::ArabicToOtherRadixes(arabic, &output));
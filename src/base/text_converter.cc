@@ -29,6 +29,7 @@
 
 #include "base/text_converter.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include "base/string_piece.h"
@@ -81,6 +82,10 @@ void TextConverter::Convert(const DoubleArray *da,
   output->clear();
   const char *begin = input.data();
   const char *const end = input.data() + input.size();
+  // Base of the root node.  A character whose first byte has no transition
+  // from the root is never converted, so the following run of such
+  // characters (e.g. ASCII for most of the tables) is appended at once.
+  const int32 root = da[0].base;
   while (begin < end) {
     int result = 0;
     size_t mblen = Lookup(da, begin, static_cast<int>(end - begin), &result);
@@ -91,9 +96,15 @@ void TextConverter::Convert(const DoubleArray *da,
       mblen -= static_cast<int32>(p[len + 1]);
       begin += mblen;
     } else {
-      mblen = Util::OneCharLen(begin);
-      output->append(begin, mblen);
-      begin += mblen;
+      const char *run_end = begin + Util::OneCharLen(begin);
+      while (run_end < end &&
+             da[root + static_cast<uint8>(*run_end) + 1].check !=
+                 static_cast<uint32>(root)) {
+        run_end += Util::OneCharLen(run_end);
+      }
+      run_end = min(run_end, end);
+      output->append(begin, run_end - begin);
+      begin = run_end;
     }
   }
 }
@@ -0,0 +1,370 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "base/thread_pool.h"
+
+#ifdef OS_WIN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif  // OS_WIN
+
+#include <algorithm>
+#include <deque>
+
+#include "base/cpu_stats.h"
+#include "base/logging.h"
+#include "base/singleton.h"
+#include "base/thread.h"
+
+namespace mozc {
+namespace {
+
+// The tasks in the engine are small.  More threads only add contention.
+const size_t kMaxDefaultNumThreads = 8;
+
+#ifdef OS_WIN
+typedef DWORD ThreadId;
+
+ThreadId GetCurrentThreadId() {
+  return ::GetCurrentThreadId();
+}
+
+bool IsSameThread(ThreadId lhs, ThreadId rhs) {
+  return lhs == rhs;
+}
+#else  // OS_WIN
+typedef pthread_t ThreadId;
+
+ThreadId GetCurrentThreadId() {
+  return pthread_self();
+}
+
+bool IsSameThread(ThreadId lhs, ThreadId rhs) {
+  return pthread_equal(lhs, rhs) != 0;
+}
+#endif  // OS_WIN
+
+class SharedThreadPool : public ThreadPool {
+ public:
+  SharedThreadPool() : ThreadPool(ThreadPool::GetDefaultNumThreads()) {}
+};
+
+}  // namespace
+
+class ThreadPool::Worker : public Thread {
+ public:
+  Worker(ThreadPool *pool, size_t index)
+      : started(false), pool_(pool), index_(index) {}
+
+  virtual void Run() {
+    pool_->WorkerLoop(index_);
+  }
+
+  // Set by the worker thread before the constructor of ThreadPool returns.
+  ThreadId thread_id;
+  bool started;
+
+  // Guards |queue|.
+  Mutex mutex;
+  deque<QueuedTask> queue;
+
+  // Notified when the worker should wake up.
+  UnnamedEvent event;
+
+ private:
+  ThreadPool *pool_;
+  const size_t index_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : next_worker_(0), num_started_workers_(0), stopping_(false) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(new Worker(this, i));
+  }
+  size_t num_running_workers = 0;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Start();
+    if (workers_[i]->IsRunning()) {
+      ++num_running_workers;
+    } else {
+      // The other workers and waiting threads steal its tasks.
+      LOG(ERROR) << "Failed to start a worker thread";
+    }
+  }
+  // Waits for the workers to record their thread IDs.
+  while (true) {
+    {
+      scoped_lock l(&sleep_mutex_);
+      if (num_started_workers_ == num_running_workers) {
+        break;
+      }
+    }
+    started_event_.Wait(-1);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    scoped_lock l(&sleep_mutex_);
+    stopping_ = true;
+    for (size_t i = 0; i < sleepers_.size(); ++i) {
+      sleepers_[i]->Notify();
+    }
+    sleepers_.clear();
+  }
+  // Joins all the workers first since a running worker accesses the queues
+  // of the others.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Join();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    DCHECK(workers_[i]->queue.empty()) << "A task group is not waited";
+    delete workers_[i];
+  }
+}
+
+// static
+size_t ThreadPool::GetDefaultNumThreads() {
+  const CPUStats cpu_stats;
+  const size_t num_processors = cpu_stats.GetNumberOfProcessors();
+  if (num_processors <= 1) {
+    return 0;
+  }
+  return min(num_processors - 1, kMaxDefaultNumThreads);
+}
+
+// static
+ThreadPool *ThreadPool::GetSharedInstance() {
+  return Singleton<SharedThreadPool>::get();
+}
+
+void ThreadPool::Schedule(Task *task, TaskGroup *group) {
+  DCHECK(!workers_.empty());
+  QueuedTask queued;
+  queued.task = task;
+  queued.group = group;
+
+  size_t index = GetCurrentWorkerIndex();
+  if (index == kNoWorker) {
+    scoped_lock l(&sleep_mutex_);
+    index = next_worker_;
+    next_worker_ = (next_worker_ + 1) % workers_.size();
+  }
+  {
+    Worker *worker = workers_[index];
+    scoped_lock l(&worker->mutex);
+    worker->queue.push_back(queued);
+  }
+
+  // Notifies under the lock because the event of a waiting thread is
+  // destroyed once the thread leaves Sleep().
+  scoped_lock l(&sleep_mutex_);
+  if (!sleepers_.empty()) {
+    sleepers_.back()->Notify();
+    sleepers_.pop_back();
+  }
+}
+
+bool ThreadPool::RunQueuedTask(size_t worker_index) {
+  QueuedTask queued;
+  bool found = false;
+  if (worker_index != kNoWorker) {
+    // Takes the newest task of its own, which is likely to be hot in cache.
+    Worker *worker = workers_[worker_index];
+    scoped_lock l(&worker->mutex);
+    if (!worker->queue.empty()) {
+      queued = worker->queue.back();
+      worker->queue.pop_back();
+      found = true;
+    }
+  }
+  for (size_t i = 1; !found && i <= workers_.size(); ++i) {
+    // Steals the oldest task, starting from the next worker so that thieves
+    // don't contend on the same queue.
+    const size_t victim_index = worker_index == kNoWorker ?
+        i - 1 : (worker_index + i) % workers_.size();
+    if (victim_index == worker_index) {
+      continue;
+    }
+    Worker *victim = workers_[victim_index];
+    scoped_lock l(&victim->mutex);
+    if (!victim->queue.empty()) {
+      queued = victim->queue.front();
+      victim->queue.pop_front();
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  queued.group->RunTask(queued.task);
+  return true;
+}
+
+size_t ThreadPool::GetCurrentWorkerIndex() const {
+  const ThreadId current = GetCurrentThreadId();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->started &&
+        IsSameThread(workers_[i]->thread_id, current)) {
+      return i;
+    }
+  }
+  return kNoWorker;
+}
+
+bool ThreadPool::HasQueuedTask() {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    scoped_lock l(&workers_[i]->mutex);
+    if (!workers_[i]->queue.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::Sleep(UnnamedEvent *event, const TaskGroup *group) {
+  {
+    scoped_lock l(&sleep_mutex_);
+    if (stopping_) {
+      return false;
+    }
+    sleepers_.push_back(event);
+  }
+
+  // Checks again after the registration so that a task scheduled in between
+  // isn't missed.  Notify() before Wait() makes Wait() return immediately.
+  if (!HasQueuedTask() && (group == NULL || !group->IsDone())) {
+    event->Wait(-1);
+  }
+
+  scoped_lock l(&sleep_mutex_);
+  vector<UnnamedEvent *>::iterator it =
+      find(sleepers_.begin(), sleepers_.end(), event);
+  if (it != sleepers_.end()) {
+    sleepers_.erase(it);
+  } else if (group != NULL && group->IsDone() && !sleepers_.empty()) {
+    // This thread was woken up for a new task but is leaving to return from
+    // TaskGroup::Wait().  Passes the wakeup to another thread.
+    sleepers_.back()->Notify();
+    sleepers_.pop_back();
+  }
+  return true;
+}
+
+void ThreadPool::WorkerLoop(size_t worker_index) {
+  Worker *worker = workers_[worker_index];
+  worker->thread_id = GetCurrentThreadId();
+  worker->started = true;
+  {
+    scoped_lock l(&sleep_mutex_);
+    ++num_started_workers_;
+    started_event_.Notify();
+  }
+
+  while (true) {
+    if (RunQueuedTask(worker_index)) {
+      continue;
+    }
+    if (!Sleep(&worker->event, NULL)) {
+      break;
+    }
+  }
+}
+
+TaskGroup::TaskGroup(ThreadPool *pool)
+    : pool_(pool), num_pending_tasks_(0), waiter_event_(NULL) {
+  DCHECK(pool_);
+}
+
+TaskGroup::~TaskGroup() {
+  Wait();
+}
+
+void TaskGroup::Run(ThreadPool::Task *task) {
+  DCHECK(task);
+  {
+    scoped_lock l(&mutex_);
+    ++num_pending_tasks_;
+  }
+  if (pool_->workers_.empty()) {
+    RunTask(task);
+    return;
+  }
+  pool_->Schedule(task, this);
+}
+
+void TaskGroup::Wait() {
+  const size_t worker_index = pool_->GetCurrentWorkerIndex();
+  UnnamedEvent *event = (worker_index == ThreadPool::kNoWorker) ?
+      &event_ : &pool_->workers_[worker_index]->event;
+  {
+    scoped_lock l(&mutex_);
+    if (num_pending_tasks_ == 0) {
+      return;
+    }
+    DCHECK(waiter_event_ == NULL) << "Wait() is called concurrently";
+    waiter_event_ = event;
+  }
+
+  while (!IsDone()) {
+    if (pool_->RunQueuedTask(worker_index)) {
+      continue;
+    }
+    if (!pool_->Sleep(event, this)) {
+      LOG(DFATAL) << "The thread pool is destroyed before the task group";
+      break;
+    }
+  }
+
+  scoped_lock l(&mutex_);
+  waiter_event_ = NULL;
+}
+
+void TaskGroup::RunTask(ThreadPool::Task *task) {
+  if (!IsCancelled()) {
+    task->Run();
+  }
+  // Notifies under the lock because this group may be destroyed once Wait()
+  // sees no pending task.
+  scoped_lock l(&mutex_);
+  DCHECK_GT(num_pending_tasks_, 0);
+  if (--num_pending_tasks_ == 0 && waiter_event_ != NULL) {
+    waiter_event_->Notify();
+  }
+}
+
+bool TaskGroup::IsDone() const {
+  scoped_lock l(&mutex_);
+  return num_pending_tasks_ == 0;
+}
+
+}  // namespace mozc
@@ -0,0 +1,202 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// ThreadPool is a fixed set of worker threads executing short CPU bound
+// tasks, e.g., independent parts of a prediction or a dictionary build.
+// Each worker has its own task queue.  A worker takes tasks from the back of
+// its own queue and, when it runs out of tasks, steals tasks from the front of
+// the other workers' queues, so that tasks spawned by a task are likely to run
+// on the same thread while idle threads still share the load.
+//
+// Tasks are scheduled through a TaskGroup, which tracks the completion of its
+// tasks.  TaskGroup::Wait() doesn't just block: the waiting thread executes
+// queued tasks until all the tasks of the group finish.  Therefore a task may
+// create a nested TaskGroup and wait for it without deadlocks.
+//
+// Usage:
+//   class SumTask : public ThreadPool::Task {
+//    public:
+//     virtual void Run() { ... }
+//   };
+//
+//   vector<SumTask> tasks(n);
+//   TaskGroup group(ThreadPool::GetSharedInstance());
+//   for (size_t i = 0; i < tasks.size(); ++i) {
+//     group.Run(&tasks[i]);
+//   }
+//   group.Wait();
+
+#ifndef MOZC_BASE_THREAD_POOL_H_
+#define MOZC_BASE_THREAD_POOL_H_
+
+#include <vector>
+
+#include "base/cancellation_flag.h"
+#include "base/mutex.h"
+#include "base/port.h"
+#include "base/unnamed_event.h"
+
+namespace mozc {
+
+class TaskGroup;
+
+class ThreadPool {
+ public:
+  // A unit of work.  Tasks must not throw and should not block for long,
+  // e.g., on network or IPC.  Reading a local file once, like a history file
+  // loaded at the engine initialization, is fine.
+  class Task {
+   public:
+    virtual ~Task() {}
+    virtual void Run() = 0;
+  };
+
+  // Starts |num_threads| worker threads.  If |num_threads| is 0, tasks are
+  // executed synchronously by TaskGroup::Run().
+  explicit ThreadPool(size_t num_threads);
+
+  // All the task groups using this pool must have been waited.
+  ~ThreadPool();
+
+  size_t num_threads() const {
+    return workers_.size();
+  }
+
+  // Returns the number of worker threads suitable for this machine, i.e., the
+  // number of processors minus one because the thread calling
+  // TaskGroup::Wait() executes tasks too.
+  static size_t GetDefaultNumThreads();
+
+  // Returns the pool shared in the process, which has GetDefaultNumThreads()
+  // workers.
+  static ThreadPool *GetSharedInstance();
+
+ private:
+  friend class TaskGroup;
+  class Worker;
+
+  struct QueuedTask {
+    Task *task;
+    TaskGroup *group;
+  };
+
+  // Pushes |task| to the queue of the calling worker, or to the queue of a
+  // worker if the caller is not a worker of this pool, and wakes up a
+  // sleeping thread.
+  void Schedule(Task *task, TaskGroup *group);
+
+  // Pops a queued task and runs it.  |worker_index| is the index of the
+  // calling worker, or kNoWorker.  Returns false if no task is queued.
+  bool RunQueuedTask(size_t worker_index);
+
+  // Returns the index of the calling thread in |workers_|, or kNoWorker.
+  size_t GetCurrentWorkerIndex() const;
+
+  // Blocks the calling thread until a task is scheduled or |group| finishes.
+  // |event| is the event owned by the calling thread.  Returns false if the
+  // pool is shutting down.
+  bool Sleep(UnnamedEvent *event, const TaskGroup *group);
+
+  bool HasQueuedTask();
+
+  // The main loop of the worker |worker_index|.
+  void WorkerLoop(size_t worker_index);
+
+  static const size_t kNoWorker = static_cast<size_t>(-1);
+
+  vector<Worker *> workers_;
+
+  // Guards the fields below.
+  Mutex sleep_mutex_;
+  // Events of the sleeping threads.
+  vector<UnnamedEvent *> sleepers_;
+  size_t next_worker_;
+  size_t num_started_workers_;
+  bool stopping_;
+  UnnamedEvent started_event_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+// A set of tasks whose completion can be waited.  Only one thread can call
+// Wait() at the same time.  Methods except for Wait() are thread-safe, so
+// a running task can schedule more tasks to its group.
+class TaskGroup {
+ public:
+  // |pool| is not owned and must outlive this group.
+  explicit TaskGroup(ThreadPool *pool);
+
+  // Waits for the remaining tasks.
+  ~TaskGroup();
+
+  // Schedules |task|, which is not owned and must be alive until Wait()
+  // returns.  Tasks scheduled after Cancel() are not executed.
+  void Run(ThreadPool::Task *task);
+
+  // Blocks until all the scheduled tasks finish, executing queued tasks in
+  // the meantime.
+  void Wait();
+
+  // Skips the tasks which haven't started yet.  Running tasks can poll
+  // IsCancelled() to stop early.  Wait() is still needed to synchronize with
+  // the running tasks.
+  void Cancel() {
+    cancellation_flag_.Cancel();
+  }
+
+  bool IsCancelled() const {
+    return cancellation_flag_.IsCancelled();
+  }
+
+ private:
+  friend class ThreadPool;
+
+  // Runs |task| unless this group is cancelled, and marks it finished.
+  void RunTask(ThreadPool::Task *task);
+
+  bool IsDone() const;
+
+  ThreadPool *pool_;
+  CancellationFlag cancellation_flag_;
+
+  // Guards the fields below.
+  mutable Mutex mutex_;
+  size_t num_pending_tasks_;
+  // The event of the thread in Wait(), which is notified when the last task
+  // finishes.
+  UnnamedEvent *waiter_event_;
+  // Used as |waiter_event_| when Wait() is called from a non-worker thread.
+  UnnamedEvent event_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskGroup);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_BASE_THREAD_POOL_H_
@@ -0,0 +1,203 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Small benchmark code to measure the overhead and the scalability of
+// ThreadPool.
+//  - Scheduling overhead: many empty tasks in one group.
+//  - Flat parallelism: a CPU bound loop split into independent tasks.
+//  - Nested parallelism: the same loop split recursively with nested groups.
+//
+// Usage:
+//   thread_pool_benchmark --num_threads=3 --iterations=10
+
+#include <iostream>  // NOLINT
+#include <vector>
+
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/stopwatch.h"
+#include "base/thread_pool.h"
+#include "base/util.h"
+
+DEFINE_int32(num_threads, -1,
+             "The number of worker threads.  If negative, "
+             "ThreadPool::GetDefaultNumThreads() is used.");
+DEFINE_int32(iterations, 10, "The number of iterations of each benchmark.");
+DEFINE_int32(num_tasks, 10000, "The number of empty tasks.");
+DEFINE_int32(work_size, 1 << 24, "The number of loop iterations to split.");
+
+namespace mozc {
+namespace {
+
+class EmptyTask : public ThreadPool::Task {
+ public:
+  virtual void Run() {}
+};
+
+// Computes a hash-like value over [begin, end) so that the loop isn't
+// optimized out.
+uint64 Work(uint64 begin, uint64 end) {
+  uint64 value = 0;
+  for (uint64 i = begin; i < end; ++i) {
+    value = (value ^ i) * GG_ULONGLONG(0x100000001b3);
+  }
+  return value;
+}
+
+class WorkTask : public ThreadPool::Task {
+ public:
+  WorkTask() : pool_(NULL), begin_(0), end_(0), grain_(0), result_(0) {}
+
+  void Init(ThreadPool *pool, uint64 begin, uint64 end, uint64 grain) {
+    pool_ = pool;
+    begin_ = begin;
+    end_ = end;
+    grain_ = grain;
+  }
+
+  // Splits the range recursively if |pool_| is set.
+  virtual void Run() {
+    if (pool_ == NULL || end_ - begin_ <= grain_) {
+      result_ = Work(begin_, end_);
+      return;
+    }
+    const uint64 middle = begin_ + (end_ - begin_) / 2;
+    WorkTask left, right;
+    left.Init(pool_, begin_, middle, grain_);
+    right.Init(pool_, middle, end_, grain_);
+    TaskGroup group(pool_);
+    group.Run(&left);
+    group.Run(&right);
+    group.Wait();
+    result_ = left.result() ^ right.result();
+  }
+
+  uint64 result() const {
+    return result_;
+  }
+
+ private:
+  ThreadPool *pool_;
+  uint64 begin_;
+  uint64 end_;
+  uint64 grain_;
+  uint64 result_;
+};
+
+void Report(const char *name, int64 elapsed_usec) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f msec/iteration",
+                             elapsed_usec / 1000.0 / FLAGS_iterations)
+       << endl;
+}
+
+void BenchmarkEmptyTasks(ThreadPool *pool) {
+  vector<EmptyTask> tasks(FLAGS_num_tasks);
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    TaskGroup group(pool);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      group.Run(&tasks[i]);
+    }
+    group.Wait();
+  }
+  stopwatch.Stop();
+  cout << "Empty tasks: "
+       << Util::StringPrintf(
+              "%.3f usec/task",
+              static_cast<double>(stopwatch.GetElapsedMicroseconds()) /
+              (FLAGS_iterations * tasks.size()))
+       << endl;
+}
+
+void BenchmarkWork(ThreadPool *pool) {
+  const uint64 size = FLAGS_work_size;
+  uint64 result = 0;
+  {
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      result ^= Work(0, size);
+    }
+    stopwatch.Stop();
+    Report("Serial", stopwatch.GetElapsedMicroseconds());
+  }
+  {
+    // One task per thread including the waiting thread, each split into
+    // four so that idle threads can steal.
+    const size_t num_tasks = 4 * (pool->num_threads() + 1);
+    vector<WorkTask> tasks(num_tasks);
+    for (size_t i = 0; i < num_tasks; ++i) {
+      tasks[i].Init(NULL, size * i / num_tasks, size * (i + 1) / num_tasks, 0);
+    }
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      TaskGroup group(pool);
+      for (size_t i = 0; i < tasks.size(); ++i) {
+        group.Run(&tasks[i]);
+      }
+      group.Wait();
+    }
+    stopwatch.Stop();
+    Report("Flat groups", stopwatch.GetElapsedMicroseconds());
+  }
+  {
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      WorkTask task;
+      task.Init(pool, 0, size, size / 64);
+      TaskGroup group(pool);
+      group.Run(&task);
+      group.Wait();
+    }
+    stopwatch.Stop();
+    Report("Nested groups", stopwatch.GetElapsedMicroseconds());
+  }
+  VLOG(1) << "result: " << result;
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+  CHECK_GT(FLAGS_num_tasks, 0);
+  CHECK_GT(FLAGS_work_size, 0);
+  const size_t num_threads = FLAGS_num_threads < 0 ?
+      mozc::ThreadPool::GetDefaultNumThreads() :
+      static_cast<size_t>(FLAGS_num_threads);
+  cout << "Worker threads: " << num_threads << endl;
+
+  mozc::ThreadPool pool(num_threads);
+  mozc::BenchmarkEmptyTasks(&pool);
+  mozc::BenchmarkWork(&pool);
+  return 0;
+}
@@ -0,0 +1,299 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "base/thread_pool.h"
+
+#include <vector>
+
+#include "base/cpu_stats.h"
+#include "base/mutex.h"
+#include "base/port.h"
+#include "base/thread.h"
+#include "base/unnamed_event.h"
+#include "base/util.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+class CountTask : public ThreadPool::Task {
+ public:
+  CountTask() : count_(0) {}
+  virtual void Run() {
+    ++count_;
+  }
+  int count() const {
+    return count_;
+  }
+
+ private:
+  int count_;
+};
+
+// Computes the sum of [begin, end) by splitting the range recursively into
+// nested task groups.
+class RangeSumTask : public ThreadPool::Task {
+ public:
+  RangeSumTask() : pool_(NULL), begin_(0), end_(0), sum_(0) {}
+
+  void Init(ThreadPool *pool, uint64 begin, uint64 end) {
+    pool_ = pool;
+    begin_ = begin;
+    end_ = end;
+  }
+
+  virtual void Run() {
+    if (end_ - begin_ <= 16) {
+      for (uint64 i = begin_; i < end_; ++i) {
+        sum_ += i;
+      }
+      return;
+    }
+    const uint64 middle = begin_ + (end_ - begin_) / 2;
+    RangeSumTask left, right;
+    left.Init(pool_, begin_, middle);
+    right.Init(pool_, middle, end_);
+    TaskGroup group(pool_);
+    group.Run(&left);
+    group.Run(&right);
+    group.Wait();
+    sum_ = left.sum() + right.sum();
+  }
+
+  uint64 sum() const {
+    return sum_;
+  }
+
+ private:
+  ThreadPool *pool_;
+  uint64 begin_;
+  uint64 end_;
+  uint64 sum_;
+};
+
+// Blocks until released.
+class BlockingTask : public ThreadPool::Task {
+ public:
+  BlockingTask() : run_(false) {}
+
+  virtual void Run() {
+    {
+      scoped_lock l(&mutex_);
+      run_ = true;
+    }
+    started_.Notify();
+    released_.Wait(-1);
+  }
+
+  void WaitUntilStarted() {
+    started_.Wait(-1);
+  }
+
+  void Release() {
+    released_.Notify();
+  }
+
+  bool run() const {
+    scoped_lock l(&mutex_);
+    return run_;
+  }
+
+ private:
+  UnnamedEvent started_;
+  UnnamedEvent released_;
+  mutable Mutex mutex_;
+  bool run_;
+};
+
+// Runs until the group is cancelled.
+class PollingTask : public ThreadPool::Task {
+ public:
+  explicit PollingTask(const TaskGroup *group) : group_(group) {}
+
+  virtual void Run() {
+    started_.Notify();
+    while (!group_->IsCancelled()) {
+      Util::Sleep(1);
+    }
+  }
+
+  void WaitUntilStarted() {
+    started_.Wait(-1);
+  }
+
+ private:
+  const TaskGroup *group_;
+  UnnamedEvent started_;
+};
+
+class SumThread : public Thread {
+ public:
+  SumThread(ThreadPool *pool, uint64 end) : pool_(pool), end_(end), sum_(0) {
+    task_.Init(pool, 0, end);
+  }
+
+  virtual void Run() {
+    TaskGroup group(pool_);
+    group.Run(&task_);
+    group.Wait();
+    sum_ = task_.sum();
+  }
+
+  uint64 expected_sum() const {
+    return end_ * (end_ - 1) / 2;
+  }
+
+  uint64 sum() const {
+    return sum_;
+  }
+
+ private:
+  ThreadPool *pool_;
+  RangeSumTask task_;
+  const uint64 end_;
+  uint64 sum_;
+};
+
+TEST(ThreadPoolTest, RunAllTasks) {
+  const size_t kNumThreads[] = {0, 1, 4};
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i) {
+    ThreadPool pool(kNumThreads[i]);
+    EXPECT_EQ(kNumThreads[i], pool.num_threads());
+
+    vector<CountTask> tasks(1000);
+    TaskGroup group(&pool);
+    for (size_t j = 0; j < tasks.size(); ++j) {
+      group.Run(&tasks[j]);
+    }
+    group.Wait();
+    for (size_t j = 0; j < tasks.size(); ++j) {
+      EXPECT_EQ(1, tasks[j].count()) << j;
+    }
+
+    // The group can be reused after Wait().
+    group.Run(&tasks[0]);
+    group.Wait();
+    EXPECT_EQ(2, tasks[0].count());
+  }
+}
+
+TEST(ThreadPoolTest, WaitWithoutTasks) {
+  ThreadPool pool(2);
+  TaskGroup group(&pool);
+  group.Wait();
+  group.Wait();
+}
+
+TEST(ThreadPoolTest, NestedGroups) {
+  const size_t kNumThreads[] = {0, 1, 2, 4};
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i) {
+    ThreadPool pool(kNumThreads[i]);
+    RangeSumTask task;
+    const uint64 kEnd = 100000;
+    task.Init(&pool, 0, kEnd);
+    TaskGroup group(&pool);
+    group.Run(&task);
+    group.Wait();
+    EXPECT_EQ(kEnd * (kEnd - 1) / 2, task.sum());
+  }
+}
+
+TEST(ThreadPoolTest, ConcurrentGroups) {
+  ThreadPool pool(3);
+  vector<SumThread *> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(new SumThread(&pool, 10000 * (i + 1)));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Start();
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+    EXPECT_EQ(threads[i]->expected_sum(), threads[i]->sum());
+    delete threads[i];
+  }
+}
+
+TEST(ThreadPoolTest, CancelQueuedTasks) {
+  ThreadPool pool(1);
+  TaskGroup group(&pool);
+  BlockingTask blocking_task;
+  group.Run(&blocking_task);
+  // Now the worker is blocked and the tasks below stay in the queue.
+  blocking_task.WaitUntilStarted();
+  vector<CountTask> tasks(100);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    group.Run(&tasks[i]);
+  }
+  EXPECT_FALSE(group.IsCancelled());
+  group.Cancel();
+  EXPECT_TRUE(group.IsCancelled());
+  blocking_task.Release();
+  group.Wait();
+
+  EXPECT_TRUE(blocking_task.run());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    EXPECT_EQ(0, tasks[i].count()) << i;
+  }
+
+  // Tasks scheduled after Cancel() are skipped too.
+  group.Run(&tasks[0]);
+  group.Wait();
+  EXPECT_EQ(0, tasks[0].count());
+}
+
+TEST(ThreadPoolTest, CancelRunningTask) {
+  ThreadPool pool(2);
+  TaskGroup group(&pool);
+  PollingTask task(&group);
+  group.Run(&task);
+  task.WaitUntilStarted();
+  group.Cancel();
+  group.Wait();
+}
+
+TEST(ThreadPoolTest, SharedInstance) {
+  ThreadPool *pool = ThreadPool::GetSharedInstance();
+  ASSERT_NE(static_cast<ThreadPool *>(NULL), pool);
+  EXPECT_EQ(pool, ThreadPool::GetSharedInstance());
+  EXPECT_EQ(ThreadPool::GetDefaultNumThreads(), pool->num_threads());
+
+  const CPUStats cpu_stats;
+  EXPECT_LT(pool->num_threads(), cpu_stats.GetNumberOfProcessors());
+
+  RangeSumTask task;
+  task.Init(pool, 0, 1000);
+  TaskGroup group(pool);
+  group.Run(&task);
+  group.Wait();
+  EXPECT_EQ(static_cast<uint64>(1000 * 999 / 2), task.sum());
+}
+
+}  // namespace
+}  // namespace mozc
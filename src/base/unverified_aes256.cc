@@ -32,6 +32,11 @@
 #include <algorithm>
 #include <cstring>
 
+#ifdef MOZC_X86_SIMD_AVAILABLE
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
 #include "base/logging.h"
 
 namespace mozc {
@@ -164,6 +169,32 @@ void UnverifiedAES256::TransformCBC(const uint8 (&key)[kKeyBytes],
                                     const uint8 (&iv)[kBlockBytes],
                                     uint8 *block,
                                     size_t block_count) {
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (CPUFeatures::HasAESNI()) {
+    TransformCBCWithAESNI(key, iv, block, block_count);
+    return;
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+  TransformCBCPortable(key, iv, block, block_count);
+}
+
+void UnverifiedAES256::InverseTransformCBC(const uint8 (&key)[kKeyBytes],
+                                           const uint8 (&iv)[kBlockBytes],
+                                           uint8 *block,
+                                           size_t block_count) {
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (CPUFeatures::HasAESNI()) {
+    InverseTransformCBCWithAESNI(key, iv, block, block_count);
+    return;
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+  InverseTransformCBCPortable(key, iv, block, block_count);
+}
+
+void UnverifiedAES256::TransformCBCPortable(const uint8 (&key)[kKeyBytes],
+                                            const uint8 (&iv)[kBlockBytes],
+                                            uint8 *block,
+                                            size_t block_count) {
   uint8 w[kKeyScheduleBytes];
   MakeKeySchedule(key, w);
 
@@ -179,10 +210,11 @@ void UnverifiedAES256::TransformCBC(const uint8 (&key)[kKeyBytes],
   }
 }
 
-void UnverifiedAES256::InverseTransformCBC(const uint8 (&key)[kKeyBytes],
-                                           const uint8 (&iv)[kBlockBytes],
-                                           uint8 *block,
-                                           size_t block_count) {
+void UnverifiedAES256::InverseTransformCBCPortable(
+    const uint8 (&key)[kKeyBytes],
+    const uint8 (&iv)[kBlockBytes],
+    uint8 *block,
+    size_t block_count) {
   uint8 w[kKeyScheduleBytes];
   MakeKeySchedule(key, w);
 
@@ -200,6 +232,101 @@ void UnverifiedAES256::InverseTransformCBC(const uint8 (&key)[kKeyBytes],
   }
 }
 
+#ifdef MOZC_X86_SIMD_AVAILABLE
+// The round keys made by MakeKeySchedule() have the same byte order as the
+// ones AES-NI expects, so the key schedule is shared with the portable
+// implementation.
+MOZC_TARGET_FEATURES("aes,sse2")
+void UnverifiedAES256::TransformCBCWithAESNI(const uint8 (&key)[kKeyBytes],
+                                             const uint8 (&iv)[kBlockBytes],
+                                             uint8 *block,
+                                             size_t block_count) {
+  uint8 w[kKeyScheduleBytes];
+  MakeKeySchedule(key, w);
+  __m128i round_keys[kNr + 1];
+  for (size_t i = 0; i <= kNr; ++i) {
+    round_keys[i] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(&w[kBlockBytes * i]));
+  }
+
+  // Each block depends on the previous one, so the blocks are encrypted one
+  // by one.
+  __m128i vec = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+  for (size_t i = 0; i < block_count; ++i) {
+    __m128i *src = reinterpret_cast<__m128i *>(block + (i * kBlockBytes));
+    vec = _mm_xor_si128(_mm_loadu_si128(src), vec);
+    vec = _mm_xor_si128(vec, round_keys[0]);
+    for (size_t round = 1; round < kNr; ++round) {
+      vec = _mm_aesenc_si128(vec, round_keys[round]);
+    }
+    vec = _mm_aesenclast_si128(vec, round_keys[kNr]);
+    _mm_storeu_si128(src, vec);
+  }
+}
+
+MOZC_TARGET_FEATURES("aes,sse2")
+void UnverifiedAES256::InverseTransformCBCWithAESNI(
+    const uint8 (&key)[kKeyBytes],
+    const uint8 (&iv)[kBlockBytes],
+    uint8 *block,
+    size_t block_count) {
+  uint8 w[kKeyScheduleBytes];
+  MakeKeySchedule(key, w);
+  // AESDEC takes the round keys in the reverse order with InvMixColumns
+  // applied except for the first and the last ones.
+  __m128i round_keys[kNr + 1];
+  for (size_t i = 0; i <= kNr; ++i) {
+    const __m128i round_key = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(&w[kBlockBytes * (kNr - i)]));
+    round_keys[i] = (i == 0 || i == kNr) ?
+        round_key : _mm_aesimc_si128(round_key);
+  }
+
+  // Unlike encryption, the blocks can be decrypted independently. Decrypting
+  // several blocks at once hides the latency of AESDEC.
+  const size_t kParallelBlocks = 4;
+  __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(iv));
+  size_t i = 0;
+  for (; i + kParallelBlocks <= block_count; i += kParallelBlocks) {
+    __m128i *src = reinterpret_cast<__m128i *>(block + (i * kBlockBytes));
+    const __m128i c0 = _mm_loadu_si128(src + 0);
+    const __m128i c1 = _mm_loadu_si128(src + 1);
+    const __m128i c2 = _mm_loadu_si128(src + 2);
+    const __m128i c3 = _mm_loadu_si128(src + 3);
+    __m128i b0 = _mm_xor_si128(c0, round_keys[0]);
+    __m128i b1 = _mm_xor_si128(c1, round_keys[0]);
+    __m128i b2 = _mm_xor_si128(c2, round_keys[0]);
+    __m128i b3 = _mm_xor_si128(c3, round_keys[0]);
+    for (size_t round = 1; round < kNr; ++round) {
+      b0 = _mm_aesdec_si128(b0, round_keys[round]);
+      b1 = _mm_aesdec_si128(b1, round_keys[round]);
+      b2 = _mm_aesdec_si128(b2, round_keys[round]);
+      b3 = _mm_aesdec_si128(b3, round_keys[round]);
+    }
+    b0 = _mm_aesdeclast_si128(b0, round_keys[kNr]);
+    b1 = _mm_aesdeclast_si128(b1, round_keys[kNr]);
+    b2 = _mm_aesdeclast_si128(b2, round_keys[kNr]);
+    b3 = _mm_aesdeclast_si128(b3, round_keys[kNr]);
+    _mm_storeu_si128(src + 0, _mm_xor_si128(b0, prev));
+    _mm_storeu_si128(src + 1, _mm_xor_si128(b1, c0));
+    _mm_storeu_si128(src + 2, _mm_xor_si128(b2, c1));
+    _mm_storeu_si128(src + 3, _mm_xor_si128(b3, c2));
+    prev = c3;
+  }
+  for (; i < block_count; ++i) {
+    __m128i *src = reinterpret_cast<__m128i *>(block + (i * kBlockBytes));
+    const __m128i c = _mm_loadu_si128(src);
+    __m128i b = _mm_xor_si128(c, round_keys[0]);
+    for (size_t round = 1; round < kNr; ++round) {
+      b = _mm_aesdec_si128(b, round_keys[round]);
+    }
+    b = _mm_aesdeclast_si128(b, round_keys[kNr]);
+    _mm_storeu_si128(src, _mm_xor_si128(b, prev));
+    prev = c;
+  }
+}
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
 void UnverifiedAES256::MakeKeySchedule(const uint8 (&key)[kKeyBytes],
                                        uint8 w[kKeyScheduleBytes]) {
   memcpy(w, key, kKeyBytes);
@@ -30,6 +30,7 @@
 #ifndef MOZC_BASE_UNVERIFIED_AES256_H_
 #define MOZC_BASE_UNVERIFIED_AES256_H_
 
+#include "base/cpu_features.h"
 #include "base/port.h"
 
 namespace mozc {
@@ -38,7 +39,8 @@ namespace internal {
 // Note that this implemenation is kept just for the backward compatibility
 // so that we can read previously obfuscated data.
 // !!! Not FIPS-certified.
-// !!! Performance optimization is not well considered.
+// !!! Performance optimization is not well considered except that AES-NI is
+//     used when the CPU supports it.
 // !!! Side-channel attack is not well considered.
 // TODO(team): Consider to remove this class and stop doing obfuscation.
 class UnverifiedAES256 {
@@ -62,6 +64,29 @@ class UnverifiedAES256 {
                                   size_t block_count);
 
  protected:
+  // Portable implementations of TransformCBC() and InverseTransformCBC().
+  static void TransformCBCPortable(const uint8 (&key)[kKeyBytes],
+                                   const uint8 (&iv)[kBlockBytes],
+                                   uint8 *buffer,
+                                   size_t block_count);
+  static void InverseTransformCBCPortable(const uint8 (&key)[kKeyBytes],
+                                          const uint8 (&iv)[kBlockBytes],
+                                          uint8 *buffer,
+                                          size_t block_count);
+
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  // Implementations with AES-NI, which produce the same results as the
+  // portable ones. Call them only when CPUFeatures::HasAESNI() is true.
+  static void TransformCBCWithAESNI(const uint8 (&key)[kKeyBytes],
+                                    const uint8 (&iv)[kBlockBytes],
+                                    uint8 *buffer,
+                                    size_t block_count);
+  static void InverseTransformCBCWithAESNI(const uint8 (&key)[kKeyBytes],
+                                           const uint8 (&iv)[kBlockBytes],
+                                           uint8 *buffer,
+                                           size_t block_count);
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
   // Does AES256 ECB transformation.
   // CAVEATS: See the above comment.
   static void TransformECB(const uint8 (&w)[kKeyScheduleBytes],
@@ -28,6 +28,10 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "base/unverified_aes256.h"
+
+#include <vector>
+
+#include "base/cpu_features.h"
 #include "testing/base/public/googletest.h"
 #include "testing/base/public/gunit.h"
 
@@ -51,6 +55,12 @@ class TestableUnverifiedAES256 : public UnverifiedAES256 {
   using UnverifiedAES256::InvShiftRows;
   using UnverifiedAES256::TransformECB;
   using UnverifiedAES256::InverseTransformECB;
+  using UnverifiedAES256::TransformCBCPortable;
+  using UnverifiedAES256::InverseTransformCBCPortable;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  using UnverifiedAES256::TransformCBCWithAESNI;
+  using UnverifiedAES256::InverseTransformCBCWithAESNI;
+#endif  // MOZC_X86_SIMD_AVAILABLE
 
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(TestableUnverifiedAES256);
@@ -452,6 +462,59 @@ TEST(UnverifiedAES256Test, InverseTransformCBC_NonZero) {
   EXPECT_EQ_ARRAY(kExpected, block);
 }
 
+// The implementation chosen at runtime must produce the same results as the
+// portable one. The number of blocks covers both the parallel decryption and
+// the rest.
+TEST(UnverifiedAES256Test, TransformCBC_SameAsPortable) {
+  uint8 key[UnverifiedAES256::kKeyBytes];
+  for (size_t i = 0; i < arraysize(key); ++i) {
+    key[i] = static_cast<uint8>(i * 37 + 11);
+  }
+  uint8 iv[UnverifiedAES256::kBlockBytes];
+  for (size_t i = 0; i < arraysize(iv); ++i) {
+    iv[i] = static_cast<uint8>(i * 53 + 3);
+  }
+
+  for (size_t num_blocks = 0; num_blocks <= 19; ++num_blocks) {
+    vector<uint8> original(UnverifiedAES256::kBlockBytes * num_blocks);
+    for (size_t i = 0; i < original.size(); ++i) {
+      original[i] = static_cast<uint8>(i * 101 + num_blocks);
+    }
+
+    vector<uint8> expected = original;
+    vector<uint8> actual = original;
+    TestableUnverifiedAES256::TransformCBCPortable(
+        key, iv, expected.data(), num_blocks);
+    TestableUnverifiedAES256::TransformCBC(key, iv, actual.data(), num_blocks);
+    EXPECT_EQ(expected, actual) << num_blocks;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+    if (CPUFeatures::HasAESNI()) {
+      actual = original;
+      TestableUnverifiedAES256::TransformCBCWithAESNI(
+          key, iv, actual.data(), num_blocks);
+      EXPECT_EQ(expected, actual) << num_blocks;
+    }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+    const vector<uint8> encrypted = expected;
+    TestableUnverifiedAES256::InverseTransformCBCPortable(
+        key, iv, expected.data(), num_blocks);
+    EXPECT_EQ(original, expected) << num_blocks;
+    actual = encrypted;
+    TestableUnverifiedAES256::InverseTransformCBC(
+        key, iv, actual.data(), num_blocks);
+    EXPECT_EQ(original, actual) << num_blocks;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+    if (CPUFeatures::HasAESNI()) {
+      actual = encrypted;
+      TestableUnverifiedAES256::InverseTransformCBCWithAESNI(
+          key, iv, actual.data(), num_blocks);
+      EXPECT_EQ(original, actual) << num_blocks;
+    }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+  }
+}
+
 // TODO(yukawa): Add more tests based on well-known test vectors.
 
 }  // namespace
@@ -32,6 +32,10 @@
 #include <algorithm>
 #include <climits>  // for CHAR_BIT
 
+#ifdef MOZC_X86_SIMD_AVAILABLE
+#include <immintrin.h>
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
 #include "base/logging.h"
 
 namespace mozc {
@@ -197,6 +201,112 @@ class PaddedMessageIterator {
   size_t message_index_;
 };
 
+typedef StringPiece::value_type MessageBlock[
+    PaddedMessageIterator::kMessageBlockBytes];
+
+// 6.1.2 SHA-1 Hash Computation for a message block.
+void ProcessMessageBlock(const MessageBlock &message,
+                         uint32 (&H)[kNumDWordsOfDigest]) {
+  uint32 W[80];  // Message schedule.
+  for (size_t i = 0; i < 16; ++i) {
+    const size_t base_index = i * 4;
+    W[i] = (static_cast<uint32>(message[base_index + 0]) << 24) |
+           (static_cast<uint32>(message[base_index + 1]) << 16) |
+           (static_cast<uint32>(message[base_index + 2]) << 8) |
+           (static_cast<uint32>(message[base_index + 3]) << 0);
+  }
+  for (size_t t = 16; t < 80; ++t) {
+    W[t] = ROTL<1>(W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+  }
+
+  uint32 a = H[0];
+  uint32 b = H[1];
+  uint32 c = H[2];
+  uint32 d = H[3];
+  uint32 e = H[4];
+
+  for (size_t t = 0; t < 80; ++t) {
+    const uint32 T = ROTL<5>(a) + f(t, b, c, d) + e + W[t] + K(t);
+    e = d;
+    d = c;
+    c = ROTL<30>(b);
+    b = a;
+    a = T;
+  }
+
+  H[0] += a;
+  H[1] += b;
+  H[2] += c;
+  H[3] += d;
+  H[4] += e;
+}
+
+#ifdef MOZC_X86_SIMD_AVAILABLE
+// Same as ProcessMessageBlock() but uses Intel SHA extensions. Each
+// SHA1RNDS4 performs 4 rounds, whose function and constant are selected by
+// the immediate operand, with a 128-bit register holding 4 words of the
+// message schedule.
+MOZC_TARGET_FEATURES("sha,sse4.1,ssse3")
+void ProcessMessageBlockWithSHAExtensions(const MessageBlock &message,
+                                          uint32 (&H)[kNumDWordsOfDigest]) {
+  // Reverses the byte order so that each word is loaded as big-endian and
+  // the first word comes to the highest lane.
+  const __m128i kByteSwapMask =
+      _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+
+  // Message schedule, 4 words each.
+  __m128i W[20];
+  for (size_t i = 0; i < 4; ++i) {
+    W[i] = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(message) + i),
+        kByteSwapMask);
+  }
+  for (size_t i = 4; i < 20; ++i) {
+    W[i] = _mm_sha1msg2_epu32(
+        _mm_xor_si128(_mm_sha1msg1_epu32(W[i - 4], W[i - 3]), W[i - 2]),
+        W[i - 1]);
+  }
+
+  // A is stored in the highest lane.
+  const __m128i abcd_orig = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(H)), 0x1b);
+  const __m128i e_orig = _mm_set_epi32(H[4], 0, 0, 0);
+
+  // SHA1NEXTE calculates E of the next 4 rounds from A of the previous 4
+  // rounds.
+  __m128i abcd = abcd_orig;
+  __m128i prev_abcd = abcd;
+  abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e_orig, W[0]), 0);
+  for (size_t i = 1; i < 5; ++i) {
+    const __m128i e = _mm_sha1nexte_epu32(prev_abcd, W[i]);
+    prev_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+  }
+  for (size_t i = 5; i < 10; ++i) {
+    const __m128i e = _mm_sha1nexte_epu32(prev_abcd, W[i]);
+    prev_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+  }
+  for (size_t i = 10; i < 15; ++i) {
+    const __m128i e = _mm_sha1nexte_epu32(prev_abcd, W[i]);
+    prev_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+  }
+  for (size_t i = 15; i < 20; ++i) {
+    const __m128i e = _mm_sha1nexte_epu32(prev_abcd, W[i]);
+    prev_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+  }
+
+  abcd = _mm_shuffle_epi32(_mm_add_epi32(abcd, abcd_orig), 0x1b);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(H), abcd);
+  H[4] = static_cast<uint32>(
+      _mm_extract_epi32(_mm_sha1nexte_epu32(prev_abcd, e_orig), 3));
+}
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+template <void (*ProcessBlock)(const MessageBlock &,
+                               uint32 (&)[kNumDWordsOfDigest])>
 string MakeDigestImpl(StringPiece source) {
   // 5.3 Setting the Initial Hash Value / 5.3.1 SHA-1
 
@@ -211,41 +321,9 @@ string MakeDigestImpl(StringPiece source) {
 
   // 6.1.2 SHA-1 Hash Computation
   for (PaddedMessageIterator it(source); it.HasMessage(); it.MoveNext()) {
-    StringPiece::value_type message[64];
+    MessageBlock message;
     it.FillNextMessage(message);
-
-    uint32 W[80];  // Message schedule.
-    for (size_t i = 0; i < 16; ++i) {
-      const size_t base_index = i * 4;
-      W[i] = (static_cast<uint32>(message[base_index + 0]) << 24) |
-             (static_cast<uint32>(message[base_index + 1]) << 16) |
-             (static_cast<uint32>(message[base_index + 2]) << 8) |
-             (static_cast<uint32>(message[base_index + 3]) << 0);
-    }
-    for (size_t t = 16; t < 80; ++t) {
-      W[t] = ROTL<1>(W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-    }
-
-    uint32 a = H[0];
-    uint32 b = H[1];
-    uint32 c = H[2];
-    uint32 d = H[3];
-    uint32 e = H[4];
-
-    for (size_t t = 0; t < 80; ++t) {
-      const uint32 T = ROTL<5>(a) + f(t, b, c, d) + e + W[t] + K(t);
-      e = d;
-      d = c;
-      c = ROTL<30>(b);
-      b = a;
-      a = T;
-    }
-
-    H[0] += a;
-    H[1] += b;
-    H[2] += c;
-    H[3] += d;
-    H[4] += e;
+    ProcessBlock(message, H);
   }
 
   return AsByteStream(H);
@@ -254,8 +332,24 @@ string MakeDigestImpl(StringPiece source) {
 }  // namespace
 
 string UnverifiedSHA1::MakeDigest(StringPiece source) {
-  return MakeDigestImpl(source);
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (CPUFeatures::HasSHA() && CPUFeatures::HasSSSE3() &&
+      CPUFeatures::HasSSE41()) {
+    return MakeDigestWithSHAExtensions(source);
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+  return MakeDigestPortable(source);
+}
+
+string UnverifiedSHA1::MakeDigestPortable(StringPiece source) {
+  return MakeDigestImpl<ProcessMessageBlock>(source);
+}
+
+#ifdef MOZC_X86_SIMD_AVAILABLE
+string UnverifiedSHA1::MakeDigestWithSHAExtensions(StringPiece source) {
+  return MakeDigestImpl<ProcessMessageBlockWithSHAExtensions>(source);
 }
+#endif  // MOZC_X86_SIMD_AVAILABLE
 
 }  // namespace internal
 }  // namespace mozc
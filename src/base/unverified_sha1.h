@@ -30,6 +30,7 @@
 #ifndef MOZC_BASE_UNVERIFIED_SHA1_H_
 #define MOZC_BASE_UNVERIFIED_SHA1_H_
 
+#include "base/cpu_features.h"
 #include "base/port.h"
 #include "base/string_piece.h"
 
@@ -39,7 +40,8 @@ namespace internal {
 // Note that this implemenation is kept just for the backward compatibility
 // so that we can read previously obfuscated data.
 // !!! Not FIPS-certified.
-// !!! Performance optimization is not well considered.
+// !!! Performance optimization is not well considered except that Intel SHA
+//     extensions are used when the CPU supports them.
 // !!! Side-channel attack is not well considered.
 // TODO(team): Consider to remove this class and stop doing obfuscation.
 class UnverifiedSHA1 {
@@ -48,6 +50,17 @@ class UnverifiedSHA1 {
   // CAVEATS: See the above comment.
   static string MakeDigest(StringPiece source);
 
+ protected:
+  // Portable implementation of MakeDigest().
+  static string MakeDigestPortable(StringPiece source);
+
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  // Implementation with Intel SHA extensions, which produces the same result
+  // as the portable one. Call it only when CPUFeatures::HasSHA(),
+  // CPUFeatures::HasSSSE3() and CPUFeatures::HasSSE41() are true.
+  static string MakeDigestWithSHAExtensions(StringPiece source);
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(UnverifiedSHA1);
 };
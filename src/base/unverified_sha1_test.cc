@@ -28,6 +28,10 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "base/unverified_sha1.h"
+
+#include <string>
+
+#include "base/cpu_features.h"
 #include "testing/base/public/googletest.h"
 #include "testing/base/public/gunit.h"
 
@@ -63,6 +67,18 @@ AssertionResult AssertEqualHashWithFormat(
 #define EXPECT_EQ_HASH(expected, actual)  \
     EXPECT_PRED_FORMAT2(AssertEqualHashWithFormat, expected, actual)
 
+class TestableUnverifiedSHA1 : public UnverifiedSHA1 {
+ public:
+  // Change access rights:
+  using UnverifiedSHA1::MakeDigestPortable;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  using UnverifiedSHA1::MakeDigestWithSHAExtensions;
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(TestableUnverifiedSHA1);
+};
+
 TEST(UnverifiedSHA1Test, OneBlockMessage) {
   // http://csrc.nist.gov/groups/ST/toolkit/documents/Examples/SHA1.pdf
   // Example: one-block message.
@@ -109,6 +125,25 @@ TEST(UnverifiedSHA1Test, ManyBlockMessage) {
   EXPECT_EQ_HASH(kExpected, UnverifiedSHA1::MakeDigest(input));
 }
 
+// The implementation chosen at runtime must produce the same digest as the
+// portable one. The lengths cover the boundaries of the padding.
+TEST(UnverifiedSHA1Test, SameAsPortable) {
+  string input;
+  for (size_t length = 0; length <= 200; ++length) {
+    const string expected = TestableUnverifiedSHA1::MakeDigestPortable(input);
+    EXPECT_EQ(expected, UnverifiedSHA1::MakeDigest(input)) << length;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+    if (CPUFeatures::HasSHA() && CPUFeatures::HasSSSE3() &&
+        CPUFeatures::HasSSE41()) {
+      EXPECT_EQ(expected,
+                TestableUnverifiedSHA1::MakeDigestWithSHAExtensions(input))
+          << length;
+    }
+#endif  // MOZC_X86_SIMD_AVAILABLE
+    input.push_back(static_cast<char>(length * 73 + 5));
+  }
+}
+
 // TODO(yukawa): Add more tests based on well-known test vectors.
 
 }  // namespace
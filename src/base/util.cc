@@ -61,6 +61,7 @@
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/cpu_features.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
@@ -68,6 +69,9 @@
 #include "base/string_piece.h"
 #include "base/text_converter.h"
 
+#ifdef MOZC_X86_SIMD_AVAILABLE
+#include <emmintrin.h>
+#endif  // MOZC_X86_SIMD_AVAILABLE
 
 namespace {
 
@@ -289,6 +293,7 @@ void Util::SplitStringAllowEmpty(StringPiece str,
 void Util::SplitStringToUtf8Chars(const string &str, vector<string> *output) {
   size_t begin = 0;
   const size_t end = str.size();
+  output->reserve(output->size() + CharsLen(str));
 
   while (begin < end) {
     const size_t mblen = OneCharLen(str.c_str() + begin);
@@ -575,6 +580,76 @@ bool IsUTF8TrailingByte(uint8 c) {
   return (c & 0xc0) == 0x80;
 }
 
+#ifdef MOZC_X86_SIMD_AVAILABLE
+// Number of bytes processed at once by the SIMD routines.
+const size_t kSIMDBlockSize = 16;
+
+inline uint32 CountBits16(uint32 x) {
+  x = x - ((x >> 1) & 0x5555);
+  x = (x & 0x3333) + ((x >> 2) & 0x3333);
+  x = (x + (x >> 4)) & 0x0f0f;
+  return (x + (x >> 8)) & 0x1f;
+}
+
+// Counts characters in |src| in the same way as the scalar loop of
+// Util::CharsLen, i.e., by the lengths in kUTF8LenTbl, 16 bytes at a time.
+// A block is counted by the number of non-trailing bytes only when every
+// trailing byte in it is expected by a preceding leading byte and vice versa,
+// which is always the case for valid UTF-8.  Returns the number of the
+// processed bytes, which ends at a character boundary, and adds the number
+// of characters in them to |*count|.  The rest, including an invalid
+// sequence, must be processed by the scalar loop.
+MOZC_TARGET_FEATURES("sse2")
+size_t CharsLenSSE2(const uint8 *src, size_t length, size_t *count) {
+  // Bytes are compared as signed integers: trailing bytes (0x80-0xBF) are
+  // less than -64 and leading bytes of 2, 3 and 4 byte sequences (0xC0-,
+  // 0xE0- and 0xF0-0xFF) are negative and greater than -65, -33 and -17.
+  const __m128i kMaxTrailingByte = _mm_set1_epi8(-64);
+  const __m128i kMin2BytesLeadingByte = _mm_set1_epi8(-65);
+  const __m128i kMin3BytesLeadingByte = _mm_set1_epi8(-33);
+  const __m128i kMin4BytesLeadingByte = _mm_set1_epi8(-17);
+
+  size_t processed = 0;
+  size_t processed_count = 0;
+  size_t block_count = 0;
+  // Bits of the trailing bytes expected in the next block.
+  uint32 pending = 0;
+  for (size_t pos = 0; pos + kSIMDBlockSize <= length;
+       pos += kSIMDBlockSize) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pos));
+    const uint32 non_ascii = _mm_movemask_epi8(bytes);
+    if (non_ascii == 0 && pending == 0) {
+      block_count += kSIMDBlockSize;
+      processed = pos + kSIMDBlockSize;
+      processed_count = block_count;
+      continue;
+    }
+    const uint32 trailing = _mm_movemask_epi8(
+        _mm_cmplt_epi8(bytes, kMaxTrailingByte));
+    const uint32 leading2 = non_ascii & _mm_movemask_epi8(
+        _mm_cmpgt_epi8(bytes, kMin2BytesLeadingByte));
+    const uint32 leading3 = non_ascii & _mm_movemask_epi8(
+        _mm_cmpgt_epi8(bytes, kMin3BytesLeadingByte));
+    const uint32 leading4 = non_ascii & _mm_movemask_epi8(
+        _mm_cmpgt_epi8(bytes, kMin4BytesLeadingByte));
+    const uint32 expected =
+        pending | (leading2 << 1) | (leading3 << 2) | (leading4 << 3);
+    if ((expected & 0xffff) != trailing) {
+      break;
+    }
+    block_count += kSIMDBlockSize - CountBits16(trailing);
+    pending = expected >> kSIMDBlockSize;
+    if (pending == 0) {
+      processed = pos + kSIMDBlockSize;
+      processed_count = block_count;
+    }
+  }
+  *count += processed_count;
+  return processed;
+}
+#endif  // MOZC_X86_SIMD_AVAILABLE
+
 }  // namespace
 
 // Return length of a single UTF-8 source character
@@ -585,7 +660,13 @@ size_t Util::OneCharLen(const char *src) {
 size_t Util::CharsLen(const char *src, size_t length) {
   const char *begin = src;
   const char *end = src + length;
-  int result = 0;
+  size_t result = 0;
+#ifdef MOZC_X86_SIMD_AVAILABLE
+  if (length >= kSIMDBlockSize && CPUFeatures::HasSSE2()) {
+    begin += CharsLenSSE2(reinterpret_cast<const uint8 *>(src), length,
+                          &result);
+  }
+#endif  // MOZC_X86_SIMD_AVAILABLE
   while (begin < end) {
     ++result;
     begin += OneCharLen(begin);
@@ -639,6 +720,18 @@ bool Util::SplitFirstChar32(StringPiece s,
         return true;
       }
 
+      // Fast path for the 3 byte sequences starting with 0xE1-0xEF, which
+      // cover Kana and most of Kanji.  They are never redundant.
+      if (leading_byte > 0xe0 && leading_byte <= 0xef && s.size() >= 3 &&
+          IsUTF8TrailingByte(static_cast<uint8>(s[1])) &&
+          IsUTF8TrailingByte(static_cast<uint8>(s[2]))) {
+        *first_char32 = ((leading_byte & 0x0f) << 12) |
+                        ((static_cast<uint8>(s[1]) & 0x3f) << 6) |
+                        (static_cast<uint8>(s[2]) & 0x3f);
+        *rest = s.substr(3);
+        return true;
+      }
+
       if (IsUTF8TrailingByte(leading_byte)) {
         // UTF-8 sequence should not start trailing bytes.
         return false;
@@ -1625,6 +1718,19 @@ void Util::EscapeCss(const string &plain, string *escaped) {
 // TODO(yukawa, team): Make a mechanism to keep this classifier up-to-date
 //   based on the original data from Unicode.org.
 Util::ScriptType Util::GetScriptType(char32 w) {
+  // Fast path for Kana and the main block of Kanji, which are the majority
+  // of Japanese text.  The ranges don't overlap with the others below.
+  if (INRANGE(w, 0x3041, 0x30FF)) {
+    if (w <= 0x309F) {
+      return HIRAGANA;
+    }
+    if (w >= 0x30A1) {
+      return KATAKANA;
+    }
+  } else if (INRANGE(w, 0x4E00, 0x9FFF)) {
+    return KANJI;
+  }
+
   if (INRANGE(w, 0x0030, 0x0039) ||    // ascii number
       INRANGE(w, 0xFF10, 0xFF19)) {    // full width number
     return NUMBER;
@@ -0,0 +1,152 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Microbenchmark of the character level utilities which run for every key
+// and candidate, e.g. Util::CharsLen and Util::GetScriptType.  The inputs
+// are the sentences of --sentences_file, which are mostly Hiragana, and
+// their Katakana and full-width mixed variants.  The sentences are also
+// concatenated into long inputs to see the throughput on long texts.
+//
+// The results are printed as TSV lines, see BenchmarkRecorder.
+//
+// Usage:
+//   util_benchmark --sentences_file=data/test/stress_test/sentences.txt
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/util.h"
+
+DEFINE_int32(iterations, 10, "The number of iterations over each corpus.");
+DEFINE_string(sentences_file, "data/test/stress_test/sentences.txt",
+              "The sentences used as inputs, one sentence per line.");
+
+namespace mozc {
+namespace {
+
+// Makes the inputs of mixed scripts from Hiragana |sentences|: the first
+// half of each sentence is converted to Katakana and the ASCII digits and
+// alphabets are appended in full-width.
+void MakeMixedInputs(const vector<string> &sentences, vector<string> *inputs) {
+  string katakana, fullwidth;
+  for (size_t i = 0; i < sentences.size(); ++i) {
+    const string &sentence = sentences[i];
+    const size_t half = Util::CharsLen(sentence) / 2;
+    Util::HiraganaToKatakana(Util::SubString(sentence, 0, half), &katakana);
+    Util::HalfWidthAsciiToFullWidthAscii("Mozc 2015", &fullwidth);
+    inputs->push_back(katakana + Util::SubString(sentence, half, string::npos) +
+                      "Mozc 2015" + fullwidth);
+  }
+}
+
+// Keeps the results alive so that the calls are not optimized away.
+size_t g_sink = 0;
+
+void CharsLen(const string &input) {
+  g_sink += Util::CharsLen(input);
+}
+
+void GetScriptType(const string &input) {
+  g_sink += Util::GetScriptType(input);
+}
+
+void IsHiragana(const string &input) {
+  g_sink += Util::IsScriptType(input, Util::HIRAGANA);
+}
+
+void SplitStringToUtf8Chars(const string &input) {
+  vector<string> output;
+  Util::SplitStringToUtf8Chars(input, &output);
+  g_sink += output.size();
+}
+
+void FullWidthAsciiToHalfWidthAscii(const string &input) {
+  string output;
+  Util::FullWidthAsciiToHalfWidthAscii(input, &output);
+  g_sink += output.size();
+}
+
+void HiraganaToKatakana(const string &input) {
+  string output;
+  Util::HiraganaToKatakana(input, &output);
+  g_sink += output.size();
+}
+
+void Run(const string &name, const vector<string> &inputs,
+         void (*func)(const string &)) {
+  BenchmarkRecorder recorder(name);
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      recorder.Start();
+      func(inputs[i]);
+      recorder.Stop();
+    }
+  }
+  recorder.Print(&cout);
+}
+
+void RunCorpus(const string &name, const vector<string> &inputs) {
+  Run("Util::CharsLen/" + name, inputs, CharsLen);
+  Run("Util::GetScriptType/" + name, inputs, GetScriptType);
+  Run("Util::IsScriptType(HIRAGANA)/" + name, inputs, IsHiragana);
+  Run("Util::SplitStringToUtf8Chars/" + name, inputs, SplitStringToUtf8Chars);
+  Run("Util::FullWidthAsciiToHalfWidthAscii/" + name, inputs,
+      FullWidthAsciiToHalfWidthAscii);
+  Run("Util::HiraganaToKatakana/" + name, inputs, HiraganaToKatakana);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  vector<string> sentences;
+  CHECK(mozc::BenchmarkCorpus::LoadKeys(FLAGS_sentences_file, &sentences));
+  CHECK(!sentences.empty());
+  vector<string> mixed;
+  mozc::MakeMixedInputs(sentences, &mixed);
+  vector<string> long_mixed;
+  mozc::BenchmarkCorpus::MakeLongInputs(mixed, 200, &long_mixed);
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  mozc::RunCorpus("sentences", sentences);
+  mozc::RunCorpus("mixed", mixed);
+  mozc::RunCorpus("long_mixed", long_mixed);
+  VLOG(1) << mozc::g_sink;
+  return 0;
+}
@@ -35,6 +35,7 @@
 #include <ctime>
 #include <map>
 #include <sstream>
+#include <set>
 #include <string>
 
 #include "base/clock_mock.h"
@@ -836,6 +837,37 @@ TEST(UtilTest, CharsLen) {
   EXPECT_EQ(Util::CharsLen(src.c_str(), src.size()), 9);
 }
 
+TEST(UtilTest, CharsLenLongText) {
+  // Long strings are counted 16 bytes at a time, where a character may cross
+  // the blocks.  The result must be the same as counting by OneCharLen,
+  // including invalid sequences.
+  const char *kPieces[] = {
+    "a", "0",
+    "\xC3\xA9",          // "é"
+    "\xE3\x81\x82",      // "あ"
+    "\xE6\xBC\xA2",      // "漢"
+    "\xF0\x9F\x98\x80",  // U+1F600
+    "\x80",              // Trailing byte without leading byte.
+    "\xE3\x81",          // Truncated sequence.
+    "\xFF",
+  };
+  for (size_t num_pieces = 1; num_pieces <= arraysize(kPieces);
+       ++num_pieces) {
+    for (size_t offset = 0; offset < 20; ++offset) {
+      string src(offset, 'x');
+      for (size_t i = 0; i < 40; ++i) {
+        src.append(kPieces[(i * 7 + offset) % num_pieces]);
+      }
+      size_t expected = 0;
+      for (size_t pos = 0; pos < src.size();
+           pos += Util::OneCharLen(src.data() + pos)) {
+        ++expected;
+      }
+      EXPECT_EQ(expected, Util::CharsLen(src)) << num_pieces << " " << offset;
+    }
+  }
+}
+
 TEST(UtilTest, SubStringPiece) {
   // "私の名前は中野です"
   const string src = "\xe7\xa7\x81\xe3\x81\xae\xe5\x90\x8d\xe5\x89\x8d\xe3\x81"
@@ -1398,6 +1430,19 @@ TEST(UtilTest, FullWidthAndHalfWidth) {
   Util::FullWidthAsciiToHalfWidthAscii("\x20\xe3\x80\x80", &output);
   CHECK_EQ("  ", output);
 
+  // Runs of characters which are not converted are copied as is.
+  // "abc１２３def　ghi"
+  Util::FullWidthAsciiToHalfWidthAscii(
+      "abc\xef\xbc\x91\xef\xbc\x92\xef\xbc\x93""def\xe3\x80\x80""ghi",
+      &output);
+  CHECK_EQ("abc123def ghi", output);
+
+  // A truncated character at the end is copied without reading beyond the
+  // input.
+  Util::FullWidthAsciiToHalfWidthAscii(StringPiece("ab\xe3\x81", 4),
+                                       &output);
+  CHECK_EQ("ab\xe3\x81", output);
+
   // " 　"
   Util::HalfWidthAsciiToFullWidthAscii("\x20\xe3\x80\x80", &output);
   // "　　"
@@ -2270,6 +2315,51 @@ TEST(UtilTest, Fingerprint32WithSeed_uint32) {
   EXPECT_EQ(num_hash, str_hash) << num_hash << " != " << str_hash;
 }
 
+TEST(UtilTest, FingerprintV2) {
+  // The values must never change since they may be persisted.
+  EXPECT_EQ(GG_ULONGLONG(0xeeb40f7a87f1ddb1), Util::FingerprintV2(""));
+  EXPECT_EQ(GG_ULONGLONG(0x894fdf1b6df8d7dc), Util::FingerprintV2("a"));
+  EXPECT_EQ(GG_ULONGLONG(0xbb7dc7dc51e8918a), Util::FingerprintV2("mozc"));
+  // "もずく"
+  EXPECT_EQ(GG_ULONGLONG(0x66255fcad3d907be),
+            Util::FingerprintV2("\xE3\x82\x82\xE3\x81\x9A\xE3\x81\x8F"));
+  EXPECT_EQ(GG_ULONGLONG(0x439ac11bace0328f),
+            Util::FingerprintV2("0123456789abcdef"));
+  EXPECT_EQ(GG_ULONGLONG(0xeb20b9a8ae866f76),
+            Util::FingerprintV2("0123456789abcdefghijklmnopqrstuvwxyz"));
+
+  EXPECT_NE(Util::FingerprintV2("mozc"),
+            Util::FingerprintV2WithSeed("mozc", 0));
+  EXPECT_NE(Util::FingerprintV2WithSeed("mozc", 0),
+            Util::FingerprintV2WithSeed("mozc", 1));
+}
+
+TEST(UtilTest, FingerprintV2AllLengths) {
+  // Every prefix, including the ones ending in the middle of a word, has a
+  // distinct fingerprint, and the result doesn't depend on the alignment.
+  const string text =
+      "The quick brown fox jumps over the lazy dog. 0123456789abcdef";
+  set<uint64> fingerprints;
+  for (size_t length = 0; length <= text.size(); ++length) {
+    const uint64 fingerprint = Util::FingerprintV2(text.data(), length);
+    EXPECT_LT(1, fingerprint);
+    EXPECT_TRUE(fingerprints.insert(fingerprint).second) << length;
+    const string unaligned = "x" + text.substr(0, length);
+    EXPECT_EQ(fingerprint,
+              Util::FingerprintV2(unaligned.data() + 1, length));
+  }
+}
+
+TEST(UtilTest, FingerprintWithVersion) {
+  const string key = "mozc";
+  EXPECT_EQ(Util::Fingerprint(key),
+            Util::FingerprintWithVersion(Util::FINGERPRINT_V1, key.data(),
+                                         key.size()));
+  EXPECT_EQ(Util::FingerprintV2(key),
+            Util::FingerprintWithVersion(Util::FINGERPRINT_V2, key.data(),
+                                         key.size()));
+}
+
 TEST(UtilTest, RandomSeedTest) {
   Util::SetRandomSeed(0);
   const int first_try = Util::Random(INT_MAX);
@@ -244,7 +244,8 @@ void Client::PushHistory(const commands::Input &input,
   // found context boundary.
   // don't regard the empty output (output without preedit) as the context
   // boundary, as the IMEOn command make the empty output.
-  if (input.type() == commands::Input::SEND_KEY &&
+  if ((input.type() == commands::Input::SEND_KEY ||
+       input.type() == commands::Input::SEND_KEYS) &&
       output.has_result()) {
     ResetHistory();
   }
@@ -293,6 +294,16 @@ bool Client::SendKeyWithContext(const commands::KeyEvent &key,
   return EnsureCallCommand(&input, output);
 }
 
+bool Client::SendKeys(const vector<commands::KeyEvent> &keys,
+                      commands::Output *output) {
+  commands::Input input;
+  input.set_type(commands::Input::SEND_KEYS);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    input.add_keys()->CopyFrom(keys[i]);
+  }
+  return EnsureCallCommand(&input, output);
+}
+
 bool Client::TestSendKeyWithContext(const commands::KeyEvent &key,
                                     const commands::Context &context,
                                     commands::Output *output) {
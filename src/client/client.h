@@ -117,6 +117,11 @@ class Client : public ClientInterface {
   bool TestSendKeyWithContext(const commands::KeyEvent &key,
                               const commands::Context &context,
                               commands::Output *output);
+  // Sends |keys| in a single SEND_KEYS command.  Only the output of the last
+  // processed key is returned.  If output->num_processed_keys() is smaller
+  // than keys.size(), the caller should handle the rest of the keys.
+  bool SendKeys(const vector<commands::KeyEvent> &keys,
+                commands::Output *output);
   bool SendCommandWithContext(const commands::SessionCommand &command,
                               const commands::Context &context,
                               commands::Output *output);
@@ -237,6 +237,57 @@ class PreeditWithSuggestion : public PreeditCommon {
   }
 };
 
+// Measures the latency of a whole sentence typed as a burst of keys.
+class PreeditBurstCommon : public TestScenarioInterface {
+ protected:
+  virtual void RunTest(bool use_send_keys, Result *result) {
+    const vector<vector<commands::KeyEvent> > &keys =
+        Singleton<TestSentenceGenerator>::get()->GetTestKeys();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      Stopwatch stopwatch;
+      stopwatch.Start();
+      if (use_send_keys) {
+        client_.SendKeys(keys[i], &output_);
+      } else {
+        for (int j = 0; j < keys[i].size(); ++j) {
+          client_.SendKey(keys[i][j], &output_);
+        }
+      }
+      stopwatch.Stop();
+      result->operations_times.push_back(stopwatch.GetElapsedMicroseconds());
+      commands::SessionCommand command;
+      command.set_type(commands::SessionCommand::REVERT);
+      client_.SendCommand(command, &output_);
+    }
+  }
+};
+
+class PreeditBurstWithSendKey : public PreeditBurstCommon {
+ public:
+  virtual void Run(Result *result) {
+    result->test_name = "preedit_burst_with_send_key";
+    ResetConfig();
+    IMEOn();
+    EnableSuggestion();
+    RunTest(false, result);
+    IMEOff();
+    ResetConfig();
+  }
+};
+
+class PreeditBurstWithSendKeys : public PreeditBurstCommon {
+ public:
+  virtual void Run(Result *result) {
+    result->test_name = "preedit_burst_with_send_keys";
+    ResetConfig();
+    IMEOn();
+    EnableSuggestion();
+    RunTest(true, result);
+    IMEOff();
+    ResetConfig();
+  }
+};
+
 enum PredictionRequestType {
   ONE_CHAR,
   TWO_CHARS
@@ -372,6 +423,8 @@ int main(int argc, char **argv) {
 
   tests.push_back(new mozc::PreeditWithoutSuggestion);
   tests.push_back(new mozc::PreeditWithSuggestion);
+  tests.push_back(new mozc::PreeditBurstWithSendKey);
+  tests.push_back(new mozc::PreeditBurstWithSendKeys);
   tests.push_back(new mozc::Conversion);
   tests.push_back(new mozc::PredictionWithOneChar);
   tests.push_back(new mozc::PredictionWithTwoChars);
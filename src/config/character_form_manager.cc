@@ -37,6 +37,7 @@
 #include "base/config_file_stream.h"
 #include "base/init.h"
 #include "base/logging.h"
+#include "base/mutex.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
 #include "base/singleton.h"
@@ -565,7 +566,15 @@ class CharacterFormManager::Data {
     return conversion_.get();
   }
 
+  // The manager is a process-wide singleton shared by all sessions.  Lookups
+  // take the reader lock and updates of the rules or the storage take the
+  // writer lock.
+  ReaderWriterMutex *mutex() {
+    return &mutex_;
+  }
+
  private:
+  ReaderWriterMutex mutex_;
   scoped_ptr<PreeditCharacterFormManagerImpl> preedit_;
   scoped_ptr<ConversionCharacterFormManagerImpl> conversion_;
   scoped_ptr<LRUStorage> storage_;
@@ -598,9 +607,11 @@ CharacterFormManager::~CharacterFormManager() {
 }
 
 void CharacterFormManager::Reload() {
-  Clear();
   const Config &config = ConfigHandler::GetConfig();
 
+  scoped_writer_lock l(data_->mutex());
+  data_->GetConversionManager()->Clear();
+  data_->GetPreeditManager()->Clear();
   if (config.character_form_rules_size() > 0) {
     for (size_t i = 0; i < config.character_form_rules_size(); ++i) {
       const string &group = config.character_form_rules(i).group();
@@ -608,11 +619,12 @@ void CharacterFormManager::Reload() {
           config.character_form_rules(i).preedit_character_form();
       const Config::CharacterForm conversion_form =
           config.character_form_rules(i).conversion_character_form();
-      AddPreeditRule(group, preedit_form);
-      AddConversionRule(group, conversion_form);
+      data_->GetPreeditManager()->AddRule(group, preedit_form);
+      data_->GetConversionManager()->AddRule(group, conversion_form);
     }
   } else {
-    SetDefaultRule();
+    data_->GetPreeditManager()->SetDefaultRule();
+    data_->GetConversionManager()->SetDefaultRule();
   }
 }
 
@@ -631,16 +643,19 @@ void CharacterFormManager::ConvertWidth(
 
 void CharacterFormManager::ConvertPreeditString(const string &input,
                                                 string *output) const {
+  scoped_reader_lock l(data_->mutex());
   data_->GetPreeditManager()->ConvertString(input, output);
 }
 
 void CharacterFormManager::ConvertConversionString(const string &input,
                                                    string *output) const {
+  scoped_reader_lock l(data_->mutex());
   data_->GetConversionManager()->ConvertString(input, output);
 }
 
 bool CharacterFormManager::ConvertPreeditStringWithAlternative(
     const string &input, string *output, string *alternative_output) const {
+  scoped_reader_lock l(data_->mutex());
   return data_->GetPreeditManager()->ConvertStringWithAlternative(
       input,
       output, alternative_output);
@@ -648,6 +663,7 @@ bool CharacterFormManager::ConvertPreeditStringWithAlternative(
 
 bool CharacterFormManager::ConvertConversionStringWithAlternative(
     const string &input, string *output, string *alternative_output) const {
+  scoped_reader_lock l(data_->mutex());
   return data_->GetConversionManager()->ConvertStringWithAlternative(
       input,
       output, alternative_output);
@@ -655,11 +671,13 @@ bool CharacterFormManager::ConvertConversionStringWithAlternative(
 
 Config::CharacterForm CharacterFormManager::GetPreeditCharacterForm(
     const string &input) const {
+  scoped_reader_lock l(data_->mutex());
   return data_->GetPreeditManager()->GetCharacterForm(input);
 }
 
 Config::CharacterForm CharacterFormManager::GetConversionCharacterForm(
     const string &input) const {
+  scoped_reader_lock l(data_->mutex());
   return data_->GetConversionManager()->GetCharacterForm(input);
 }
 
@@ -667,23 +685,27 @@ void CharacterFormManager::ClearHistory() {
   // no need to call, as storage is shared
   // GetPreeditManager()->ClearHistory();
   VLOG(1) << "CharacterFormManager::ClearHistory() is called";
+  scoped_writer_lock l(data_->mutex());
   data_->GetConversionManager()->ClearHistory();
 }
 
 void CharacterFormManager::Clear() {
   VLOG(1) << "CharacterFormManager::Clear() is called";
+  scoped_writer_lock l(data_->mutex());
   data_->GetConversionManager()->Clear();
   data_->GetPreeditManager()->Clear();
 }
 
 void CharacterFormManager::SetCharacterForm(
     const string &input, Config::CharacterForm form) {
+  scoped_writer_lock l(data_->mutex());
   // no need to call Preedit, as storage is shared
   // GetPreeditManager()->SetCharacterForm(input, form);
   data_->GetConversionManager()->SetCharacterForm(input, form);
 }
 
 void CharacterFormManager::GuessAndSetCharacterForm(const string &input) {
+  scoped_writer_lock l(data_->mutex());
   // no need to call Preedit, as storage is shared
   // GetPreeditManager()->SetCharacterForm(input, form);
   data_->GetConversionManager()->GuessAndSetCharacterForm(input);
@@ -691,15 +713,18 @@ void CharacterFormManager::GuessAndSetCharacterForm(const string &input) {
 
 void CharacterFormManager::AddPreeditRule(
     const string &input, Config::CharacterForm form) {
+  scoped_writer_lock l(data_->mutex());
   data_->GetPreeditManager()->AddRule(input, form);
 }
 
 void CharacterFormManager::AddConversionRule(
     const string &input, Config::CharacterForm form) {
+  scoped_writer_lock l(data_->mutex());
   data_->GetConversionManager()->AddRule(input, form);
 }
 
 void CharacterFormManager::SetDefaultRule() {
+  scoped_writer_lock l(data_->mutex());
   data_->GetPreeditManager()->SetDefaultRule();
   data_->GetConversionManager()->SetDefaultRule();
 }
@@ -0,0 +1,247 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmark of the duplicate detection used while expanding candidates.
+//  - Duplicate detection of candidate values with set<string> compared with
+//    FingerprintSet, which CandidateFilter and the predictors use.
+//  - CandidateFilter::FilterCandidate() for a long list of candidates
+//    containing duplicates.
+//  - Conversion with long candidate expansions, i.e., each segment is
+//    expanded to --max_candidates candidates by ExpandCandidates().
+//
+// Usage:
+//   candidate_expansion_benchmark --iterations=100 --max_candidates=200
+
+#include <iostream>  // NOLINT
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/fingerprint_set.h"
+#include "base/flags.h"
+#include "base/freelist.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+#include "converter/candidate_filter.h"
+#include "converter/converter_interface.h"
+#include "converter/node.h"
+#include "converter/segments.h"
+#include "data_manager/testing/mock_data_manager.h"
+#include "dictionary/pos_matcher.h"
+#include "dictionary/suppression_dictionary.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "prediction/suggestion_filter.h"
+#include "session/random_keyevents_generator.h"
+
+DEFINE_int32(iterations, 100, "The number of iterations of each benchmark.");
+DEFINE_int32(max_candidates, 200,
+             "The number of candidates each segment is expanded to.");
+DEFINE_int32(max_sentences, 100,
+             "The number of test sentences used for conversion.");
+
+namespace mozc {
+namespace {
+
+using dictionary::SuppressionDictionary;
+
+void Report(const char *name, double elapsed_usec, size_t calls) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f nsec/call (%d calls)",
+                             elapsed_usec * 1000.0 / calls,
+                             static_cast<int>(calls))
+       << endl;
+}
+
+// Makes |size| candidate values sharing long prefixes, like the values of the
+// candidates of a long segment.  Every value appears twice.
+void MakeValues(size_t size, vector<string> *values) {
+  // "東京都港区六本木" as a common prefix.
+  const string prefix =
+      "\xE6\x9D\xB1\xE4\xBA\xAC\xE9\x83\xBD\xE6\xB8\xAF\xE5\x8C\xBA"
+      "\xE5\x85\xAD\xE6\x9C\xAC\xE6\x9C\xA8";
+  values->clear();
+  for (size_t i = 0; i < size; ++i) {
+    values->push_back(
+        prefix + Util::StringPrintf("%d", static_cast<int>(i / 2)));
+  }
+}
+
+void BenchmarkDuplicateDetection(const vector<string> &values) {
+  const size_t calls = values.size() * FLAGS_iterations;
+  // Accumulates the results so that the loops are not optimized out.
+  size_t inserted = 0;
+  {
+    set<string> seen;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      seen.clear();
+      for (size_t i = 0; i < values.size(); ++i) {
+        inserted += seen.insert(values[i]).second;
+      }
+    }
+    stopwatch.Stop();
+    Report("set<string>::insert", stopwatch.GetElapsedMicroseconds(), calls);
+  }
+  {
+    FingerprintSet seen;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      seen.Clear();
+      for (size_t i = 0; i < values.size(); ++i) {
+        inserted += seen.Insert(values[i]);
+      }
+    }
+    stopwatch.Stop();
+    Report("FingerprintSet::Insert", stopwatch.GetElapsedMicroseconds(),
+           calls);
+  }
+  VLOG(1) << "inserted: " << inserted;
+}
+
+void BenchmarkCandidateFilter(const testing::MockDataManager &data_manager,
+                              const vector<string> &values) {
+  const char *data = NULL;
+  size_t size = 0;
+  data_manager.GetSuggestionFilterData(&data, &size);
+  const SuggestionFilter suggestion_filter(data, size);
+  const SuppressionDictionary suppression_dictionary;
+  converter::CandidateFilter filter(&suppression_dictionary,
+                                    data_manager.GetPOSMatcher(),
+                                    &suggestion_filter);
+  const uint16 noun_id = data_manager.GetPOSMatcher()->GetGeneralNounId();
+
+  FreeList<Node> node_freelist(values.size());
+  FreeList<Segment::Candidate> candidate_freelist(values.size());
+  vector<const Segment::Candidate *> candidates;
+  vector<vector<const Node *> > nodes_list;
+  for (size_t i = 0; i < values.size(); ++i) {
+    Node *node = node_freelist.Alloc(1);
+    node->Init();
+    node->key = "key";
+    node->value = values[i];
+    node->lid = noun_id;
+    node->rid = noun_id;
+
+    Segment::Candidate *candidate = candidate_freelist.Alloc(1);
+    candidate->Init();
+    candidate->key = node->key;
+    candidate->value = node->value;
+    candidate->content_key = node->key;
+    candidate->content_value = node->value;
+    candidate->lid = noun_id;
+    candidate->rid = noun_id;
+    candidate->cost = 1000 + i;
+    candidate->structure_cost = 100;
+    candidates.push_back(candidate);
+
+    nodes_list.push_back(vector<const Node *>(1, node));
+  }
+
+  size_t good = 0;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    filter.Reset();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const converter::CandidateFilter::ResultType result =
+          filter.FilterCandidate(candidates[i]->key, candidates[i],
+                                 nodes_list[i], Segments::CONVERSION);
+      if (result == converter::CandidateFilter::STOP_ENUMERATION) {
+        break;
+      }
+      good += (result == converter::CandidateFilter::GOOD_CANDIDATE);
+    }
+  }
+  stopwatch.Stop();
+  Report("CandidateFilter::FilterCandidate",
+         stopwatch.GetElapsedMicroseconds(),
+         candidates.size() * FLAGS_iterations);
+  VLOG(1) << "good: " << good;
+}
+
+void BenchmarkConversion() {
+  scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
+  ConverterInterface *converter = engine->GetConverter();
+  CHECK(converter);
+
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  size = min(static_cast<size_t>(FLAGS_max_sentences), size);
+  CHECK_GT(size, 0);
+
+  // Conversion is much slower than the benchmarks above.
+  const int iterations = max(1, FLAGS_iterations / 10);
+  Segments segments;
+  segments.set_max_conversion_candidates_size(FLAGS_max_candidates);
+  size_t num_segments = 0;
+  size_t num_candidates = 0;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int n = 0; n < iterations; ++n) {
+    for (size_t i = 0; i < size; ++i) {
+      segments.Clear();
+      converter->StartConversion(&segments, sentences[i]);
+      for (size_t j = 0; j < segments.conversion_segments_size(); ++j) {
+        ++num_segments;
+        num_candidates += segments.conversion_segment(j).candidates_size();
+      }
+    }
+  }
+  stopwatch.Stop();
+  const double elapsed_usec = stopwatch.GetElapsedMicroseconds();
+  cout << "Converter::StartConversion: "
+       << Util::StringPrintf(
+              "%.1f usec/conversion, %.1f candidates/segment",
+              elapsed_usec / (size * iterations),
+              num_segments == 0 ? 0.0 :
+              static_cast<double>(num_candidates) / num_segments)
+       << endl;
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+  CHECK_GT(FLAGS_max_candidates, 0);
+
+  vector<string> values;
+  mozc::MakeValues(FLAGS_max_candidates, &values);
+  mozc::BenchmarkDuplicateDetection(values);
+
+  const mozc::testing::MockDataManager data_manager;
+  mozc::BenchmarkCandidateFilter(data_manager, values);
+  mozc::BenchmarkConversion();
+  return 0;
+}
@@ -89,6 +89,7 @@ CandidateFilter::CandidateFilter(
     : suppression_dictionary_(suppression_dictionary),
       pos_matcher_(pos_matcher),
       suggestion_filter_(suggestion_filter),
+      seen_(kMaxCandidatesSize),
       top_candidate_(NULL) {
   CHECK(suppression_dictionary_);
   CHECK(pos_matcher_);
@@ -98,13 +99,14 @@ CandidateFilter::CandidateFilter(
 CandidateFilter::~CandidateFilter() {}
 
 void CandidateFilter::Reset() {
-  seen_.clear();
+  seen_.Clear();
   top_candidate_ = NULL;
 }
 
 CandidateFilter::ResultType CandidateFilter::FilterCandidateInternal(
     const string &original_key,
     const Segment::Candidate *candidate,
+    uint64 value_fingerprint,
     const vector<const Node *> &nodes,
     Segments::RequestType request_type) {
   DCHECK(candidate);
@@ -173,7 +175,7 @@ CandidateFilter::ResultType CandidateFilter::FilterCandidateInternal(
   }
 
   // The candidate is already seen.
-  if (seen_.find(candidate->value) != seen_.end()) {
+  if (seen_.Contains(value_fingerprint)) {
     return CandidateFilter::BAD_CANDIDATE;
   }
 
@@ -361,19 +363,20 @@ CandidateFilter::ResultType CandidateFilter::FilterCandidate(
     const Segment::Candidate *candidate,
     const vector<const Node *> &nodes,
     Segments::RequestType request_type) {
+  const uint64 value_fingerprint = Util::FingerprintV2(candidate->value);
   if (request_type == Segments::REVERSE_CONVERSION) {
     // In reverse conversion, only remove duplicates because the filtering
     // criteria of FilterCandidateInternal() are completely designed for
     // (forward) conversion.
-    const bool inserted = seen_.insert(candidate->value).second;
+    const bool inserted = seen_.Insert(value_fingerprint);
     return inserted ? GOOD_CANDIDATE : BAD_CANDIDATE;
   } else {
-    const ResultType result = FilterCandidateInternal(original_key, candidate,
-                                                      nodes, request_type);
+    const ResultType result = FilterCandidateInternal(
+        original_key, candidate, value_fingerprint, nodes, request_type);
     if (result != GOOD_CANDIDATE) {
       return result;
     }
-    seen_.insert(candidate->value);
+    seen_.Insert(value_fingerprint);
     return result;
   }
 }
@@ -30,10 +30,10 @@
 #ifndef MOZC_CONVERTER_CANDIDATE_FILTER_H_
 #define MOZC_CONVERTER_CANDIDATE_FILTER_H_
 
-#include <set>
 #include <string>
 #include <vector>
 
+#include "base/fingerprint_set.h"
 #include "base/port.h"
 #include "converter/segments.h"
 #include "dictionary/pos_matcher.h"
@@ -72,6 +72,7 @@ class CandidateFilter {
  private:
   ResultType FilterCandidateInternal(const string &original_key,
                                      const Segment::Candidate *candidate,
+                                     uint64 value_fingerprint,
                                      const vector<const Node *> &nodes,
                                      Segments::RequestType request_type);
 
@@ -79,7 +80,8 @@ class CandidateFilter {
   const dictionary::POSMatcher *pos_matcher_;
   const SuggestionFilter *suggestion_filter_;
 
-  set<string> seen_;
+  // Fingerprints of the values of the accepted candidates.
+  FingerprintSet seen_;
   const Segment::Candidate *top_candidate_;
 
   DISALLOW_COPY_AND_ASSIGN(CandidateFilter);
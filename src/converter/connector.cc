@@ -29,7 +29,9 @@
 
 #include "converter/connector.h"
 
-#include <algorithm>
+#ifdef OS_WIN
+#include <windows.h>
+#endif  // OS_WIN
 
 #include "base/logging.h"
 #include "base/port.h"
@@ -59,6 +61,38 @@ inline uint32 EncodeKey(uint16 rid, uint16 lid) {
   return (static_cast<uint32>(rid) << 16) | lid;
 }
 
+// A cache entry packs the key into the upper 32 bits and the cost into the
+// lower 32 bits so that a reader never sees a key paired with the cost of
+// another key even when several threads share the connector.
+inline uint64 EncodeCacheEntry(uint32 key, int value) {
+  return (static_cast<uint64>(key) << 32) | static_cast<uint32>(value);
+}
+
+// Relaxed ordering is sufficient: each entry is self-contained and a stale
+// entry only causes a cache miss.
+inline uint64 LoadCacheEntry(const volatile uint64 *entry) {
+#if defined(OS_WIN) && !defined(_WIN64)
+  return static_cast<uint64>(::InterlockedCompareExchange64(
+      reinterpret_cast<volatile LONGLONG *>(
+          const_cast<volatile uint64 *>(entry)), 0, 0));
+#elif defined(OS_WIN)
+  return *entry;
+#else
+  return __atomic_load_n(entry, __ATOMIC_RELAXED);
+#endif  // OS_WIN
+}
+
+inline void StoreCacheEntry(volatile uint64 *entry, uint64 value) {
+#if defined(OS_WIN) && !defined(_WIN64)
+  ::InterlockedExchange64(reinterpret_cast<volatile LONGLONG *>(entry),
+                          static_cast<LONGLONG>(value));
+#elif defined(OS_WIN)
+  *entry = value;
+#else
+  __atomic_store_n(entry, value, __ATOMIC_RELAXED);
+#endif  // OS_WIN
+}
+
 }  // namespace
 
 class Connector::Row {
@@ -128,8 +162,7 @@ Connector::Connector(const char *connection_data,
     : default_cost_(nullptr),
       cache_size_(cache_size),
       cache_hash_mask_(cache_size - 1),
-      cache_key_(new uint32[cache_size]),
-      cache_value_(new int[cache_size]) {
+      cache_(new uint64[cache_size]) {
   const uint16 *ptr = reinterpret_cast<const uint16 *>(connection_data);
   CHECK_EQ(kConnectorMagicNumber, ptr[0]);
   resolution_ = ptr[1];
@@ -186,12 +219,12 @@ Connector::~Connector() {
 int Connector::GetTransitionCost(uint16 rid, uint16 lid) const {
   const uint32 index = EncodeKey(rid, lid);
   const uint32 bucket = GetHashValue(rid, lid, cache_hash_mask_);
-  if (cache_key_[bucket] == index) {
-    return cache_value_[bucket];
+  const uint64 entry = LoadCacheEntry(&cache_[bucket]);
+  if (static_cast<uint32>(entry >> 32) == index) {
+    return static_cast<int>(static_cast<uint32>(entry));
   }
   const int value = LookupCost(rid, lid);
-  cache_key_[bucket] = index;
-  cache_value_[bucket] = value;
+  StoreCacheEntry(&cache_[bucket], EncodeCacheEntry(index, value));
   return value;
 }
 
@@ -200,7 +233,10 @@ int Connector::GetResolution() const {
 }
 
 void Connector::ClearCache() {
-  fill(cache_key_.get(), cache_key_.get() + cache_size_, kInvalidCacheKey);
+  const uint64 invalid_entry = EncodeCacheEntry(kInvalidCacheKey, 0);
+  for (int i = 0; i < cache_size_; ++i) {
+    StoreCacheEntry(&cache_[i], invalid_entry);
+  }
 }
 
 int Connector::LookupCost(uint16 rid, uint16 lid) const {
@@ -66,8 +66,10 @@ class Connector {
 
   const int cache_size_;
   const uint32 cache_hash_mask_;
-  mutable scoped_ptr<uint32[]> cache_key_;
-  mutable scoped_ptr<int[]> cache_value_;
+  // Transition cost cache shared by all callers.  Each entry holds both the
+  // key and the cost and is read and written atomically, so the connector can
+  // be used from multiple threads without a lock.
+  mutable scoped_ptr<volatile uint64[]> cache_;
 
   DISALLOW_COPY_AND_ASSIGN(Connector);
 };
@@ -36,6 +36,7 @@
 #include "base/file_util.h"
 #include "base/mmap.h"
 #include "base/scoped_ptr.h"
+#include "base/thread.h"
 #include "data_manager/connection_file_reader.h"
 #include "testing/base/public/gunit.h"
 
@@ -55,6 +56,47 @@ struct ConnectionDataEntry {
   int cost;
 };
 
+void ReadConnectionData(vector<ConnectionDataEntry> *data) {
+  const string connection_text_path =
+      FileUtil::JoinPath(FLAGS_test_srcdir, kTestConnectionFilePath);
+  for (ConnectionFileReader reader(connection_text_path);
+       !reader.done(); reader.Next()) {
+    ConnectionDataEntry entry;
+    entry.rid = reader.rid_of_left_node();
+    entry.lid = reader.lid_of_right_node();
+    entry.cost = reader.cost();
+    data->push_back(entry);
+  }
+}
+
+// Looks up a shared connector in its own random order and counts the
+// mismatches against the raw data.
+class LookupThread : public Thread {
+ public:
+  LookupThread(const Connector *connector,
+               const vector<ConnectionDataEntry> &data)
+      : connector_(connector), data_(data), num_errors_(0) {}
+
+  virtual void Run() {
+    random_shuffle(data_.begin(), data_.end());
+    for (size_t i = 0; i < data_.size(); ++i) {
+      if (connector_->GetTransitionCost(data_[i].rid, data_[i].lid) !=
+          data_[i].cost) {
+        ++num_errors_;
+      }
+    }
+  }
+
+  int num_errors() const { return num_errors_; }
+
+ private:
+  const Connector *connector_;
+  vector<ConnectionDataEntry> data_;
+  int num_errors_;
+
+  DISALLOW_COPY_AND_ASSIGN(LookupThread);
+};
+
 TEST(ConnectorTest, CompareWithRawData) {
   const string path = FileUtil::JoinPath(
       FLAGS_test_srcdir, kTestConnectionDataImagePath);
@@ -64,17 +106,8 @@ TEST(ConnectorTest, CompareWithRawData) {
       new Connector(cmmap.begin(), cmmap.size(), 256));
   ASSERT_EQ(1, connector->GetResolution());
 
-  const string connection_text_path =
-      FileUtil::JoinPath(FLAGS_test_srcdir, kTestConnectionFilePath);
   vector<ConnectionDataEntry> data;
-  for (ConnectionFileReader reader(connection_text_path);
-       !reader.done(); reader.Next()) {
-    ConnectionDataEntry entry;
-    entry.rid = reader.rid_of_left_node();
-    entry.lid = reader.lid_of_right_node();
-    entry.cost = reader.cost();
-    data.push_back(entry);
-  }
+  ReadConnectionData(&data);
 
   for (int trial = 0; trial < 3; ++trial) {
     // Lookup in random order for a few times.
@@ -90,5 +123,33 @@ TEST(ConnectorTest, CompareWithRawData) {
   }
 }
 
+TEST(ConnectorTest, ConcurrentLookup) {
+  const string path = FileUtil::JoinPath(
+      FLAGS_test_srcdir, kTestConnectionDataImagePath);
+  Mmap cmmap;
+  ASSERT_TRUE(cmmap.Open(path.c_str())) << "Failed to open image: " << path;
+  // Use a small cache so that the threads keep overwriting each other's
+  // entries.
+  scoped_ptr<Connector> connector(
+      new Connector(cmmap.begin(), cmmap.size(), 256));
+
+  vector<ConnectionDataEntry> data;
+  ReadConnectionData(&data);
+
+  const int kNumThreads = 4;
+  vector<LookupThread *> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(new LookupThread(connector.get(), data));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Start();
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+    EXPECT_EQ(0, threads[i]->num_errors());
+    delete threads[i];
+  }
+}
+
 }  // namespace
 }  // namespace mozc
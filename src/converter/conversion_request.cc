@@ -29,7 +29,9 @@
 
 #include "config/config_handler.h"
 #include "converter/conversion_request.h"
+#include "base/cancellation_flag.h"
 #include "base/logging.h"
+#include "base/util.h"
 #include "session/commands.pb.h"
 
 namespace mozc {
@@ -40,7 +42,9 @@ ConversionRequest::ConversionRequest()
       use_actual_converter_for_realtime_conversion_(false),
       composer_key_selection_(CONVERSION_KEY),
       skip_slow_rewriters_(false),
-      create_partial_candidates_(false) {}
+      create_partial_candidates_(false),
+      deadline_ticks_(0),
+      cancellation_flag_(NULL) {}
 
 ConversionRequest::ConversionRequest(const composer::Composer *c,
                                      const commands::Request *request)
@@ -49,7 +53,9 @@ ConversionRequest::ConversionRequest(const composer::Composer *c,
       use_actual_converter_for_realtime_conversion_(false),
       composer_key_selection_(CONVERSION_KEY),
       skip_slow_rewriters_(false),
-      create_partial_candidates_(false) {}
+      create_partial_candidates_(false),
+      deadline_ticks_(0),
+      cancellation_flag_(NULL) {}
 
 ConversionRequest::~ConversionRequest() {}
 
@@ -111,6 +117,29 @@ bool ConversionRequest::IsKanaModifierInsensitiveConversion() const {
          GET_CONFIG(use_kana_modifier_insensitive_conversion);
 }
 
+uint64 ConversionRequest::deadline_ticks() const {
+  return deadline_ticks_;
+}
+
+void ConversionRequest::set_deadline_ticks(uint64 ticks) {
+  deadline_ticks_ = ticks;
+}
+
+void ConversionRequest::SetTimeBudgetMsec(uint32 msec) {
+  deadline_ticks_ = Util::GetTicks() + Util::GetFrequency() * msec / 1000;
+}
+
+void ConversionRequest::set_cancellation_flag(const CancellationFlag *flag) {
+  cancellation_flag_ = flag;
+}
+
+bool ConversionRequest::IsExpired() const {
+  if (cancellation_flag_ != NULL && cancellation_flag_->IsCancelled()) {
+    return true;
+  }
+  return deadline_ticks_ != 0 && Util::GetTicks() >= deadline_ticks_;
+}
+
 void ConversionRequest::CopyFrom(const ConversionRequest &request) {
   composer_ = request.composer_;
   request_ = request.request_;
@@ -119,6 +148,8 @@ void ConversionRequest::CopyFrom(const ConversionRequest &request) {
   composer_key_selection_ = request.composer_key_selection_;
   skip_slow_rewriters_ = request.skip_slow_rewriters_;
   create_partial_candidates_ = request.create_partial_candidates_;
+  deadline_ticks_ = request.deadline_ticks_;
+  cancellation_flag_ = request.cancellation_flag_;
 }
 
 }  // namespace mozc
@@ -35,6 +35,7 @@
 #include "base/port.h"
 
 namespace mozc {
+class CancellationFlag;
 namespace composer {
 class Composer;
 }  // namespace composer
@@ -94,6 +95,23 @@ class ConversionRequest {
 
   bool IsKanaModifierInsensitiveConversion() const;
 
+  // Deadline and cancellation.
+  // A request is expired when its deadline has passed or when its
+  // cancellation flag has been raised.  Expensive stages (lattice
+  // construction, prediction aggregation and rewriters) check IsExpired() at
+  // their stage boundaries and return best-effort partial results.
+  //
+  // The deadline is in ticks of Util::GetTicks().  0 means no deadline.
+  uint64 deadline_ticks() const;
+  void set_deadline_ticks(uint64 ticks);
+  // Sets the deadline to |msec| milliseconds from now.
+  void SetTimeBudgetMsec(uint32 msec);
+
+  // This class doesn't take the ownership of |flag|.
+  void set_cancellation_flag(const CancellationFlag *flag);
+
+  bool IsExpired() const;
+
  private:
   // Required fields
   // Input composer to generate a key for conversion, suggestion, etc.
@@ -121,6 +139,10 @@ class ConversionRequest {
   // For example, "私の" is created from composition "わたしのなまえ".
   bool create_partial_candidates_;
 
+  // See IsExpired().
+  uint64 deadline_ticks_;
+  const CancellationFlag *cancellation_flag_;
+
   // TODO(noriyukit): Moves all the members of Segments that are irrelevant to
   // this structure, e.g., Segments::user_history_enabled_ and
   // Segments::request_type_. Also, a key for conversion is eligible to live in
@@ -56,5 +56,19 @@
         'converter_base.gyp:segments',
       ],
     },
+    {
+      'target_name': 'quality_regression_util',
+      'type': 'static_library',
+      'sources': [
+        'quality_regression_util.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../composer/composer.gyp:composer',
+        '../session/session_base.gyp:session_protocol',
+        'converter_base.gyp:conversion_request',
+        'converter_base.gyp:segments',
+      ],
+    },
   ],
 }
@@ -126,6 +126,7 @@
         '../dictionary/dictionary_base.gyp:suppression_dictionary',
         '../rewriter/rewriter_base.gyp:gen_rewriter_files#host',
         '../session/session_base.gyp:session_protocol',
+        '../usage_stats/usage_stats_base.gyp:usage_stats',
         'connector',
         'immutable_converter_interface',
         'segmenter',
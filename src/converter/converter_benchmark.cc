@@ -0,0 +1,158 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark of the converter replaying reproducible corpora keystroke by
+// keystroke, like the client does while the user types.
+//  - For each prefix of an input grown by one character, the suggestion is
+//    requested and its latency is recorded as one keystroke.
+//  - For each whole input, the conversion and the prediction are requested.
+// The corpora are the test sentences of RandomKeyEventsGenerator, the long
+// inputs made by concatenating them, and optionally --corpus_file, which can
+// be a file of the quality regression test.
+//
+// The results are printed as TSV lines, see BenchmarkRecorder.
+//
+// Usage:
+//   converter_benchmark --iterations=3 --corpus_file=quality_regression.tsv
+
+#include <algorithm>
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/util.h"
+#include "converter/converter_interface.h"
+#include "converter/segments.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "session/random_keyevents_generator.h"
+
+DEFINE_int32(iterations, 3, "The number of iterations over each corpus.");
+DEFINE_int32(max_sentences, 200,
+             "The number of test sentences used as a corpus.");
+DEFINE_int32(long_input_chars, 60,
+             "The minimum number of characters of the long inputs.");
+DEFINE_string(corpus_file, "",
+              "A file of the keys or a TSV file of the quality regression "
+              "test used as an additional corpus.");
+
+namespace mozc {
+namespace {
+
+struct Corpus {
+  string name;
+  vector<string> keys;
+};
+
+void MakeCorpora(vector<Corpus> *corpora) {
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  size = min(static_cast<size_t>(FLAGS_max_sentences), size);
+  CHECK_GT(size, 0);
+
+  corpora->resize(2);
+  (*corpora)[0].name = "sentences";
+  (*corpora)[0].keys.assign(sentences, sentences + size);
+  (*corpora)[1].name = "long_inputs";
+  BenchmarkCorpus::MakeLongInputs((*corpora)[0].keys, FLAGS_long_input_chars,
+                                  &(*corpora)[1].keys);
+
+  if (!FLAGS_corpus_file.empty()) {
+    corpora->resize(3);
+    (*corpora)[2].name = "corpus_file";
+    CHECK(BenchmarkCorpus::LoadKeys(FLAGS_corpus_file, &(*corpora)[2].keys));
+  }
+}
+
+void RunCorpus(const ConverterInterface &converter,
+               const Corpus &corpus) {
+  BenchmarkRecorder suggestion("Converter::StartSuggestion/" + corpus.name);
+  BenchmarkRecorder conversion("Converter::StartConversion/" + corpus.name);
+  BenchmarkRecorder prediction("Converter::StartPrediction/" + corpus.name);
+
+  Segments segments;
+  string prefix;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    for (size_t i = 0; i < corpus.keys.size(); ++i) {
+      const string &key = corpus.keys[i];
+      for (const char *begin = key.data(), *end = key.data() + key.size();
+           begin < end; begin += Util::OneCharLen(begin)) {
+        prefix.assign(key.data(), begin + Util::OneCharLen(begin));
+        segments.Clear();
+        suggestion.Start();
+        converter.StartSuggestion(&segments, prefix);
+        suggestion.Stop();
+      }
+
+      segments.Clear();
+      prediction.Start();
+      converter.StartPrediction(&segments, key);
+      prediction.Stop();
+
+      segments.Clear();
+      conversion.Start();
+      converter.StartConversion(&segments, key);
+      conversion.Stop();
+    }
+  }
+
+  suggestion.Print(&cout);
+  prediction.Print(&cout);
+  conversion.Print(&cout);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  vector<mozc::Corpus> corpora;
+  mozc::MakeCorpora(&corpora);
+
+  scoped_ptr<mozc::EngineInterface> engine(
+      mozc::MockDataEngineFactory::Create());
+  const mozc::ConverterInterface *converter = engine->GetConverter();
+  CHECK(converter);
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  for (size_t i = 0; i < corpora.size(); ++i) {
+    mozc::RunCorpus(*converter, corpora[i]);
+  }
+  return 0;
+}
@@ -52,5 +52,62 @@
         'converter_base.gyp:segments',
       ],
     },
+    {
+      'target_name': 'quality_regression_main',
+      'type': 'executable',
+      'sources': [
+        'quality_regression_main.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../engine/engine.gyp:engine_factory',
+        '../session/session_base.gyp:session_protocol',
+        'converter.gyp:quality_regression_util',
+      ],
+    },
+    {
+      'target_name': 'candidate_expansion_benchmark',
+      'type': 'executable',
+      'sources': [
+        'candidate_expansion_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../data_manager/testing/mock_data_manager.gyp:mock_data_manager',
+        '../engine/engine.gyp:mock_data_engine_factory',
+        '../prediction/prediction_base.gyp:suggestion_filter',
+        '../session/session.gyp:random_keyevents_generator',
+        'converter_base.gyp:segments',
+      ],
+    },
+    {
+      'target_name': 'converter_benchmark',
+      'type': 'executable',
+      'sources': [
+        'converter_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../base/base_test.gyp:benchmark_util',
+        '../engine/engine.gyp:mock_data_engine_factory',
+        '../session/session.gyp:random_keyevents_generator',
+        'converter_base.gyp:segments',
+      ],
+    },
+    {
+      'target_name': 'pos_matcher_benchmark',
+      'type': 'executable',
+      'sources': [
+        'pos_matcher_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../data_manager/testing/mock_data_manager.gyp:mock_data_manager',
+        '../engine/engine.gyp:mock_data_engine_factory',
+        '../prediction/prediction_base.gyp:suggestion_filter',
+        '../session/session.gyp:random_keyevents_generator',
+        'converter_base.gyp:segments',
+      ],
+    },
   ],
 }
@@ -63,6 +63,7 @@
 #include "dictionary/system/value_dictionary.h"
 #include "dictionary/user_dictionary_stub.h"
 #include "engine/engine.h"
+#include "engine/engine_core.h"
 #include "engine/engine_interface.h"
 #include "engine/mock_data_engine_factory.h"
 #include "prediction/dictionary_predictor.h"
@@ -293,6 +294,47 @@ TEST_F(ConverterTest, CanConvertTest) {
   }
 }
 
+TEST_F(ConverterTest, EnginesShareEngineCore) {
+  testing::MockDataManager data_manager;
+  EngineCore core(&data_manager);
+  EXPECT_TRUE(core.system_dictionary() != NULL);
+  EXPECT_TRUE(core.value_dictionary() != NULL);
+  scoped_ptr<Engine> engine1(new Engine);
+  engine1->Init(&core, DefaultPredictor::CreateDefaultPredictor, false);
+  Engine engine2;
+  engine2.Init(&core, DefaultPredictor::CreateDefaultPredictor, false);
+
+  EXPECT_EQ(&core, engine1->GetEngineCore());
+  EXPECT_EQ(&core, engine2.GetEngineCore());
+  EXPECT_NE(engine1->GetConverter(), engine2.GetConverter());
+
+  // "おきておきて"
+  const string kKey = "\xe3\x81\x8a\xe3\x81\x8d\xe3\x81\xa6\xe3\x81\x8a"
+                      "\xe3\x81\x8d\xe3\x81\xa6";
+  Segments segments1;
+  ASSERT_TRUE(engine1->GetConverter()->StartConversion(&segments1, kKey));
+  Segments segments2;
+  ASSERT_TRUE(engine2.GetConverter()->StartConversion(&segments2, kKey));
+  ASSERT_EQ(segments1.conversion_segments_size(),
+            segments2.conversion_segments_size());
+  for (size_t i = 0; i < segments1.conversion_segments_size(); ++i) {
+    EXPECT_EQ(segments1.conversion_segment(i).candidate(0).value,
+              segments2.conversion_segment(i).candidate(0).value);
+  }
+
+  // The system and value dictionaries are owned by |core|, so destroying an
+  // engine doesn't affect the others.
+  engine1.reset();
+  Segments segments3;
+  ASSERT_TRUE(engine2.GetConverter()->StartConversion(&segments3, kKey));
+  ASSERT_EQ(segments2.conversion_segments_size(),
+            segments3.conversion_segments_size());
+  for (size_t i = 0; i < segments2.conversion_segments_size(); ++i) {
+    EXPECT_EQ(segments2.conversion_segment(i).candidate(0).value,
+              segments3.conversion_segment(i).candidate(0).value);
+  }
+}
+
 namespace {
 string ContextAwareConvert(const string &first_key,
                            const string &first_value,
@@ -1284,7 +1326,8 @@ TEST_F(ConverterTest, VariantExpansionForSuggestion) {
                   new RewriterImpl(converter.get(),
                                    &data_manager,
                                    pos_group.get(),
-                                   kNullDictionary),
+                                   kNullDictionary,
+                                   NULL),
                   immutable_converter.get());
 
   Segments segments;
@@ -44,6 +44,7 @@
         'key_corrector_test.cc',
         'lattice_test.cc',
         'nbest_generator_test.cc',
+        'quality_regression_util_test.cc',
         'segments_test.cc',
       ],
       'dependencies': [
@@ -65,6 +66,7 @@
         '../transliteration/transliteration.gyp:transliteration',
         '../usage_stats/usage_stats_test.gyp:usage_stats_testing_util',
         'converter.gyp:converter',
+        'converter.gyp:quality_regression_util',
         'converter_base.gyp:connector',
         'converter_base.gyp:converter_mock',
         'converter_base.gyp:segmenter',
@@ -36,6 +36,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/latency_histogram.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
@@ -60,12 +61,14 @@
 #include "dictionary/suppression_dictionary.h"
 #include "prediction/suggestion_filter.h"
 #include "session/commands.pb.h"
+#include "usage_stats/usage_stats.h"
 
 using mozc::dictionary::DictionaryInterface;
 using mozc::dictionary::POSMatcher;
 using mozc::dictionary::PosGroup;
 using mozc::dictionary::SuppressionDictionary;
 using mozc::dictionary::Token;
+using mozc::usage_stats::UsageStats;
 
 namespace mozc {
 namespace {
@@ -296,7 +299,15 @@ ImmutableConverterImpl::ImmutableConverterImpl(
       number_id_(pos_matcher_->GetNumberId()),
       unknown_id_(pos_matcher_->GetUnknownId()),
       last_to_first_name_transition_cost_(
-          connector_->GetTransitionCost(last_name_id_, first_name_id_)) {
+          connector_->GetTransitionCost(last_name_id_, first_name_id_)),
+      make_lattice_histogram_(
+          LatencyHistogram::Get("ImmutableConverter::MakeLattice")),
+      viterbi_histogram_(
+          LatencyHistogram::Get("ImmutableConverter::Viterbi")),
+      prediction_viterbi_histogram_(
+          LatencyHistogram::Get("ImmutableConverter::PredictionViterbi")),
+      make_segments_histogram_(
+          LatencyHistogram::Get("ImmutableConverter::MakeSegments")) {
   DCHECK(dictionary_);
   DCHECK(suffix_dictionary_);
   DCHECK(suppression_dictionary_);
@@ -1403,7 +1414,13 @@ bool ImmutableConverterImpl::MakeLattice(
 
   // Predictive real time conversion
   if (is_prediction) {
-    MakeLatticeNodesForPredictiveNodes(*segments, request, lattice);
+    if (request.IsExpired()) {
+      // The lattice is complete without predictive nodes, so just skip them
+      // to return a best-effort result.
+      UsageStats::IncrementCount("ConversionRequestExpiredInMakeLattice");
+    } else {
+      MakeLatticeNodesForPredictiveNodes(*segments, request, lattice);
+    }
   }
 
   if (!is_valid_lattice) {
@@ -1966,20 +1983,25 @@ bool ImmutableConverterImpl::ConvertForRequest(
 
   Lattice *lattice = GetLattice(segments, is_prediction);
 
-  if (!MakeLattice(request, segments, lattice)) {
-    LOG(WARNING) << "could not make lattice";
-    return false;
+  {
+    ScopedLatencyTimer timer(make_lattice_histogram_);
+    if (!MakeLattice(request, segments, lattice)) {
+      LOG(WARNING) << "could not make lattice";
+      return false;
+    }
   }
 
   vector<uint16> group;
   MakeGroup(*segments, &group);
 
   if (is_prediction) {
+    ScopedLatencyTimer timer(prediction_viterbi_histogram_);
     if (!PredictionViterbi(*segments, lattice)) {
       LOG(WARNING) << "prediction_viterbi failed";
       return false;
     }
   } else {
+    ScopedLatencyTimer timer(viterbi_histogram_);
     if (!Viterbi(*segments, lattice)) {
       LOG(WARNING) << "viterbi failed";
       return false;
@@ -1987,9 +2009,13 @@ bool ImmutableConverterImpl::ConvertForRequest(
   }
 
   VLOG(2) << lattice->DebugString();
-  if (!MakeSegments(request, *lattice, group, segments)) {
-    LOG(WARNING) << "make segments failed";
-    return false;
+  {
+    // Candidate enumeration by NBestGenerator dominates this stage.
+    ScopedLatencyTimer timer(make_segments_histogram_);
+    if (!MakeSegments(request, *lattice, group, segments)) {
+      LOG(WARNING) << "make segments failed";
+      return false;
+    }
   }
 
   return true;
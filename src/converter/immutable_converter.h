@@ -49,6 +49,7 @@ namespace mozc {
 
 struct Node;
 class ImmutableConverterInterface;
+class LatencyHistogram;
 class Lattice;
 class NBestGenerator;
 class Segmenter;
@@ -198,6 +199,12 @@ class ImmutableConverterImpl : public ImmutableConverterInterface {
   // Cache for transition cost.
   const int32 last_to_first_name_transition_cost_;
 
+  // Per-stage latency histograms of ConvertForRequest().
+  LatencyHistogram *make_lattice_histogram_;
+  LatencyHistogram *viterbi_histogram_;
+  LatencyHistogram *prediction_viterbi_histogram_;
+  LatencyHistogram *make_segments_histogram_;
+
   DISALLOW_COPY_AND_ASSIGN(ImmutableConverterImpl);
 };
 
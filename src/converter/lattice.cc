@@ -226,11 +226,15 @@ void Lattice::Clear() {
   key_.clear();
   begin_nodes_.clear();
   end_nodes_.clear();
-  node_allocator_->Free();
+  node_allocator_->Reset();
   cache_info_.clear();
   history_end_pos_ = 0;
 }
 
+void Lattice::Shrink() {
+  node_allocator_->Shrink();
+}
+
 void Lattice::SetDebugDisplayNode(size_t begin_pos, size_t end_pos,
                                   const string &str) {
   LatticeDisplayNodeInfo *info = Singleton<LatticeDisplayNodeInfo>::get();
@@ -83,8 +83,13 @@ class Lattice {
   void Insert(size_t pos, Node *node);
 
   // clear all lattice and nodes allocated with NewNode method.
+  // The memory for the nodes is kept and reused by the following NewNode
+  // calls.
   void Clear();
 
+  // release the node memory which has not been used since the last call.
+  void Shrink();
+
   // return true if this instance has a valid lattice.
   bool has_lattice() const;
 
@@ -67,6 +67,34 @@ TEST(LatticeTest, NewNodeTest) {
   EXPECT_EQ(0, node->rid);
 }
 
+TEST(LatticeTest, ClearKeepsNodeMemory) {
+  Lattice lattice;
+  const NodeAllocator &allocator = *lattice.node_allocator();
+  for (int i = 0; i < 5000; ++i) {
+    lattice.NewNode();
+  }
+  const size_t chunk_count = allocator.chunk_count();
+  EXPECT_LT(1, chunk_count);
+
+  // Building the same lattice again allocates nothing.
+  lattice.Clear();
+  for (int i = 0; i < 5000; ++i) {
+    lattice.NewNode();
+  }
+  EXPECT_EQ(chunk_count, allocator.chunk_count());
+
+  // The first Shrink() keeps the high-water mark of the recent use, and
+  // the second one releases all of it as nothing was used in between.
+  lattice.Clear();
+  lattice.Shrink();
+  EXPECT_EQ(chunk_count, allocator.chunk_count());
+  lattice.Shrink();
+  EXPECT_EQ(0, allocator.chunk_count());
+
+  Node *node = lattice.NewNode();
+  EXPECT_TRUE(node != NULL);
+}
+
 TEST(LatticeTest, InsertTest) {
   Lattice lattice;
 
@@ -57,6 +57,21 @@ class NodeAllocator {
     node_count_ = 0;
   }
 
+  // Same as Free() but keeps the memory for the next NewNode() calls.
+  void Reset() {
+    node_freelist_.Reset();
+    node_count_ = 0;
+  }
+
+  // Returns the memory unused since the last Shrink() call to the heap.
+  void Shrink() {
+    node_freelist_.Shrink();
+  }
+
+  size_t chunk_count() const {
+    return node_freelist_.chunk_count();
+  }
+
   size_t max_nodes_size() const {
     return max_nodes_size_;
   }
@@ -0,0 +1,231 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark of POSMatcher predicates and their main callers.
+//  - POSMatcher: the bitmask lookup used by Is<RuleName>() compared with the
+//    range scan which Is<RuleName>() used to do.
+//  - CandidateFilter::FilterCandidate(), which calls several predicates for
+//    each candidate.
+//  - Conversion throughput of the converter with the test data.
+//
+// Usage:
+//   pos_matcher_benchmark --iterations=100
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/flags.h"
+#include "base/freelist.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+#include "converter/candidate_filter.h"
+#include "converter/converter_interface.h"
+#include "converter/node.h"
+#include "converter/segments.h"
+#include "data_manager/testing/mock_data_manager.h"
+#include "dictionary/pos_matcher.h"
+#include "dictionary/suppression_dictionary.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "prediction/suggestion_filter.h"
+#include "session/random_keyevents_generator.h"
+
+DEFINE_int32(iterations, 100, "The number of iterations of each benchmark.");
+DEFINE_int32(max_sentences, 100,
+             "The number of test sentences used for conversion.");
+
+namespace mozc {
+namespace {
+
+using dictionary::POSMatcher;
+using dictionary::SuppressionDictionary;
+
+// The largest POS ID used by the benchmarks.
+const uint16 kMaxId = 3000;
+
+void Report(const char *name, double elapsed_usec, size_t calls) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f nsec/call (%d calls)",
+                             elapsed_usec * 1000.0 / calls,
+                             static_cast<int>(calls))
+       << endl;
+}
+
+void BenchmarkPOSMatcher(const POSMatcher &pos_matcher) {
+  const size_t calls = static_cast<size_t>(FLAGS_iterations) *
+      POSMatcher::kNumRules * kMaxId;
+  // Accumulates the results so that the loops are not optimized out.
+  size_t matched = 0;
+  {
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (int i = 0; i < POSMatcher::kNumRules; ++i) {
+        for (uint16 id = 0; id < kMaxId; ++id) {
+          matched += pos_matcher.MatchesByRangeScan(i, id);
+        }
+      }
+    }
+    stopwatch.Stop();
+    Report("POSMatcher::MatchesByRangeScan",
+           stopwatch.GetElapsedMicroseconds(), calls);
+  }
+  {
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (int i = 0; i < POSMatcher::kNumRules; ++i) {
+        for (uint16 id = 0; id < kMaxId; ++id) {
+          matched += pos_matcher.Matches(i, id);
+        }
+      }
+    }
+    stopwatch.Stop();
+    Report("POSMatcher::Matches", stopwatch.GetElapsedMicroseconds(), calls);
+  }
+  VLOG(1) << "matched: " << matched;
+}
+
+void BenchmarkCandidateFilter(const testing::MockDataManager &data_manager) {
+  const char *data = NULL;
+  size_t size = 0;
+  data_manager.GetSuggestionFilterData(&data, &size);
+  const SuggestionFilter suggestion_filter(data, size);
+  const SuppressionDictionary suppression_dictionary;
+  converter::CandidateFilter filter(&suppression_dictionary,
+                                    data_manager.GetPOSMatcher(),
+                                    &suggestion_filter);
+
+  // Candidates consisting of two nodes with various POS IDs.
+  FreeList<Node> node_freelist(kMaxId * 2);
+  FreeList<Segment::Candidate> candidate_freelist(kMaxId);
+  vector<const Segment::Candidate *> candidates;
+  vector<vector<const Node *> > nodes_list;
+  for (uint16 id = 0; id < kMaxId; ++id) {
+    Node *content = node_freelist.Alloc(1);
+    content->Init();
+    content->key = Util::StringPrintf("key%d", id);
+    content->value = Util::StringPrintf("value%d", id);
+    content->lid = id;
+    content->rid = id;
+    Node *functional = node_freelist.Alloc(1);
+    functional->Init();
+    functional->key = "no";
+    functional->value = "no";
+    functional->lid = kMaxId - 1 - id;
+    functional->rid = kMaxId - 1 - id;
+
+    Segment::Candidate *candidate = candidate_freelist.Alloc(1);
+    candidate->Init();
+    candidate->key = content->key + functional->key;
+    candidate->value = content->value + functional->value;
+    candidate->content_key = content->key;
+    candidate->content_value = content->value;
+    candidate->lid = content->lid;
+    candidate->rid = functional->rid;
+    candidate->cost = 1000 + id;
+    candidate->structure_cost = 100;
+    candidates.push_back(candidate);
+
+    nodes_list.push_back(vector<const Node *>());
+    nodes_list.back().push_back(content);
+    nodes_list.back().push_back(functional);
+  }
+
+  const Segments::RequestType kRequestTypes[] = {
+    Segments::CONVERSION,
+    Segments::SUGGESTION,
+  };
+  for (size_t t = 0; t < arraysize(kRequestTypes); ++t) {
+    size_t good = 0;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      filter.Reset();
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        if (filter.FilterCandidate(candidates[i]->key, candidates[i],
+                                   nodes_list[i], kRequestTypes[t]) ==
+            converter::CandidateFilter::GOOD_CANDIDATE) {
+          ++good;
+        }
+      }
+    }
+    stopwatch.Stop();
+    Report(t == 0 ? "CandidateFilter::FilterCandidate (CONVERSION)"
+                  : "CandidateFilter::FilterCandidate (SUGGESTION)",
+           stopwatch.GetElapsedMicroseconds(),
+           candidates.size() * FLAGS_iterations);
+    VLOG(1) << "good: " << good;
+  }
+}
+
+void BenchmarkConversion() {
+  scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
+  ConverterInterface *converter = engine->GetConverter();
+  CHECK(converter);
+
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  size = min(static_cast<size_t>(FLAGS_max_sentences), size);
+  CHECK_GT(size, 0);
+
+  // Conversion is much slower than the benchmarks above.
+  const int iterations = max(1, FLAGS_iterations / 10);
+  Segments segments;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (int n = 0; n < iterations; ++n) {
+    for (size_t i = 0; i < size; ++i) {
+      segments.Clear();
+      converter->StartConversion(&segments, sentences[i]);
+    }
+  }
+  stopwatch.Stop();
+  const double elapsed_usec = stopwatch.GetElapsedMicroseconds();
+  cout << "Converter::StartConversion: "
+       << Util::StringPrintf("%.1f usec/conversion, %.1f conversions/sec",
+                             elapsed_usec / (size * iterations),
+                             size * iterations * 1.0e6 / elapsed_usec)
+       << endl;
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  const mozc::testing::MockDataManager data_manager;
+  mozc::BenchmarkPOSMatcher(*data_manager.GetPOSMatcher());
+  mozc::BenchmarkCandidateFilter(data_manager);
+  mozc::BenchmarkConversion();
+  return 0;
+}
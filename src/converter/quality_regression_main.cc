@@ -27,42 +27,98 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+// Converts the items of a quality regression test file and prints
+// "OK:\t<item>" or "FAILED:\t<item>\t<actual value>" for each item in the
+// order of the file.  The file is read and converted in batches of
+// --batch_size items, and the items of a batch are converted in parallel on
+// --num_threads threads sharing one engine, so large files can be processed
+// with bounded memory.
+//
+// Usage:
+//   quality_regression_main --test_file=regression.tsv --num_threads=8
+
 #include <iostream>  // NOLINT
 #include <string>
 #include <vector>
 
+#include "base/file_stream.h"
 #include "base/flags.h"
+#include "base/logging.h"
 #include "base/scoped_ptr.h"
+#include "base/thread_pool.h"
 #include "base/util.h"
 #include "converter/quality_regression_util.h"
 #include "engine/engine_factory.h"
 #include "engine/engine_interface.h"
+#include "session/commands.pb.h"
 
 DEFINE_string(test_file, "", "regression test file");
+DEFINE_int32(num_threads, -1,
+             "The number of worker threads.  The main thread converts items "
+             "too.  If negative, the number of processors minus one is used.");
+DEFINE_int32(batch_size, 10000,
+             "The number of items read and converted at once.");
 
 using mozc::EngineFactory;
 using mozc::EngineInterface;
+using mozc::InputFileStream;
+using mozc::ThreadPool;
 using mozc::quality_regression::QualityRegressionUtil;
 
+namespace {
+
+void ConvertAndPrintBatch(
+    EngineInterface *engine, ThreadPool *pool,
+    const vector<QualityRegressionUtil::TestItem> &items) {
+  vector<QualityRegressionUtil::TestResult> results;
+  QualityRegressionUtil::ConvertAndTestInParallel(
+      engine->GetConverter(), mozc::commands::Request::default_instance(),
+      items, pool, &results);
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (results[i].passed) {
+      cout << "OK:\t" << items[i].OutputAsTSV() << endl;
+    } else {
+      cout << "FAILED:\t" << items[i].OutputAsTSV() << "\t"
+           << results[i].actual_value << endl;
+    }
+  }
+}
+
+}  // namespace
+
 int main(int argc, char **argv) {
   InitGoogle(argv[0], &argc, &argv, false);
 
+  CHECK_GT(FLAGS_batch_size, 0);
+  InputFileStream ifs(FLAGS_test_file.c_str());
+  if (!ifs.good()) {
+    LOG(ERROR) << "Cannot open: " << FLAGS_test_file;
+    return 1;
+  }
+
   scoped_ptr<EngineInterface> engine(EngineFactory::Create());
-  QualityRegressionUtil util(engine->GetConverter());
+  ThreadPool pool(FLAGS_num_threads < 0 ?
+                  ThreadPool::GetDefaultNumThreads() :
+                  static_cast<size_t>(FLAGS_num_threads));
 
   vector<QualityRegressionUtil::TestItem> items;
-  QualityRegressionUtil::ParseFile(FLAGS_test_file, &items);
-
-  for (size_t i = 0; i < items.size(); ++i) {
-    string actual_value;
-    const  bool result = util.ConvertAndTest(items[i], &actual_value);
-    if (result) {
-      cout << "OK:\t" << items[i].OutputAsTSV() << endl;
-    } else {
-      cout << "FAILED:\t" << items[i].OutputAsTSV() << "\t"
-           << actual_value << endl;
+  items.reserve(FLAGS_batch_size);
+  string line;
+  while (!getline(ifs, line).fail()) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    items.resize(items.size() + 1);
+    if (!items.back().ParseFromTSV(line)) {
+      LOG(ERROR) << "Cannot parse: " << line;
+      return 1;
+    }
+    if (items.size() == static_cast<size_t>(FLAGS_batch_size)) {
+      ConvertAndPrintBatch(engine.get(), &pool, items);
+      items.clear();
     }
   }
+  ConvertAndPrintBatch(engine.get(), &pool, items);
 
   return 0;
 }
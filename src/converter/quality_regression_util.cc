@@ -29,15 +29,17 @@
 
 #include "converter/quality_regression_util.h"
 
+#include <algorithm>
+#include <sstream>  // NOLINT
 #include <string>
 #include <vector>
-#include <sstream>  // NOLINT
 
 #include "base/file_stream.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/string_piece.h"
 #include "base/text_normalizer.h"
+#include "base/thread_pool.h"
 #include "base/util.h"
 #include "composer/composer.h"
 #include "composer/table.h"
@@ -113,6 +115,51 @@ uint32 GetPlatfromFromString(StringPiece str) {
   LOG(FATAL) << "Unknown platform name: " << str;
   return QualityRegressionUtil::DESKTOP;
 }
+
+// Converts the test items in [begin, end) sequentially.
+class ConvertAndTestTask : public ThreadPool::Task {
+ public:
+  ConvertAndTestTask()
+      : converter_(NULL), request_(NULL), items_(NULL), results_(NULL),
+        begin_(0), end_(0) {}
+
+  void Init(ConverterInterface *converter, const commands::Request *request,
+            const vector<QualityRegressionUtil::TestItem> *items,
+            vector<QualityRegressionUtil::TestResult> *results,
+            size_t begin, size_t end) {
+    converter_ = converter;
+    request_ = request;
+    items_ = items;
+    results_ = results;
+    begin_ = begin;
+    end_ = end;
+  }
+
+  virtual void Run() {
+    QualityRegressionUtil util(converter_);
+    util.SetRequest(*request_);
+    for (size_t i = begin_; i < end_; ++i) {
+      QualityRegressionUtil::TestResult *result = &(*results_)[i];
+      result->passed = util.ConvertAndTest((*items_)[i],
+                                           &result->actual_value);
+    }
+  }
+
+ private:
+  ConverterInterface *converter_;
+  const commands::Request *request_;
+  const vector<QualityRegressionUtil::TestItem> *items_;
+  vector<QualityRegressionUtil::TestResult> *results_;
+  size_t begin_;
+  size_t end_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConvertAndTestTask);
+};
+
+// The number of shards per thread.  Items take very different time to
+// convert, so the items are split into more shards than the threads to
+// balance the load.
+const size_t kShardsPerThread = 8;
 }   // namespace
 
 string QualityRegressionUtil::TestItem::OutputAsTSV() const {
@@ -252,6 +299,38 @@ bool QualityRegressionUtil::ConvertAndTest(const TestItem &item,
   return result;
 }
 
+// static
+void QualityRegressionUtil::ConvertAndTestInParallel(
+    ConverterInterface *converter, const commands::Request &request,
+    const vector<TestItem> &items, ThreadPool *pool,
+    vector<TestResult> *results) {
+  CHECK(converter);
+  CHECK(pool);
+  CHECK(results);
+  results->clear();
+  results->resize(items.size());
+  if (items.empty()) {
+    return;
+  }
+
+  // The thread calling Wait() executes the tasks as well.
+  const size_t num_shards =
+      min(items.size(), (pool->num_threads() + 1) * kShardsPerThread);
+  const size_t shard_size = (items.size() + num_shards - 1) / num_shards;
+  vector<ConvertAndTestTask> tasks(num_shards);
+  TaskGroup group(pool);
+  for (size_t i = 0; i < num_shards; ++i) {
+    const size_t begin = min(items.size(), i * shard_size);
+    const size_t end = min(items.size(), begin + shard_size);
+    if (begin == end) {
+      break;
+    }
+    tasks[i].Init(converter, &request, &items, results, begin, end);
+    group.Run(&tasks[i]);
+  }
+  group.Wait();
+}
+
 void QualityRegressionUtil::SetRequest(const commands::Request &request) {
   request_->CopyFrom(request);
 }
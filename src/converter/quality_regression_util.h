@@ -37,8 +37,9 @@
 #include "base/scoped_ptr.h"
 
 namespace mozc {
-class Segments;
 class ConverterInterface;
+class Segments;
+class ThreadPool;
 
 namespace commands {
 class Request;
@@ -70,6 +71,11 @@ class QualityRegressionUtil {
     bool ParseFromTSV(const string &tsv_line);
   };
 
+  struct TestResult {
+    bool passed;
+    string actual_value;
+  };
+
   explicit QualityRegressionUtil(ConverterInterface *converter);
   virtual ~QualityRegressionUtil();
 
@@ -80,6 +86,18 @@ class QualityRegressionUtil {
   bool ConvertAndTest(const TestItem &item,
                       string *actual_value);
 
+  // Runs ConvertAndTest() for |items| in parallel and stores the result of
+  // items[i] into (*results)[i].  |items| are split into shards executed as
+  // the tasks of |pool|, and each task converts its shard sequentially with
+  // its own QualityRegressionUtil.  So |converter| is shared by the threads
+  // and must be thread-safe like the converter of Engine.  |request| is set
+  // to all the QualityRegressionUtil instances.
+  static void ConvertAndTestInParallel(ConverterInterface *converter,
+                                       const commands::Request &request,
+                                       const vector<TestItem> &items,
+                                       ThreadPool *pool,
+                                       vector<TestResult> *results);
+
   void SetRequest(const commands::Request &request);
   static string GetPlatformString(uint32 platform_bitfiled);
 
@@ -0,0 +1,142 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "converter/quality_regression_util.h"
+
+#include <string>
+#include <vector>
+
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/system_util.h"
+#include "base/thread_pool.h"
+#include "base/util.h"
+#include "config/config.pb.h"
+#include "config/config_handler.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "session/commands.pb.h"
+#include "testing/base/public/gunit.h"
+
+DECLARE_string(test_tmpdir);
+
+namespace mozc {
+namespace quality_regression {
+namespace {
+
+class QualityRegressionUtilTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    SystemUtil::SetUserProfileDirectory(FLAGS_test_tmpdir);
+    config::Config config;
+    config::ConfigHandler::GetDefaultConfig(&config);
+    config::ConfigHandler::SetConfig(config);
+    engine_.reset(MockDataEngineFactory::Create());
+  }
+
+  virtual void TearDown() {
+    engine_.reset();
+    config::Config config;
+    config::ConfigHandler::GetDefaultConfig(&config);
+    config::ConfigHandler::SetConfig(config);
+  }
+
+  // Makes |size| items cycling over a few keys and commands.
+  static void MakeItems(size_t size,
+                        vector<QualityRegressionUtil::TestItem> *items) {
+    const char *kLines[] = {
+      // "わたしのなまえはなかのです" "私の名前は中野です"
+      "label\t"
+      "\xE3\x82\x8F\xE3\x81\x9F\xE3\x81\x97\xE3\x81\xAE\xE3\x81\xAA"
+      "\xE3\x81\xBE\xE3\x81\x88\xE3\x81\xAF\xE3\x81\xAA\xE3\x81\x8B"
+      "\xE3\x81\xAE\xE3\x81\xA7\xE3\x81\x99\t"
+      "\xE7\xA7\x81\xE3\x81\xAE\xE5\x90\x8D\xE5\x89\x8D\xE3\x81\xAF"
+      "\xE4\xB8\xAD\xE9\x87\x8E\xE3\x81\xA7\xE3\x81\x99\t"
+      "Conversion Expected\t0\t1.0",
+      // "きょう" "今日"
+      "label\t"
+      "\xE3\x81\x8D\xE3\x82\x87\xE3\x81\x86\t"
+      "\xE4\xBB\x8A\xE6\x97\xA5\t"
+      "Prediction Expected\t10\t1.0",
+      // "あいう" "愛"
+      "label\t"
+      "\xE3\x81\x82\xE3\x81\x84\xE3\x81\x86\t"
+      "\xE6\x84\x9B\t"
+      "Conversion Not Expected\t0\t1.0",
+    };
+    items->resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_TRUE((*items)[i].ParseFromTSV(kLines[i % arraysize(kLines)]));
+    }
+  }
+
+  scoped_ptr<EngineInterface> engine_;
+};
+
+TEST_F(QualityRegressionUtilTest, ConvertAndTestInParallel) {
+  vector<QualityRegressionUtil::TestItem> items;
+  MakeItems(50, &items);
+
+  QualityRegressionUtil util(engine_->GetConverter());
+  vector<QualityRegressionUtil::TestResult> expected(items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    expected[i].passed =
+        util.ConvertAndTest(items[i], &expected[i].actual_value);
+  }
+
+  for (size_t num_threads = 0; num_threads <= 2; ++num_threads) {
+    ThreadPool pool(num_threads);
+    vector<QualityRegressionUtil::TestResult> results;
+    QualityRegressionUtil::ConvertAndTestInParallel(
+        engine_->GetConverter(), commands::Request::default_instance(),
+        items, &pool, &results);
+    ASSERT_EQ(items.size(), results.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+      EXPECT_EQ(expected[i].passed, results[i].passed)
+          << num_threads << " threads, item " << i;
+      EXPECT_EQ(expected[i].actual_value, results[i].actual_value)
+          << num_threads << " threads, item " << i;
+    }
+  }
+}
+
+TEST_F(QualityRegressionUtilTest, ConvertAndTestInParallelWithNoItems) {
+  ThreadPool pool(1);
+  const vector<QualityRegressionUtil::TestItem> items;
+  vector<QualityRegressionUtil::TestResult> results(3);
+  QualityRegressionUtil::ConvertAndTestInParallel(
+      engine_->GetConverter(), commands::Request::default_instance(),
+      items, &pool, &results);
+  EXPECT_TRUE(results.empty());
+}
+
+}  // namespace
+}  // namespace quality_regression
+}  // namespace mozc
@@ -30,8 +30,10 @@
 #include "converter/segments.h"
 
 #include <algorithm>
+#include <set>
 #include <sstream>  // For DebugString()
 #include <string>
+#include <vector>
 
 #include "base/freelist.h"
 #include "base/logging.h"
@@ -271,7 +273,7 @@ size_t Segment::candidates_size() const {
 }
 
 void Segment::clear_candidates() {
-  pool_->Free();
+  pool_->Reset();
   candidates_.clear();
 }
 
@@ -421,6 +423,14 @@ void Segment::Clear() {
   segment_type_ = FREE;
 }
 
+void Segment::Shrink() {
+  pool_->Shrink();
+}
+
+size_t Segment::pool_chunk_count() const {
+  return pool_->chunk_count();
+}
+
 void Segment::CopyFrom(const Segment &src) {
   Clear();
 
@@ -623,8 +633,39 @@ void Segments::CopyFrom(const Segments &src) {
   }
 }
 
+void Segments::Shrink() {
+  pool_->Shrink();
+
+  // The pooled segments which are not in |segments_| still hold the
+  // candidates of their last use.  They are cleared so that their candidate
+  // pools are shrunk as idle ones.
+  vector<Segment *> pooled_segments;
+  pool_->GetAllObjects(&pooled_segments);
+  const set<const Segment *> live_segments(segments_.begin(), segments_.end());
+  for (size_t i = 0; i < pooled_segments.size(); ++i) {
+    Segment *segment = pooled_segments[i];
+    if (live_segments.find(segment) == live_segments.end()) {
+      segment->Clear();
+    }
+    segment->Shrink();
+  }
+
+  cached_lattice_->Shrink();
+}
+
+size_t Segments::pool_chunk_count() const {
+  size_t result = pool_->chunk_count();
+  vector<Segment *> pooled_segments;
+  pool_->GetAllObjects(&pooled_segments);
+  for (size_t i = 0; i < pooled_segments.size(); ++i) {
+    result += pooled_segments[i]->pool_chunk_count();
+  }
+  result += cached_lattice_->node_allocator()->chunk_count();
+  return result;
+}
+
 void Segments::clear_segments() {
-  pool_->Free();
+  pool_->Reset();
   resized_ = false;
   segments_.clear();
 }
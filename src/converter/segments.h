@@ -323,6 +323,11 @@ class Segment {
   void Clear();
   void CopyFrom(const Segment &src);
 
+  // Cleared candidates are kept in the pool for reuse.  Shrink() returns
+  // the pooled memory which has not been used since the last call.
+  void Shrink();
+  size_t pool_chunk_count() const;
+
   // Keep clear() method as other modules are still using the old method
   void clear() { Clear(); }
 
@@ -452,8 +457,22 @@ class Segments {
   void set_resized(bool resized);
 
   // clear segments
+  // The memory of the segments, their candidates and the cached lattice is
+  // kept and reused, so a Segments object living across conversions
+  // doesn't allocate once it has grown to the working size.
   void Clear();
 
+  // Returns the pooled memory which has not been used since the last call
+  // to the heap.  Calling this periodically bounds the memory held by an
+  // idle instance to its recent high-water mark.
+  void Shrink();
+
+  // Returns the number of chunks held by the segment pool, the candidate
+  // pools of the pooled segments and the cached lattice.  As cleared
+  // objects are reused, an increase of this value means that the
+  // operation in between allocated memory.
+  size_t pool_chunk_count() const;
+
   // Copy segments from src
   void CopyFrom(const Segments &src);
 
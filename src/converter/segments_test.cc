@@ -37,6 +37,7 @@
 #include "base/util.h"
 #include "config/config.pb.h"
 #include "config/config_handler.h"
+#include "converter/lattice.h"
 #include "testing/base/public/gunit.h"
 
 DECLARE_string(test_tmpdir);
@@ -455,6 +456,78 @@ TEST_F(SegmentsTest, CopyFromTest) {
   }
 }
 
+TEST_F(SegmentsTest, ClearKeepsPoolMemory) {
+  const int kSegmentsSize = 50;
+  const int kCandidatesSize = 40;
+  Segments segments;
+  for (int i = 0; i < kSegmentsSize; ++i) {
+    Segment *segment = segments.add_segment();
+    for (int j = 0; j < kCandidatesSize; ++j) {
+      segment->add_candidate()->value = "value";
+    }
+  }
+  const size_t chunk_count = segments.pool_chunk_count();
+
+  // Refilling the cleared segments reuses the pooled objects.
+  segments.Clear();
+  for (int i = 0; i < kSegmentsSize; ++i) {
+    Segment *segment = segments.add_segment();
+    EXPECT_EQ(0, segment->candidates_size());
+    for (int j = 0; j < kCandidatesSize; ++j) {
+      Segment::Candidate *candidate = segment->add_candidate();
+      EXPECT_TRUE(candidate->value.empty());
+    }
+  }
+  EXPECT_EQ(chunk_count, segments.pool_chunk_count());
+
+  // Shrink() doesn't touch the segments in use.
+  segments.Shrink();
+  EXPECT_EQ(chunk_count, segments.pool_chunk_count());
+  EXPECT_EQ(kSegmentsSize, segments.segments_size());
+  EXPECT_EQ(kCandidatesSize, segments.segment(0).candidates_size());
+
+  // Once idle, two Shrink() calls release all the memory.
+  segments.Clear();
+  segments.Shrink();
+  segments.Shrink();
+  EXPECT_EQ(0, segments.pool_chunk_count());
+}
+
+TEST_F(SegmentsTest, ShrinkAfterLongConversion) {
+  const int kSegmentsSize = 100;
+  const int kCandidatesSize = 200;
+  const int kNodesSize = 10000;
+  Segments segments;
+  for (int i = 0; i < kSegmentsSize; ++i) {
+    Segment *segment = segments.add_segment();
+    for (int j = 0; j < kCandidatesSize; ++j) {
+      segment->add_candidate()->value = "value";
+    }
+  }
+  for (int i = 0; i < kNodesSize; ++i) {
+    segments.mutable_cached_lattice()->NewNode();
+  }
+  EXPECT_LT(kSegmentsSize, segments.pool_chunk_count());
+
+  // The next input is short.  The segments released by Clear() keep their
+  // candidates until Shrink() clears them.
+  segments.Clear();
+  segments.mutable_cached_lattice()->Clear();
+  segments.add_segment()->add_candidate()->value = "value";
+  segments.Shrink();
+  segments.Shrink();
+  // One chunk for the segment pool and one for the candidates of the
+  // segment in use.
+  EXPECT_EQ(2, segments.pool_chunk_count());
+  EXPECT_EQ(1, segments.segments_size());
+  EXPECT_EQ("value", segments.segment(0).candidate(0).value);
+
+  segments.Clear();
+  segments.Shrink();
+  segments.Shrink();
+  EXPECT_EQ(0, segments.pool_chunk_count());
+}
+
 TEST_F(CandidateTest, functional_key) {
   Segment::Candidate candidate;
   candidate.Init();
@@ -54,17 +54,33 @@ DictionaryImpl::DictionaryImpl(
       system_dictionary_(system_dictionary),
       value_dictionary_(value_dictionary),
       user_dictionary_(user_dictionary),
+      owned_system_dictionary_(system_dictionary),
+      owned_value_dictionary_(value_dictionary),
       suppression_dictionary_(suppression_dictionary) {
   CHECK(pos_matcher_);
-  CHECK(system_dictionary_.get());
-  CHECK(value_dictionary_.get());
+  CHECK(system_dictionary_);
+  CHECK(value_dictionary_);
   CHECK(user_dictionary_);
   CHECK(suppression_dictionary_);
-  dics_.push_back(system_dictionary_.get());
-  dics_.push_back(value_dictionary_.get());
+  dics_.push_back(system_dictionary_);
+  dics_.push_back(value_dictionary_);
   dics_.push_back(user_dictionary_);
 }
 
+DictionaryImpl *DictionaryImpl::CreateWithSharedDictionaries(
+    const DictionaryInterface *system_dictionary,
+    const DictionaryInterface *value_dictionary,
+    DictionaryInterface *user_dictionary,
+    const SuppressionDictionary *suppression_dictionary,
+    const POSMatcher *pos_matcher) {
+  DictionaryImpl *dictionary = new DictionaryImpl(
+      system_dictionary, value_dictionary, user_dictionary,
+      suppression_dictionary, pos_matcher);
+  dictionary->owned_system_dictionary_.release();
+  dictionary->owned_value_dictionary_.release();
+  return dictionary;
+}
+
 DictionaryImpl::~DictionaryImpl() {
   dics_.clear();
 }
@@ -59,6 +59,16 @@ class DictionaryImpl : public DictionaryInterface {
                  const SuppressionDictionary *suppression_dictionary,
                  const POSMatcher *pos_matcher);
 
+  // Same as above, but doesn't take the ownership of the system and value
+  // dictionaries either, so that they can be shared by multiple instances.
+  // They must outlive the returned object.
+  static DictionaryImpl *CreateWithSharedDictionaries(
+      const DictionaryInterface *system_dictionary,
+      const DictionaryInterface *value_dictionary,
+      DictionaryInterface *user_dictionary,
+      const SuppressionDictionary *suppression_dictionary,
+      const POSMatcher *pos_matcher);
+
   virtual ~DictionaryImpl();
 
   virtual bool HasKey(StringPiece key) const;
@@ -89,10 +99,14 @@ class DictionaryImpl : public DictionaryInterface {
   const POSMatcher *pos_matcher_;
 
   // Main three dictionaries.
-  scoped_ptr<const DictionaryInterface> system_dictionary_;
-  scoped_ptr<const DictionaryInterface> value_dictionary_;
+  const DictionaryInterface *system_dictionary_;
+  const DictionaryInterface *value_dictionary_;
   DictionaryInterface *user_dictionary_;
 
+  // Set only when the system and value dictionaries are owned.
+  scoped_ptr<const DictionaryInterface> owned_system_dictionary_;
+  scoped_ptr<const DictionaryInterface> owned_value_dictionary_;
+
   // Convenient container to handle the above three dictionaries as one
   // composite dictionary.
   vector<const DictionaryInterface *> dics_;
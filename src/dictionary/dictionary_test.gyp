@@ -39,6 +39,7 @@
       'sources': [
         'dictionary_impl_test.cc',
         'dictionary_mock_test.cc',
+        'pos_matcher_test.cc',
         'suffix_dictionary_test.cc',
         'suppression_dictionary_test.cc',
         'user_dictionary_importer_test.cc',
@@ -85,6 +86,20 @@
         'test_size': 'small',
       },
     },
+    {
+      'target_name': 'user_dictionary_benchmark',
+      'type': 'executable',
+      'sources': [
+        'user_dictionary_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../data_manager/data_manager.gyp:user_pos_manager',
+        'dictionary_base.gyp:suppression_dictionary',
+        'dictionary_base.gyp:user_dictionary',
+        'dictionary_base.gyp:user_pos',
+      ],
+    },
     # Test cases meta target: this target is referred from gyp/tests.gyp
     {
       'target_name': 'dictionary_all_test',
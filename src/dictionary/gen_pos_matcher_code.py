@@ -107,11 +107,20 @@ def OutputPosMatcherHeader(pos_matcher, output):
   POSMatcher is independent of the actual input data but just provides logic
   for POS matching. To use a generated class, it's required to pass two arrays,
   kRuleIdTable[] and kRangeTables[], to the constructor of POSMatcher.
+
+  The constructor compiles kRangeTables[] into a dense table which has
+  kNumMaskWords 32-bit words per POS ID, one bit per rule, so that each
+  Is<RuleName>(uint16 id) is a single load-and-test. The table is built at
+  run time because the packed data manager only provides kRangeTables[].
   """
 
+  num_rules = len(pos_matcher.GetRuleNameList())
+  num_mask_words = max(1, (num_rules + 31) // 32)
+
   output.write(
       '#ifndef MOZC_DICTIONARY_POS_MATCHER_H_\n'
       '#define MOZC_DICTIONARY_POS_MATCHER_H_\n'
+      '#include <vector>\n'
       '#include "./base/port.h"\n'
       'namespace mozc {\n'
       'namespace dictionary {\n'
@@ -120,7 +129,10 @@ def OutputPosMatcherHeader(pos_matcher, output):
       '  struct Range {\n'
       '    uint16 lower;\n'
       '    uint16 upper;\n'
-      '  };\n')
+      '  };\n'
+      '  static const int kNumRules = %(num_rules)d;\n'
+      '  static const int kNumMaskWords = %(num_mask_words)d;\n'
+      % { 'num_rules': num_rules, 'num_mask_words': num_mask_words })
 
   # Helper function to generate Get<RuleName>Id() method from rule name and its
   # corresponding index.
@@ -130,18 +142,16 @@ def OutputPosMatcherHeader(pos_matcher, output):
             '  }' % { 'rule_name': rule_name, 'index': index })
 
   # Helper function to generate Is<RuleName>(uint16 id) method from rule name
-  # and its corresponding index. The generated function checks if the given id
-  # belongs to some range in kRangeTable[index] = kRangeTable_RuleName[].
+  # and its corresponding index. The generated function tests the bit of the
+  # rule in the mask table built from kRangeTable[index].
   def _GenerateIsMethod(rule_name, index):
     return ('  inline bool Is%(rule_name)s(uint16 id) const {\n'
-            '    for (const Range *range = range_table_[%(index)d];\n'
-            '         range->lower != static_cast<uint16>(0xFFFF); ++range) {\n'
-            '      if (id >= range->lower && id <= range->upper) {\n'
-            '        return true;\n'
-            '      }\n'
-            '    }\n'
-            '    return false;\n'
-            '  }' % { 'rule_name': rule_name, 'index': index })
+            '    return id < num_ids_ &&\n'
+            '        (mask_table_[id * kNumMaskWords + %(word)d] &\n'
+            '         0x%(bit)08Xu) != 0;\n'
+            '  }' % { 'rule_name': rule_name,
+                      'word': index // 32,
+                      'bit': 1 << (index % 32) })
 
   # Generate Get<RuleName>Id() and Is<RuleName>(uint16 id) for each rule.
   for i, rule_name in enumerate(pos_matcher.GetRuleNameList()):
@@ -161,10 +171,52 @@ def OutputPosMatcherHeader(pos_matcher, output):
       '  POSMatcher(const uint16 *const rule_id_table,\n'
       '             const Range *const *const range_table)\n'
       '      : rule_id_table_(rule_id_table),\n'
-      '        range_table_(range_table) {}\n'
+      '        range_table_(range_table),\n'
+      '        num_ids_(0) {\n'
+      '    BuildMaskTable();\n'
+      '  }\n'
+      '  // Same as Is<RuleName>(id) for the |rule_index|-th rule.\n'
+      '  inline bool Matches(int rule_index, uint16 id) const {\n'
+      '    return id < num_ids_ &&\n'
+      '        (mask_table_[id * kNumMaskWords + rule_index / 32] &\n'
+      '         (1u << (rule_index % 32))) != 0;\n'
+      '  }\n'
+      '  // Reference implementation of Matches() which scans the ranges.\n'
+      '  // Only for tests and benchmarks.\n'
+      '  bool MatchesByRangeScan(int rule_index, uint16 id) const {\n'
+      '    for (const Range *range = range_table_[rule_index];\n'
+      '         range->lower != static_cast<uint16>(0xFFFF); ++range) {\n'
+      '      if (id >= range->lower && id <= range->upper) {\n'
+      '        return true;\n'
+      '      }\n'
+      '    }\n'
+      '    return false;\n'
+      '  }\n'
       ' private:\n'
+      '  void BuildMaskTable() {\n'
+      '    for (int i = 0; i < kNumRules; ++i) {\n'
+      '      for (const Range *range = range_table_[i];\n'
+      '           range->lower != static_cast<uint16>(0xFFFF); ++range) {\n'
+      '        if (range->upper >= num_ids_) {\n'
+      '          num_ids_ = static_cast<uint32>(range->upper) + 1;\n'
+      '        }\n'
+      '      }\n'
+      '    }\n'
+      '    mask_table_.assign(num_ids_ * kNumMaskWords, 0);\n'
+      '    for (int i = 0; i < kNumRules; ++i) {\n'
+      '      for (const Range *range = range_table_[i];\n'
+      '           range->lower != static_cast<uint16>(0xFFFF); ++range) {\n'
+      '        for (uint32 id = range->lower; id <= range->upper; ++id) {\n'
+      '          mask_table_[id * kNumMaskWords + i / 32] |= 1u << (i % 32);\n'
+      '        }\n'
+      '      }\n'
+      '    }\n'
+      '  }\n'
       '  const uint16 *const rule_id_table_;\n'
       '  const Range *const *const range_table_;\n'
+      '  // One bit per rule for each POS ID in [0, num_ids_).\n'
+      '  uint32 num_ids_;\n'
+      '  vector<uint32> mask_table_;\n'
       '};\n'
       '}  // namespace dictionary\n'
       '}  // namespace mozc\n'
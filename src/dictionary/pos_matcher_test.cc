@@ -0,0 +1,95 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "dictionary/pos_matcher.h"
+
+#include <vector>
+
+#include "base/port.h"
+#include "data_manager/testing/mock_user_pos_manager.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace dictionary {
+namespace {
+
+TEST(POSMatcherTest, MaskTableMatchesRanges) {
+  // The i-th rule matches [10 * i, 10 * i + i] and 1000 + i.
+  vector<vector<POSMatcher::Range> > ranges(POSMatcher::kNumRules);
+  vector<const POSMatcher::Range *> range_table;
+  vector<uint16> rule_id_table;
+  for (int i = 0; i < POSMatcher::kNumRules; ++i) {
+    const POSMatcher::Range kRanges[] = {
+      { static_cast<uint16>(10 * i), static_cast<uint16>(10 * i + i) },
+      { static_cast<uint16>(1000 + i), static_cast<uint16>(1000 + i) },
+      { static_cast<uint16>(0xFFFF), static_cast<uint16>(0xFFFF) },
+    };
+    ranges[i].assign(kRanges, kRanges + arraysize(kRanges));
+    range_table.push_back(&ranges[i][0]);
+    rule_id_table.push_back(static_cast<uint16>(10 * i));
+  }
+  range_table.push_back(NULL);
+  rule_id_table.push_back(static_cast<uint16>(0xFFFF));
+
+  const POSMatcher matcher(&rule_id_table[0], &range_table[0]);
+  for (int i = 0; i < POSMatcher::kNumRules; ++i) {
+    for (int id = 0; id < 2000; ++id) {
+      const bool expected = (10 * i <= id && id <= 10 * i + i) ||
+                            id == 1000 + i;
+      EXPECT_EQ(expected, matcher.Matches(i, static_cast<uint16>(id)))
+          << "rule: " << i << " id: " << id;
+      EXPECT_EQ(expected,
+                matcher.MatchesByRangeScan(i, static_cast<uint16>(id)));
+    }
+    // IDs beyond the table never match.
+    EXPECT_FALSE(matcher.Matches(i, static_cast<uint16>(0xFFFE)));
+  }
+  // The generated predicates are bound to the rules in the declared order.
+  EXPECT_TRUE(matcher.IsFunctional(matcher.GetFunctionalId()));
+  EXPECT_FALSE(matcher.IsFunctional(matcher.GetUnknownId()));
+}
+
+TEST(POSMatcherTest, ConsistentWithRangeScanOnRealData) {
+  const testing::MockUserPosManager user_pos_manager;
+  const POSMatcher *matcher = user_pos_manager.GetPOSMatcher();
+  for (int i = 0; i < POSMatcher::kNumRules; ++i) {
+    for (uint32 id = 0; id <= 0xFFFF; ++id) {
+      ASSERT_EQ(matcher->MatchesByRangeScan(i, static_cast<uint16>(id)),
+                matcher->Matches(i, static_cast<uint16>(id)))
+          << "rule: " << i << " id: " << id;
+    }
+  }
+  EXPECT_TRUE(matcher->IsZipcode(matcher->GetZipcodeId()));
+  EXPECT_TRUE(matcher->IsNumber(matcher->GetNumberId()));
+}
+
+}  // namespace
+}  // namespace dictionary
+}  // namespace mozc
@@ -76,6 +76,7 @@ const char kKeySectionName[] = "k";
 const char kValueSectionName[] = "v";
 const char kTokensSectionName[] = "t";
 const char kPosSectionName[] = "p";
+const char kReverseLookupIndexSectionName[] = "r";
 
 //// Constants for validation ////
 // 12 bits
@@ -213,6 +214,11 @@ const string SystemDictionaryCodec::GetSectionNameForPos() const {
   return kPosSectionName;
 }
 
+const string
+SystemDictionaryCodec::GetSectionNameForReverseLookupIndex() const {
+  return kReverseLookupIndexSectionName;
+}
+
 void SystemDictionaryCodec::EncodeKey(
     const StringPiece src, string *dst) const {
   EncodeDecodeKeyImpl(src, dst);
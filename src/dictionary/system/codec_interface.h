@@ -60,6 +60,9 @@ class SystemDictionaryCodecInterface {
   // Return section name for frequent pos map
   virtual const string GetSectionNameForPos() const = 0;
 
+  // Return section name for prebuilt reverse lookup index
+  virtual const string GetSectionNameForReverseLookupIndex() const = 0;
+
   // Encode value(word) string
   virtual void EncodeValue(const StringPiece src, string *dst) const = 0;
 
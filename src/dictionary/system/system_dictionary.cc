@@ -43,6 +43,10 @@
 //       Frequenty appearing POSs are stored as POS ids in token info for
 //       reducing binary size. This table is the map from the id to the
 //       actual ids.
+//  (5) Reverse lookup index (optional)
+//       Map from the id in value trie to the ids in key trie of the tokens
+//       having the value. Used in place for reverse lookup instead of
+//       scanning token array.
 
 #include "dictionary/system/system_dictionary.h"
 
@@ -430,94 +434,125 @@ class SystemDictionary::ReverseLookupCache {
   DISALLOW_COPY_AND_ASSIGN(ReverseLookupCache);
 };
 
+// Index from value id to the ids in key trie of the tokens having the value.
+// The index is an array of uint32 laid out as follows:
+//   [0]                : number of value ids (N)
+//   [1, N + 1]         : begin position of the key ids for each value id,
+//                        followed by the total number of key ids (M)
+//   [N + 2, N + 2 + M) : key ids
+// A key id appears once for each token having the value, in the order of the
+// token array scan. SystemDictionaryBuilder writes the same image to the
+// reverse lookup index section, which is used without copying when available.
 class SystemDictionary::ReverseLookupIndex {
  public:
+  // Builds the index by scanning the token array.
   ReverseLookupIndex(
       const SystemDictionaryCodecInterface *codec,
-      const BitVectorBasedArray &token_array) {
-    // Gets id size.
-    int value_id_max = -1;
-    for (TokenScanIterator iter(codec, token_array);
-         !iter.Done(); iter.Next()) {
-      const TokenScanIterator::Result &result = iter.Get();
-      value_id_max = max(value_id_max, result.value_id);
-    }
-
-    CHECK_GE(value_id_max, 0);
-    index_size_ = value_id_max + 1;
-    index_.reset(new ReverseLookupResultArray[index_size_]);
-
+      const BitVectorBasedArray &token_array)
+      : token_array_(token_array) {
     // Gets result size for each ids.
+    vector<uint32> counts;
     for (TokenScanIterator iter(codec, token_array);
          !iter.Done(); iter.Next()) {
       const TokenScanIterator::Result &result = iter.Get();
-      if (result.value_id != -1) {
-        DCHECK_LT(result.value_id, index_size_);
-        ++(index_[result.value_id].size);
+      if (result.value_id == -1) {
+        continue;
+      }
+      if (static_cast<size_t>(result.value_id) >= counts.size()) {
+        counts.resize(result.value_id + 1, 0);
       }
+      ++counts[result.value_id];
     }
-
-    for (size_t i = 0; i < index_size_; ++i) {
-      index_[i].results.reset(new ReverseLookupResult[index_[i].size]);
+    CHECK(!counts.empty());
+
+    const size_t num_value_ids = counts.size();
+    buffer_.resize(num_value_ids + 2);
+    buffer_[0] = num_value_ids;
+    uint32 total = 0;
+    for (size_t i = 0; i < num_value_ids; ++i) {
+      buffer_[i + 1] = total;
+      // Reuses |counts| as the next position to fill for each value id.
+      const uint32 count = counts[i];
+      counts[i] = total;
+      total += count;
     }
+    buffer_[num_value_ids + 1] = total;
+    buffer_.resize(num_value_ids + 2 + total);
 
     // Builds index.
+    uint32 *key_ids = &buffer_[num_value_ids + 2];
     for (TokenScanIterator iter(codec, token_array);
          !iter.Done(); iter.Next()) {
       const TokenScanIterator::Result &result = iter.Get();
-      if (result.value_id == -1) {
-        continue;
-      }
-
-      DCHECK_LT(result.value_id, index_size_);
-      ReverseLookupResultArray *result_array = &index_[result.value_id];
-
-      // Finds uninitialized result.
-      size_t result_index = 0;
-      for (result_index = 0;
-           result_index < result_array->size;
-           ++result_index) {
-        const ReverseLookupResult &lookup_result =
-            result_array->results[result_index];
-        if (lookup_result.tokens_offset == -1 &&
-            lookup_result.id_in_key_trie == -1) {
-          result_array->results[result_index].tokens_offset =
-              result.tokens_offset;
-          result_array->results[result_index].id_in_key_trie = result.index;
-          break;
-        }
+      if (result.value_id != -1) {
+        key_ids[counts[result.value_id]++] = result.index;
       }
     }
 
-    CHECK(index_.get() != NULL);
+    Init(&buffer_[0]);
+  }
+
+  // Uses |image| in place. |image| must outlive this instance.
+  ReverseLookupIndex(const uint32 *image,
+                     const BitVectorBasedArray &token_array)
+      : token_array_(token_array) {
+    Init(image);
   }
 
   ~ReverseLookupIndex() {}
 
+  // Returns true if |image| of |len| bytes is a well-formed index.
+  static bool IsValidImage(const char *image, int len) {
+    if (image == NULL || len < static_cast<int>(sizeof(uint32)) * 2 ||
+        len % sizeof(uint32) != 0) {
+      return false;
+    }
+    const uint32 *words = reinterpret_cast<const uint32 *>(image);
+    const size_t num_words = len / sizeof(uint32);
+    const size_t num_value_ids = words[0];
+    if (num_value_ids + 2 > num_words ||
+        num_value_ids + 2 + words[num_value_ids + 1] != num_words) {
+      return false;
+    }
+    for (size_t i = 1; i <= num_value_ids; ++i) {
+      if (words[i] > words[i + 1]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   void FillResultMap(const set<int> &id_set,
                      multimap<int, ReverseLookupResult> *result_map) {
+    const uint8 *encoded_tokens_ptr = GetTokenArrayPtr(token_array_, 0);
     for (set<int>::const_iterator id_itr  = id_set.begin();
          id_itr != id_set.end(); ++id_itr) {
-      const ReverseLookupResultArray &result_array = index_[*id_itr];
-      for (size_t i = 0; i < result_array.size; ++i) {
-        result_map->insert(make_pair(*id_itr, result_array.results[i]));
+      if (*id_itr < 0 || static_cast<size_t>(*id_itr) >= num_value_ids_) {
+        continue;
+      }
+      for (uint32 i = begins_[*id_itr]; i < begins_[*id_itr + 1]; ++i) {
+        ReverseLookupResult result;
+        result.id_in_key_trie = key_ids_[i];
+        result.tokens_offset =
+            GetTokenArrayPtr(token_array_, key_ids_[i]) - encoded_tokens_ptr;
+        result_map->insert(make_pair(*id_itr, result));
       }
     }
   }
 
  private:
-  struct ReverseLookupResultArray {
-    ReverseLookupResultArray() : size(0) {}
-    // Use scoped_ptr for reducing memory consumption as possible.
-    // Using vector requires 90 MB even when we call resize explicitly.
-    // On the other hand, scoped_ptr requires 57 MB.
-    scoped_ptr<ReverseLookupResult[]> results;
-    size_t size;
-  };
+  void Init(const uint32 *image) {
+    num_value_ids_ = image[0];
+    begins_ = image + 1;
+    key_ids_ = image + num_value_ids_ + 2;
+  }
 
-  // Use scoped array for reducing memory consumption as possible.
-  scoped_ptr<ReverseLookupResultArray[]> index_;
-  size_t index_size_;
+  const BitVectorBasedArray &token_array_;
+  // Owns the image when the index is built at runtime; empty otherwise.
+  vector<uint32> buffer_;
+  size_t num_value_ids_;
+  const uint32 *begins_;
+  const uint32 *key_ids_;
 
   DISALLOW_COPY_AND_ASSIGN(ReverseLookupIndex);
 };
@@ -655,6 +690,20 @@ bool SystemDictionary::OpenDictionaryFile(bool enable_reverse_lookup_index) {
     return false;
   }
 
+  // The prebuilt index costs nothing to open, so use it regardless of
+  // |enable_reverse_lookup_index|. Older dictionaries don't have it.
+  const char *reverse_lookup_index_image = dictionary_file_->GetSection(
+      codec_->GetSectionNameForReverseLookupIndex(), &len);
+  if (reverse_lookup_index_image != NULL) {
+    if (ReverseLookupIndex::IsValidImage(reverse_lookup_index_image, len)) {
+      reverse_lookup_index_.reset(new ReverseLookupIndex(
+          reinterpret_cast<const uint32 *>(reverse_lookup_index_image),
+          token_array_));
+    } else {
+      LOG(ERROR) << "Broken reverse lookup index section. Ignored.";
+    }
+  }
+
   if (enable_reverse_lookup_index) {
     InitReverseLookupIndex();
   }
@@ -1187,8 +1236,8 @@ void SystemDictionary::PopulateReverseLookupCache(StringPiece str) const {
     // as we have already built the index for reverse lookup.
     return;
   }
-  reverse_lookup_cache_.reset(new ReverseLookupCache);
-  DCHECK(reverse_lookup_cache_.get());
+  scoped_ptr<ReverseLookupCache> cache(new ReverseLookupCache);
+  DCHECK(cache.get());
 
   // Iterate each suffix and collect IDs of all substrings.
   set<int> id_set;
@@ -1202,11 +1251,16 @@ void SystemDictionary::PopulateReverseLookupCache(StringPiece str) const {
     AddKeyIdsOfAllPrefixes(value_trie_, lookup_key, &id_set);
     pos += Util::OneCharLen(suffix.data());
   }
-  // Collect tokens for all IDs.
-  ScanTokens(id_set, reverse_lookup_cache_.get());
+  // Collect tokens for all IDs.  The scan is done outside of the lock as it
+  // walks through the whole token array.
+  ScanTokens(id_set, cache.get());
+
+  scoped_lock lock(&reverse_lookup_cache_mutex_);
+  reverse_lookup_cache_.swap(cache);
 }
 
 void SystemDictionary::ClearReverseLookupCache() const {
+  scoped_lock lock(&reverse_lookup_cache_mutex_);
   reverse_lookup_cache_.reset(NULL);
 }
 
@@ -1260,22 +1314,25 @@ void SystemDictionary::RegisterReverseLookupTokensForValue(
   set<int> id_set;
   AddKeyIdsOfAllPrefixes(value_trie_, lookup_key, &id_set);
 
-  ReverseLookupCache *results = NULL;
   ReverseLookupCache non_cached_results;
   if (reverse_lookup_index_ != NULL) {
     reverse_lookup_index_->FillResultMap(id_set, &non_cached_results.results);
-    results = &non_cached_results;
-  } else if (reverse_lookup_cache_.get() != NULL &&
-             reverse_lookup_cache_->IsAvailable(id_set)) {
-    results = reverse_lookup_cache_.get();
-  } else {
-    // Cache is not available. Get token for each ID.
-    ScanTokens(id_set, &non_cached_results);
-    results = &non_cached_results;
+    RegisterReverseLookupResults(id_set, non_cached_results, callback);
+    return;
+  }
+
+  {
+    scoped_lock lock(&reverse_lookup_cache_mutex_);
+    if (reverse_lookup_cache_.get() != NULL &&
+        reverse_lookup_cache_->IsAvailable(id_set)) {
+      RegisterReverseLookupResults(id_set, *reverse_lookup_cache_, callback);
+      return;
+    }
   }
-  DCHECK(results != NULL);
 
-  RegisterReverseLookupResults(id_set, *results, callback);
+  // Cache is not available. Get token for each ID.
+  ScanTokens(id_set, &non_cached_results);
+  RegisterReverseLookupResults(id_set, non_cached_results, callback);
 }
 
 void SystemDictionary::ScanTokens(
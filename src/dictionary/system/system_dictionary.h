@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 
+#include "base/mutex.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
 #include "base/string_piece.h"
@@ -58,6 +59,8 @@ class SystemDictionary : public DictionaryInterface {
     // If ENABLE_REVERSE_LOOKUP_INDEX is set, we will have the index in heap
     // from the id in value trie to the id in key trie.
     // That consumes more memory but we can perform reverse lookup more quickly.
+    // This option has no effect when the dictionary file has the prebuilt
+    // reverse lookup index section, which is always used.
     ENABLE_REVERSE_LOOKUP_INDEX = 1,
   };
 
@@ -152,6 +155,10 @@ class SystemDictionary : public DictionaryInterface {
   const SystemDictionaryCodecInterface *codec_;
   KeyExpansionTable hiragana_expansion_table_;
   scoped_ptr<DictionaryFile> dictionary_file_;
+  // The reverse lookup cache is the only mutable state of this class.  It is
+  // guarded by |reverse_lookup_cache_mutex_| so that the dictionary can be
+  // shared by sessions running on different threads.
+  mutable Mutex reverse_lookup_cache_mutex_;
   mutable scoped_ptr<ReverseLookupCache> reverse_lookup_cache_;
   scoped_ptr<ReverseLookupIndex> reverse_lookup_index_;
 
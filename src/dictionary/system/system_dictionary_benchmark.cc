@@ -27,5 +27,199 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+
 // small benchmark code to measure incremental input and reverse conversion
 // performance.
+//
+// Builds two system dictionaries from the same source, with and without the
+// prebuilt reverse lookup index section, and measures
+//  - the time to open the dictionary, including building the reverse lookup
+//    index in heap when ENABLE_REVERSE_LOOKUP_INDEX is given,
+//  - reverse lookup by scanning the token array, with the heap index and with
+//    the prebuilt index section,
+//  - prefix and predictive lookup for each prefix of the keys, which emulates
+//    incremental input.
+//
+// Usage:
+//   system_dictionary_benchmark --dictionary_source=<dictionary00.txt>
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+#include "data_manager/user_pos_manager.h"
+#include "dictionary/dictionary_interface.h"
+#include "dictionary/dictionary_token.h"
+#include "dictionary/system/system_dictionary.h"
+#include "dictionary/system/system_dictionary_builder.h"
+#include "dictionary/text_dictionary_loader.h"
+
+DEFINE_string(dictionary_source, "data/dictionary_oss/dictionary00.txt",
+              "source dictionary file.");
+DEFINE_string(output_dir, "", "directory to write the built dictionaries.");
+DEFINE_int32(dictionary_size, 0,
+             "number of tokens to use. Uses all the tokens if 0.");
+DEFINE_int32(num_reverse_lookups, 10000,
+             "number of values to look up with the index.");
+DEFINE_int32(num_reverse_lookups_by_scan, 100,
+             "number of values to look up by scanning the token array.");
+DEFINE_int32(num_incremental_keys, 1000,
+             "number of keys to look up incrementally.");
+DECLARE_bool(build_reverse_lookup_index);
+
+namespace mozc {
+namespace dictionary {
+namespace {
+
+class CountingCallback : public DictionaryInterface::Callback {
+ public:
+  CountingCallback() : num_tokens_(0) {}
+
+  virtual ResultType OnToken(StringPiece key, StringPiece actual_key,
+                             const Token &token) {
+    ++num_tokens_;
+    return TRAVERSE_CONTINUE;
+  }
+
+  size_t num_tokens() const { return num_tokens_; }
+
+ private:
+  size_t num_tokens_;
+};
+
+void Report(const string &name, double elapsed_usec, size_t calls) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f msec total, %.3f usec/call (%d calls)",
+                             elapsed_usec / 1000.0,
+                             calls == 0 ? 0.0 : elapsed_usec / calls,
+                             static_cast<int>(calls))
+       << endl;
+}
+
+void BuildDictionary(const vector<Token *> &tokens, bool with_index,
+                     const string &filename) {
+  const bool original_flag = FLAGS_build_reverse_lookup_index;
+  FLAGS_build_reverse_lookup_index = with_index;
+  SystemDictionaryBuilder builder;
+  builder.BuildFromTokens(tokens);
+  builder.WriteToFile(filename);
+  FLAGS_build_reverse_lookup_index = original_flag;
+}
+
+SystemDictionary *OpenDictionary(const string &name, const string &filename,
+                                 SystemDictionary::Options options) {
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  SystemDictionary *dictionary =
+      SystemDictionary::Builder(filename).SetOptions(options).Build();
+  stopwatch.Stop();
+  CHECK(dictionary) << "Failed to open " << filename;
+  Report("Open (" + name + ")", stopwatch.GetElapsedMicroseconds(), 1);
+  return dictionary;
+}
+
+void BenchmarkLookupReverse(const string &name,
+                            const SystemDictionary &dictionary,
+                            const vector<Token *> &tokens, int size) {
+  CountingCallback callback;
+  size_t calls = 0;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (size_t i = 0;
+       i < tokens.size() && calls < static_cast<size_t>(size);
+       ++i, ++calls) {
+    dictionary.LookupReverse(tokens[i]->value, &callback);
+  }
+  stopwatch.Stop();
+  Report("LookupReverse (" + name + ")", stopwatch.GetElapsedMicroseconds(),
+         calls);
+  VLOG(1) << "tokens: " << callback.num_tokens();
+}
+
+void BenchmarkIncrementalInput(const SystemDictionary &dictionary,
+                               const vector<Token *> &tokens) {
+  CountingCallback callback;
+  size_t calls = 0;
+  Stopwatch stopwatch = Stopwatch::StartNew();
+  for (size_t i = 0;
+       i < tokens.size() &&
+           i < static_cast<size_t>(FLAGS_num_incremental_keys);
+       ++i) {
+    const string &key = tokens[i]->key;
+    for (size_t len = Util::OneCharLen(key.c_str()); len <= key.size();
+         len += Util::OneCharLen(key.c_str() + len)) {
+      const StringPiece prefix(key.data(), len);
+      dictionary.LookupPrefix(prefix, false, &callback);
+      dictionary.LookupPredictive(prefix, false, &callback);
+      ++calls;
+      if (len == key.size()) {
+        break;
+      }
+    }
+  }
+  stopwatch.Stop();
+  Report("LookupPrefix + LookupPredictive",
+         stopwatch.GetElapsedMicroseconds(), calls);
+  VLOG(1) << "tokens: " << callback.num_tokens();
+}
+
+}  // namespace
+}  // namespace dictionary
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  using mozc::dictionary::SystemDictionary;
+  using mozc::dictionary::TextDictionaryLoader;
+  using mozc::dictionary::Token;
+
+  TextDictionaryLoader loader(
+      *mozc::UserPosManager::GetUserPosManager()->GetPOSMatcher());
+  if (FLAGS_dictionary_size > 0) {
+    loader.LoadWithLineLimit(FLAGS_dictionary_source, "",
+                             FLAGS_dictionary_size);
+  } else {
+    loader.Load(FLAGS_dictionary_source, "");
+  }
+  const vector<Token *> &tokens = loader.tokens();
+  CHECK(!tokens.empty()) << "No tokens in " << FLAGS_dictionary_source;
+  cout << "Tokens: " << tokens.size() << endl;
+
+  const string output_dir = FLAGS_output_dir.empty() ?
+      mozc::FileUtil::Dirname(argv[0]) : FLAGS_output_dir;
+  const string without_index_file =
+      mozc::FileUtil::JoinPath(output_dir, "system_dictionary_no_index.dic");
+  const string with_index_file =
+      mozc::FileUtil::JoinPath(output_dir, "system_dictionary_index.dic");
+  mozc::dictionary::BuildDictionary(tokens, false, without_index_file);
+  mozc::dictionary::BuildDictionary(tokens, true, with_index_file);
+
+  scoped_ptr<SystemDictionary> scan(mozc::dictionary::OpenDictionary(
+      "scan", without_index_file, SystemDictionary::NONE));
+  scoped_ptr<SystemDictionary> heap_index(mozc::dictionary::OpenDictionary(
+      "heap index", without_index_file,
+      SystemDictionary::ENABLE_REVERSE_LOOKUP_INDEX));
+  scoped_ptr<SystemDictionary> prebuilt_index(
+      mozc::dictionary::OpenDictionary(
+          "prebuilt index", with_index_file,
+          SystemDictionary::ENABLE_REVERSE_LOOKUP_INDEX));
+
+  mozc::dictionary::BenchmarkLookupReverse(
+      "scan", *scan, tokens, FLAGS_num_reverse_lookups_by_scan);
+  mozc::dictionary::BenchmarkLookupReverse(
+      "heap index", *heap_index, tokens, FLAGS_num_reverse_lookups);
+  mozc::dictionary::BenchmarkLookupReverse(
+      "prebuilt index", *prebuilt_index, tokens, FLAGS_num_reverse_lookups);
+
+  mozc::dictionary::BenchmarkIncrementalInput(*prebuilt_index, tokens);
+
+  mozc::FileUtil::Unlink(without_index_file);
+  mozc::FileUtil::Unlink(with_index_file);
+  return 0;
+}
@@ -53,6 +53,8 @@ DEFINE_bool(preserve_intermediate_dictionary, false,
             "preserve inetemediate dictionary file.");
 DEFINE_int32(min_key_length_to_use_small_cost_encoding, 6,
              "minimum key length to use 1 byte cost encoding.");
+DEFINE_bool(build_reverse_lookup_index, true,
+            "write prebuilt reverse lookup index section.");
 
 namespace mozc {
 namespace dictionary {
@@ -62,6 +64,11 @@ using mozc::storage::louds::BitVectorBasedArrayBuilder;
 
 namespace {
 
+struct ReverseLookupEntry {
+  int value_id;
+  uint32 id_in_key_trie;
+};
+
 struct TokenGreaterThan {
   inline bool operator()(const TokenInfo& lhs,
                          const TokenInfo& rhs) const {
@@ -161,6 +168,15 @@ void SystemDictionaryBuilder::WriteToStream(
     file_codec->GetSectionName(codec_->GetSectionNameForPos()));
   sections.push_back(frequent_pos_section);
 
+  if (!reverse_lookup_index_.empty()) {
+    DictionaryFileSection reverse_lookup_index_section(
+      reinterpret_cast<const char *>(&reverse_lookup_index_[0]),
+      reverse_lookup_index_.size() * sizeof(reverse_lookup_index_[0]),
+      file_codec->GetSectionName(
+          codec_->GetSectionNameForReverseLookupIndex()));
+    sections.push_back(reverse_lookup_index_section);
+  }
+
   if (FLAGS_preserve_intermediate_dictionary &&
       !intermediate_output_file_base_path.empty()) {
     // Write out intermediate results to files.
@@ -170,6 +186,9 @@ void SystemDictionaryBuilder::WriteToStream(
     WriteSectionToFile(key_trie_section, basepath + ".key");
     WriteSectionToFile(token_array_section, basepath + ".tokens");
     WriteSectionToFile(frequent_pos_section, basepath + ".freq_pos");
+    if (!reverse_lookup_index_.empty()) {
+      WriteSectionToFile(sections.back(), basepath + ".reverse_index");
+    }
   }
 
   LOG(INFO) << "Start writing dictionary file.";
@@ -442,6 +461,7 @@ void SystemDictionaryBuilder::BuildTokenArray(
   // Here we make a reverse lookup table as follows:
   //   |key_info_list[X].id_in_key_trie| -> |key_info_list[X]|
   // assuming |key_info_list[X].id_in_key_trie| is unique and successive.
+  vector<string> encoded_tokens_list(key_info_list.size());
   {
     vector<const KeyInfo *> id_to_keyinfo_table;
     id_to_keyinfo_table.resize(key_info_list.size());
@@ -454,14 +474,69 @@ void SystemDictionaryBuilder::BuildTokenArray(
 
     for (size_t i = 0; i < id_to_keyinfo_table.size(); ++i) {
       const KeyInfo &key_info = *id_to_keyinfo_table[i];
-      string tokens_str;
-      codec_->EncodeTokens(key_info.tokens, &tokens_str);
-      token_array_builder_->Add(tokens_str);
+      codec_->EncodeTokens(key_info.tokens, &encoded_tokens_list[i]);
+      token_array_builder_->Add(encoded_tokens_list[i]);
     }
   }
 
   token_array_builder_->Add(string(1, codec_->GetTokensTerminationFlag()));
   token_array_builder_->Build();
+
+  if (FLAGS_build_reverse_lookup_index) {
+    BuildReverseLookupIndex(encoded_tokens_list);
+  }
+}
+
+void SystemDictionaryBuilder::BuildReverseLookupIndex(
+    const vector<string> &encoded_tokens_list) {
+  // Reads the value id of each token in the same way as the token scan of
+  // SystemDictionary, so that the index has the identical results.
+  vector<ReverseLookupEntry> entries;
+  vector<uint32> counts;
+  for (size_t i = 0; i < encoded_tokens_list.size(); ++i) {
+    const string &tokens_str = encoded_tokens_list[i];
+    const uint8 *ptr = reinterpret_cast<const uint8 *>(tokens_str.data());
+    size_t offset = 0;
+    bool has_next = true;
+    while (has_next) {
+      ReverseLookupEntry entry;
+      int read_bytes = 0;
+      has_next = codec_->ReadTokenForReverseLookup(
+          ptr + offset, &entry.value_id, &read_bytes);
+      offset += read_bytes;
+      if (entry.value_id == -1) {
+        continue;
+      }
+      entry.id_in_key_trie = i;
+      entries.push_back(entry);
+      if (static_cast<size_t>(entry.value_id) >= counts.size()) {
+        counts.resize(entry.value_id + 1, 0);
+      }
+      ++counts[entry.value_id];
+    }
+    DCHECK_EQ(tokens_str.size(), offset);
+  }
+
+  // Layout: [num_value_ids][begin of each value id + 1 sentinel][key ids]
+  const size_t num_value_ids = counts.size();
+  reverse_lookup_index_.assign(num_value_ids + 2 + entries.size(), 0);
+  reverse_lookup_index_[0] = num_value_ids;
+  uint32 total = 0;
+  for (size_t i = 0; i < num_value_ids; ++i) {
+    reverse_lookup_index_[i + 1] = total;
+    // Reuses |counts| as the next position to fill for each value id.
+    const uint32 count = counts[i];
+    counts[i] = total;
+    total += count;
+  }
+  reverse_lookup_index_[num_value_ids + 1] = total;
+
+  uint32 *key_ids = &reverse_lookup_index_[num_value_ids + 2];
+  for (size_t i = 0; i < entries.size(); ++i) {
+    key_ids[counts[entries[i].value_id]++] = entries[i].id_in_key_trie;
+  }
+  VLOG(1) << "Reverse lookup index: " << num_value_ids << " values, "
+          << entries.size() << " tokens";
 }
 
 }  // namespace dictionary
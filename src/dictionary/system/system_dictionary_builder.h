@@ -87,6 +87,10 @@ class SystemDictionaryBuilder {
 
   void BuildTokenArray(const KeyInfoList &key_info_list);
 
+  // Builds the value id -> key id index from the encoded tokens of each key,
+  // which are given in the order of key id.
+  void BuildReverseLookupIndex(const vector<string> &encoded_tokens_list);
+
   void SetIdForValue(KeyInfoList *key_info_list) const;
   void SetIdForKey(KeyInfoList *key_info_list) const;
   void SortTokenInfo(KeyInfoList *key_info_list) const;
@@ -103,6 +107,10 @@ class SystemDictionaryBuilder {
   // mapping from {left_id, right_id} to POS index (0--255)
   map<uint32, int> frequent_pos_;
 
+  // Image of the reverse lookup index section. Empty if the section is not
+  // built. See SystemDictionary::ReverseLookupIndex for the layout.
+  vector<uint32> reverse_lookup_index_;
+
   const SystemDictionaryCodecInterface *codec_;
 
   DISALLOW_COPY_AND_ASSIGN(SystemDictionaryBuilder);
@@ -78,6 +78,7 @@ DEFINE_int32(dictionary_reverse_lookup_test_size, kDefaultReverseLookupTestSize,
 DECLARE_string(test_srcdir);
 DECLARE_string(test_tmpdir);
 DECLARE_int32(min_key_length_to_use_small_cost_encoding);
+DECLARE_bool(build_reverse_lookup_index);
 
 namespace mozc {
 namespace dictionary {
@@ -107,11 +108,16 @@ class SystemDictionaryTest : public testing::Test {
     original_flags_min_key_length_to_use_small_cost_encoding_ =
         FLAGS_min_key_length_to_use_small_cost_encoding;
     FLAGS_min_key_length_to_use_small_cost_encoding = kint32max;
+
+    original_flags_build_reverse_lookup_index_ =
+        FLAGS_build_reverse_lookup_index;
   }
 
   virtual void TearDown() {
     FLAGS_min_key_length_to_use_small_cost_encoding =
         original_flags_min_key_length_to_use_small_cost_encoding_;
+    FLAGS_build_reverse_lookup_index =
+        original_flags_build_reverse_lookup_index_;
   }
 
   void BuildSystemDictionary(const vector <Token *>& tokens,
@@ -123,6 +129,7 @@ class SystemDictionaryTest : public testing::Test {
   scoped_ptr<TextDictionaryLoader> text_dict_;
   const string dic_fn_;
   int original_flags_min_key_length_to_use_small_cost_encoding_;
+  bool original_flags_build_reverse_lookup_index_;
 };
 
 void SystemDictionaryTest::BuildSystemDictionary(const vector<Token *>& source,
@@ -897,6 +904,8 @@ TEST_F(SystemDictionaryTest, LookupReverse) {
 }
 
 TEST_F(SystemDictionaryTest, LookupReverseIndex) {
+  // Builds the index in heap instead of using the prebuilt one.
+  FLAGS_build_reverse_lookup_index = false;
   const vector<Token *> &source_tokens = text_dict_->tokens();
   BuildSystemDictionary(source_tokens, FLAGS_dictionary_test_size);
 
@@ -931,6 +940,52 @@ TEST_F(SystemDictionaryTest, LookupReverseIndex) {
   }
 }
 
+TEST_F(SystemDictionaryTest, LookupReversePrebuiltIndex) {
+  const vector<Token *> &source_tokens = text_dict_->tokens();
+  FLAGS_build_reverse_lookup_index = false;
+  BuildSystemDictionary(source_tokens, FLAGS_dictionary_test_size);
+  scoped_ptr<SystemDictionary> system_dic_without_index(
+      SystemDictionary::Builder(dic_fn_).Build());
+  ASSERT_TRUE(system_dic_without_index.get() != NULL)
+      << "Failed to open dictionary source:" << dic_fn_;
+
+  FLAGS_build_reverse_lookup_index = true;
+  const string dic_with_index_fn = FLAGS_test_tmpdir + "/mozc_index.dic";
+  {
+    SystemDictionaryBuilder builder;
+    vector<Token *> tokens;
+    for (vector<Token *>::const_iterator it = source_tokens.begin();
+         tokens.size() < FLAGS_dictionary_test_size &&
+             it != source_tokens.end(); ++it) {
+      tokens.push_back(*it);
+    }
+    builder.BuildFromTokens(tokens);
+    builder.WriteToFile(dic_with_index_fn);
+  }
+  scoped_ptr<SystemDictionary> system_dic_with_index(
+      SystemDictionary::Builder(dic_with_index_fn).Build());
+  ASSERT_TRUE(system_dic_with_index.get() != NULL)
+      << "Failed to open dictionary source:" << dic_with_index_fn;
+
+  vector<Token *>::const_iterator it;
+  int size = FLAGS_dictionary_reverse_lookup_test_size;
+  for (it = source_tokens.begin();
+       size > 0 && it != source_tokens.end(); ++it, --size) {
+    const Token &t = **it;
+    CollectTokenCallback callback1, callback2;
+    system_dic_without_index->LookupReverse(t.value, &callback1);
+    system_dic_with_index->LookupReverse(t.value, &callback2);
+
+    const vector<Token> &tokens1 = callback1.tokens();
+    const vector<Token> &tokens2 = callback2.tokens();
+    ASSERT_EQ(tokens1.size(), tokens2.size());
+    for (size_t i = 0; i < tokens1.size(); ++i) {
+      EXPECT_TOKEN_EQ(tokens1[i], tokens2[i]);
+    }
+  }
+  FileUtil::Unlink(dic_with_index_fn);
+}
+
 TEST_F(SystemDictionaryTest, LookupReverseWithCache) {
   const string kDoraemon =
       "\xe3\x83\x89\xe3\x83\xa9\xe3\x81\x88\xe3\x82\x82\xe3\x82\x93";
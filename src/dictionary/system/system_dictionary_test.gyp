@@ -111,6 +111,20 @@
         'test_size': 'small',
       },
     },
+    {
+      'target_name': 'system_dictionary_benchmark',
+      'type': 'executable',
+      'sources': [
+        'system_dictionary_benchmark.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../data_manager/data_manager.gyp:user_pos_manager',
+        '../dictionary_base.gyp:text_dictionary_loader',
+        'system_dictionary.gyp:system_dictionary',
+        'system_dictionary.gyp:system_dictionary_builder',
+      ],
+    },
     # Test cases meta target: this target is referred from gyp/tests.gyp
     {
       'target_name': 'system_dictionary_all_test',
@@ -31,10 +31,10 @@
 
 #include <algorithm>
 #include <limits>
-#include <set>
 #include <string>
 
 #include "base/compiler_specific.h"
+#include "base/fingerprint_set.h"
 #include "base/logging.h"
 #include "base/mutex.h"
 #include "base/singleton.h"
@@ -123,9 +123,20 @@ class UserDictionary::TokensIndex : public vector<UserPOS::Token *> {
 
   void Load(const user_dictionary::UserDictionaryStorage &storage) {
     Clear();
-    set<uint64> seen;
     vector<UserPOS::Token> tokens;
 
+    // Sizes the containers up front; a 100K-word dictionary otherwise
+    // rehashes |seen| and reallocates this vector many times.
+    size_t num_entries = 0;
+    for (size_t i = 0; i < storage.dictionaries_size(); ++i) {
+      if (storage.dictionaries(i).enabled()) {
+        num_entries += storage.dictionaries(i).entries_size();
+      }
+    }
+    FingerprintSet seen(num_entries);
+    this->reserve(num_entries);
+    string fingerprint_key;
+
     if (!suppression_dictionary_->IsLocked()) {
       LOG(ERROR) << "SuppressionDictionary must be locked first";
     }
@@ -161,12 +172,11 @@ MOZC_CLANG_DISABLE_WARNING(tautological-constant-out-of-range-compare);
 #endif  // MOZC_CLANG_HAS_WARNING(tautological-constant-out-of-range-compare)
         DCHECK_LE(entry.pos(), 255);
 MOZC_CLANG_POP_WARNING();
-        const uint64 fp = Util::Fingerprint(reading +
-                                            "\t" +
-                                            entry.value() +
-                                            "\t" +
-                                            static_cast<char>(entry.pos()));
-        if (!seen.insert(fp).second) {
+        fingerprint_key.assign(reading);
+        fingerprint_key.append(1, '\t').append(entry.value());
+        fingerprint_key.append(1, '\t').append(1,
+                                               static_cast<char>(entry.pos()));
+        if (!seen.Insert(fingerprint_key)) {
           VLOG(1) << "Found dup item";
           continue;
         }
@@ -553,25 +563,23 @@ void UserDictionary::Swap(TokensIndex *new_tokens) {
 
 bool UserDictionary::Load(
     const user_dictionary::UserDictionaryStorage &storage) {
+  // The new index is built while the current one keeps serving lookups,
+  // and then swapped in at once.  Only on Android, where the memory is
+  // tight, a big dictionary is first removed so that two indices don't
+  // coexist; lookups return nothing until the new index is ready.
+#ifdef OS_ANDROID
+  const size_t kVeryBigUserDictionarySize = 5000;
   size_t size = 0;
   {
     scoped_reader_lock l(mutex_.get());
     size = tokens_->size();
   }
-
-  // If UserDictionary is pretty big, we first remove the
-  // current dictionary to save memory usage.
-#ifdef OS_ANDROID
-  const size_t kVeryBigUserDictionarySize = 5000;
-#else
-  const size_t kVeryBigUserDictionarySize = 100000;
-#endif
-
   if (size >= kVeryBigUserDictionarySize) {
     TokensIndex *dummy_empty_tokens = new TokensIndex(user_pos_.get(),
                                                       suppression_dictionary_);
     Swap(dummy_empty_tokens);
   }
+#endif  // OS_ANDROID
 
   TokensIndex *tokens = new TokensIndex(user_pos_.get(),
                                         suppression_dictionary_);
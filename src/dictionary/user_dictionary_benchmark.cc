@@ -0,0 +1,236 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Small benchmark code to measure the import of a big user dictionary.
+//
+// Generates |num_entries| entries in the Mozc text format and measures
+//  - the import into a UserDictionary protobuf, which is what the
+//    dictionary tool and UserDictionarySession do,
+//  - UserDictionary::Load(), i.e. building the tokens index,
+//  - LookupPrefix() running while the index is rebuilt in another thread.
+//    The old index keeps serving lookups until the new one is swapped in,
+//    so the lookups are expected to keep finding tokens.
+//
+// Usage:
+//   user_dictionary_benchmark --num_entries=100000
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/stopwatch.h"
+#include "base/thread.h"
+#include "base/util.h"
+#include "data_manager/user_pos_manager.h"
+#include "dictionary/dictionary_interface.h"
+#include "dictionary/dictionary_token.h"
+#include "dictionary/suppression_dictionary.h"
+#include "dictionary/user_dictionary.h"
+#include "dictionary/user_dictionary_importer.h"
+#include "dictionary/user_dictionary_storage.h"
+#include "dictionary/user_pos.h"
+
+DEFINE_int32(num_entries, 100000, "number of entries to import.");
+DEFINE_string(output_dir, "", "directory to write the user dictionary.");
+
+namespace mozc {
+namespace dictionary {
+namespace {
+
+class CountingCallback : public DictionaryInterface::Callback {
+ public:
+  CountingCallback() : num_tokens_(0) {}
+
+  virtual ResultType OnToken(StringPiece key, StringPiece actual_key,
+                             const Token &token) {
+    ++num_tokens_;
+    return TRAVERSE_CONTINUE;
+  }
+
+  size_t num_tokens() const { return num_tokens_; }
+
+ private:
+  size_t num_tokens_;
+};
+
+class CountingProgressCallback
+    : public UserDictionaryImporter::ProgressCallbackInterface {
+ public:
+  CountingProgressCallback() : num_calls_(0) {}
+
+  virtual void OnProgress(size_t num_read_entries, size_t num_added_entries) {
+    ++num_calls_;
+    VLOG(1) << num_read_entries << " read, " << num_added_entries << " added";
+  }
+
+  size_t num_calls() const { return num_calls_; }
+
+ private:
+  size_t num_calls_;
+};
+
+class LoadThread : public Thread {
+ public:
+  LoadThread(UserDictionary *dictionary,
+             SuppressionDictionary *suppression_dictionary,
+             const user_dictionary::UserDictionaryStorage &storage)
+      : dictionary_(dictionary),
+        suppression_dictionary_(suppression_dictionary),
+        storage_(storage) {}
+
+  virtual void Run() {
+    suppression_dictionary_->Lock();
+    dictionary_->Load(storage_);
+  }
+
+ private:
+  UserDictionary *dictionary_;
+  SuppressionDictionary *suppression_dictionary_;
+  const user_dictionary::UserDictionaryStorage &storage_;
+};
+
+void Report(const string &name, double elapsed_usec, size_t calls) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f msec total, %.3f usec/call (%d calls)",
+                             elapsed_usec / 1000.0,
+                             calls == 0 ? 0.0 : elapsed_usec / calls,
+                             static_cast<int>(calls))
+       << endl;
+}
+
+// Returns a reading of hiragana characters which is unique to |id|.
+string MakeReading(uint32 id) {
+  // "あ" (U+3042) to "ん" (U+3093).
+  const uint32 kNumChars = 0x3093 - 0x3042 + 1;
+  string reading;
+  do {
+    Util::UCS4ToUTF8Append(0x3042 + id % kNumChars, &reading);
+    id /= kNumChars;
+  } while (id > 0);
+  return reading;
+}
+
+void MakeEntries(int num_entries, vector<string> *readings, string *text) {
+  for (int i = 0; i < num_entries; ++i) {
+    const string reading = MakeReading(static_cast<uint32>(i));
+    readings->push_back(reading);
+    // "名詞"
+    text->append(reading).append("\t")
+        .append("value").append(Util::StringPrintf("%d", i)).append("\t")
+        .append("\xE5\x90\x8D\xE8\xA9\x9E").append("\t")
+        .append("comment\n");
+  }
+}
+
+}  // namespace
+}  // namespace dictionary
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  using mozc::dictionary::SuppressionDictionary;
+  using mozc::dictionary::UserDictionary;
+  using mozc::dictionary::UserPOS;
+
+  vector<string> readings;
+  string text;
+  mozc::dictionary::MakeEntries(FLAGS_num_entries, &readings, &text);
+  cout << "Entries: " << readings.size() << endl;
+
+  const string output_dir = FLAGS_output_dir.empty() ?
+      mozc::FileUtil::Dirname(argv[0]) : FLAGS_output_dir;
+  const string filename =
+      mozc::FileUtil::JoinPath(output_dir, "user_dictionary_benchmark.db");
+  mozc::FileUtil::Unlink(filename);
+  UserDictionary::SetUserDictionaryName(filename);
+
+  mozc::UserDictionaryStorage storage(filename);
+  uint64 dictionary_id = 0;
+  CHECK(storage.CreateDictionary("benchmark", &dictionary_id));
+  {
+    mozc::UserDictionaryImporter::StringTextLineIterator iter(text);
+    mozc::dictionary::CountingProgressCallback progress;
+    mozc::Stopwatch stopwatch = mozc::Stopwatch::StartNew();
+    const mozc::UserDictionaryImporter::ErrorType result =
+        mozc::UserDictionaryImporter::ImportFromTextLineIterator(
+            mozc::UserDictionaryImporter::MOZC, &iter, &progress,
+            storage.mutable_dictionaries(0));
+    stopwatch.Stop();
+    CHECK_EQ(mozc::UserDictionaryImporter::IMPORT_NO_ERROR, result);
+    mozc::dictionary::Report("Import", stopwatch.GetElapsedMicroseconds(),
+                             storage.dictionaries(0).entries_size());
+    cout << "Progress callbacks: " << progress.num_calls() << endl;
+  }
+
+  const mozc::UserPosManager *user_pos_manager =
+      mozc::UserPosManager::GetUserPosManager();
+  SuppressionDictionary suppression_dictionary;
+  UserDictionary dictionary(
+      new UserPOS(user_pos_manager->GetUserPOSData()),
+      user_pos_manager->GetPOSMatcher(),
+      &suppression_dictionary);
+  dictionary.WaitForReloader();
+  {
+    suppression_dictionary.Lock();
+    mozc::Stopwatch stopwatch = mozc::Stopwatch::StartNew();
+    dictionary.Load(storage);
+    stopwatch.Stop();
+    mozc::dictionary::Report("Load", stopwatch.GetElapsedMicroseconds(),
+                             readings.size());
+  }
+
+  {
+    mozc::dictionary::LoadThread thread(&dictionary, &suppression_dictionary,
+                                        storage);
+    mozc::dictionary::CountingCallback callback;
+    size_t calls = 0;
+    mozc::Stopwatch stopwatch = mozc::Stopwatch::StartNew();
+    thread.Start();
+    while (thread.IsRunning()) {
+      dictionary.LookupPrefix(readings[calls % readings.size()], false,
+                              &callback);
+      ++calls;
+    }
+    stopwatch.Stop();
+    thread.Join();
+    mozc::dictionary::Report("LookupPrefix during Load",
+                             stopwatch.GetElapsedMicroseconds(), calls);
+    cout << "Tokens found during Load: " << callback.num_tokens() << endl;
+  }
+
+  mozc::FileUtil::Unlink(filename);
+  return 0;
+}
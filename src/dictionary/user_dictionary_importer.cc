@@ -38,11 +38,11 @@
 
 #include <algorithm>
 #include <map>
-#include <set>
 #include <string>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/fingerprint_set.h"
 #include "base/mmap.h"
 #include "base/number_util.h"
 #include "base/port.h"
@@ -58,7 +58,8 @@ using user_dictionary::UserDictionaryCommandStatus;
 
 namespace {
 
-uint64 EntryFingerprint(const UserDictionary::Entry &entry) {
+// |buffer| is a scratch space reused across the calls.
+uint64 EntryFingerprint(const UserDictionary::Entry &entry, string *buffer) {
   DCHECK_LE(0, entry.pos());
 MOZC_CLANG_PUSH_WARNING();
 #if MOZC_CLANG_HAS_WARNING(tautological-constant-out-of-range-compare)
@@ -66,9 +67,10 @@ MOZC_CLANG_DISABLE_WARNING(tautological-constant-out-of-range-compare);
 #endif  // MOZC_CLANG_HAS_WARNING(tautological-constant-out-of-range-compare)
   DCHECK_LE(entry.pos(), 255);
 MOZC_CLANG_POP_WARNING();
-  return Util::Fingerprint(entry.key() + "\t" +
-                           entry.value() + "\t" +
-                           static_cast<char>(entry.pos()));
+  buffer->assign(entry.key());
+  buffer->append(1, '\t').append(entry.value());
+  buffer->append(1, '\t').append(1, static_cast<char>(entry.pos()));
+  return Util::FingerprintV2(*buffer);
 }
 
 void NormalizePOS(const string &input, string *output) {
@@ -375,6 +377,12 @@ UserDictionaryImporter::ErrorType UserDictionaryImporter::ImportFromMSIME(
 
 UserDictionaryImporter::ErrorType UserDictionaryImporter::ImportFromIterator(
     InputIteratorInterface *iter, UserDictionary *user_dic) {
+  return ImportFromIterator(iter, NULL, user_dic);
+}
+
+UserDictionaryImporter::ErrorType UserDictionaryImporter::ImportFromIterator(
+    InputIteratorInterface *iter, ProgressCallbackInterface *progress,
+    UserDictionary *user_dic) {
   if (iter == NULL || user_dic == NULL) {
     LOG(ERROR) << "iter or user_dic is NULL";
     return IMPORT_FATAL;
@@ -384,17 +392,29 @@ UserDictionaryImporter::ErrorType UserDictionaryImporter::ImportFromIterator(
 
   ErrorType ret = IMPORT_NO_ERROR;
 
-  set<uint64> existent_entries;
+  string buffer;
+  FingerprintSet existent_entries(user_dic->entries_size() + kImportChunkSize);
   for (size_t i = 0; i < user_dic->entries_size(); ++i) {
-    existent_entries.insert(EntryFingerprint(user_dic->entries(i)));
+    existent_entries.Insert(EntryFingerprint(user_dic->entries(i), &buffer));
   }
 
+  const size_t original_size = user_dic->entries_size();
+  size_t num_read_entries = 0;
   UserDictionary::Entry entry;
   RawEntry raw_entry;
   while (iter->Next(&raw_entry)) {
+    // Reports the entries processed so far, which excludes |raw_entry|.
+    if (progress != NULL && num_read_entries > 0 &&
+        num_read_entries % kImportChunkSize == 0) {
+      progress->OnProgress(num_read_entries,
+                           user_dic->entries_size() - original_size);
+    }
+    ++num_read_entries;
+
     if (user_dic->entries_size() >= max_size) {
       LOG(WARNING) << "Too many words in one dictionary";
-      return IMPORT_TOO_MANY_WORDS;
+      ret = IMPORT_TOO_MANY_WORDS;
+      break;
     }
 
     if (raw_entry.key.empty() &&
@@ -412,13 +432,19 @@ UserDictionaryImporter::ErrorType UserDictionaryImporter::ImportFromIterator(
     }
 
     // Don't register words if it is aleady in the current dictionary.
-    if (!existent_entries.insert(EntryFingerprint(entry)).second) {
+    if (!existent_entries.Insert(EntryFingerprint(entry, &buffer))) {
       continue;
     }
 
+    // |entry| is fully reset by ConvertEntry(), so its strings can be moved.
     UserDictionary::Entry *new_entry = user_dic->add_entries();
     DCHECK(new_entry);
-    new_entry->CopyFrom(entry);
+    new_entry->Swap(&entry);
+  }
+
+  if (progress != NULL) {
+    progress->OnProgress(num_read_entries,
+                         user_dic->entries_size() - original_size);
   }
 
   return ret;
@@ -429,12 +455,21 @@ UserDictionaryImporter::ImportFromTextLineIterator(
     IMEType ime_type,
     TextLineIteratorInterface *iter,
     UserDictionary *user_dic) {
+  return ImportFromTextLineIterator(ime_type, iter, NULL, user_dic);
+}
+
+UserDictionaryImporter::ErrorType
+UserDictionaryImporter::ImportFromTextLineIterator(
+    IMEType ime_type,
+    TextLineIteratorInterface *iter,
+    ProgressCallbackInterface *progress,
+    UserDictionary *user_dic) {
   TextInputIterator text_iter(ime_type, iter);
   if (text_iter.ime_type() == NUM_IMES) {
     return IMPORT_NOT_SUPPORTED;
   }
 
-  return ImportFromIterator(&text_iter, user_dic);
+  return ImportFromIterator(&text_iter, progress, user_dic);
 }
 
 UserDictionaryImporter::StringTextLineIterator::StringTextLineIterator(
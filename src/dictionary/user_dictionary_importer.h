@@ -76,6 +76,26 @@ class UserDictionaryImporter {
     DISALLOW_COPY_AND_ASSIGN(InputIteratorInterface);
   };
 
+  // An abstract class for receiving the progress of an import.  The
+  // importer reads the input in chunks of kImportChunkSize entries and
+  // calls OnProgress() after each chunk and at the end, so that the caller
+  // can update its UI without paying for it on every entry.
+  class ProgressCallbackInterface {
+   public:
+    ProgressCallbackInterface() {}
+    virtual ~ProgressCallbackInterface() {}
+
+    // |num_read_entries| entries have been read so far and
+    // |num_added_entries| of them have been added to the dictionary.
+    virtual void OnProgress(size_t num_read_entries,
+                            size_t num_added_entries) = 0;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(ProgressCallbackInterface);
+  };
+
+  static const size_t kImportChunkSize = 1000;
+
   // An abstract class for reading a text file per line.  It runs over
   // all lines, e.g. comment lines.
   // As we'd like to use QTextFileStream to load UTF16 files, make an
@@ -191,12 +211,25 @@ class UserDictionaryImporter {
       InputIteratorInterface *iter,
       user_dictionary::UserDictionary *dic);
 
+  // Same as above, but reports the progress to |progress| per chunk.
+  // |progress| can be NULL.
+  static ErrorType ImportFromIterator(
+      InputIteratorInterface *iter,
+      ProgressCallbackInterface *progress,
+      user_dictionary::UserDictionary *dic);
+
   // Import a dictionary from TextLineIterator.
   static ErrorType ImportFromTextLineIterator(
       IMEType ime_type,
       TextLineIteratorInterface *iter,
       user_dictionary::UserDictionary *dic);
 
+  static ErrorType ImportFromTextLineIterator(
+      IMEType ime_type,
+      TextLineIteratorInterface *iter,
+      ProgressCallbackInterface *progress,
+      user_dictionary::UserDictionary *dic);
+
   // Import a dictionary from MS-IME's user dictionary.
   // Only available on Windows
   static ErrorType ImportFromMSIME(user_dictionary::UserDictionary *dic);
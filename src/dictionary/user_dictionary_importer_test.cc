@@ -430,6 +430,51 @@ TEST(UserDictionaryImporter, ImportFromIteratorNormalTest) {
   }
 }
 
+class TestProgressCallback
+    : public UserDictionaryImporter::ProgressCallbackInterface {
+ public:
+  virtual void OnProgress(size_t num_read_entries, size_t num_added_entries) {
+    num_read_entries_.push_back(num_read_entries);
+    num_added_entries_.push_back(num_added_entries);
+  }
+
+  vector<size_t> num_read_entries_;
+  vector<size_t> num_added_entries_;
+};
+
+TEST(UserDictionaryImporter, ImportFromIteratorProgressTest) {
+  vector<UserDictionaryImporter::RawEntry> entries;
+  for (size_t j = 0; j < 2500; ++j) {
+    // The last 500 entries are duplicates of the first ones.
+    const uint32 id = static_cast<uint32>(j < 2000 ? j : j - 2000);
+    UserDictionaryImporter::RawEntry entry;
+    entry.key = "key" + NumberUtil::SimpleItoa(id);
+    entry.value = "value" + NumberUtil::SimpleItoa(id);
+    // entry.pos = "名詞";
+    entry.pos = "\xE5\x90\x8D\xE8\xA9\x9E";
+    entries.push_back(entry);
+  }
+
+  TestInputIterator iter;
+  iter.set_available(true);
+  iter.set_entries(&entries);
+  TestProgressCallback progress;
+  UserDictionaryStorage::UserDictionary user_dic;
+  EXPECT_EQ(UserDictionaryImporter::IMPORT_NO_ERROR,
+            UserDictionaryImporter::ImportFromIterator(
+                &iter, &progress, &user_dic));
+  EXPECT_EQ(2000, user_dic.entries_size());
+
+  // Called per chunk and once at the end.
+  ASSERT_EQ(3, progress.num_read_entries_.size());
+  EXPECT_EQ(1000, progress.num_read_entries_[0]);
+  EXPECT_EQ(2000, progress.num_read_entries_[1]);
+  EXPECT_EQ(2500, progress.num_read_entries_[2]);
+  EXPECT_EQ(1000, progress.num_added_entries_[0]);
+  EXPECT_EQ(2000, progress.num_added_entries_[1]);
+  EXPECT_EQ(2000, progress.num_added_entries_[2]);
+}
+
 TEST(UserDictionaryImporter, ImportFromIteratorInvalidEntriesTest) {
   TestInputIterator iter;
   UserDictionaryStorage::UserDictionary user_dic;
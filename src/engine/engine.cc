@@ -29,44 +29,37 @@
 
 #include "engine/engine.h"
 
+#include "base/flags.h"
+#include "base/latency_histogram.h"
 #include "base/logging.h"
 #include "base/port.h"
-#include "converter/connector.h"
+#include "base/thread_pool.h"
 #include "converter/converter.h"
 #include "converter/converter_interface.h"
 #include "converter/immutable_converter.h"
 #include "converter/immutable_converter_interface.h"
-#include "converter/segmenter.h"
 #include "data_manager/data_manager_interface.h"
 #include "dictionary/dictionary_impl.h"
 #include "dictionary/dictionary_interface.h"
-#include "dictionary/pos_group.h"
 #include "dictionary/pos_matcher.h"
-#include "dictionary/suffix_dictionary.h"
-#include "dictionary/suffix_dictionary_token.h"
 #include "dictionary/suppression_dictionary.h"
-#include "dictionary/system/system_dictionary.h"
-#include "dictionary/system/value_dictionary.h"
 #include "dictionary/user_dictionary.h"
+#include "engine/engine_core.h"
 #include "engine/engine_interface.h"
 #include "engine/user_data_manager_interface.h"
 #include "prediction/dictionary_predictor.h"
 #include "prediction/predictor.h"
 #include "prediction/predictor_interface.h"
-#include "prediction/suggestion_filter.h"
 #include "prediction/user_history_predictor.h"
 #include "rewriter/rewriter.h"
 #include "rewriter/rewriter_interface.h"
 
 using mozc::dictionary::DictionaryImpl;
-using mozc::dictionary::PosGroup;
-using mozc::dictionary::SuffixDictionary;
-using mozc::dictionary::SuffixToken;
 using mozc::dictionary::SuppressionDictionary;
-using mozc::dictionary::SystemDictionary;
 using mozc::dictionary::UserDictionary;
 using mozc::dictionary::UserPOS;
-using mozc::dictionary::ValueDictionary;
+
+DECLARE_bool(parallel_engine_init);
 
 namespace mozc {
 namespace {
@@ -133,74 +126,68 @@ bool UserDataManagerImpl::WaitForSyncerForTest() {
 
 }  // namespace
 
-Engine::Engine() {}
+Engine::Engine() : core_(NULL) {}
 Engine::~Engine() {}
 
-// Since the composite predictor class differs on desktop and mobile, Init()
-// takes a function pointer to create an instance of predictor class.
 void Engine::Init(
     const DataManagerInterface *data_manager,
     PredictorInterface *(*predictor_factory)(PredictorInterface *,
                                              PredictorInterface *),
     bool enable_content_word_learning) {
   CHECK(data_manager);
+  owned_core_.reset(new EngineCore(data_manager));
+  Init(owned_core_.get(), predictor_factory, enable_content_word_learning);
+}
+
+// Since the composite predictor class differs on desktop and mobile, Init()
+// takes a function pointer to create an instance of predictor class.
+void Engine::Init(
+    const EngineCore *core,
+    PredictorInterface *(*predictor_factory)(PredictorInterface *,
+                                             PredictorInterface *),
+    bool enable_content_word_learning) {
+  CHECK(core);
   CHECK(predictor_factory);
+  ScopedLatencyTimer total_timer(
+      LatencyHistogram::Get("EngineInit::Engine"));
+  core_ = core;
+  const DataManagerInterface *data_manager = core_->data_manager();
+  ThreadPool *init_pool = FLAGS_parallel_engine_init ?
+      ThreadPool::GetSharedInstance() : NULL;
 
   suppression_dictionary_.reset(new SuppressionDictionary);
   CHECK(suppression_dictionary_.get());
 
-  user_dictionary_.reset(
-      new UserDictionary(new UserPOS(data_manager->GetUserPOSData()),
-                         data_manager->GetPOSMatcher(),
-                         suppression_dictionary_.get()));
-  CHECK(user_dictionary_.get());
-
-  const char *dictionary_data = NULL;
-  int dictionary_size = 0;
-  data_manager->GetSystemDictionaryData(&dictionary_data, &dictionary_size);
+  {
+    // The user dictionary is loaded by its reloader thread.
+    ScopedLatencyTimer timer(
+        LatencyHistogram::Get("EngineInit::UserDictionary"));
+    user_dictionary_.reset(
+        new UserDictionary(new UserPOS(data_manager->GetUserPOSData()),
+                           core_->pos_matcher(),
+                           suppression_dictionary_.get()));
+    CHECK(user_dictionary_.get());
+  }
 
-  dictionary_.reset(new DictionaryImpl(
-      SystemDictionary::Builder(dictionary_data, dictionary_size).Build(),
-      ValueDictionary::CreateValueDictionaryFromImage(
-          *data_manager->GetPOSMatcher(), dictionary_data, dictionary_size),
+  // The system and value dictionaries are shared with the other engines
+  // built on |core_|.
+  dictionary_.reset(DictionaryImpl::CreateWithSharedDictionaries(
+      core_->system_dictionary(),
+      core_->value_dictionary(),
       user_dictionary_.get(),
       suppression_dictionary_.get(),
-      data_manager->GetPOSMatcher()));
+      core_->pos_matcher()));
   CHECK(dictionary_.get());
 
-  const SuffixToken *suffix_tokens = NULL;
-  size_t suffix_tokens_size = 0;
-  data_manager->GetSuffixDictionaryData(&suffix_tokens, &suffix_tokens_size);
-  suffix_dictionary_.reset(new SuffixDictionary(suffix_tokens,
-                                                suffix_tokens_size));
-  CHECK(suffix_dictionary_.get());
-
-  connector_.reset(Connector::CreateFromDataManager(*data_manager));
-  CHECK(connector_.get());
-
-  segmenter_.reset(Segmenter::CreateFromDataManager(*data_manager));
-  CHECK(segmenter_.get());
-
-  pos_group_.reset(new PosGroup(data_manager->GetPosGroupData()));
-  CHECK(pos_group_.get());
-
-  {
-    const char *data = NULL;
-    size_t size = 0;
-    data_manager->GetSuggestionFilterData(&data, &size);
-    CHECK(data);
-    suggestion_filter_.reset(new SuggestionFilter(data, size));
-  }
-
   immutable_converter_.reset(new ImmutableConverterImpl(
       dictionary_.get(),
-      suffix_dictionary_.get(),
+      core_->suffix_dictionary(),
       suppression_dictionary_.get(),
-      connector_.get(),
-      segmenter_.get(),
-      data_manager->GetPOSMatcher(),
-      pos_group_.get(),
-      suggestion_filter_.get()));
+      core_->connector(),
+      core_->segmenter(),
+      core_->pos_matcher(),
+      core_->pos_group(),
+      core_->suggestion_filter()));
   CHECK(immutable_converter_.get());
 
   // Since predictor and rewriter require a pointer to a converter instace,
@@ -215,21 +202,23 @@ void Engine::Init(
 
   {
     // Create a predictor with three sub-predictors, dictionary predictor, user
-    // history predictor, and extra predictor.
+    // history predictor, and extra predictor.  The user history is loaded
+    // asynchronously by the predictor.
+    ScopedLatencyTimer timer(LatencyHistogram::Get("EngineInit::Predictor"));
     PredictorInterface *dictionary_predictor =
         new DictionaryPredictor(converter_.get(),
                                 immutable_converter_.get(),
                                 dictionary_.get(),
-                                suffix_dictionary_.get(),
-                                connector_.get(),
-                                segmenter_.get(),
-                                data_manager->GetPOSMatcher(),
-                                suggestion_filter_.get());
+                                core_->suffix_dictionary(),
+                                core_->connector(),
+                                core_->segmenter(),
+                                core_->pos_matcher(),
+                                core_->suggestion_filter());
     CHECK(dictionary_predictor);
 
     PredictorInterface *user_history_predictor =
         new UserHistoryPredictor(dictionary_.get(),
-                                 data_manager->GetPOSMatcher(),
+                                 core_->pos_matcher(),
                                  suppression_dictionary_.get(),
                                  enable_content_word_learning);
     CHECK(user_history_predictor);
@@ -239,13 +228,17 @@ void Engine::Init(
     CHECK(predictor_);
   }
 
-  rewriter_ = new RewriterImpl(converter_impl,
-                               data_manager,
-                               pos_group_.get(),
-                               dictionary_.get());
-  CHECK(rewriter_);
+  {
+    ScopedLatencyTimer timer(LatencyHistogram::Get("EngineInit::Rewriter"));
+    rewriter_ = new RewriterImpl(converter_impl,
+                                 data_manager,
+                                 core_->pos_group(),
+                                 dictionary_.get(),
+                                 init_pool);
+    CHECK(rewriter_);
+  }
 
-  converter_impl->Init(data_manager->GetPOSMatcher(),
+  converter_impl->Init(core_->pos_matcher(),
                        suppression_dictionary_.get(),
                        predictor_,
                        rewriter_,
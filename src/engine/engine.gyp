@@ -39,6 +39,7 @@
       'sources': [
         '<(gen_out_dir)/../dictionary/pos_matcher.h',
         'engine.cc',
+        'engine_core.cc',
       ],
       'dependencies': [
         '../base/base.gyp:base',
@@ -33,23 +33,24 @@
 #include "base/port.h"
 #include "base/scoped_ptr.h"
 #include "dictionary/dictionary_interface.h"
-#include "dictionary/pos_group.h"
 #include "dictionary/user_dictionary.h"
 #include "engine/engine_interface.h"
 
 namespace mozc {
 
-class Connector;
 class ConverterInterface;
 class DataManagerInterface;
+class EngineCore;
 class ImmutableConverterInterface;
 class PredictorInterface;
 class RewriterInterface;
-class Segmenter;
-class SuggestionFilter;
 class UserDataManagerInterface;
 
 // Builds and manages a set of modules that are necessary for conversion engine.
+// The immutable modules live in EngineCore, which may be shared with other
+// engines.  The learning stores owned by this class (user dictionary, user
+// history and segment histories) are synchronized internally, so sessions
+// using the same engine can be served from multiple threads.
 class Engine : public EngineInterface {
  public:
   Engine();
@@ -63,6 +64,15 @@ class Engine : public EngineInterface {
                                                      PredictorInterface *),
             bool enable_content_word_learning);
 
+  // Same as above but builds the engine on top of |core|, which is shared and
+  // not owned.  |core| must outlive this object.
+  void Init(const EngineCore *core,
+            PredictorInterface *(*predictor_factory)(PredictorInterface *,
+                                                     PredictorInterface *),
+            bool enable_content_word_learning);
+
+  const EngineCore *GetEngineCore() const { return core_; }
+
   virtual ConverterInterface *GetConverter() const { return converter_.get(); }
   virtual PredictorInterface *GetPredictor() const { return predictor_; }
   virtual dictionary::SuppressionDictionary *GetSuppressionDictionary() {
@@ -76,15 +86,14 @@ class Engine : public EngineInterface {
   }
 
  private:
+  // Set only when the core is built by Init(data_manager, ...).
+  scoped_ptr<const EngineCore> owned_core_;
+  const EngineCore *core_;
+
   scoped_ptr<dictionary::SuppressionDictionary> suppression_dictionary_;
-  scoped_ptr<const Connector> connector_;
-  scoped_ptr<const Segmenter> segmenter_;
   scoped_ptr<dictionary::UserDictionary> user_dictionary_;
-  scoped_ptr<dictionary::DictionaryInterface> suffix_dictionary_;
   scoped_ptr<dictionary::DictionaryInterface> dictionary_;
-  scoped_ptr<const dictionary::PosGroup> pos_group_;
   scoped_ptr<ImmutableConverterInterface> immutable_converter_;
-  scoped_ptr<const SuggestionFilter> suggestion_filter_;
 
   // TODO(noriyukit): Currently predictor and rewriter are created by this class
   // but owned by converter_. Since this class creates these two, it'd be better
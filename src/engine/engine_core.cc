@@ -0,0 +1,165 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/engine_core.h"
+
+#include <string>
+
+#include "base/flags.h"
+#include "base/latency_histogram.h"
+#include "base/logging.h"
+#include "base/thread_pool.h"
+#include "converter/connector.h"
+#include "converter/segmenter.h"
+#include "data_manager/data_manager_interface.h"
+#include "dictionary/pos_group.h"
+#include "dictionary/pos_matcher.h"
+#include "dictionary/suffix_dictionary.h"
+#include "dictionary/suffix_dictionary_token.h"
+#include "dictionary/system/system_dictionary.h"
+#include "dictionary/system/value_dictionary.h"
+#include "prediction/suggestion_filter.h"
+
+using mozc::dictionary::PosGroup;
+using mozc::dictionary::POSMatcher;
+using mozc::dictionary::SuffixDictionary;
+using mozc::dictionary::SuffixToken;
+using mozc::dictionary::SystemDictionary;
+using mozc::dictionary::ValueDictionary;
+
+DEFINE_bool(parallel_engine_init, true,
+            "Build the independent modules of the engine concurrently, and "
+            "the expensive rewriters in the background.");
+
+namespace mozc {
+
+// Runs one initialization step and records its latency.
+class EngineCore::InitTask : public ThreadPool::Task {
+ public:
+  InitTask(EngineCore *core, void (EngineCore::*init)(), const char *name)
+      : core_(core), init_(init),
+        histogram_(LatencyHistogram::Get(string("EngineInit::") + name)) {}
+
+  virtual void Run() {
+    ScopedLatencyTimer timer(histogram_);
+    (core_->*init_)();
+  }
+
+ private:
+  EngineCore *core_;
+  void (EngineCore::*init_)();
+  LatencyHistogram *histogram_;
+};
+
+EngineCore::EngineCore(const DataManagerInterface *data_manager)
+    : data_manager_(data_manager) {
+  CHECK(data_manager_);
+  ScopedLatencyTimer total_timer(
+      LatencyHistogram::Get("EngineInit::EngineCore"));
+
+  // The system and value dictionaries build the rank indexes of their tries
+  // from the same image when opened, so they are opened concurrently too.
+  InitTask tasks[] = {
+    InitTask(this, &EngineCore::InitSystemDictionary, "SystemDictionary"),
+    InitTask(this, &EngineCore::InitValueDictionary, "ValueDictionary"),
+    InitTask(this, &EngineCore::InitConnector, "Connector"),
+    InitTask(this, &EngineCore::InitSegmenter, "Segmenter"),
+    InitTask(this, &EngineCore::InitSuffixDictionary, "SuffixDictionary"),
+    InitTask(this, &EngineCore::InitPosGroup, "PosGroup"),
+    InitTask(this, &EngineCore::InitSuggestionFilter, "SuggestionFilter"),
+  };
+  if (!FLAGS_parallel_engine_init) {
+    for (size_t i = 0; i < arraysize(tasks); ++i) {
+      tasks[i].Run();
+    }
+    return;
+  }
+  TaskGroup group(ThreadPool::GetSharedInstance());
+  for (size_t i = 0; i < arraysize(tasks); ++i) {
+    group.Run(&tasks[i]);
+  }
+  group.Wait();
+}
+
+EngineCore::~EngineCore() {}
+
+void EngineCore::InitSystemDictionary() {
+  const char *data = NULL;
+  int size = 0;
+  data_manager_->GetSystemDictionaryData(&data, &size);
+  system_dictionary_.reset(SystemDictionary::Builder(data, size).Build());
+  CHECK(system_dictionary_.get());
+}
+
+void EngineCore::InitValueDictionary() {
+  const char *data = NULL;
+  int size = 0;
+  data_manager_->GetSystemDictionaryData(&data, &size);
+  value_dictionary_.reset(ValueDictionary::CreateValueDictionaryFromImage(
+      *data_manager_->GetPOSMatcher(), data, size));
+  CHECK(value_dictionary_.get());
+}
+
+void EngineCore::InitConnector() {
+  connector_.reset(Connector::CreateFromDataManager(*data_manager_));
+  CHECK(connector_.get());
+}
+
+void EngineCore::InitSegmenter() {
+  segmenter_.reset(Segmenter::CreateFromDataManager(*data_manager_));
+  CHECK(segmenter_.get());
+}
+
+void EngineCore::InitSuffixDictionary() {
+  const SuffixToken *suffix_tokens = NULL;
+  size_t suffix_tokens_size = 0;
+  data_manager_->GetSuffixDictionaryData(&suffix_tokens, &suffix_tokens_size);
+  suffix_dictionary_.reset(new SuffixDictionary(suffix_tokens,
+                                                suffix_tokens_size));
+  CHECK(suffix_dictionary_.get());
+}
+
+void EngineCore::InitPosGroup() {
+  pos_group_.reset(new PosGroup(data_manager_->GetPosGroupData()));
+  CHECK(pos_group_.get());
+}
+
+void EngineCore::InitSuggestionFilter() {
+  const char *data = NULL;
+  size_t size = 0;
+  data_manager_->GetSuggestionFilterData(&data, &size);
+  CHECK(data);
+  suggestion_filter_.reset(new SuggestionFilter(data, size));
+}
+
+const POSMatcher *EngineCore::pos_matcher() const {
+  return data_manager_->GetPOSMatcher();
+}
+
+}  // namespace mozc
@@ -0,0 +1,111 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef MOZC_ENGINE_ENGINE_CORE_H_
+#define MOZC_ENGINE_ENGINE_CORE_H_
+
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+
+namespace mozc {
+
+class Connector;
+class DataManagerInterface;
+class Segmenter;
+class SuggestionFilter;
+
+namespace dictionary {
+class DictionaryInterface;
+class PosGroup;
+class POSMatcher;
+}  // namespace dictionary
+
+// Immutable part of the conversion engine built from a data manager: the
+// system and value dictionaries, connection matrix, segmenter, suffix
+// dictionary, POS group and suggestion filter.  None of these modules is
+// modified after construction (the connector's cost cache is updated
+// atomically and the reverse lookup cache of the system dictionary is
+// guarded by its own mutex), so one instance can be
+// shared by any number of engines and sessions running on different threads
+// without locking.  Mutable learning state, e.g. the user dictionary and the
+// history stores, is owned by Engine instead.
+//
+// Each module is built by an independent step, whose latency is recorded to
+// the histogram "EngineInit::<module>".  With --parallel_engine_init, the
+// steps run concurrently on the shared thread pool.
+class EngineCore {
+ public:
+  // |data_manager| must outlive this object.
+  explicit EngineCore(const DataManagerInterface *data_manager);
+  ~EngineCore();
+
+  const DataManagerInterface *data_manager() const { return data_manager_; }
+  const dictionary::POSMatcher *pos_matcher() const;
+  const dictionary::DictionaryInterface *system_dictionary() const {
+    return system_dictionary_.get();
+  }
+  const dictionary::DictionaryInterface *value_dictionary() const {
+    return value_dictionary_.get();
+  }
+  const Connector *connector() const { return connector_.get(); }
+  const Segmenter *segmenter() const { return segmenter_.get(); }
+  const dictionary::DictionaryInterface *suffix_dictionary() const {
+    return suffix_dictionary_.get();
+  }
+  const dictionary::PosGroup *pos_group() const { return pos_group_.get(); }
+  const SuggestionFilter *suggestion_filter() const {
+    return suggestion_filter_.get();
+  }
+
+ private:
+  class InitTask;
+
+  void InitSystemDictionary();
+  void InitValueDictionary();
+  void InitConnector();
+  void InitSegmenter();
+  void InitSuffixDictionary();
+  void InitPosGroup();
+  void InitSuggestionFilter();
+
+  const DataManagerInterface *data_manager_;
+  scoped_ptr<const dictionary::DictionaryInterface> system_dictionary_;
+  scoped_ptr<const dictionary::DictionaryInterface> value_dictionary_;
+  scoped_ptr<const Connector> connector_;
+  scoped_ptr<const Segmenter> segmenter_;
+  scoped_ptr<const dictionary::DictionaryInterface> suffix_dictionary_;
+  scoped_ptr<const dictionary::PosGroup> pos_group_;
+  scoped_ptr<const SuggestionFilter> suggestion_filter_;
+
+  DISALLOW_COPY_AND_ASSIGN(EngineCore);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_ENGINE_ENGINE_CORE_H_
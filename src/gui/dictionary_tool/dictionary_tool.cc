@@ -111,10 +111,24 @@ void InstallStyleSheet(const QString &filename) {
 }
 #endif
 
+// A text line iterator which shows how much of the file has been read on a
+// progress dialog.  The importer reports the progress once per chunk of
+// entries, as updating the modal dialog processes the UI events, which is
+// too expensive to do for every line of a big dictionary.
+class ProgressTextLineIterator
+    : public UserDictionaryImporter::TextLineIteratorInterface,
+      public UserDictionaryImporter::ProgressCallbackInterface {
+ public:
+  ProgressTextLineIterator() {}
+  virtual ~ProgressTextLineIterator() {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ProgressTextLineIterator);
+};
+
 // Use QTextStream to read UTF16 text -- we can't use ifstream,
 // since ifstream cannot handle Wide character.
-class UTF16TextLineIterator
-    : public UserDictionaryImporter::TextLineIteratorInterface {
+class UTF16TextLineIterator : public ProgressTextLineIterator {
  public:
   UTF16TextLineIterator(
       UserDictionaryImporter::EncodingType encoding_type,
@@ -156,12 +170,14 @@ class UTF16TextLineIterator
       }
     }
 
-    progress_->setValue(file_.pos());
-
     *line = output_line.toUtf8().data();
     return true;
   }
 
+  void OnProgress(size_t num_read_entries, size_t num_added_entries) {
+    progress_->setValue(file_.pos());
+  }
+
   void Reset() {
     file_.seek(0);
     stream_.reset(new QTextStream);
@@ -175,8 +191,7 @@ class UTF16TextLineIterator
   scoped_ptr<QProgressDialog> progress_;
 };
 
-class MultiByteTextLineIterator
-    : public UserDictionaryImporter::TextLineIteratorInterface {
+class MultiByteTextLineIterator : public ProgressTextLineIterator {
  public:
   MultiByteTextLineIterator(
       UserDictionaryImporter::EncodingType encoding_type,
@@ -220,8 +235,6 @@ class MultiByteTextLineIterator
       }
     }
 
-    progress_->setValue(ifs_->tellg());
-
     *line = output_line;
 
     // We can't use QTextCodec as QTextCodec is not enabled by default.
@@ -243,6 +256,12 @@ class MultiByteTextLineIterator
     return true;
   }
 
+  void OnProgress(size_t num_read_entries, size_t num_added_entries) {
+    // tellg() fails once the whole file has been read.
+    progress_->setValue(ifs_->good() ? static_cast<int>(ifs_->tellg()) :
+                                       progress_->maximum());
+  }
+
   void Reset() {
     // Clear state bit (eofbit, failbit, badbit).
     ifs_->clear();
@@ -257,7 +276,7 @@ class MultiByteTextLineIterator
   bool first_line_;
 };
 
-UserDictionaryImporter::TextLineIteratorInterface *CreateTextLineIterator(
+ProgressTextLineIterator *CreateTextLineIterator(
     UserDictionaryImporter::EncodingType encoding_type,
     const string &filename,
     QWidget *parent) {
@@ -886,7 +905,7 @@ void DictionaryTool::ImportHelper(
   SyncToStorage();
 
   // Open dictionary
-  scoped_ptr<UserDictionaryImporter::TextLineIteratorInterface> iter(
+  scoped_ptr<ProgressTextLineIterator> iter(
       CreateTextLineIterator(encoding_type, file_name, this));
   if (iter.get() == NULL) {
     LOG(ERROR) << "CreateTextLineIterator returns NULL";
@@ -896,6 +915,7 @@ void DictionaryTool::ImportHelper(
   const int old_size = dic->entries_size();
   const UserDictionaryImporter::ErrorType error =
       UserDictionaryImporter::ImportFromTextLineIterator(ime_type,
+                                                         iter.get(),
                                                          iter.get(),
                                                          dic);
 
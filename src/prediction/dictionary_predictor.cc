@@ -40,7 +40,9 @@
 #include <utility>
 #include <vector>
 
+#include "base/fingerprint_set.h"
 #include "base/flags.h"
+#include "base/latency_histogram.h"
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/util.h"
@@ -61,6 +63,7 @@
 #include "prediction/zero_query_data.h"
 #include "prediction/zero_query_number_data.h"
 #include "session/commands.pb.h"
+#include "usage_stats/usage_stats.h"
 
 // This flag is set by predictor.cc
 // We can remove this after the ambiguity expansion feature get stable.
@@ -77,6 +80,7 @@ DECLARE_bool(enable_typing_correction);
 using mozc::dictionary::DictionaryInterface;
 using mozc::dictionary::POSMatcher;
 using mozc::dictionary::Token;
+using mozc::usage_stats::UsageStats;
 
 namespace mozc {
 namespace {
@@ -309,7 +313,19 @@ DictionaryPredictor::DictionaryPredictor(
       segmenter_(segmenter),
       suggestion_filter_(suggestion_filter),
       counter_suffix_word_id_(pos_matcher->GetCounterSuffixWordId()),
-      predictor_name_("DictionaryPredictor") {}
+      predictor_name_("DictionaryPredictor"),
+      realtime_conversion_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateRealtimeConversion")),
+      unigram_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateUnigramPrediction")),
+      bigram_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateBigramPrediction")),
+      suffix_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateSuffixPrediction")),
+      english_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateEnglishPrediction")),
+      type_correcting_histogram_(LatencyHistogram::Get(
+          "DictionaryPredictor::AggregateTypeCorrectingPrediction")) {}
 
 DictionaryPredictor::~DictionaryPredictor() {}
 
@@ -349,15 +365,42 @@ bool DictionaryPredictor::AggregatePrediction(
     // composition mode. Thus it should return only the candidates whose key
     // exactly matches the query.
     // Therefore, we use only the realtime conversion result.
+    ScopedLatencyTimer timer(realtime_conversion_histogram_);
     AggregateRealtimeConversion(prediction_types, request, segments, results);
   } else {
-    AggregateRealtimeConversion(prediction_types, request, segments, results);
-    AggregateUnigramPrediction(prediction_types, request, *segments, results);
-    AggregateBigramPrediction(prediction_types, request, *segments, results);
-    AggregateSuffixPrediction(prediction_types, request, *segments, results);
-    AggregateEnglishPrediction(prediction_types, request, *segments, results);
-    AggregateTypeCorrectingPrediction(prediction_types, request, *segments,
-                                      results);
+    {
+      ScopedLatencyTimer timer(realtime_conversion_histogram_);
+      AggregateRealtimeConversion(prediction_types, request, segments,
+                                  results);
+    }
+
+    typedef void (DictionaryPredictor::*AggregateFunc)(
+        PredictionTypes types, const ConversionRequest &request,
+        const Segments &segments, vector<Result> *results) const;
+    struct Aggregator {
+      AggregateFunc func;
+      LatencyHistogram *histogram;
+    };
+    const Aggregator kAggregators[] = {
+      {&DictionaryPredictor::AggregateUnigramPrediction, unigram_histogram_},
+      {&DictionaryPredictor::AggregateBigramPrediction, bigram_histogram_},
+      {&DictionaryPredictor::AggregateSuffixPrediction, suffix_histogram_},
+      {&DictionaryPredictor::AggregateEnglishPrediction, english_histogram_},
+      {&DictionaryPredictor::AggregateTypeCorrectingPrediction,
+       type_correcting_histogram_},
+    };
+    for (size_t i = 0; i < arraysize(kAggregators); ++i) {
+      // Once the request expires, the results aggregated so far are used as
+      // a best-effort result.
+      if (request.IsExpired()) {
+        UsageStats::IncrementCount(
+            "ConversionRequestExpiredInAggregatePrediction");
+        break;
+      }
+      ScopedLatencyTimer timer(kAggregators[i].histogram);
+      (this->*kAggregators[i].func)(prediction_types, request, *segments,
+                                    results);
+    }
   }
 
   if (results->empty()) {
@@ -425,7 +468,7 @@ bool DictionaryPredictor::AddPredictionToCandidates(
                           results->size());
 
   int added = 0;
-  set<string> seen;
+  FingerprintSet seen(size);
 
   int added_suffix = 0;
   bool cursor_at_tail =
@@ -475,7 +518,7 @@ bool DictionaryPredictor::AddPredictionToCandidates(
       value = result.value;
     }
 
-    if (!seen.insert(value).second) {
+    if (!seen.Insert(value)) {
       continue;
     }
 
@@ -48,6 +48,7 @@ class Connector;
 class ConversionRequest;
 class ConverterInterface;
 class ImmutableConverterInterface;
+class LatencyHistogram;
 class Segmenter;
 class Segments;
 class SuggestionFilter;
@@ -433,6 +434,14 @@ class DictionaryPredictor : public PredictorInterface {
   const uint16 counter_suffix_word_id_;
   const string predictor_name_;
 
+  // Latency histograms for each aggregation in AggregatePrediction().
+  LatencyHistogram *realtime_conversion_histogram_;
+  LatencyHistogram *unigram_histogram_;
+  LatencyHistogram *bigram_histogram_;
+  LatencyHistogram *suffix_histogram_;
+  LatencyHistogram *english_histogram_;
+  LatencyHistogram *type_correcting_histogram_;
+
   DISALLOW_COPY_AND_ASSIGN(DictionaryPredictor);
 };
 
@@ -32,12 +32,16 @@
 #include <algorithm>
 #include <cctype>
 #include <climits>
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/config_file_stream.h"
 #include "base/flags.h"
 #include "base/init.h"
 #include "base/logging.h"
+#include "base/mutex.h"
 #include "base/thread.h"
 #include "base/trie.h"
 #include "base/util.h"
@@ -61,6 +65,7 @@ using mozc::commands::Request;
 using mozc::dictionary::SuppressionDictionary;
 using mozc::dictionary::DictionaryInterface;
 using mozc::dictionary::POSMatcher;
+using mozc::user_history_predictor::UserHistoryDelta;
 
 // This flag is set by predictor.cc
 // We can remove this after the ambiguity expansion feature get stable.
@@ -96,6 +101,10 @@ const size_t kMaxNextEntriesSize = 4;
 // revert id for user_history_predictor
 const uint16 kRevertId = 1;
 
+// maximum number of deltas in the log. When the log gets longer, the whole
+// history is rewritten so that Load() doesn't replay too many deltas.
+const size_t kMaxLogSize = 64;
+
 // default object pool size for EntryPriorityQueue
 const size_t kEntryPoolSize = 16;
 
@@ -280,12 +289,16 @@ bool UserHistoryPredictor::IsPrivacySensitive(const Segments *segments) const {
 }
 
 UserHistoryStorage::UserHistoryStorage(const string &filename)
-    : storage_(new storage::EncryptedStringStorage(filename)) {
+    : storage_(new storage::EncryptedStringStorage(filename)),
+      log_broken_(false) {
 }
 
 UserHistoryStorage::~UserHistoryStorage() {}
 
 bool UserHistoryStorage::Load() {
+  deltas_.clear();
+  log_broken_ = false;
+
   string input;
   if (!storage_->Load(&input)) {
     LOG(ERROR) << "Can't load user history data.";
@@ -297,7 +310,31 @@ bool UserHistoryStorage::Load() {
     return false;
   }
 
-  VLOG(1) << "Loaded user histroy, size=" << entries_size();
+  vector<string> records;
+  if (!storage_->LoadLog(&records)) {
+    // The records before the broken one are still available.
+    LOG(WARNING) << "The log of user history data is broken.";
+    log_broken_ = true;
+  }
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    UserHistoryDelta delta;
+    if (!delta.ParseFromString(records[i])) {
+      LOG(WARNING) << "ParseFromString failed. delta looks broken";
+      log_broken_ = true;
+      break;
+    }
+    if (delta.generation() != generation()) {
+      // Appended to an older snapshot which was replaced before the log was
+      // cleared.
+      VLOG(1) << "Skipped the delta of generation " << delta.generation();
+      continue;
+    }
+    deltas_.push_back(delta);
+  }
+
+  VLOG(1) << "Loaded user histroy, size=" << entries_size()
+          << " deltas=" << deltas_.size();
   return true;
 }
 
@@ -318,6 +355,27 @@ bool UserHistoryStorage::Save() const {
     return false;
   }
 
+  // Even if the log remains, its deltas are ignored as they have the
+  // generation of the older snapshot.
+  if (!storage_->ClearLog()) {
+    LOG(WARNING) << "Can't clear the log of user history data.";
+  }
+
+  return true;
+}
+
+bool UserHistoryStorage::AppendDelta(const UserHistoryDelta &delta) const {
+  string output;
+  if (!delta.AppendToString(&output)) {
+    LOG(ERROR) << "AppendToString failed";
+    return false;
+  }
+
+  if (!storage_->AppendLog(output)) {
+    LOG(ERROR) << "Can't append user history delta.";
+    return false;
+  }
+
   return true;
 }
 
@@ -328,7 +386,7 @@ UserHistoryPredictor::EntryPriorityQueue::~EntryPriorityQueue() {}
 
 bool UserHistoryPredictor::EntryPriorityQueue::Push(Entry *entry) {
   DCHECK(entry);
-  if (!seen_.insert(Util::Fingerprint32(entry->value())).second) {
+  if (!seen_.Insert(entry->value())) {
     VLOG(2) << "found dups";
     return false;
   }
@@ -401,7 +459,10 @@ UserHistoryPredictor::UserHistoryPredictor(
       predictor_name_("UserHistoryPredictor"),
       content_word_learning_enabled_(enable_content_word_learning),
       updated_(false),
-      dic_(new DicCache(UserHistoryPredictor::cache_size())) {
+      dic_(new DicCache(UserHistoryPredictor::cache_size())),
+      generation_(0),
+      log_size_(0),
+      snapshot_required_(false) {
   AsyncLoad();  // non-blocking
   // Load()  blocking version can be used if any
 }
@@ -423,6 +484,9 @@ uint16 UserHistoryPredictor::revert_id() {
 }
 
 void UserHistoryPredictor::WaitForSyncer() {
+  // The syncer thread never acquires |syncer_mutex_|, so it is safe to join
+  // it while holding the lock.
+  scoped_lock l(&syncer_mutex_);
   if (syncer_.get() != NULL) {
     syncer_->Join();
     syncer_.reset(NULL);
@@ -435,6 +499,11 @@ bool UserHistoryPredictor::WaitForSyncerForTest() {
 }
 
 bool UserHistoryPredictor::CheckSyncerAndDelete() const {
+  scoped_lock l(&syncer_mutex_);
+  return CheckSyncerAndDeleteInternal();
+}
+
+bool UserHistoryPredictor::CheckSyncerAndDeleteInternal() const {
   if (syncer_.get() != NULL) {
     if (syncer_->IsRunning()) {
       return false;
@@ -457,7 +526,8 @@ bool UserHistoryPredictor::Reload() {
 }
 
 bool UserHistoryPredictor::AsyncLoad() {
-  if (!CheckSyncerAndDelete()) {  // now loading/saving
+  scoped_lock l(&syncer_mutex_);
+  if (!CheckSyncerAndDeleteInternal()) {  // now loading/saving
     return true;
   }
 
@@ -470,11 +540,15 @@ bool UserHistoryPredictor::AsyncLoad() {
 }
 
 bool UserHistoryPredictor::AsyncSave() {
-  if (!updated_) {
-    return true;
+  {
+    scoped_reader_lock l(&dic_mutex_);
+    if (!updated_) {
+      return true;
+    }
   }
 
-  if (!CheckSyncerAndDelete()) {  // now loading/saving
+  scoped_lock l(&syncer_mutex_);
+  if (!CheckSyncerAndDeleteInternal()) {  // now loading/saving
     return true;
   }
 
@@ -495,17 +569,57 @@ bool UserHistoryPredictor::Load() {
     return false;
   }
 
+  scoped_writer_lock l(&dic_mutex_);
   for (size_t i = 0; i < history.entries_size(); ++i) {
     dic_->Insert(EntryFingerprint(history.entries(i)),
                  history.entries(i));
   }
 
-  VLOG(1) << "Loaded user histroy, size=" << history.entries_size();
+  for (size_t i = 0; i < history.deltas().size(); ++i) {
+    ApplyDelta(history.deltas()[i]);
+  }
+
+  {
+    scoped_lock l(&dirty_entries_mutex_);
+    generation_ = history.generation();
+    log_size_ = history.deltas().size();
+    if (history.log_broken()) {
+      // Deltas appended after the broken record would not be readable.
+      snapshot_required_ = true;
+    }
+  }
+
+  VLOG(1) << "Loaded user histroy, size=" << history.entries_size()
+          << " deltas=" << history.deltas().size();
 
   return true;
 }
 
+void UserHistoryPredictor::ApplyDelta(const UserHistoryDelta &delta) {
+  for (size_t i = 0; i < delta.updated_entries_size(); ++i) {
+    const Entry &entry = delta.updated_entries(i);
+    Entry *target = dic_->MutableLookupWithoutInsert(EntryFingerprint(entry));
+    if (target != NULL) {
+      target->CopyFrom(entry);
+    }
+  }
+
+  // The erased entries include the ones evicted by the inserts (see
+  // InsertToDic()).  Once they are erased, the inserts fit in the LRU
+  // without evicting anything, so the replay reproduces the saved LRU.
+  for (size_t i = 0; i < delta.erased_entry_fps_size(); ++i) {
+    dic_->Erase(delta.erased_entry_fps(i));
+  }
+
+  for (size_t i = 0; i < delta.entries_size(); ++i) {
+    dic_->Insert(EntryFingerprint(delta.entries(i)), delta.entries(i));
+  }
+}
+
 bool UserHistoryPredictor::Save() {
+  // Sessions do not touch the history while the syncer is running, so
+  // holding the lock during the file I/O doesn't block them in practice.
+  scoped_writer_lock l(&dic_mutex_);
   if (!updated_) {
     return true;
   }
@@ -520,46 +634,178 @@ bool UserHistoryPredictor::Save() {
     return true;
   }
 
-  const DicElement *tail = dic_->Tail();
-  if (tail == NULL) {
+  if (dic_->Tail() == NULL) {
     return true;
   }
 
   const string filename = GetUserHistoryFileName();
 
   UserHistoryStorage history(filename);
-  for (const DicElement *elm = tail; elm != NULL; elm = elm->prev) {
-    history.add_entries()->CopyFrom(elm->value);
+
+  map<uint32, bool> dirty_entries;
+  bool snapshot_required = false;
+  {
+    scoped_lock l(&dirty_entries_mutex_);
+    dirty_entries.swap(dirty_entries_);
+    snapshot_required =
+        snapshot_required_ || generation_ == 0 || log_size_ >= kMaxLogSize;
+  }
+
+  const bool saved = snapshot_required ?
+      SaveSnapshot(&history) : SaveDelta(dirty_entries, &history);
+  if (!saved) {
+    // Keep the changes for the next Save().
+    scoped_lock l(&dirty_entries_mutex_);
+    for (map<uint32, bool>::const_iterator it = dirty_entries.begin();
+         it != dirty_entries.end(); ++it) {
+      bool &moved_to_head = dirty_entries_[it->first];
+      moved_to_head = moved_to_head || it->second;
+    }
+    return false;
   }
 
   // update usage stats here.
   usage_stats::UsageStats::SetInteger(
       "UserHistoryPredictorEntrySize",
-      static_cast<int>(history.entries_size()));
+      static_cast<int>(dic_->Size()));
+
+  updated_ = false;
+
+  return true;
+}
 
-  if (!history.Save()) {
+bool UserHistoryPredictor::SaveSnapshot(UserHistoryStorage *history) {
+  for (const DicElement *elm = dic_->Tail(); elm != NULL; elm = elm->prev) {
+    history->add_entries()->CopyFrom(elm->value);
+  }
+
+  uint64 current_generation = 0;
+  {
+    scoped_lock l(&dirty_entries_mutex_);
+    current_generation = generation_;
+  }
+
+  // A new generation invalidates the deltas in the log even if the log
+  // cannot be cleared.
+  uint64 generation = 0;
+  while (generation == 0 || generation == current_generation) {
+    Util::GetRandomSequence(reinterpret_cast<char *>(&generation),
+                            sizeof(generation));
+  }
+  history->set_generation(generation);
+
+  if (!history->Save()) {
     LOG(ERROR) << "UserHistoryStorage::Save() failed";
     return false;
   }
 
-  updated_ = false;
+  scoped_lock l(&dirty_entries_mutex_);
+  generation_ = generation;
+  log_size_ = 0;
+  snapshot_required_ = false;
+
+  return true;
+}
+
+bool UserHistoryPredictor::SaveDelta(const map<uint32, bool> &dirty_entries,
+                                     UserHistoryStorage *history) {
+  if (dirty_entries.empty()) {
+    return true;
+  }
+
+  UserHistoryDelta delta;
+  {
+    scoped_lock l(&dirty_entries_mutex_);
+    delta.set_generation(generation_);
+  }
+
+  size_t num_moved_entries = 0;
+  for (map<uint32, bool>::const_iterator it = dirty_entries.begin();
+       it != dirty_entries.end(); ++it) {
+    const Entry *entry = dic_->LookupWithoutInsert(it->first);
+    if (entry == NULL) {
+      delta.add_erased_entry_fps(it->first);
+    } else if (it->second) {
+      ++num_moved_entries;
+    } else {
+      delta.add_updated_entries()->CopyFrom(*entry);
+    }
+  }
+
+  // The moved entries are near the head of LRU. Collect them from the head
+  // and store them from tail to head so that replaying them reproduces the
+  // order of LRU.
+  vector<const Entry *> moved_entries;
+  for (const DicElement *elm = dic_->Head();
+       elm != NULL && moved_entries.size() < num_moved_entries;
+       elm = elm->next) {
+    const map<uint32, bool>::const_iterator it = dirty_entries.find(elm->key);
+    if (it != dirty_entries.end() && it->second) {
+      moved_entries.push_back(&elm->value);
+    }
+  }
+  for (vector<const Entry *>::const_reverse_iterator it =
+           moved_entries.rbegin();
+       it != moved_entries.rend(); ++it) {
+    delta.add_entries()->CopyFrom(**it);
+  }
+
+  if (!history->AppendDelta(delta)) {
+    LOG(ERROR) << "UserHistoryStorage::AppendDelta() failed";
+    return false;
+  }
+
+  scoped_lock l(&dirty_entries_mutex_);
+  ++log_size_;
 
   return true;
 }
 
+UserHistoryPredictor::DicElement *UserHistoryPredictor::InsertToDic(
+    uint32 fp) {
+  const DicElement *tail = dic_->Tail();
+  const bool has_other_tail = (tail != NULL && tail->key != fp);
+  const uint32 tail_fp = has_other_tail ? tail->key : 0;
+  DicElement *e = dic_->Insert(fp);
+  if (has_other_tail && !dic_->HasKey(tail_fp)) {
+    // The tail was evicted to make room for |fp|.
+    MarkDirty(tail_fp, false);
+  }
+  if (e != NULL) {
+    MarkDirty(fp, true);
+  }
+  return e;
+}
+
+void UserHistoryPredictor::MarkDirty(uint32 fp, bool moved_to_head) {
+  scoped_lock l(&dirty_entries_mutex_);
+  bool &dirty_moved_to_head = dirty_entries_[fp];
+  dirty_moved_to_head = dirty_moved_to_head || moved_to_head;
+}
+
+void UserHistoryPredictor::RequestSnapshot() {
+  scoped_lock l(&dirty_entries_mutex_);
+  dirty_entries_.clear();
+  snapshot_required_ = true;
+}
+
 bool UserHistoryPredictor::ClearAllHistory() {
   // Wait until syncer finishes
   WaitForSyncer();
 
   VLOG(1) << "Clearing user prediction";
-  // renew DicCache as LRUCache tries to reuse the internal value by
-  // using FreeList
-  dic_.reset(new DicCache(UserHistoryPredictor::cache_size()));
+  {
+    scoped_writer_lock l(&dic_mutex_);
+    // renew DicCache as LRUCache tries to reuse the internal value by
+    // using FreeList
+    dic_.reset(new DicCache(UserHistoryPredictor::cache_size()));
 
-  // insert a dummy event entry.
-  InsertEvent(Entry::CLEAN_ALL_EVENT);
+    // insert a dummy event entry.
+    InsertEvent(Entry::CLEAN_ALL_EVENT);
 
-  updated_ = true;
+    RequestSnapshot();
+    updated_ = true;
+  }
 
   Sync();
 
@@ -571,31 +817,35 @@ bool UserHistoryPredictor::ClearUnusedHistory() {
   WaitForSyncer();
 
   VLOG(1) << "Clearing unused prediction";
-  const DicElement *head = dic_->Head();
-  if (head == NULL) {
-    VLOG(2) << "dic head is NULL";
-    return false;
-  }
-
   vector<uint32> keys;
-  for (const DicElement *elm = head; elm != NULL; elm = elm->next) {
-    VLOG(3) << elm->key << " " << elm->value.suggestion_freq();
-    if (elm->value.suggestion_freq() == 0) {
-      keys.push_back(elm->key);
+  {
+    scoped_writer_lock l(&dic_mutex_);
+    const DicElement *head = dic_->Head();
+    if (head == NULL) {
+      VLOG(2) << "dic head is NULL";
+      return false;
     }
-  }
 
-  for (size_t i = 0; i < keys.size(); ++i) {
-    VLOG(2) << "Removing: " << keys[i];
-    if (!dic_->Erase(keys[i])) {
-      LOG(ERROR) << "cannot erase " << keys[i];
+    for (const DicElement *elm = head; elm != NULL; elm = elm->next) {
+      VLOG(3) << elm->key << " " << elm->value.suggestion_freq();
+      if (elm->value.suggestion_freq() == 0) {
+        keys.push_back(elm->key);
+      }
     }
-  }
 
-  // insert a dummy event entry.
-  InsertEvent(Entry::CLEAN_UNUSED_EVENT);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      VLOG(2) << "Removing: " << keys[i];
+      if (!dic_->Erase(keys[i])) {
+        LOG(ERROR) << "cannot erase " << keys[i];
+      }
+    }
 
-  updated_ = true;
+    // insert a dummy event entry.
+    InsertEvent(Entry::CLEAN_UNUSED_EVENT);
+
+    RequestSnapshot();
+    updated_ = true;
+  }
 
   Sync();
 
@@ -673,6 +923,7 @@ UserHistoryPredictor::RemoveNgramChain(const string &target_key,
           // |entry| is the second-to-the-last node. So cut the link to the
           // child entry.
           EraseNextEntries(fp, entry);
+          MarkDirty(EntryFingerprint(*entry), false);
           return DONE;
         default:
           break;
@@ -708,15 +959,18 @@ UserHistoryPredictor::RemoveNgramChain(const string &target_key,
 
 bool UserHistoryPredictor::ClearHistoryEntry(const string &key,
                                              const string &value) {
+  scoped_writer_lock l(&dic_mutex_);
   bool deleted = false;
   {
     // Find the history entry that has the exactly same key and value and has
     // not been removed yet. If exists, remove it.
-    Entry *entry = dic_->MutableLookupWithoutInsert(Fingerprint(key, value));
+    const uint32 fp = Fingerprint(key, value);
+    Entry *entry = dic_->MutableLookupWithoutInsert(fp);
     if (entry != NULL && !entry->removed()) {
       entry->set_suggestion_freq(0);
       entry->set_conversion_freq(0);
       entry->set_removed(true);
+      MarkDirty(fp, false);
       // We don't clear entry->next_entries() so that we can generate prediction
       // by chaining.
       deleted = true;
@@ -1157,6 +1411,10 @@ bool UserHistoryPredictor::PredictForRequest(const ConversionRequest &request,
     return false;
   }
 
+  // Prediction only reads the history, so sessions on other threads can
+  // predict at the same time.
+  scoped_reader_lock l(&dic_mutex_);
+
   if (GET_CONFIG(incognito_mode)) {
     VLOG(2) << "incognito mode";
     return false;
@@ -1528,7 +1786,7 @@ void UserHistoryPredictor::InsertEvent(EntryType type) {
   const uint32 dic_key = Fingerprint("", "", type);
 
   CHECK(dic_.get());
-  DicElement *e = dic_->Insert(dic_key);
+  DicElement *e = InsertToDic(dic_key);
   if (e == NULL) {
     VLOG(2) << "insert failed";
     return;
@@ -1572,7 +1830,7 @@ void UserHistoryPredictor::Insert(const string &key,
     // add a treatment for UPDATE_ENTRY mode
   }
 
-  DicElement *e = dic_->Insert(dic_key);
+  DicElement *e = InsertToDic(dic_key);
   if (e == NULL) {
     VLOG(2) << "insert failed";
     return;
@@ -1633,6 +1891,8 @@ void UserHistoryPredictor::Finish(Segments *segments) {
     return;
   }
 
+  scoped_writer_lock l(&dic_mutex_);
+
   const bool is_suggestion = segments->request_type() != Segments::CONVERSION;
   const uint64 last_access_time = Util::GetTime();
 
@@ -1820,8 +2080,11 @@ void UserHistoryPredictor::InsertHistory(bool is_suggestion_selected,
         IsPunctuation(conversion_segment.value)) {
       return;
     }
-    Entry *history_entry = dic_->MutableLookupWithoutInsert(
-        LearningSegmentFingerprint(history_segment));
+    const uint32 history_fp = LearningSegmentFingerprint(history_segment);
+    Entry *history_entry = dic_->MutableLookupWithoutInsert(history_fp);
+    if (history_entry != NULL) {
+      MarkDirty(history_fp, false);
+    }
     NextEntry next_entry;
     if (segments->request_type() == Segments::CONVERSION) {
       next_entry.set_entry_fp(LearningSegmentFingerprint(conversion_segment));
@@ -1845,13 +2108,17 @@ void UserHistoryPredictor::Revert(Segments *segments) {
     return;
   }
 
+  scoped_writer_lock l(&dic_mutex_);
+
   for (size_t i = 0; i < segments->revert_entries_size(); ++i) {
     const Segments::RevertEntry &revert_entry =
         segments->revert_entry(i);
     if (revert_entry.id == UserHistoryPredictor::revert_id() &&
         revert_entry.revert_entry_type == Segments::RevertEntry::CREATE_ENTRY) {
-      VLOG(2) << "Erasing the key: " << StringToUint32(revert_entry.key);
-      dic_->Erase(StringToUint32(revert_entry.key));
+      const uint32 fp = StringToUint32(revert_entry.key);
+      VLOG(2) << "Erasing the key: " << fp;
+      dic_->Erase(fp);
+      MarkDirty(fp, false);
     }
   }
 }
@@ -30,13 +30,15 @@
 #ifndef MOZC_PREDICTION_USER_HISTORY_PREDICTOR_H_
 #define MOZC_PREDICTION_USER_HISTORY_PREDICTOR_H_
 
+#include <map>
 #include <queue>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/fingerprint_set.h"
 #include "base/freelist.h"
+#include "base/mutex.h"
 #include "base/scoped_ptr.h"
 #include "base/string_piece.h"
 #include "base/trie.h"
@@ -66,21 +68,40 @@ class UserHistoryStorage : public mozc::user_history_predictor::UserHistory {
   explicit UserHistoryStorage(const string &filename);
   ~UserHistoryStorage();
 
-  // Load from encrypted file.
+  // Load from encrypted file. The deltas appended to the log of this
+  // snapshot are loaded into deltas().
   bool Load();
 
-  // Save history into encrypted file.
+  // Save history into encrypted file. As the log is cleared, all the deltas
+  // must be merged into the entries beforehand.
   bool Save() const;
 
+  // Appends |delta| to the log without rewriting the whole history.
+  bool AppendDelta(const user_history_predictor::UserHistoryDelta &delta) const;
+
+  // Deltas loaded by Load(), in the order of appending.
+  const vector<user_history_predictor::UserHistoryDelta> &deltas() const {
+    return deltas_;
+  }
+
+  // Returns true if Load() found a broken record at the end of the log. As
+  // records appended after the broken one cannot be read, the history must
+  // be saved with Save() before calling AppendDelta().
+  bool log_broken() const {
+    return log_broken_;
+  }
+
  private:
   scoped_ptr<storage::StringStorageInterface> storage_;
+  vector<user_history_predictor::UserHistoryDelta> deltas_;
+  bool log_broken_;
 };
 
-// UserHistoryPredictor is NOT thread safe.
-// Currently, all methods of UserHistoryPredictor is called
-// by single thread. Although AsyncSave() and AsyncLoad() make
-// worker threads internally, these two functions won't be
-// called by multiple-threads at the same time
+// UserHistoryPredictor is thread safe.  The history is guarded by a
+// reader-writer lock: predictions from different sessions run in parallel
+// while Finish(), Revert() and the clear operations are serialized.
+// AsyncSave() and AsyncLoad() make a worker thread internally; predictions
+// are skipped while it is running.
 class UserHistoryPredictor : public PredictorInterface {
  public:
   UserHistoryPredictor(
@@ -239,6 +260,9 @@ class UserHistoryPredictor : public PredictorInterface {
   FRIEND_TEST(UserHistoryPredictorTest, PrivacySensitiveTest);
   FRIEND_TEST(UserHistoryPredictorTest, PrivacySensitiveMultiSegmentsTest);
   FRIEND_TEST(UserHistoryPredictorTest, UserHistoryStorage);
+  FRIEND_TEST(UserHistoryPredictorTest, IncrementalSave);
+  FRIEND_TEST(UserHistoryPredictorTest, IncrementalSaveWithBrokenLog);
+  FRIEND_TEST(UserHistoryPredictorTest, IncrementalSaveWithEvictions);
   FRIEND_TEST(UserHistoryPredictorTest, RomanFuzzyPrefixMatch);
   FRIEND_TEST(UserHistoryPredictorTest, MaybeRomanMisspelledKey);
   FRIEND_TEST(UserHistoryPredictorTest, GetRomanMisspelledKey);
@@ -298,9 +322,29 @@ class UserHistoryPredictor : public PredictorInterface {
   // Load user history data to LRU from local file
   bool Load();
 
-  // Save user history data in LRU to local file
+  // Save user history data in LRU to local file. Usually only the entries
+  // changed since the last save are appended to the log, and the whole
+  // history is rewritten when the log gets long.
   bool Save();
 
+  // Rewrites the whole history with a new generation and clears the log.
+  bool SaveSnapshot(UserHistoryStorage *history);
+
+  // Appends the changes of |dirty_entries| to the log.
+  bool SaveDelta(const map<uint32, bool> &dirty_entries,
+                 UserHistoryStorage *history);
+
+  // Applies |delta| loaded from the log to LRU.
+  void ApplyDelta(const user_history_predictor::UserHistoryDelta &delta);
+
+  // Records that the entry of |fp| was changed after the last save.
+  // |moved_to_head| is true if the entry was inserted or moved to the head of
+  // LRU. Erased entries are recorded with false.
+  void MarkDirty(uint32 fp, bool moved_to_head);
+
+  // Makes the next Save() rewrite the whole history instead of the changes.
+  void RequestSnapshot();
+
   // non-blocking version of Load
   // This makes a new thread and call Load()
   bool AsyncSave();
@@ -372,13 +416,21 @@ class UserHistoryPredictor : public PredictorInterface {
     typedef priority_queue<QueueElement> Agenda;
     Agenda agenda_;
     FreeList<Entry> pool_;
-    set<uint32> seen_;
+    // Fingerprints of the values of the pushed entries.
+    FingerprintSet seen_;
   };
 
   typedef mozc::storage::LRUCache<uint32, Entry> DicCache;
   typedef DicCache::Element DicElement;
 
+  // Inserts |fp| at the head of LRU and marks it dirty.  If the insert
+  // evicts the tail, the evicted entry is marked dirty as erased so that the
+  // delta reproduces the eviction.
+  DicElement *InsertToDic(uint32 fp);
+
   bool CheckSyncerAndDelete() const;
+  // Same as CheckSyncerAndDelete() but |syncer_mutex_| must be held.
+  bool CheckSyncerAndDeleteInternal() const;
 
   // If |entry| is the target of prediction,
   // create a new result and insert it to |results|.
@@ -499,8 +551,25 @@ class UserHistoryPredictor : public PredictorInterface {
   const string predictor_name_;
 
   bool content_word_learning_enabled_;
+
+  // Guards |dic_| and |updated_|.  Acquired before |dirty_entries_mutex_|.
+  mutable ReaderWriterMutex dic_mutex_;
   bool updated_;
   scoped_ptr<DicCache> dic_;
+
+  // Entries changed after the last save. The value is true if the entry was
+  // moved to the head of LRU.
+  map<uint32, bool> dirty_entries_;
+  // Guards |dirty_entries_|, |generation_|, |log_size_| and
+  // |snapshot_required_|.
+  Mutex dirty_entries_mutex_;
+  // Generation of the snapshot on the disk, or 0 if unknown.
+  uint64 generation_;
+  // Number of deltas appended to the log of the snapshot.
+  size_t log_size_;
+  // True if the next Save() must rewrite the whole history.
+  bool snapshot_required_;
+  mutable Mutex syncer_mutex_;
   mutable scoped_ptr<UserHistoryPredictorSyncer> syncer_;
 };
 
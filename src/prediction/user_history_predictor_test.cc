@@ -32,6 +32,7 @@
 #include <set>
 #include <string>
 
+#include "base/file_stream.h"
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/number_util.h"
@@ -123,6 +124,15 @@ void AddCandidateWithDescription(const string &value,
   AddCandidateWithDescription(0, value, desc, segments);
 }
 
+void FinishConversion(UserHistoryPredictor *predictor,
+                      const string &key, const string &value,
+                      Segments *segments) {
+  segments->Clear();
+  MakeSegmentsForConversion(key, segments);
+  AddCandidate(value, segments);
+  predictor->Finish(segments);
+}
+
 bool FindCandidateByValue(const string &value, const Segments &segments) {
   for (size_t i = 0;
        i < segments.conversion_segment(0).candidates_size(); ++i) {
@@ -168,6 +178,40 @@ class UserHistoryPredictorTest : public ::testing::Test {
     return predictor;
   }
 
+  // Creates another predictor sharing the dictionaries. It loads the history
+  // saved by GetUserHistoryPredictor() asynchronously.
+  UserHistoryPredictor *CreateUserHistoryPredictor() const {
+    testing::MockDataManager data_manager;
+    return new UserHistoryPredictor(
+        data_and_predictor_->dictionary.get(),
+        data_manager.GetPOSMatcher(),
+        data_and_predictor_->suppression_dictionary.get(),
+        false);
+  }
+
+  static bool HasEntry(const UserHistoryPredictor &predictor,
+                       const string &key, const string &value) {
+    return predictor.dic_->LookupWithoutInsert(
+        UserHistoryPredictor::Fingerprint(key, value)) != NULL;
+  }
+
+  static size_t GetLogSize(const UserHistoryPredictor &predictor) {
+    return predictor.log_size_;
+  }
+
+  // Expects that the LRUs of |expected| and |actual| have the same entries in
+  // the same order.
+  static void ExpectSameHistory(const UserHistoryPredictor &expected,
+                                const UserHistoryPredictor &actual) {
+    const UserHistoryPredictor::DicElement *e = expected.dic_->Head();
+    const UserHistoryPredictor::DicElement *a = actual.dic_->Head();
+    for (; e != NULL && a != NULL; e = e->next, a = a->next) {
+      EXPECT_EQ(e->value.DebugString(), a->value.DebugString());
+    }
+    EXPECT_TRUE(e == NULL);
+    EXPECT_TRUE(a == NULL);
+  }
+
   DictionaryMock *GetDictionaryMock() {
     return data_and_predictor_->dictionary.get();
   }
@@ -2662,6 +2706,176 @@ TEST_F(UserHistoryPredictorTest, UserHistoryStorage) {
   FileUtil::Unlink(filename);
 }
 
+TEST_F(UserHistoryPredictorTest, UserHistoryStorageDelta) {
+  const string filename =
+      FileUtil::JoinPath(SystemUtil::GetUserProfileDirectory(), "test");
+
+  UserHistoryStorage storage1(filename);
+  storage1.add_entries()->set_key("key");
+  storage1.set_generation(1);
+  ASSERT_TRUE(storage1.Save());
+
+  user_history_predictor::UserHistoryDelta delta;
+  delta.set_generation(2);
+  delta.add_erased_entry_fps(12345);
+  EXPECT_TRUE(storage1.AppendDelta(delta));
+  delta.set_generation(1);
+  delta.add_entries()->set_key("new key");
+  EXPECT_TRUE(storage1.AppendDelta(delta));
+
+  // The delta of the other generation is ignored.
+  UserHistoryStorage storage2(filename);
+  ASSERT_TRUE(storage2.Load());
+  EXPECT_EQ(1, storage2.generation());
+  ASSERT_EQ(1, storage2.deltas().size());
+  EXPECT_EQ(delta.DebugString(), storage2.deltas()[0].DebugString());
+  EXPECT_FALSE(storage2.log_broken());
+
+  // Saving the snapshot clears the log.
+  ASSERT_TRUE(storage2.Save());
+  UserHistoryStorage storage3(filename);
+  ASSERT_TRUE(storage3.Load());
+  EXPECT_TRUE(storage3.deltas().empty());
+
+  FileUtil::Unlink(filename);
+}
+
+TEST_F(UserHistoryPredictorTest, IncrementalSave) {
+  UserHistoryPredictor *predictor =
+      GetUserHistoryPredictorWithClearedHistory();
+  const string log_filename =
+      UserHistoryPredictor::GetUserHistoryFileName() + ".log";
+
+  // ClearAllHistory() rewrites the whole history.
+  EXPECT_EQ(0, GetLogSize(*predictor));
+  EXPECT_FALSE(FileUtil::FileExists(log_filename));
+
+  Segments segments;
+  FinishConversion(predictor, "abc", "ABC", &segments);
+  FinishConversion(predictor, "def", "DEF", &segments);
+  EXPECT_TRUE(predictor->Save());
+  EXPECT_EQ(1, GetLogSize(*predictor));
+  EXPECT_TRUE(FileUtil::FileExists(log_filename));
+
+  // Moves an entry to the head, reverts a new entry and removes an entry.
+  FinishConversion(predictor, "abc", "ABC", &segments);
+  FinishConversion(predictor, "ghi", "GHI", &segments);
+  predictor->Revert(&segments);
+  EXPECT_TRUE(predictor->ClearHistoryEntry("def", "DEF"));
+  FinishConversion(predictor, "jkl", "JKL", &segments);
+  EXPECT_TRUE(predictor->Save());
+  EXPECT_EQ(2, GetLogSize(*predictor));
+
+  {
+    scoped_ptr<UserHistoryPredictor> loaded(CreateUserHistoryPredictor());
+    loaded->WaitForSyncer();
+    EXPECT_TRUE(HasEntry(*loaded, "abc", "ABC"));
+    EXPECT_FALSE(HasEntry(*loaded, "ghi", "GHI"));
+    ExpectSameHistory(*predictor, *loaded);
+  }
+
+  // The whole history is rewritten when the log gets long.
+  for (int i = 0; i < 100; ++i) {
+    const string number = NumberUtil::SimpleItoa(i);
+    // "value<number>あ"
+    FinishConversion(predictor, "key" + number,
+                     "value" + number + "\xE3\x81\x82", &segments);
+    EXPECT_TRUE(predictor->Save());
+  }
+  EXPECT_GT(100, GetLogSize(*predictor));
+
+  {
+    scoped_ptr<UserHistoryPredictor> loaded(CreateUserHistoryPredictor());
+    loaded->WaitForSyncer();
+    ExpectSameHistory(*predictor, *loaded);
+  }
+
+  predictor->ClearAllHistory();
+  predictor->WaitForSyncer();
+  EXPECT_EQ(0, GetLogSize(*predictor));
+  EXPECT_FALSE(FileUtil::FileExists(log_filename));
+}
+
+TEST_F(UserHistoryPredictorTest, IncrementalSaveWithEvictions) {
+  UserHistoryPredictor *predictor =
+      GetUserHistoryPredictorWithClearedHistory();
+
+  // Fills the LRU.  The values contain a non-ASCII character so that they
+  // are not rejected as privacy sensitive.
+  Segments segments;
+  for (uint32 i = 0; i < UserHistoryPredictor::cache_size(); ++i) {
+    const string number = NumberUtil::SimpleItoa(i);
+    // "value<number>あ"
+    FinishConversion(predictor, "key" + number,
+                     "value" + number + "\xE3\x81\x82", &segments);
+  }
+  EXPECT_EQ(UserHistoryPredictor::cache_size(), predictor->dic_->Size());
+  EXPECT_TRUE(predictor->Save());
+
+  for (int i = 0; i < 10; ++i) {
+    const string number = NumberUtil::SimpleItoa(i);
+    // Inserts into the full LRU, which evicts the tail, and erases the new
+    // entry in the same delta.
+    FinishConversion(predictor, "a" + number, "A" + number + "\xE3\x81\x82",
+                     &segments);  // "A<number>あ"
+    predictor->Revert(&segments);
+    FinishConversion(predictor, "b" + number, "B" + number + "\xE3\x81\x82",
+                     &segments);  // "B<number>あ"
+    EXPECT_TRUE(predictor->Save());
+
+    // Erases an entry and then inserts into the slot without eviction.
+    predictor->Revert(&segments);
+    FinishConversion(predictor, "c" + number, "C" + number + "\xE3\x81\x82",
+                     &segments);  // "C<number>あ"
+    EXPECT_TRUE(predictor->Save());
+
+    // Loading the snapshot and the deltas reproduces the LRU.
+    scoped_ptr<UserHistoryPredictor> loaded(CreateUserHistoryPredictor());
+    loaded->WaitForSyncer();
+    ExpectSameHistory(*predictor, *loaded);
+  }
+  EXPECT_LT(0, GetLogSize(*predictor));
+}
+
+TEST_F(UserHistoryPredictorTest, IncrementalSaveWithBrokenLog) {
+  UserHistoryPredictor *predictor =
+      GetUserHistoryPredictorWithClearedHistory();
+  const string log_filename =
+      UserHistoryPredictor::GetUserHistoryFileName() + ".log";
+
+  Segments segments;
+  FinishConversion(predictor, "abc", "ABC", &segments);
+  EXPECT_TRUE(predictor->Save());
+  FinishConversion(predictor, "def", "DEF", &segments);
+  EXPECT_TRUE(predictor->Save());
+  EXPECT_EQ(2, GetLogSize(*predictor));
+
+  // Emulates a crash while appending the last delta.
+  string log;
+  {
+    InputFileStream ifs(log_filename.c_str(), ios::in | ios::binary);
+    ASSERT_TRUE(ifs);
+    log.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  }
+  {
+    OutputFileStream ofs(log_filename.c_str(),
+                         ios::out | ios::trunc | ios::binary);
+    ofs.write(log.data(), log.size() - 1);
+  }
+
+  // Only the last delta is lost.
+  scoped_ptr<UserHistoryPredictor> loaded(CreateUserHistoryPredictor());
+  loaded->WaitForSyncer();
+  EXPECT_TRUE(HasEntry(*loaded, "abc", "ABC"));
+  EXPECT_FALSE(HasEntry(*loaded, "def", "DEF"));
+
+  // The broken log is discarded by rewriting the whole history.
+  FinishConversion(loaded.get(), "ghi", "GHI", &segments);
+  EXPECT_TRUE(loaded->Save());
+  EXPECT_EQ(0, GetLogSize(*loaded));
+  EXPECT_FALSE(FileUtil::FileExists(log_filename));
+}
+
 TEST_F(UserHistoryPredictorTest, RomanFuzzyPrefixMatch) {
   // same
   EXPECT_FALSE(UserHistoryPredictor::RomanFuzzyPrefixMatch("abc", "abc"));
@@ -60,6 +60,18 @@
         '../base/base.gyp:base',
       ],
     },
+    {
+      'target_name': 'renderer_command_delta',
+      'type': 'static_library',
+      'sources': [
+        'renderer_command_delta.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../protobuf/protobuf.gyp:protobuf',
+        'renderer_protocol',
+      ],
+    },
     {
       'target_name': 'renderer_client',
       'type': 'static_library',
@@ -71,6 +83,7 @@
         '../config/config.gyp:config_protocol',
         '../ipc/ipc.gyp:ipc',
         '../session/session_base.gyp:session_protocol',
+        'renderer_command_delta',
         'renderer_protocol',
       ],
     },
@@ -86,9 +99,24 @@
         '../config/config.gyp:config_handler',
         '../ipc/ipc.gyp:ipc',
         '../session/session_base.gyp:session_protocol',
+        'renderer_command_delta',
         'renderer_protocol',
       ],
     },
+    {
+      'target_name': 'renderer_command_delta_test',
+      'type': 'executable',
+      'sources': [
+        'renderer_command_delta_test.cc',
+      ],
+      'dependencies': [
+        '../testing/testing.gyp:gtest_main',
+        'renderer_command_delta',
+      ],
+      'variables': {
+        'test_size': 'small',
+      },
+    },
     {
       'target_name': 'renderer_client_test',
       'type': 'executable',
@@ -211,6 +239,7 @@
       'type': 'none',
       'dependencies': [
         'renderer_client_test',
+        'renderer_command_delta_test',
         'renderer_server_test',
         'renderer_style_handler_test',
         'table_layout_test',
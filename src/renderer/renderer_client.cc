@@ -44,6 +44,7 @@
 #include "ipc/ipc.h"
 #include "ipc/named_event.h"
 #include "renderer/renderer_command.pb.h"
+#include "renderer/renderer_command_delta.h"
 
 #ifdef OS_MACOSX
 #include "base/mac_util.h"
@@ -64,20 +65,27 @@ const size_t kMaxErrorTimes         = 5;
 const uint64 kRetryIntervalTime     = 30;  // 30 sec
 const char   kServiceName[]         = "renderer";
 
-inline void CallCommand(IPCClientInterface *client,
+// Returns false if the call fails or the renderer rejects |command|, i.e.,
+// |command| is a delta whose base command is not cached in the renderer.
+inline bool CallCommand(IPCClientInterface *client,
                         const commands::RendererCommand &command) {
+  // A delta lacks required fields.
   string buf;
-  command.SerializeToString(&buf);
+  command.SerializePartialToString(&buf);
 
-  // basically, we don't need to get the result
-  char result[32];
+  // The result is used only for delta updates.  Older renderers reply
+  // nothing meaningful, which is regarded as accepted.
+  char result[32] = {};
   size_t result_size = sizeof(result);
 
   if (!client->Call(buf.data(), buf.size(),
                     result, &result_size,
                     kIPCTimeout)) {
     LOG(ERROR) << "Cannot send the request: ";
+    return false;
   }
+  return result_size == 0 ||
+      result[0] != RendererCommandDelta::kNeedsFullUpdate;
 }
 }  // namespace
 
@@ -318,11 +326,18 @@ RendererClient::RendererClient()
     : is_window_visible_(false),
       disable_renderer_path_check_(false),
       version_mismatch_nums_(0),
+      revision_(0),
       ipc_client_factory_interface_(IPCClientFactory::GetIPCClientFactory()),
       renderer_launcher_(new RendererLauncher),
       renderer_launcher_interface_(NULL) {
   renderer_launcher_interface_ = renderer_launcher_.get();
 
+  // The renderer caches a single command for all the clients.  Starting at a
+  // random revision makes the revisions unique among the clients, so that a
+  // delta never applies to the command cached for another client.
+  Util::GetRandomSequence(reinterpret_cast<char *>(&revision_),
+                          sizeof(revision_));
+
   name_ = kServiceName;
   const string desktop_name(SystemUtil::GetDesktopNameAsString());
   if (!desktop_name.empty()) {
@@ -421,6 +436,7 @@ bool RendererClient::ExecCommand(const commands::RendererCommand &command) {
   }
 
   if (!renderer_launcher_interface_->CanConnect()) {
+    last_command_.reset();
     renderer_launcher_interface_->SetPendingCommand(command);
     // Check CanConnect() again, as the status might be changed
     // after SetPendingCommand().
@@ -450,6 +466,7 @@ bool RendererClient::ExecCommand(const commands::RendererCommand &command) {
   is_window_visible_ = command.visible();
 
   if (!client->Connected()) {
+    last_command_.reset();
     // We don't need to send HIDE if the renderer is not running
     if (command.type() == commands::RendererCommand::UPDATE &&
         (!is_window_visible_ || !command.has_output())) {
@@ -473,6 +490,7 @@ bool RendererClient::ExecCommand(const commands::RendererCommand &command) {
       LOG(ERROR) << "ForceTerminateServer failed";
     }
     ++version_mismatch_nums_;
+    last_command_.reset();
     renderer_launcher_interface_->SetPendingCommand(command);
     return true;
   } else if (IPC_PROTOCOL_VERSION < client->GetServerProtocolVersion()) {
@@ -489,6 +507,7 @@ bool RendererClient::ExecCommand(const commands::RendererCommand &command) {
     LOG(WARNING) << "Version mismatch: "
                  << client->GetServerProductVersion() << " "
                  << Version::GetMozcVersion();
+    last_command_.reset();
     renderer_launcher_interface_->SetPendingCommand(command);
     commands::RendererCommand shutdown_command;
     shutdown_command.set_type(commands::RendererCommand::SHUTDOWN);
@@ -497,11 +516,67 @@ bool RendererClient::ExecCommand(const commands::RendererCommand &command) {
     return true;
   }
 
-  CallCommand(client.get(), command);
+  SendCommand(client.get(), command);
 
   return true;
 }
 
+void RendererClient::SendCommand(IPCClientInterface *client,
+                                 const commands::RendererCommand &command) {
+  if (command.type() != commands::RendererCommand::UPDATE) {
+    // The renderer drops its cache when it receives a command without a
+    // revision.
+    last_command_.reset();
+    CallCommand(client, command);
+    return;
+  }
+
+  // 0 means that the command has no revision.
+  if (++revision_ == 0) {
+    ++revision_;
+  }
+  const uint64 revision = revision_;
+  scoped_ptr<IPCClientInterface> retry_client;
+  if (last_command_.get() != NULL) {
+    commands::RendererCommand delta;
+    if (RendererCommandDelta::MakeDelta(*last_command_, command, &delta)) {
+      delta.set_revision(revision);
+      delta.set_base_revision(last_command_->revision());
+      const int delta_size = delta.ByteSize();
+      if (CallCommand(client, delta)) {
+        ++update_stats_.num_delta_updates;
+        update_stats_.delta_update_bytes += delta_size;
+        VLOG(2) << "Sent a delta update: " << delta_size << " bytes";
+        last_command_->CopyFrom(command);
+        last_command_->set_revision(revision);
+        return;
+      }
+      // The renderer may not have the base command, e.g., it has been
+      // restarted.  Falls back to the full update with a new connection.
+      retry_client.reset(CreateIPCClient());
+      if (retry_client.get() == NULL) {
+        last_command_.reset();
+        return;
+      }
+      client = retry_client.get();
+    }
+  }
+
+  if (last_command_.get() == NULL) {
+    last_command_.reset(new commands::RendererCommand);
+  }
+  last_command_->CopyFrom(command);
+  last_command_->set_revision(revision);
+  const int full_size = last_command_->ByteSize();
+  if (!CallCommand(client, *last_command_)) {
+    last_command_.reset();
+    return;
+  }
+  ++update_stats_.num_full_updates;
+  update_stats_.full_update_bytes += full_size;
+  VLOG(2) << "Sent a full update: " << full_size << " bytes";
+}
+
 IPCClientInterface *RendererClient::CreateIPCClient() const {
   if (ipc_client_factory_interface_ == NULL) {
     return NULL;
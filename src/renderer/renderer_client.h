@@ -84,6 +84,18 @@ class RendererLauncherInterface {
 // IPC-based client for out-proc renderer.
 class RendererClient : public RendererInterface {
  public:
+  // Counters of the UPDATE commands sent to the renderer.
+  struct UpdateStats {
+    uint64 num_full_updates;
+    uint64 num_delta_updates;
+    uint64 full_update_bytes;
+    uint64 delta_update_bytes;
+
+    UpdateStats()
+        : num_full_updates(0), num_delta_updates(0),
+          full_update_bytes(0), delta_update_bytes(0) {}
+  };
+
   RendererClient();
   virtual ~RendererClient();
 
@@ -123,15 +135,30 @@ class RendererClient : public RendererInterface {
   // Sets the flag of error dialog suppression.
   void set_suppress_error_dialog(bool suppress);
 
+  const UpdateStats &update_stats() const { return update_stats_; }
+
  private:
   IPCClientInterface *CreateIPCClient() const;
 
+  // Sends |command| to the renderer.  An UPDATE command is sent as a delta
+  // from |last_command_| if possible, and as the full command if the delta
+  // cannot be made or the renderer rejects it.
+  void SendCommand(IPCClientInterface *client,
+                   const commands::RendererCommand &command);
+
   bool is_window_visible_;
   bool disable_renderer_path_check_;
   int  version_mismatch_nums_;
   string name_;
   string renderer_path_;
 
+  // The last UPDATE command accepted by the renderer with its revision, or
+  // NULL if the renderer may not have cached it.
+  scoped_ptr<commands::RendererCommand> last_command_;
+  // The revision of the last UPDATE command.  Starts at a random value.
+  uint64 revision_;
+  UpdateStats update_stats_;
+
   IPCClientFactoryInterface *ipc_client_factory_interface_;
 
   scoped_ptr<RendererLauncherInterface> renderer_launcher_;
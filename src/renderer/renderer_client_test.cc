@@ -38,6 +38,7 @@
 #include "base/version.h"
 #include "ipc/ipc.h"
 #include "renderer/renderer_command.pb.h"
+#include "renderer/renderer_command_delta.h"
 #include "renderer/renderer_interface.h"
 #include "testing/base/public/gunit.h"
 
@@ -62,6 +63,8 @@ int g_counter = 0;
 bool g_connected = false;
 uint32 g_server_protocol_version = IPC_PROTOCOL_VERSION;
 string g_server_product_version;
+bool g_reject_delta = false;
+int g_delta_counter = 0;
 
 class TestIPCClient : public IPCClientInterface {
  public:
@@ -94,6 +97,20 @@ class TestIPCClient : public IPCClientInterface {
                     size_t *response_size,
                     int32 timeout) {
     g_counter++;
+    uint64 revision = 0, base_revision = 0;
+    EXPECT_TRUE(RendererCommandDelta::GetRevisions(
+        request, request_size, &revision, &base_revision));
+    char result = RendererCommandDelta::kAccepted;
+    if (base_revision != 0) {
+      g_delta_counter++;
+      if (g_reject_delta) {
+        result = RendererCommandDelta::kNeedsFullUpdate;
+      }
+    }
+    if (*response_size > 0) {
+      response[0] = result;
+      *response_size = 1;
+    }
     return true;
   }
 
@@ -103,12 +120,22 @@ class TestIPCClient : public IPCClientInterface {
 
   static void Reset() {
     g_counter = 0;
+    g_delta_counter = 0;
+    g_reject_delta = false;
   }
 
   static int counter() {
     return g_counter;
   }
 
+  static int delta_counter() {
+    return g_delta_counter;
+  }
+
+  static void set_reject_delta(bool reject_delta) {
+    g_reject_delta = reject_delta;
+  }
+
   static void set_server_protocol_version(uint32 version) {
     g_server_protocol_version = version;
   }
@@ -394,6 +421,74 @@ TEST(RendererClient, ConnectionTest) {
   }
 }
 
+TEST(RendererClient, DeltaUpdateTest) {
+  TestIPCClientFactory factory;
+  TestRendererLauncher launcher;
+
+  RendererClient client;
+
+  client.SetIPCClientFactory(&factory);
+  client.SetRendererLauncherInterface(&launcher);
+  launcher.Reset();
+  launcher.set_can_connect(true);
+  TestIPCClient::set_connected(true);
+  TestIPCClient::Reset();
+
+  commands::RendererCommand command;
+  command.set_type(commands::RendererCommand::UPDATE);
+  command.set_visible(true);
+  commands::Candidates *candidates =
+      command.mutable_output()->mutable_candidates();
+  for (int i = 0; i < 9; ++i) {
+    commands::Candidates::Candidate *candidate = candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_value("candidate value " + NumberUtil::SimpleItoa(i));
+    candidate->set_id(i);
+  }
+  candidates->set_focused_index(0);
+  candidates->set_size(9);
+
+  // The first update is sent as the full command.
+  EXPECT_TRUE(client.ExecCommand(command));
+  EXPECT_EQ(1, TestIPCClient::counter());
+  EXPECT_EQ(0, TestIPCClient::delta_counter());
+  EXPECT_EQ(1, client.update_stats().num_full_updates);
+
+  // Moving the focus is sent as a delta.
+  candidates->set_focused_index(1);
+  EXPECT_TRUE(client.ExecCommand(command));
+  EXPECT_EQ(2, TestIPCClient::counter());
+  EXPECT_EQ(1, TestIPCClient::delta_counter());
+  EXPECT_EQ(1, client.update_stats().num_delta_updates);
+  EXPECT_LT(client.update_stats().delta_update_bytes,
+            client.update_stats().full_update_bytes);
+
+  // A rejected delta is followed by the full command.
+  TestIPCClient::set_reject_delta(true);
+  candidates->set_focused_index(2);
+  EXPECT_TRUE(client.ExecCommand(command));
+  EXPECT_EQ(4, TestIPCClient::counter());
+  EXPECT_EQ(2, TestIPCClient::delta_counter());
+  EXPECT_EQ(2, client.update_stats().num_full_updates);
+  TestIPCClient::set_reject_delta(false);
+
+  // Clearing a field cannot be expressed by a delta.
+  command.mutable_output()->clear_candidates();
+  EXPECT_TRUE(client.ExecCommand(command));
+  EXPECT_EQ(5, TestIPCClient::counter());
+  EXPECT_EQ(2, TestIPCClient::delta_counter());
+  EXPECT_EQ(3, client.update_stats().num_full_updates);
+
+  // A command other than UPDATE resets the delta.
+  commands::RendererCommand noop;
+  noop.set_type(commands::RendererCommand::NOOP);
+  EXPECT_TRUE(client.ExecCommand(noop));
+  EXPECT_TRUE(client.ExecCommand(command));
+  EXPECT_EQ(7, TestIPCClient::counter());
+  EXPECT_EQ(2, TestIPCClient::delta_counter());
+  EXPECT_EQ(4, client.update_stats().num_full_updates);
+}
+
 TEST(RendererClient, ShutdownTest) {
   TestIPCClientFactory factory;
   TestRendererLauncher launcher;
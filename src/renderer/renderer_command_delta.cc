@@ -0,0 +1,330 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "renderer/renderer_command_delta.h"
+
+#include <vector>
+
+#include "base/logging.h"
+#include "base/protobuf/coded_stream.h"
+#include "base/protobuf/descriptor.h"
+#include "base/protobuf/message.h"
+#include "base/protobuf/wire_format.h"
+#include "renderer/renderer_command.pb.h"
+
+namespace mozc {
+namespace renderer {
+namespace {
+
+using ::mozc::commands::RendererCommand;
+using ::mozc::protobuf::Descriptor;
+using ::mozc::protobuf::FieldDescriptor;
+using ::mozc::protobuf::Message;
+using ::mozc::protobuf::Reflection;
+using ::mozc::protobuf::internal::WireFormatLite;
+using ::mozc::protobuf::io::CodedInputStream;
+
+bool IsRevisionField(const FieldDescriptor *field) {
+  return field->containing_type() == RendererCommand::descriptor() &&
+      (field->number() == RendererCommand::kRevisionFieldNumber ||
+       field->number() == RendererCommand::kBaseRevisionFieldNumber);
+}
+
+bool HasField(const Message &message, const FieldDescriptor *field) {
+  const Reflection *reflection = message.GetReflection();
+  return field->is_repeated() ? reflection->FieldSize(message, field) > 0 :
+      reflection->HasField(message, field);
+}
+
+bool EqualsMessage(const Message &message1, const Message &message2);
+
+// Returns true if |field| of the messages are equal.  Both messages must have
+// the field.
+bool EqualsField(const Message &message1, const Message &message2,
+                 const FieldDescriptor *field) {
+  const Reflection *reflection = message1.GetReflection();
+
+// Use macro for boilerplate code generation.
+#define MOZC_FIELD_EQ_CASE(cpptype, method) \
+  case FieldDescriptor::cpptype: \
+    return reflection->method(message1, field) == \
+        reflection->method(message2, field)
+#define MOZC_REPEATED_FIELD_EQ_CASE(cpptype, method) \
+  case FieldDescriptor::cpptype: \
+    for (int i = 0; i < size; ++i) { \
+      if (reflection->method(message1, field, i) != \
+          reflection->method(message2, field, i)) { \
+        return false; \
+      } \
+    } \
+    return true
+
+  if (!field->is_repeated()) {
+    switch (field->cpp_type()) {
+      MOZC_FIELD_EQ_CASE(CPPTYPE_INT32, GetInt32);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_INT64, GetInt64);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_UINT32, GetUInt32);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_UINT64, GetUInt64);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_DOUBLE, GetDouble);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_FLOAT, GetFloat);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_BOOL, GetBool);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_ENUM, GetEnum);
+      MOZC_FIELD_EQ_CASE(CPPTYPE_STRING, GetString);
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        return EqualsMessage(reflection->GetMessage(message1, field),
+                             reflection->GetMessage(message2, field));
+    }
+  } else {
+    const int size = reflection->FieldSize(message1, field);
+    if (size != reflection->FieldSize(message2, field)) {
+      return false;
+    }
+    switch (field->cpp_type()) {
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_INT32, GetRepeatedInt32);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_INT64, GetRepeatedInt64);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_UINT32, GetRepeatedUInt32);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_UINT64, GetRepeatedUInt64);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_DOUBLE, GetRepeatedDouble);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_FLOAT, GetRepeatedFloat);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_BOOL, GetRepeatedBool);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_ENUM, GetRepeatedEnum);
+      MOZC_REPEATED_FIELD_EQ_CASE(CPPTYPE_STRING, GetRepeatedString);
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        for (int i = 0; i < size; ++i) {
+          if (!EqualsMessage(
+                  reflection->GetRepeatedMessage(message1, field, i),
+                  reflection->GetRepeatedMessage(message2, field, i))) {
+            return false;
+          }
+        }
+        return true;
+    }
+  }
+#undef MOZC_FIELD_EQ_CASE
+#undef MOZC_REPEATED_FIELD_EQ_CASE
+
+  LOG(ERROR) << "Unknown cpp_type: " << field->cpp_type();
+  return false;
+}
+
+bool EqualsMessage(const Message &message1, const Message &message2) {
+  const Descriptor *descriptor = message1.GetDescriptor();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor *field = descriptor->field(i);
+    const bool has_field = HasField(message1, field);
+    if (has_field != HasField(message2, field)) {
+      return false;
+    }
+    if (has_field && !EqualsField(message1, message2, field)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Replaces |field| of |to| with the one of |from|.
+void CopyField(const Message &from, const FieldDescriptor *field,
+               Message *to) {
+  const Reflection *reflection = from.GetReflection();
+  reflection->ClearField(to, field);
+
+#define MOZC_FIELD_COPY_CASE(cpptype, type) \
+  case FieldDescriptor::cpptype: \
+    reflection->Set##type(to, field, reflection->Get##type(from, field)); \
+    return
+#define MOZC_REPEATED_FIELD_COPY_CASE(cpptype, type) \
+  case FieldDescriptor::cpptype: \
+    for (int i = 0; i < size; ++i) { \
+      reflection->Add##type( \
+          to, field, reflection->GetRepeated##type(from, field, i)); \
+    } \
+    return
+
+  if (!field->is_repeated()) {
+    switch (field->cpp_type()) {
+      MOZC_FIELD_COPY_CASE(CPPTYPE_INT32, Int32);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_INT64, Int64);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_UINT32, UInt32);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_UINT64, UInt64);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_DOUBLE, Double);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_FLOAT, Float);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_BOOL, Bool);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_ENUM, Enum);
+      MOZC_FIELD_COPY_CASE(CPPTYPE_STRING, String);
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        reflection->MutableMessage(to, field)->CopyFrom(
+            reflection->GetMessage(from, field));
+        return;
+    }
+  } else {
+    const int size = reflection->FieldSize(from, field);
+    switch (field->cpp_type()) {
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_INT32, Int32);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_INT64, Int64);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_UINT32, UInt32);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_UINT64, UInt64);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_DOUBLE, Double);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_FLOAT, Float);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_BOOL, Bool);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_ENUM, Enum);
+      MOZC_REPEATED_FIELD_COPY_CASE(CPPTYPE_STRING, String);
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        for (int i = 0; i < size; ++i) {
+          reflection->AddMessage(to, field)->CopyFrom(
+              reflection->GetRepeatedMessage(from, field, i));
+        }
+        return;
+    }
+  }
+#undef MOZC_FIELD_COPY_CASE
+#undef MOZC_REPEATED_FIELD_COPY_CASE
+
+  LOG(ERROR) << "Unknown cpp_type: " << field->cpp_type();
+}
+
+bool MakeMessageDelta(const Message &base, const Message &message,
+                      Message *delta) {
+  const Descriptor *descriptor = message.GetDescriptor();
+  const Reflection *reflection = message.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor *field = descriptor->field(i);
+    if (IsRevisionField(field)) {
+      continue;
+    }
+    const bool base_has_field = HasField(base, field);
+    if (!HasField(message, field)) {
+      if (base_has_field) {
+        // A delta cannot clear a field.
+        return false;
+      }
+      continue;
+    }
+    if (!base_has_field) {
+      CopyField(message, field, delta);
+      continue;
+    }
+    if (!field->is_repeated() &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      Message *sub_delta = reflection->MutableMessage(delta, field);
+      if (!MakeMessageDelta(reflection->GetMessage(base, field),
+                            reflection->GetMessage(message, field),
+                            sub_delta)) {
+        return false;
+      }
+      vector<const FieldDescriptor *> sub_delta_fields;
+      reflection->ListFields(*sub_delta, &sub_delta_fields);
+      if (sub_delta_fields.empty()) {
+        reflection->ClearField(delta, field);
+      }
+      continue;
+    }
+    if (!EqualsField(base, message, field)) {
+      CopyField(message, field, delta);
+    }
+  }
+  return true;
+}
+
+void ApplyMessageDelta(const Message &delta, Message *message) {
+  const Descriptor *descriptor = delta.GetDescriptor();
+  const Reflection *reflection = delta.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor *field = descriptor->field(i);
+    if (IsRevisionField(field) || !HasField(delta, field)) {
+      continue;
+    }
+    if (!field->is_repeated() &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        reflection->HasField(*message, field)) {
+      ApplyMessageDelta(reflection->GetMessage(delta, field),
+                        reflection->MutableMessage(message, field));
+      continue;
+    }
+    CopyField(delta, field, message);
+  }
+}
+
+}  // namespace
+
+// static
+bool RendererCommandDelta::MakeDelta(const RendererCommand &base,
+                                     const RendererCommand &command,
+                                     RendererCommand *delta) {
+  DCHECK(delta);
+  delta->Clear();
+  return MakeMessageDelta(base, command, delta);
+}
+
+// static
+void RendererCommandDelta::ApplyDelta(const RendererCommand &delta,
+                                      RendererCommand *command) {
+  DCHECK(command);
+  ApplyMessageDelta(delta, command);
+}
+
+// static
+bool RendererCommandDelta::GetRevisions(const char *data, size_t size,
+                                        uint64 *revision,
+                                        uint64 *base_revision) {
+  DCHECK(revision);
+  DCHECK(base_revision);
+  *revision = 0;
+  *base_revision = 0;
+  CodedInputStream input(reinterpret_cast<const uint8 *>(data),
+                         static_cast<int>(size));
+  while (true) {
+    const uint32 tag = input.ReadTag();
+    if (tag == 0) {
+      // The end of |data| or an error.
+      return input.ConsumedEntireMessage();
+    }
+    const int number = WireFormatLite::GetTagFieldNumber(tag);
+    const bool is_varint = WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_VARINT;
+    ::mozc::protobuf::uint64 value = 0;
+    if (number == RendererCommand::kRevisionFieldNumber && is_varint) {
+      if (!input.ReadVarint64(&value)) {
+        return false;
+      }
+      *revision = value;
+    } else if (number == RendererCommand::kBaseRevisionFieldNumber &&
+               is_varint) {
+      if (!input.ReadVarint64(&value)) {
+        return false;
+      }
+      *base_revision = value;
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return false;
+    }
+  }
+}
+
+}  // namespace renderer
+}  // namespace mozc
@@ -0,0 +1,100 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Delta encoding of RendererCommand.
+//
+// While the user moves the focus in the candidate window, consecutive
+// commands differ only in a few fields, e.g. the focused index and the
+// preedit, but the full command contains all the candidates, annotations and
+// usages.  RendererClient sends such commands as deltas from the last command
+// the renderer has cached, and RendererServer resolves them back into full
+// commands before queuing them, so the rendering code always sees full
+// commands.
+//
+// A delta has the fields of the new command which differ from the base
+// command.  A message field set in both commands is compared recursively and
+// the delta only has the changed sub fields; other fields including repeated
+// fields are replaced as a whole.  Since a delta cannot express a cleared
+// field, MakeDelta() fails if the new command lacks a field the base has, and
+// the full command is sent instead.  Note that a delta lacks required fields
+// in general, so it has to be serialized and parsed with the *Partial*
+// methods of the protocol buffer.
+
+#ifndef MOZC_RENDERER_RENDERER_COMMAND_DELTA_H_
+#define MOZC_RENDERER_RENDERER_COMMAND_DELTA_H_
+
+#include <string>
+
+#include "base/port.h"
+
+namespace mozc {
+namespace commands {
+class RendererCommand;
+}  // namespace commands
+
+namespace renderer {
+
+class RendererCommandDelta {
+ public:
+  // The first byte of the response of the renderer to a command.
+  enum Response {
+    kAccepted = 0,
+    // The renderer does not have the base command of a delta.  The client
+    // should send the full command.
+    kNeedsFullUpdate = 1,
+  };
+
+  // Makes |delta| which turns |base| into |command| by ApplyDelta().
+  // Returns false if |command| lacks a field which |base| has.  The revision
+  // fields are neither compared nor set.
+  static bool MakeDelta(const commands::RendererCommand &base,
+                        const commands::RendererCommand &command,
+                        commands::RendererCommand *delta);
+
+  // Applies |delta| to |command|.  The revision fields of |delta| are not
+  // copied.
+  static void ApplyDelta(const commands::RendererCommand &delta,
+                         commands::RendererCommand *command);
+
+  // Reads the revision fields of a serialized RendererCommand without
+  // parsing the other fields, which is much faster than parsing a command
+  // with many candidates.  A missing field is read as 0.  Returns false if
+  // |data| is broken.
+  static bool GetRevisions(const char *data, size_t size,
+                           uint64 *revision, uint64 *base_revision);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(RendererCommandDelta);
+};
+
+}  // namespace renderer
+}  // namespace mozc
+
+#endif  // MOZC_RENDERER_RENDERER_COMMAND_DELTA_H_
@@ -0,0 +1,201 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "renderer/renderer_command_delta.h"
+
+#include <string>
+
+#include "base/number_util.h"
+#include "base/port.h"
+#include "renderer/renderer_command.pb.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace renderer {
+namespace {
+
+using commands::Candidates;
+using commands::RendererCommand;
+
+void MakeCommand(RendererCommand *command) {
+  command->set_type(RendererCommand::UPDATE);
+  command->set_visible(true);
+  command->mutable_preedit_rectangle()->set_left(10);
+  command->mutable_preedit_rectangle()->set_top(20);
+  Candidates *candidates = command->mutable_output()->mutable_candidates();
+  for (int i = 0; i < 9; ++i) {
+    Candidates::Candidate *candidate = candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_value("value" + NumberUtil::SimpleItoa(i));
+    candidate->set_id(i);
+    candidate->mutable_annotation()->set_description("description");
+  }
+  candidates->set_focused_index(0);
+  candidates->set_size(9);
+  candidates->set_position(0);
+  commands::Preedit::Segment *segment =
+      command->mutable_output()->mutable_preedit()->add_segment();
+  segment->set_value("value0");
+  segment->set_value_length(6);
+  segment->set_annotation(commands::Preedit::Segment::HIGHLIGHT);
+  command->mutable_output()->mutable_preedit()->set_cursor(6);
+}
+
+void ExpectEqualCommands(const RendererCommand &expected,
+                         const RendererCommand &actual) {
+  EXPECT_EQ(expected.SerializePartialAsString(),
+            actual.SerializePartialAsString())
+      << "expected: " << expected.DebugString()
+      << "actual: " << actual.DebugString();
+}
+
+TEST(RendererCommandDeltaTest, FocusChange) {
+  RendererCommand base;
+  MakeCommand(&base);
+  RendererCommand command = base;
+  command.mutable_output()->mutable_candidates()->set_focused_index(3);
+  command.mutable_output()->mutable_preedit()->mutable_segment(0)
+      ->set_value("value3");
+
+  RendererCommand delta;
+  ASSERT_TRUE(RendererCommandDelta::MakeDelta(base, command, &delta));
+  // Only the changed fields are set.
+  EXPECT_FALSE(delta.has_type());
+  EXPECT_FALSE(delta.has_preedit_rectangle());
+  EXPECT_EQ(0, delta.output().candidates().candidate_size());
+  EXPECT_EQ(3, delta.output().candidates().focused_index());
+  EXPECT_FALSE(delta.output().candidates().has_size());
+  // Repeated fields are replaced as a whole.
+  ASSERT_EQ(1, delta.output().preedit().segment_size());
+  EXPECT_FALSE(delta.output().preedit().has_cursor());
+  EXPECT_LT(delta.ByteSize(), command.ByteSize() / 4);
+
+  RendererCommand applied = base;
+  RendererCommandDelta::ApplyDelta(delta, &applied);
+  ExpectEqualCommands(command, applied);
+}
+
+TEST(RendererCommandDeltaTest, NoChange) {
+  RendererCommand base;
+  MakeCommand(&base);
+  RendererCommand delta;
+  ASSERT_TRUE(RendererCommandDelta::MakeDelta(base, base, &delta));
+  EXPECT_EQ(0, delta.ByteSize());
+
+  RendererCommand applied = base;
+  RendererCommandDelta::ApplyDelta(delta, &applied);
+  ExpectEqualCommands(base, applied);
+}
+
+TEST(RendererCommandDeltaTest, NewFields) {
+  RendererCommand base;
+  base.set_type(RendererCommand::UPDATE);
+  base.set_visible(false);
+  RendererCommand command;
+  MakeCommand(&command);
+
+  RendererCommand delta;
+  ASSERT_TRUE(RendererCommandDelta::MakeDelta(base, command, &delta));
+  RendererCommand applied = base;
+  RendererCommandDelta::ApplyDelta(delta, &applied);
+  ExpectEqualCommands(command, applied);
+}
+
+TEST(RendererCommandDeltaTest, ClearedFields) {
+  RendererCommand base;
+  MakeCommand(&base);
+  RendererCommand delta;
+
+  RendererCommand command = base;
+  command.mutable_output()->clear_candidates();
+  EXPECT_FALSE(RendererCommandDelta::MakeDelta(base, command, &delta));
+
+  command = base;
+  command.clear_visible();
+  EXPECT_FALSE(RendererCommandDelta::MakeDelta(base, command, &delta));
+
+  command = base;
+  command.mutable_output()->mutable_preedit()->clear_segment();
+  EXPECT_FALSE(RendererCommandDelta::MakeDelta(base, command, &delta));
+}
+
+TEST(RendererCommandDeltaTest, RevisionsAreNotCompared) {
+  RendererCommand base;
+  MakeCommand(&base);
+  base.set_revision(1);
+  RendererCommand command = base;
+  command.clear_revision();
+  command.set_visible(false);
+
+  RendererCommand delta;
+  ASSERT_TRUE(RendererCommandDelta::MakeDelta(base, command, &delta));
+  EXPECT_FALSE(delta.has_revision());
+  EXPECT_FALSE(delta.has_base_revision());
+  EXPECT_FALSE(delta.visible());
+
+  delta.set_revision(2);
+  delta.set_base_revision(1);
+  RendererCommandDelta::ApplyDelta(delta, &base);
+  EXPECT_EQ(1, base.revision());
+  EXPECT_FALSE(base.has_base_revision());
+  EXPECT_FALSE(base.visible());
+}
+
+TEST(RendererCommandDeltaTest, GetRevisions) {
+  RendererCommand command;
+  MakeCommand(&command);
+  uint64 revision = 100, base_revision = 100;
+  string data = command.SerializeAsString();
+  EXPECT_TRUE(RendererCommandDelta::GetRevisions(
+      data.data(), data.size(), &revision, &base_revision));
+  EXPECT_EQ(0, revision);
+  EXPECT_EQ(0, base_revision);
+
+  command.set_revision(0x123456789ULL);
+  command.set_base_revision(42);
+  data = command.SerializePartialAsString();
+  EXPECT_TRUE(RendererCommandDelta::GetRevisions(
+      data.data(), data.size(), &revision, &base_revision));
+  EXPECT_EQ(0x123456789ULL, revision);
+  EXPECT_EQ(42, base_revision);
+
+  EXPECT_TRUE(RendererCommandDelta::GetRevisions(
+      "", 0, &revision, &base_revision));
+  EXPECT_EQ(0, revision);
+  EXPECT_EQ(0, base_revision);
+
+  // Truncated data.
+  EXPECT_FALSE(RendererCommandDelta::GetRevisions(
+      data.data(), data.size() - 1, &revision, &base_revision));
+}
+
+}  // namespace
+}  // namespace renderer
+}  // namespace mozc
@@ -37,6 +37,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/const.h"
+#include "base/latency_histogram.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/system_util.h"
@@ -47,6 +48,7 @@
 #include "ipc/named_event.h"
 #include "ipc/process_watch_dog.h"
 #include "renderer/renderer_command.pb.h"
+#include "renderer/renderer_command_delta.h"
 #include "renderer/renderer_interface.h"
 
 // By default, mozc_renderer quits when user-input continues to be
@@ -170,6 +172,9 @@ RendererServer::RendererServer()
     : IPCServer(GetServiceName(), kNumConnections, kIPCServerTimeOut),
       timeout_(0),
       renderer_interface_(NULL),
+      cached_revision_(0),
+      exec_command_histogram_(
+          LatencyHistogram::Get("RendererServer::ExecCommand")),
       ALLOW_THIS_IN_INITIALIZER_LIST(
           watch_dog_(new ParentApplicationWatchDog(this))),
       send_command_(new RendererServerSendCommand) {
@@ -226,17 +231,74 @@ bool RendererServer::Process(const char *request,
   // If we use stack, this program will be crashed.
   //
   // The reciver of command_str takes the ownership of this string.
+  //
+  // A delta update is resolved here, not in the main thread, because the
+  // main thread may drop a queued command when a newer one arrives.  A full
+  // command is only copied, and a delta is small, so this is still fast.
   string *command_str = new string(request, request_size);
 
-  // no need to set the result code.
   *response_size = 1;
-  response[0] = '\0';
+  response[0] = RendererCommandDelta::kAccepted;
+  if (!ResolveDelta(command_str)) {
+    delete command_str;
+    response[0] = RendererCommandDelta::kNeedsFullUpdate;
+    return true;
+  }
 
   // Cannot call the method directly like renderer_interface_->ExecCommand()
   // as it's not thread-safe.
   return AsyncExecCommand(command_str);
 }
 
+bool RendererServer::ResolveDelta(string *message) {
+  uint64 revision = 0;
+  uint64 base_revision = 0;
+  if (!RendererCommandDelta::GetRevisions(message->data(), message->size(),
+                                          &revision, &base_revision)) {
+    // Let the message loop report the broken message.
+    cached_revision_ = 0;
+    return true;
+  }
+
+  if (base_revision == 0) {
+    // A full command.  Parsing is deferred until a delta arrives.
+    cached_revision_ = revision;
+    cached_command_.reset();
+    if (revision == 0) {
+      cached_message_.clear();
+    } else {
+      cached_message_ = *message;
+    }
+    return true;
+  }
+
+  if (cached_revision_ == 0 || base_revision != cached_revision_) {
+    VLOG(1) << "Unknown base revision: " << base_revision;
+    return false;
+  }
+  if (cached_command_.get() == NULL) {
+    cached_command_.reset(new commands::RendererCommand);
+    if (!cached_command_->ParsePartialFromString(cached_message_)) {
+      LOG(ERROR) << "ParseFromString failed";
+      cached_command_.reset();
+      cached_revision_ = 0;
+      return false;
+    }
+    cached_message_.clear();
+  }
+  // A delta lacks required fields.
+  commands::RendererCommand delta;
+  if (!delta.ParsePartialFromString(*message)) {
+    LOG(ERROR) << "ParseFromString failed";
+    return false;
+  }
+
+  RendererCommandDelta::ApplyDelta(delta, cached_command_.get());
+  cached_command_->set_revision(revision);
+  cached_revision_ = revision;
+  return cached_command_->SerializePartialToString(message);
+}
+
 bool RendererServer::ExecCommandInternal(
     const commands::RendererCommand &command) {
   if (renderer_interface_ == NULL) {
@@ -273,6 +335,7 @@ bool RendererServer::ExecCommandInternal(
     }
   }
 
+  ScopedLatencyTimer timer(exec_command_histogram_);
   if (renderer_interface_->ExecCommand(command)) {
     return true;
   }
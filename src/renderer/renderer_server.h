@@ -32,10 +32,18 @@
 
 #include <string>
 #include "base/port.h"
+#include "base/scoped_ptr.h"
 #include "ipc/ipc.h"
 #include "renderer/renderer_interface.h"
 
 namespace mozc {
+
+class LatencyHistogram;
+
+namespace commands {
+class RendererCommand;
+}  // namespace commands
+
 namespace renderer {
 
 class RendererInterface;
@@ -89,8 +97,25 @@ class RendererServer : public IPCServer {
   uint32 timeout() const;
 
  private:
+  // Resolves |*message| into the full command if it is a delta update, and
+  // caches the full command for the following deltas.  Returns false if the
+  // base command of the delta is not cached.  Called only from Process(),
+  // which runs on the IPC thread, so the cache needs no lock.
+  bool ResolveDelta(string *message);
+
   uint32 timeout_;
   RendererInterface *renderer_interface_;
+  // The revision of the cached command, or 0 if no command is cached.  Only
+  // the last command is cached even if there are several clients, which
+  // start their revisions at random values so that a delta from one client
+  // never matches the command of another.
+  uint64 cached_revision_;
+  // The cached command.  A full command is kept serialized in
+  // |cached_message_| and parsed into |cached_command_| only when a delta
+  // arrives.  |cached_command_| is valid if it is not NULL.
+  string cached_message_;
+  scoped_ptr<commands::RendererCommand> cached_command_;
+  LatencyHistogram *exec_command_histogram_;
   scoped_ptr<ParentApplicationWatchDog> watch_dog_;
   scoped_ptr<RendererServerSendCommand> send_command_;
 
@@ -31,6 +31,7 @@
 
 #include "base/logging.h"
 #include "base/port.h"
+#include "base/scoped_ptr.h"
 #include "base/system_util.h"
 #include "base/util.h"
 #include "ipc/ipc_test_util.h"
@@ -58,9 +59,14 @@ class TestRenderer : public RendererInterface {
       return false;
     }
     counter_++;
+    last_command_.CopyFrom(command);
     return true;
   }
 
+  const commands::RendererCommand &last_command() const {
+    return last_command_;
+  }
+
   void Reset() {
     counter_ = 0;
   }
@@ -76,6 +82,7 @@ class TestRenderer : public RendererInterface {
  private:
   int counter_;
   bool finished_;
+  commands::RendererCommand last_command_;
 };
 
 class TestRendererServer : public RendererServer {
@@ -177,5 +184,129 @@ TEST_F(RendererServerTest, IPCTest) {
   server->Wait();
 }
 
+TEST_F(RendererServerTest, DeltaUpdateTest) {
+  mozc::IPCClientFactoryOnMemory on_memory_client_factory;
+
+  scoped_ptr<TestRendererServer> server(new TestRendererServer);
+  TestRenderer renderer;
+  server->SetRendererInterface(&renderer);
+#ifdef OS_MACOSX
+  server->SetMachPortManager(on_memory_client_factory.OnMemoryPortManager());
+#endif
+  server->StartServer();
+  Util::Sleep(1000);
+
+  DummyRendererLauncher launcher;
+  RendererClient client;
+  client.SetIPCClientFactory(&on_memory_client_factory);
+  client.DisableRendererServerCheck();
+  client.SetRendererLauncherInterface(&launcher);
+
+  commands::RendererCommand command;
+  command.set_type(commands::RendererCommand::UPDATE);
+  command.set_visible(true);
+  commands::Candidates *candidates =
+      command.mutable_output()->mutable_candidates();
+  for (int i = 0; i < 9; ++i) {
+    commands::Candidates::Candidate *candidate = candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_value("value");
+  }
+  candidates->set_focused_index(0);
+  candidates->set_size(9);
+  candidates->set_position(0);
+
+  client.ExecCommand(command);
+  candidates->set_focused_index(1);
+  client.ExecCommand(command);
+  EXPECT_EQ(1, client.update_stats().num_full_updates);
+  EXPECT_EQ(1, client.update_stats().num_delta_updates);
+
+  // The renderer receives the full command.
+  EXPECT_EQ(2, renderer.counter());
+  const commands::RendererCommand &last_command = renderer.last_command();
+  EXPECT_FALSE(last_command.has_base_revision());
+  EXPECT_TRUE(last_command.visible());
+  EXPECT_EQ(9, last_command.output().candidates().candidate_size());
+  EXPECT_EQ(1, last_command.output().candidates().focused_index());
+
+  // Shutdown with a full command, as the server stops before it replies to
+  // a delta, which would make the client retry with a new connection.
+  commands::RendererCommand noop;
+  noop.set_type(commands::RendererCommand::NOOP);
+  renderer.Shutdown();
+  client.ExecCommand(noop);
+  server->Wait();
+}
+
+TEST_F(RendererServerTest, DeltaUpdateFromTwoClientsTest) {
+  mozc::IPCClientFactoryOnMemory on_memory_client_factory;
+
+  scoped_ptr<TestRendererServer> server(new TestRendererServer);
+  TestRenderer renderer;
+  server->SetRendererInterface(&renderer);
+#ifdef OS_MACOSX
+  server->SetMachPortManager(on_memory_client_factory.OnMemoryPortManager());
+#endif
+  server->StartServer();
+  Util::Sleep(1000);
+
+  DummyRendererLauncher launcher;
+  RendererClient clients[2];
+  commands::RendererCommand commands[2];
+  for (int i = 0; i < 2; ++i) {
+    clients[i].SetIPCClientFactory(&on_memory_client_factory);
+    clients[i].DisableRendererServerCheck();
+    clients[i].SetRendererLauncherInterface(&launcher);
+
+    commands[i].set_type(commands::RendererCommand::UPDATE);
+    commands[i].set_visible(true);
+    commands::Candidates *candidates =
+        commands[i].mutable_output()->mutable_candidates();
+    for (int j = 0; j < 9; ++j) {
+      commands::Candidates::Candidate *candidate = candidates->add_candidate();
+      candidate->set_index(j);
+      candidate->set_value(i == 0 ? "value" : "other value");
+    }
+    candidates->set_focused_index(0);
+    candidates->set_size(9);
+    candidates->set_position(0);
+  }
+
+  // The clients update the renderer in turn.  Each update replaces the
+  // command cached by the renderer, so a delta from either client must not
+  // be applied to the command of the other.
+  for (int i = 0; i < 6; ++i) {
+    const int index = i % 2;
+    commands[index].mutable_output()->mutable_candidates()->set_focused_index(
+        i);
+    clients[index].ExecCommand(commands[index]);
+
+    EXPECT_EQ(i + 1, renderer.counter());
+    const commands::RendererCommand &last_command = renderer.last_command();
+    EXPECT_EQ(i, last_command.output().candidates().focused_index());
+    EXPECT_EQ(index == 0 ? "value" : "other value",
+              last_command.output().candidates().candidate(0).value());
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(3, clients[i].update_stats().num_full_updates);
+    EXPECT_EQ(0, clients[i].update_stats().num_delta_updates);
+  }
+
+  // A client which updates the renderer in a row still sends deltas.
+  commands[1].mutable_output()->mutable_candidates()->set_focused_index(8);
+  clients[1].ExecCommand(commands[1]);
+  EXPECT_EQ(1, clients[1].update_stats().num_delta_updates);
+  EXPECT_EQ(8, renderer.last_command().output().candidates().focused_index());
+  EXPECT_EQ("other value",
+            renderer.last_command().output().candidates().candidate(0).value());
+
+  commands::RendererCommand noop;
+  noop.set_type(commands::RendererCommand::NOOP);
+  renderer.Shutdown();
+  clients[0].ExecCommand(noop);
+  server->Wait();
+}
+
 }  // namespace renderer
 }  // namespace mozc
@@ -83,7 +83,8 @@ CandidateWindow::CandidateWindow(
       table_layout_(table_layout),
       text_renderer_(text_renderer),
       draw_tool_(draw_tool),
-      cairo_factory_(cairo_factory) {
+      cairo_factory_(cairo_factory),
+      is_layout_valid_(false) {
 }
 
 bool CandidateWindow::OnPaint(GtkWidget *widget, GdkEventExpose* event) {
@@ -306,6 +307,7 @@ void CandidateWindow::UpdateFooterSize() {
     const Size index_guide_size = text_renderer_->GetPixelSize(
       FontSpec::FONTSET_FOOTER_INDEX,
       GetIndexGuideString(candidates_));
+    index_guide_size_ = index_guide_size;
     footer_size.width += index_guide_size.width;
     footer_size.height = max(footer_size.height, index_guide_size.height);
   }
@@ -387,7 +389,16 @@ Size CandidateWindow::Update(const commands::Candidates &candidates) {
       (candidates_.category()  == commands::USAGE))
       << "Unknown candidate category" << candidates_.category();
 
+  if (CanReuseLayout(candidates)) {
+    // Only the focus moved. The frozen layout is still valid, so just repaint
+    // the window with the new selection.
+    candidates_.CopyFrom(candidates);
+    Redraw();
+    return table_layout_->GetTotalSize();
+  }
+
   candidates_.CopyFrom(candidates);
+  index_guide_size_ = Size(0, 0);
 
   table_layout_->Initialize(candidates_.candidate_size(), NUMBER_OF_COLUMNS);
   table_layout_->SetWindowBorder(kWindowBorder);
@@ -401,11 +412,44 @@ Size CandidateWindow::Update(const commands::Candidates &candidates) {
   UpdateGap2Size(has_description);
 
   table_layout_->FreezeLayout();
+  is_layout_valid_ = true;
   Resize(table_layout_->GetTotalSize());
   Redraw();
   return table_layout_->GetTotalSize();
 }
 
+bool CandidateWindow::CanReuseLayout(
+    const commands::Candidates &candidates) const {
+  if (!is_layout_valid_) {
+    return false;
+  }
+
+  // Compares everything but the focused index, which only affects painting
+  // and the footer index guide.
+  commands::Candidates focus_normalized(candidates);
+  if (candidates_.has_focused_index()) {
+    focus_normalized.set_focused_index(candidates_.focused_index());
+  } else {
+    focus_normalized.clear_focused_index();
+  }
+  if (focus_normalized.SerializeAsString() !=
+      candidates_.SerializeAsString()) {
+    return false;
+  }
+
+  // The width of the index guide (e.g. "9/10" and "10/10") may change with
+  // the focus. The measurement is cached by the text renderer in most cases.
+  if (candidates.has_footer() && candidates.footer().index_visible()) {
+    const Size index_guide_size = text_renderer_->GetPixelSize(
+        FontSpec::FONTSET_FOOTER_INDEX, GetIndexGuideString(candidates));
+    if (index_guide_size.width != index_guide_size_.width ||
+        index_guide_size.height != index_guide_size_.height) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void CandidateWindow::GetDisplayString(
     const commands::Candidates::Candidate &candidate,
     string *shortcut,
@@ -493,6 +537,7 @@ bool CandidateWindow::SetSendCommandInterface(
 
 void CandidateWindow::ReloadFontConfig(const string &font_description) {
   text_renderer_->ReloadFontConfig(font_description);
+  is_layout_valid_ = false;
 }
 
 }  // namespace gtk
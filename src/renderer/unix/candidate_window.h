@@ -123,6 +123,10 @@ class CandidateWindow : public GtkWindowBase {
   void UpdateCandidatesSize(bool *has_description);
   void UpdateGap2Size(bool has_description);
 
+  // Returns true if |candidates| differs from the laid out candidates only
+  // in the focused index, so the current table layout can be kept as is.
+  bool CanReuseLayout(const commands::Candidates &candidates) const;
+
   // TODO(nona): Remove FRIEND_TEST
   FRIEND_TEST(CandidateWindowTest, DrawBackgroundTest);
   FRIEND_TEST(CandidateWindowTest, DrawShortcutBackgroundTest);
@@ -151,6 +155,10 @@ class CandidateWindow : public GtkWindowBase {
   std::unique_ptr<DrawToolInterface> draw_tool_;
   std::unique_ptr<CairoFactoryInterface> cairo_factory_;
   client::SendCommandInterface *send_command_interface_;
+  // True while |table_layout_| holds the frozen layout of |candidates_|.
+  bool is_layout_valid_;
+  // Size of the footer index guide measured for the current layout.
+  Size index_guide_size_;
   DISALLOW_COPY_AND_ASSIGN(CandidateWindow);
 };
 
@@ -1474,6 +1474,61 @@ TEST_F(CandidateWindowTest, ReloadFontConfigTest) {
   FinalizeTestKit(&testkit);
 }
 
+TEST_F(CandidateWindowTest, UpdateReusesLayoutOnFocusMoveTest) {
+  CandidateWindowTestKit testkit = SetUpCandidateWindow();
+  const Size text_size(10, 20);
+  EXPECT_CALL(*testkit.text_renderer_mock, GetPixelSize(_, _))
+      .WillRepeatedly(Return(text_size));
+
+  commands::Candidates candidates;
+  SetTestCandidates(10, true, true, true, true, true, &candidates);
+  candidates.set_focused_index(0);
+  candidates.mutable_footer()->set_index_visible(true);
+
+  {
+    SCOPED_TRACE("The first update lays out the table.");
+    EXPECT_CALL(*testkit.table_layout_mock, Initialize(10, _)).Times(1);
+    EXPECT_CALL(*testkit.table_layout_mock, FreezeLayout()).Times(1);
+    testkit.window->Update(candidates);
+  }
+  {
+    SCOPED_TRACE("Moving the focus keeps the layout.");
+    EXPECT_CALL(*testkit.table_layout_mock, Initialize(_, _)).Times(0);
+    EXPECT_CALL(*testkit.table_layout_mock, FreezeLayout()).Times(0);
+    for (int i = 1; i < 10; ++i) {
+      candidates.set_focused_index(i);
+      testkit.window->Update(candidates);
+    }
+  }
+  {
+    SCOPED_TRACE("The index guide width changes with the focus.");
+    EXPECT_CALL(*testkit.text_renderer_mock,
+                GetPixelSize(FontSpecInterface::FONTSET_FOOTER_INDEX,
+                             StrEq("1/10 ")))
+        .WillRepeatedly(Return(Size(text_size.width - 1, text_size.height)));
+    EXPECT_CALL(*testkit.table_layout_mock, Initialize(10, _)).Times(1);
+    EXPECT_CALL(*testkit.table_layout_mock, FreezeLayout()).Times(1);
+    candidates.set_focused_index(0);
+    testkit.window->Update(candidates);
+  }
+  {
+    SCOPED_TRACE("Changing candidates lays out the table again.");
+    SetTestCandidates(5, true, true, true, true, true, &candidates);
+    EXPECT_CALL(*testkit.table_layout_mock, Initialize(5, _)).Times(1);
+    EXPECT_CALL(*testkit.table_layout_mock, FreezeLayout()).Times(1);
+    testkit.window->Update(candidates);
+  }
+  {
+    SCOPED_TRACE("Reloading the font lays out the table again.");
+    EXPECT_CALL(*testkit.text_renderer_mock, ReloadFontConfig(_));
+    testkit.window->ReloadFontConfig("Foo,Bar,Baz");
+    EXPECT_CALL(*testkit.table_layout_mock, Initialize(5, _)).Times(1);
+    EXPECT_CALL(*testkit.table_layout_mock, FreezeLayout()).Times(1);
+    testkit.window->Update(candidates);
+  }
+  FinalizeTestKit(&testkit);
+}
+
 }  // namespace gtk
 }  // namespace renderer
 }  // namespace mozc
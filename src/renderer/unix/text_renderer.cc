@@ -30,6 +30,7 @@
 #include "renderer/unix/text_renderer.h"
 
 #include "base/coordinates.h"
+#include "base/logging.h"
 #include "renderer/unix/font_spec.h"
 #include "renderer/unix/pango_wrapper.h"
 
@@ -37,13 +38,37 @@ namespace mozc {
 namespace renderer {
 namespace gtk {
 
+namespace {
+// The candidate window shows at most a few pages of candidates with their
+// shortcuts and descriptions, so a few hundred entries are enough to keep
+// every string of the recent updates.
+const size_t kMaxSizeCacheEntries = 512;
+
+// Used as |width| of the cache key for single-line measurement.
+const int kSingleLine = -1;
+}  // namespace
+
 TextRenderer::TextRenderer(FontSpecInterface *font_spec)
   : font_spec_(font_spec),
-    pango_(nullptr) {
+    pango_(nullptr),
+    size_cache_(kMaxSizeCacheEntries) {
 }
 
 void TextRenderer::Initialize(GdkDrawable *drawable) {
   pango_.reset(new PangoWrapper(drawable));
+  size_cache_.Clear();
+}
+
+// static
+string TextRenderer::GetSizeCacheKey(FontSpecInterface::FONT_TYPE font_type,
+                                     const string &str,
+                                     int width) {
+  string key;
+  key.reserve(str.size() + 1 + sizeof(width));
+  key.push_back(static_cast<char>(font_type));
+  key.append(reinterpret_cast<const char *>(&width), sizeof(width));
+  key.append(str);
+  return key;
 }
 
 void TextRenderer::SetUpPangoLayout(const string &str,
@@ -60,6 +85,11 @@ void TextRenderer::SetUpPangoLayout(const string &str,
 
 Size TextRenderer::GetPixelSize(FontSpecInterface::FONT_TYPE font_type,
                                 const string &str) {
+  const Size *cached_size =
+      size_cache_.Lookup(GetSizeCacheKey(font_type, str, kSingleLine));
+  if (cached_size != NULL) {
+    return *cached_size;
+  }
   PangoLayoutWrapper layout(pango_->GetContext());
   return GetPixelSizeInternal(font_type, str, &layout);
 }
@@ -68,12 +98,20 @@ Size TextRenderer::GetPixelSizeInternal(FontSpecInterface::FONT_TYPE font_type,
                                         const string &str,
                                         PangoLayoutWrapperInterface *layout) {
   SetUpPangoLayout(str, font_type, layout);
-  return layout->GetPixelSize();
+  const Size size = layout->GetPixelSize();
+  size_cache_.Insert(GetSizeCacheKey(font_type, str, kSingleLine), size);
+  return size;
 }
 
 Size TextRenderer::GetMultiLinePixelSize(FontSpecInterface::FONT_TYPE font_type,
                                          const string &str,
                                          const int width) {
+  DCHECK_GE(width, 0);
+  const Size *cached_size =
+      size_cache_.Lookup(GetSizeCacheKey(font_type, str, width));
+  if (cached_size != NULL) {
+    return *cached_size;
+  }
   PangoLayoutWrapper layout(pango_->GetContext());
   return GetMultiLinePixelSizeInternal(font_type, str, width, &layout);
 }
@@ -85,7 +123,9 @@ Size TextRenderer::GetMultiLinePixelSizeInternal(
     PangoLayoutWrapperInterface *layout) {
   SetUpPangoLayout(str, font_type, layout);
   layout->SetWidth(width * PANGO_SCALE);
-  return layout->GetPixelSize();
+  const Size size = layout->GetPixelSize();
+  size_cache_.Insert(GetSizeCacheKey(font_type, str, width), size);
+  return size;
 }
 
 void TextRenderer::RenderText(const string &text,
@@ -113,6 +153,7 @@ void TextRenderer::RenderTextInternal(const string& text,
 
 void TextRenderer::ReloadFontConfig(const string &font_description) {
   font_spec_->Reload(font_description);
+  size_cache_.Clear();
 }
 }  // namespace gtk
 }  // namespace renderer
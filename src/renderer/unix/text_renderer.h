@@ -38,6 +38,7 @@
 #include "renderer/unix/font_spec_interface.h"
 #include "renderer/unix/pango_wrapper_interface.h"
 #include "renderer/unix/text_renderer_interface.h"
+#include "storage/lru_cache.h"
 #include "testing/base/public/gunit_prod.h"
 
 namespace mozc {
@@ -67,6 +68,14 @@ class TextRenderer : public TextRendererInterface {
   FRIEND_TEST(TextRendererTest, GetPixelSizeTest);
   FRIEND_TEST(TextRendererTest, GetMultilinePixelSizeTest);
   FRIEND_TEST(TextRendererTest, RenderTextTest);
+  FRIEND_TEST(TextRendererTest, PixelSizeCacheTest);
+  FRIEND_TEST(TextRendererTest, PixelSizeCacheInvalidationTest);
+
+  // Returns the key of |size_cache_|. |width| is the wrap width for
+  // multi-line measurement and negative for single-line measurement.
+  static string GetSizeCacheKey(FontSpecInterface::FONT_TYPE font_type,
+                                const string &str,
+                                int width);
 
   void SetUpPangoLayout(const string &str,
                         FontSpecInterface::FONT_TYPE font_type,
@@ -84,6 +93,10 @@ class TextRenderer : public TextRendererInterface {
                                      PangoLayoutWrapperInterface *layout);
   std::unique_ptr<FontSpecInterface> font_spec_;
   std::unique_ptr<PangoWrapperInterface> pango_;
+  // Caches measured pixel sizes. The candidate window measures the same
+  // strings on every update, and each measurement needs a fresh Pango
+  // layout. The cache is cleared whenever the font or the drawable changes.
+  storage::LRUCache<string, Size> size_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(TextRenderer);
 };
@@ -33,7 +33,9 @@
 #include "testing/base/public/gunit.h"
 
 using ::testing::Expectation;
+using ::testing::NiceMock;
 using ::testing::Return;
+using ::testing::_;
 
 namespace mozc {
 namespace renderer {
@@ -263,6 +265,63 @@ TEST_F(TextRendererTest, ReloadFontConfigTest) {
   text_renderer.ReloadFontConfig(kDummyFontDescription);
 }
 
+TEST_F(TextRendererTest, PixelSizeCacheTest) {
+  NiceMock<FontSpecMock> *font_spec_mock = new NiceMock<FontSpecMock>();
+  TextRenderer text_renderer(font_spec_mock);
+  PangoWrapperMock *pango_mock = SetUpPangoMock(&text_renderer);
+  NiceMock<PangoLayoutWrapperMock> layout_mock;
+
+  const string text = "hogehoge";
+  const FontSpecInterface::FONT_TYPE font_type =
+      FontSpecInterface::FONTSET_CANDIDATE;
+  const Size size(12, 34);
+  const Size multi_line_size(56, 78);
+  const int width = 100;
+
+  EXPECT_CALL(*pango_mock, CopyAttributes(_)).WillRepeatedly(Return(nullptr));
+  EXPECT_CALL(*pango_mock, AttributesUnref(_)).Times(2);
+  EXPECT_CALL(layout_mock, GetPixelSize())
+      .WillOnce(Return(size))
+      .WillOnce(Return(multi_line_size));
+  text_renderer.GetPixelSizeInternal(font_type, text, &layout_mock);
+  text_renderer.GetMultiLinePixelSizeInternal(font_type, text, width,
+                                              &layout_mock);
+
+  // Cached sizes are returned without creating a new Pango layout.
+  EXPECT_CALL(*pango_mock, GetContext()).Times(0);
+  Size actual_size = text_renderer.GetPixelSize(font_type, text);
+  EXPECT_EQ(size.width, actual_size.width);
+  EXPECT_EQ(size.height, actual_size.height);
+  actual_size = text_renderer.GetMultiLinePixelSize(font_type, text, width);
+  EXPECT_EQ(multi_line_size.width, actual_size.width);
+  EXPECT_EQ(multi_line_size.height, actual_size.height);
+
+  // The font type and the width are part of the key.
+  EXPECT_FALSE(text_renderer.size_cache_.HasKey(
+      TextRenderer::GetSizeCacheKey(FontSpecInterface::FONTSET_DESCRIPTION,
+                                    text, -1)));
+  EXPECT_FALSE(text_renderer.size_cache_.HasKey(
+      TextRenderer::GetSizeCacheKey(font_type, text, width + 1)));
+}
+
+TEST_F(TextRendererTest, PixelSizeCacheInvalidationTest) {
+  NiceMock<FontSpecMock> *font_spec_mock = new NiceMock<FontSpecMock>();
+  TextRenderer text_renderer(font_spec_mock);
+  NiceMock<PangoWrapperMock> *pango_mock = new NiceMock<PangoWrapperMock>();
+  text_renderer.pango_.reset(pango_mock);
+  NiceMock<PangoLayoutWrapperMock> layout_mock;
+
+  EXPECT_CALL(layout_mock, GetPixelSize()).WillRepeatedly(Return(Size(1, 2)));
+  text_renderer.GetPixelSizeInternal(FontSpecInterface::FONTSET_CANDIDATE,
+                                     "hogehoge", &layout_mock);
+  EXPECT_EQ(1, text_renderer.size_cache_.Size());
+
+  // Changing the font invalidates all of the measured sizes.
+  EXPECT_CALL(*font_spec_mock, Reload("Foo,Bar,Baz"));
+  text_renderer.ReloadFontConfig("Foo,Bar,Baz");
+  EXPECT_EQ(0, text_renderer.size_cache_.Size());
+}
+
 }  // namespace gtk
 }  // namespace renderer
 }  // namespace mozc
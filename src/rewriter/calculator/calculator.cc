@@ -41,6 +41,7 @@
 #include <string.h>
 #include <math.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -58,6 +59,33 @@ namespace {
 // whole thing in an anonymous namespace.
 
 #include "rewriter/calculator/parser.c"
+
+#if YYSTACKDEPTH <= 0
+#error "ScopedParser requires the fixed size parser stack."
+#endif
+
+// Parser context of the Lemon parser which lives on the caller's stack.  It
+// is initialized and finalized in the same way as ParseAlloc() and
+// ParseFree() do, without the heap allocation for every calculation.
+class ScopedParser {
+ public:
+  ScopedParser() {
+    parser_.yyidx = -1;
+#ifdef YYTRACKMAXSTACKDEPTH
+    parser_.yyidxMax = 0;
+#endif
+  }
+  ~ScopedParser() {
+    while (parser_.yyidx >= 0) {
+      yy_pop_parser_stack(&parser_);
+    }
+  }
+
+  void *get() { return &parser_; }
+
+ private:
+  yyParser parser_;
+};
 }  // namespace
 
 namespace mozc {
@@ -69,6 +97,12 @@ class CalculatorImpl : public CalculatorInterface {
 
   virtual bool CalculateString(const string &key, string *result) const;
 
+  // Returns false if |key| can never be an expression.  It scans |key| once
+  // with table lookups and doesn't allocate, so that ordinary (non
+  // arithmetic) keys are rejected before the normalization and the
+  // tokenization.  It may return true for invalid expressions.
+  bool MayBeExpression(const string &key) const;
+
  private:
   typedef vector<pair<int, double> > TokenSequence;
 
@@ -89,6 +123,12 @@ class CalculatorImpl : public CalculatorInterface {
   // Mapping from operator character such as '+' to the corresponding
   // token type such as PLUS.
   map<string, int> operator_map_;
+
+  // Characters which can appear in an expression before the normalization.
+  // |ascii_table_| is indexed by an ASCII byte, and |fullwidth_table_| is
+  // indexed by the last byte of U+FF00-U+FF3F (EF BC xx) minus 0x80.
+  bool ascii_table_[128];
+  bool fullwidth_table_[64];
 };
 
 CalculatorImpl::CalculatorImpl() {
@@ -105,6 +145,72 @@ CalculatorImpl::CalculatorImpl() {
   operator_map_["^"] = POW;
   operator_map_["("] = LP;
   operator_map_[")"] = RP;
+
+  // Digits, operators, parentheses, spaces and '='.  The full width
+  // characters are the ones which are normalized to them by
+  // Util::FullWidthAsciiToHalfWidthAscii().
+  const char kExpressionChars[] = "0123456789.+-*/%^() \t=";
+  fill(ascii_table_, ascii_table_ + arraysize(ascii_table_), false);
+  fill(fullwidth_table_, fullwidth_table_ + arraysize(fullwidth_table_),
+       false);
+  for (const char *c = kExpressionChars; *c != '\0'; ++c) {
+    ascii_table_[static_cast<uint8>(*c)] = true;
+    // Full width forms are U+FF01-U+FF5E for U+0021-U+007E.  Those for
+    // digits and the symbols above are in U+FF00-U+FF3F.
+    if (*c > ' ' && *c != '-') {
+      fullwidth_table_[*c - ' '] = true;
+    }
+  }
+}
+
+bool CalculatorImpl::MayBeExpression(const string &key) const {
+  const size_t size = key.size();
+  // Expression is ended with '=' or "＝".
+  if (size == 0) {
+    return false;
+  }
+  if (key[size - 1] != '=' &&
+      !(size >= 3 && key.compare(size - 3, 3, "\xEF\xBC\x9D") == 0)) {
+    return false;
+  }
+
+  bool has_digit = false;
+  const uint8 *current = reinterpret_cast<const uint8 *>(key.data());
+  const uint8 *end = current + size;
+  while (current < end) {
+    const uint8 c = *current;
+    if (c < 0x80) {
+      if (!ascii_table_[c]) {
+        return false;
+      }
+      has_digit |= (c >= '0' && c <= '9');
+      ++current;
+      continue;
+    }
+    // All the other characters are encoded in 3 bytes.
+    if (current + 3 > end) {
+      return false;
+    }
+    const uint8 c1 = current[1];
+    const uint8 c2 = current[2];
+    if (c == 0xEF && c1 == 0xBC && c2 >= 0x80 && c2 < 0xC0) {
+      // Full width ASCII.
+      if (!fullwidth_table_[c2 - 0x80]) {
+        return false;
+      }
+      has_digit |= (c2 >= 0x90 && c2 <= 0x99);
+    } else if (c == 0xE3 && c1 == 0x83 && (c2 == 0xBB || c2 == 0xBC)) {
+      // "・" and "ー"
+    } else if (c == 0xE3 && c1 == 0x80 && c2 == 0x80) {
+      // Full width space
+    } else if (c == 0xE2 && c1 == 0x88 && c2 == 0x92) {
+      // "−" (U+2212 MINUS SIGN)
+    } else {
+      return false;
+    }
+    current += 3;
+  }
+  return has_digit;
 }
 
 // Basic arithmetic operations are available.
@@ -115,6 +221,10 @@ bool CalculatorImpl::CalculateString(const string &key, string *result) const {
     LOG(ERROR) << "Key is empty.";
     return false;
   }
+  if (!MayBeExpression(key)) {
+    result->clear();
+    return false;
+  }
   string normalized_key;
   Util::FullWidthAsciiToHalfWidthAscii(key, &normalized_key);
 
@@ -213,13 +323,12 @@ bool CalculatorImpl::Tokenize(const string &input,
 bool CalculatorImpl::CalculateTokens(const TokenSequence &tokens,
                                      double *result_value) const {
   DCHECK(result_value);
-  void *parser = ParseAlloc(malloc);
+  ScopedParser parser;
   Result result;
   for (size_t i = 0; i < tokens.size(); ++i) {
-    Parse(parser, tokens[i].first, tokens[i].second, &result);
+    Parse(parser.get(), tokens[i].first, tokens[i].second, &result);
   }
-  Parse(parser, 0, 0.0, &result);
-  ParseFree(parser, free);
+  Parse(parser.get(), 0, 0.0, &result);
 
   if (result.error_type != Result::ACCEPTED) {
     return false;
@@ -89,6 +89,19 @@
         'test_size': 'small',
       },
     },
+    {
+      'target_name': 'calculator_benchmark',
+      'type': 'executable',
+      'sources': [
+        'calculator_benchmark.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../base/base_test.gyp:benchmark_util',
+        '../../session/session.gyp:random_keyevents_generator',
+        'calculator',
+      ],
+    },
     # Test cases meta target: this target is referred from gyp/tests.gyp
     {
       'target_name': 'calculator_all_test',
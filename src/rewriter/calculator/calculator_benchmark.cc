@@ -0,0 +1,122 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark of CalculatorInterface::CalculateString.
+//  - "testset" replays the expressions of data/test/calculator/testset.txt.
+//  - "typing" replays every prefix of the test sentences of
+//    RandomKeyEventsGenerator as the rewriter sees them while the user types
+//    ordinary (non arithmetic) text.
+//
+// The results are printed as TSV lines, see BenchmarkRecorder.
+//
+// Usage:
+//   calculator_benchmark --testset_file=data/test/calculator/testset.txt
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/file_stream.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/util.h"
+#include "rewriter/calculator/calculator_interface.h"
+#include "session/random_keyevents_generator.h"
+
+DEFINE_int32(iterations, 10, "The number of iterations over each corpus.");
+DEFINE_string(testset_file, "data/test/calculator/testset.txt",
+              "The test set of the calculator in the format of "
+              "\"expression=answer\".");
+
+namespace mozc {
+namespace {
+
+void LoadTestset(const string &filename, vector<string> *keys) {
+  InputFileStream ifs(filename.c_str());
+  CHECK(ifs.good()) << "Could not read: " << filename;
+  string line;
+  while (getline(ifs, line)) {
+    const size_t index_of_equal = line.find('=');
+    if (index_of_equal == string::npos) {
+      continue;
+    }
+    keys->push_back(line.substr(0, index_of_equal + 1));
+  }
+}
+
+void MakeTypingKeys(vector<string> *keys) {
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  for (size_t i = 0; i < size; ++i) {
+    const string sentence(sentences[i]);
+    for (const char *begin = sentence.data(),
+             *end = sentence.data() + sentence.size();
+         begin < end; begin += Util::OneCharLen(begin)) {
+      keys->push_back(
+          string(sentence.data(), begin + Util::OneCharLen(begin)));
+    }
+  }
+}
+
+void RunCorpus(const string &name, const vector<string> &keys) {
+  const CalculatorInterface *calculator = CalculatorFactory::GetCalculator();
+  BenchmarkRecorder recorder("Calculator::CalculateString/" + name);
+  string result;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      recorder.Start();
+      calculator->CalculateString(keys[i], &result);
+      recorder.Stop();
+    }
+  }
+  recorder.Print(&cout);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  vector<string> testset_keys;
+  mozc::LoadTestset(FLAGS_testset_file, &testset_keys);
+  vector<string> typing_keys;
+  mozc::MakeTypingKeys(&typing_keys);
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  mozc::RunCorpus("testset", testset_keys);
+  mozc::RunCorpus("typing", typing_keys);
+  return 0;
+}
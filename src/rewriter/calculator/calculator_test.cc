@@ -97,6 +97,12 @@ TEST(CalculatorTest, BasicTest) {
   VerifyRejection(calculator, "(5)=");
   // Expression must include at least one number.
   VerifyRejection(calculator, "()=");
+  // Keys including characters other than numbers and operators.
+  // "あ1+1="
+  VerifyRejection(calculator, "\xE3\x81\x82""1+1=");
+  VerifyRejection(calculator, "1+1a=");
+  // "1+1=" followed by a full width hyphen-minus, which is not an operator.
+  VerifyRejection(calculator, "1\xEF\xBC\x8D""1=");
 
   // Test for each operators
   VerifyCalculation(calculator, "38+2.5=", "40.5");
@@ -127,6 +133,8 @@ TEST(CalculatorTest, BasicTest) {
   VerifyCalculation(calculator, "10\xEF\xBC\x8F""2=", "5");
   // "2＾ー2="
   VerifyCalculation(calculator, "2\xEF\xBC\xBE\xE3\x83\xBC""2=", "0.25");
+  // "　1+1＝" (with a full width space)
+  VerifyCalculation(calculator, "\xE3\x80\x80""1+1\xEF\xBC\x9D", "2");
   // "13％3="
   VerifyCalculation(calculator, "13\xEF\xBC\x85""3=", "1");
   // "（1+1）*2="
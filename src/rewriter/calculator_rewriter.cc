@@ -52,6 +52,11 @@ CalculatorRewriter::CalculatorRewriter(
 
 CalculatorRewriter::~CalculatorRewriter() {}
 
+void CalculatorRewriter::GetTrigger(Trigger *trigger) const {
+  // An expression has at least one number.
+  trigger->script_types = Trigger::ScriptTypeBit(Util::NUMBER);
+}
+
 int CalculatorRewriter::capability(const ConversionRequest &request) const {
   if (request.request().mixed_conversion()) {
     return RewriterInterface::ALL;
@@ -51,6 +51,8 @@ class CalculatorRewriter : public RewriterInterface {
 
   virtual int capability(const ConversionRequest &request) const;
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 
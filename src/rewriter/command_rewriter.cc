@@ -188,6 +188,10 @@ CommandRewriter::CommandRewriter() {}
 
 CommandRewriter::~CommandRewriter() {}
 
+void CommandRewriter::GetTrigger(Trigger *trigger) const {
+  trigger->keys.assign(kTriggerKeys, kTriggerKeys + arraysize(kTriggerKeys));
+}
+
 void CommandRewriter::InsertIncognitoModeToggleCommand(
     Segment *segment, size_t reference_pos, size_t insert_pos) const {
   Segment::Candidate *candidate = InsertCommandCandidate(segment, reference_pos,
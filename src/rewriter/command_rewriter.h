@@ -46,6 +46,8 @@ class CommandRewriter : public RewriterInterface  {
   CommandRewriter();
   virtual ~CommandRewriter();
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 
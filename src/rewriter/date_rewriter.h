@@ -55,6 +55,9 @@ class DateRewriter : public RewriterInterface  {
 
   virtual int capability(const ConversionRequest &request) const;
 
+  // No trigger is set.  RewriteFourDigits() reads the raw input of the
+  // composer, and on 12-key layouts the key of the same input can be of any
+  // script type.
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 
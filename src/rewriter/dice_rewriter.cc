@@ -47,6 +47,9 @@ const int kDiceFaces = 6;
 // Last candidate index of one page.
 const size_t kLastCandidateIndex = 8;
 
+// "さいころ"
+const char kDiceKey[] = "\xE3\x81\x95\xE3\x81\x84\xE3\x81\x93\xE3\x82\x8D";
+
 // Insert a dice number into the |segment|
 // The number indicated by |top_face_number| is inserted at
 // |insert_pos|. Return false if insersion is failed.
@@ -89,6 +92,10 @@ DiceRewriter::DiceRewriter() {}
 
 DiceRewriter::~DiceRewriter() {}
 
+void DiceRewriter::GetTrigger(Trigger *trigger) const {
+  trigger->keys.push_back(kDiceKey);
+}
+
 bool DiceRewriter::Rewrite(const ConversionRequest &request,
                            Segments *segments) const {
   if (segments->conversion_segments_size() != 1) {
@@ -102,8 +109,7 @@ bool DiceRewriter::Rewrite(const ConversionRequest &request,
     return false;
   }
 
-  // "さいころ"
-  if (key != "\xE3\x81\x95\xE3\x81\x84\xE3\x81\x93\xE3\x82\x8D") {
+  if (key != kDiceKey) {
     return false;
   }
 
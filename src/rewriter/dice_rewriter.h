@@ -42,6 +42,8 @@ class DiceRewriter : public RewriterInterface {
   DiceRewriter();
   virtual ~DiceRewriter();
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 };
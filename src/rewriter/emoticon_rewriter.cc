@@ -258,6 +258,11 @@ int EmoticonRewriter::capability(const ConversionRequest &request) const {
   return RewriterInterface::CONVERSION;
 }
 
+void EmoticonRewriter::GetTrigger(Trigger *trigger) const {
+  // Every key of the emoticon dictionary contains Hiragana.
+  trigger->script_types = Trigger::ScriptTypeBit(Util::HIRAGANA);
+}
+
 bool EmoticonRewriter::Rewrite(const ConversionRequest &request,
                                Segments *segments) const {
   if (!GET_CONFIG(use_emoticon_conversion)) {
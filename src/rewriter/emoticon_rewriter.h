@@ -44,6 +44,8 @@ class EmoticonRewriter : public RewriterInterface  {
 
   virtual int capability(const ConversionRequest &request) const;
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 };
@@ -53,6 +53,9 @@ enum FortuneType {
   NUM_FORTUNE_TYPES            = 6,
 };
 
+// "おみくじ"
+const char kFortuneKey[] = "\xE3\x81\x8A\xE3\x81\xBF\xE3\x81\x8F\xE3\x81\x98";
+
 const int kMaxLevel = 100;
 const int kNormalLevels[]     = { 20, 40, 60, 80, 90 };
 const int kNewYearLevels[]    = { 30, 60, 80, 90, 95 };
@@ -182,6 +185,10 @@ FortuneRewriter::FortuneRewriter() {}
 
 FortuneRewriter::~FortuneRewriter() {}
 
+void FortuneRewriter::GetTrigger(Trigger *trigger) const {
+  trigger->keys.push_back(kFortuneKey);
+}
+
 bool FortuneRewriter::Rewrite(const ConversionRequest &request,
                               Segments *segments) const {
   if (segments->conversion_segments_size() != 1) {
@@ -195,8 +202,7 @@ bool FortuneRewriter::Rewrite(const ConversionRequest &request,
     return false;
   }
 
-  // "おみくじ"
-  if (key != "\xE3\x81\x8A\xE3\x81\xBF\xE3\x81\x8F\xE3\x81\x98") {
+  if (key != kFortuneKey) {
     return false;
   }
   FortuneData *fortune_data = Singleton<FortuneData>::get();
@@ -0,0 +1,135 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "rewriter/lazy_rewriter.h"
+
+#ifdef OS_WIN
+#include <windows.h>
+#endif  // OS_WIN
+
+#include "base/latency_histogram.h"
+#include "base/logging.h"
+
+namespace mozc {
+namespace {
+
+inline RewriterInterface *AcquireLoad(RewriterInterface *volatile *ptr) {
+#ifdef OS_WIN
+  return static_cast<RewriterInterface *>(
+      ::InterlockedCompareExchangePointer(
+          reinterpret_cast<PVOID volatile *>(ptr), NULL, NULL));
+#else
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif  // OS_WIN
+}
+
+inline void ReleaseStore(RewriterInterface *volatile *ptr,
+                         RewriterInterface *value) {
+#ifdef OS_WIN
+  ::InterlockedExchangePointer(reinterpret_cast<PVOID volatile *>(ptr), value);
+#else
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif  // OS_WIN
+}
+
+bool HasTrigger(const RewriterInterface &rewriter) {
+  RewriterInterface::Trigger trigger;
+  rewriter.GetTrigger(&trigger);
+  return trigger.script_types != RewriterInterface::Trigger::kAllScriptTypes ||
+      !trigger.keys.empty();
+}
+
+}  // namespace
+
+LazyRewriter::LazyRewriter(Factory *factory, const string &name,
+                           ThreadPool *pool)
+    : factory_(factory),
+      histogram_(LatencyHistogram::Get("RewriterInit::" + name)),
+      built_rewriter_(NULL),
+      build_task_(this) {
+  DCHECK(factory_.get());
+  if (pool != NULL) {
+    build_group_.reset(new TaskGroup(pool));
+    build_group_->Run(&build_task_);
+  }
+}
+
+LazyRewriter::~LazyRewriter() {}
+
+RewriterInterface *LazyRewriter::GetRewriter() const {
+  RewriterInterface *rewriter = AcquireLoad(&built_rewriter_);
+  if (rewriter != NULL) {
+    return rewriter;
+  }
+
+  scoped_lock l(&mutex_);
+  if (rewriter_.get() == NULL) {
+    ScopedLatencyTimer timer(histogram_);
+    rewriter_.reset(factory_->Create());
+    CHECK(rewriter_.get());
+    DCHECK(!HasTrigger(*rewriter_)) << "The trigger is not forwarded.";
+    ReleaseStore(&built_rewriter_, rewriter_.get());
+  }
+  return rewriter_.get();
+}
+
+int LazyRewriter::capability(const ConversionRequest &request) const {
+  return GetRewriter()->capability(request);
+}
+
+bool LazyRewriter::Rewrite(const ConversionRequest &request,
+                           Segments *segments) const {
+  return GetRewriter()->Rewrite(request, segments);
+}
+
+bool LazyRewriter::Focus(Segments *segments,
+                         size_t segment_index,
+                         int candidate_index) const {
+  return GetRewriter()->Focus(segments, segment_index, candidate_index);
+}
+
+void LazyRewriter::Finish(const ConversionRequest &request,
+                          Segments *segments) {
+  GetRewriter()->Finish(request, segments);
+}
+
+bool LazyRewriter::Sync() {
+  return GetRewriter()->Sync();
+}
+
+bool LazyRewriter::Reload() {
+  return GetRewriter()->Reload();
+}
+
+void LazyRewriter::Clear() {
+  GetRewriter()->Clear();
+}
+
+}  // namespace mozc
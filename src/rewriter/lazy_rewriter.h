@@ -0,0 +1,125 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// LazyRewriter defers the construction of a rewriter whose constructor is
+// expensive, e.g., builds a large map from the embedded data or loads a
+// history file, so that it doesn't delay the engine initialization.  The
+// wrapped rewriter is built by a factory either on a thread pool in the
+// background right after the construction of LazyRewriter, or on the first
+// call.  A factory which reads files should be given a pool so that the first
+// call doesn't wait for the I/O.  Every method blocks until the build
+// finishes and then forwards the call, so LazyRewriter behaves exactly like
+// the wrapped rewriter.
+//
+// MergerRewriter asks for the trigger when a rewriter is added, which is
+// before the build, so GetTrigger() is not forwarded.  Only rewriters without
+// a trigger can be wrapped.
+
+#ifndef MOZC_REWRITER_LAZY_REWRITER_H_
+#define MOZC_REWRITER_LAZY_REWRITER_H_
+
+#include <string>
+
+#include "base/mutex.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/thread_pool.h"
+#include "rewriter/rewriter_interface.h"
+
+namespace mozc {
+
+class ConversionRequest;
+class LatencyHistogram;
+class Segments;
+
+class LazyRewriter : public RewriterInterface {
+ public:
+  class Factory {
+   public:
+    virtual ~Factory() {}
+    virtual RewriterInterface *Create() const = 0;
+  };
+
+  // Takes the ownership of |factory|.  If |pool| is not NULL, the rewriter is
+  // built on |pool| in the background, otherwise on the first call.  The
+  // build time is recorded to the histogram "RewriterInit::<name>".
+  LazyRewriter(Factory *factory, const string &name, ThreadPool *pool);
+  virtual ~LazyRewriter();
+
+  virtual int capability(const ConversionRequest &request) const;
+  virtual bool Rewrite(const ConversionRequest &request,
+                       Segments *segments) const;
+  virtual bool Focus(Segments *segments,
+                     size_t segment_index,
+                     int candidate_index) const;
+  virtual void Finish(const ConversionRequest &request, Segments *segments);
+  virtual bool Sync();
+  virtual bool Reload();
+  virtual void Clear();
+
+ private:
+  class BuildTask : public ThreadPool::Task {
+   public:
+    explicit BuildTask(const LazyRewriter *rewriter) : rewriter_(rewriter) {}
+    virtual void Run() {
+      rewriter_->GetRewriter();
+    }
+
+   private:
+    const LazyRewriter *rewriter_;
+
+    DISALLOW_COPY_AND_ASSIGN(BuildTask);
+  };
+
+  // Builds the rewriter unless it has been built, and returns it.  Doesn't
+  // lock once the rewriter has been built.
+  RewriterInterface *GetRewriter() const;
+
+  scoped_ptr<const Factory> factory_;
+  LatencyHistogram *histogram_;
+
+  // Guards the build of |rewriter_|, which is never changed once built.
+  mutable Mutex mutex_;
+  mutable scoped_ptr<RewriterInterface> rewriter_;
+  // Same as |rewriter_|, but set with the release semantics after the build
+  // so that it can be read without |mutex_|.  NULL until then.
+  mutable RewriterInterface *volatile built_rewriter_;
+
+  BuildTask build_task_;
+  // Declared last so that the destructor waits for |build_task_| before the
+  // other members are destroyed.  NULL if |pool| is not given.
+  scoped_ptr<TaskGroup> build_group_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyRewriter);
+};
+
+}  // namespace mozc
+
+#endif  // MOZC_REWRITER_LAZY_REWRITER_H_
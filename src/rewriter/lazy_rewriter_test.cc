@@ -0,0 +1,206 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "rewriter/lazy_rewriter.h"
+
+#include <string>
+#include <vector>
+
+#include "base/mutex.h"
+#include "base/stl_util.h"
+#include "base/thread.h"
+#include "base/thread_pool.h"
+#include "base/util.h"
+#include "converter/conversion_request.h"
+#include "converter/segments.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace {
+
+// Appends the called methods to |log|.
+class LoggingRewriter : public RewriterInterface {
+ public:
+  explicit LoggingRewriter(string *log) : log_(log) {}
+
+  virtual int capability(const ConversionRequest &request) const {
+    log_->append("capability;");
+    return RewriterInterface::ALL;
+  }
+
+  virtual bool Rewrite(const ConversionRequest &request,
+                       Segments *segments) const {
+    log_->append("Rewrite;");
+    return true;
+  }
+
+  virtual bool Focus(Segments *segments,
+                     size_t segment_index,
+                     int candidate_index) const {
+    log_->append("Focus;");
+    return true;
+  }
+
+  virtual void Finish(const ConversionRequest &request, Segments *segments) {
+    log_->append("Finish;");
+  }
+
+  virtual bool Sync() {
+    log_->append("Sync;");
+    return true;
+  }
+
+  virtual bool Reload() {
+    log_->append("Reload;");
+    return true;
+  }
+
+  virtual void Clear() {
+    log_->append("Clear;");
+  }
+
+ private:
+  string *log_;
+};
+
+class LoggingRewriterFactory : public LazyRewriter::Factory {
+ public:
+  explicit LoggingRewriterFactory(string *log) : log_(log) {}
+
+  virtual RewriterInterface *Create() const {
+    log_->append("Create;");
+    return new LoggingRewriter(log_);
+  }
+
+ private:
+  string *log_;
+};
+
+class NoOpRewriter : public RewriterInterface {
+ public:
+  virtual bool Rewrite(const ConversionRequest &request,
+                       Segments *segments) const {
+    return false;
+  }
+};
+
+// Counts the builds, which take a while.
+class SlowRewriterFactory : public LazyRewriter::Factory {
+ public:
+  SlowRewriterFactory(Mutex *mutex, int *num_builds)
+      : mutex_(mutex), num_builds_(num_builds) {}
+
+  virtual RewriterInterface *Create() const {
+    Util::Sleep(100);
+    scoped_lock l(mutex_);
+    ++*num_builds_;
+    return new NoOpRewriter;
+  }
+
+ private:
+  Mutex *mutex_;
+  int *num_builds_;
+};
+
+class RewriteThread : public Thread {
+ public:
+  explicit RewriteThread(const LazyRewriter *rewriter) : rewriter_(rewriter) {}
+
+  virtual void Run() {
+    const ConversionRequest request;
+    Segments segments;
+    for (int i = 0; i < 1000; ++i) {
+      rewriter_->Rewrite(request, &segments);
+    }
+  }
+
+ private:
+  const LazyRewriter *rewriter_;
+};
+
+TEST(LazyRewriterTest, BuildOnFirstUse) {
+  string log;
+  LazyRewriter rewriter(new LoggingRewriterFactory(&log), "Logging", NULL);
+  EXPECT_TRUE(log.empty());
+
+  const ConversionRequest request;
+  Segments segments;
+  EXPECT_EQ(RewriterInterface::ALL, rewriter.capability(request));
+  EXPECT_TRUE(rewriter.Rewrite(request, &segments));
+  EXPECT_TRUE(rewriter.Focus(&segments, 0, 0));
+  rewriter.Finish(request, &segments);
+  EXPECT_TRUE(rewriter.Sync());
+  EXPECT_TRUE(rewriter.Reload());
+  rewriter.Clear();
+  EXPECT_EQ("Create;capability;Rewrite;Focus;Finish;Sync;Reload;Clear;", log);
+}
+
+TEST(LazyRewriterTest, BuildInBackground) {
+  ThreadPool pool(2);
+  string log;
+  {
+    LazyRewriter rewriter(new LoggingRewriterFactory(&log), "Logging", &pool);
+    const ConversionRequest request;
+    Segments segments;
+    EXPECT_TRUE(rewriter.Rewrite(request, &segments));
+    EXPECT_EQ("Create;Rewrite;", log);
+  }
+
+  // The rewriter is built exactly once even if it is never called.
+  log.clear();
+  {
+    LazyRewriter rewriter(new LoggingRewriterFactory(&log), "Logging", &pool);
+  }
+  EXPECT_EQ("Create;", log);
+}
+
+TEST(LazyRewriterTest, BuildOnceFromThreads) {
+  Mutex mutex;
+  int num_builds = 0;
+  LazyRewriter rewriter(new SlowRewriterFactory(&mutex, &num_builds),
+                        "Slow", NULL);
+  vector<RewriteThread *> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(new RewriteThread(&rewriter));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Start();
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+  }
+  STLDeleteElements(&threads);
+
+  scoped_lock l(&mutex);
+  EXPECT_EQ(1, num_builds);
+}
+
+}  // namespace
+}  // namespace mozc
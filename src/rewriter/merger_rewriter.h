@@ -30,15 +30,27 @@
 #ifndef MOZC_REWRITER_MERGER_REWRITER_H_
 #define MOZC_REWRITER_MERGER_REWRITER_H_
 
+#ifdef OS_WIN
+#include <windows.h>
+#endif  // OS_WIN
+
+#include <algorithm>
+#include <map>
+#include <string>
 #include <vector>
 
+#include "base/latency_histogram.h"
+#include "base/logging.h"
 #include "base/stl_util.h"
+#include "base/util.h"
+#include "composer/composer.h"
 #include "config/config.pb.h"
 #include "config/config_handler.h"
 #include "converter/conversion_request.h"
 #include "converter/segments.h"
 #include "rewriter/rewriter_interface.h"
 #include "session/commands.pb.h"
+#include "usage_stats/usage_stats.h"
 
 namespace mozc {
 
@@ -78,15 +90,89 @@ class MergerRewriter : public RewriterInterface {
 
   // This instance owns the rewriter.
   void AddRewriter(RewriterInterface *rewriter) {
-    rewriters_.push_back(rewriter);
+    AddRewriterInternal(rewriter, "", NULL, false);
+  }
+
+  // Same as above, but also records the latency of |rewriter|->Rewrite() to
+  // the histogram "Rewriter::<name>".
+  void AddRewriter(RewriterInterface *rewriter, const string &name) {
+    AddRewriterInternal(rewriter, name,
+                        LatencyHistogram::Get("Rewriter::" + name), false);
+  }
+
+  // Same as above, but |rewriter| is skipped once the request has expired
+  // (see ConversionRequest::IsExpired()).  Only the rewriters which add or
+  // reorder candidates on their own should be optional.  The rewriters which
+  // normalize or filter the candidates of the others or learn from the user
+  // must be added by AddRewriter() so that they always run.
+  void AddOptionalRewriter(RewriterInterface *rewriter, const string &name) {
+    AddRewriterInternal(rewriter, name,
+                        LatencyHistogram::Get("Rewriter::" + name), true);
+  }
+
+  // Dispatch counters of a rewriter.
+  struct DispatchStats {
+    string name;
+    // The number of Rewrite() calls.
+    uint64 called;
+    // The number of Rewrite() calls which returned true.
+    uint64 rewritten;
+    // The number of Rewrite() calls skipped by the trigger of the rewriter.
+    uint64 skipped;
+  };
+
+  // Returns the counters in the order of AddRewriter().  The counters are
+  // updated without a lock, so they may lag behind the Rewrite() calls
+  // running on the other threads.
+  void GetDispatchStats(vector<DispatchStats> *stats) const {
+    DCHECK(stats);
+    *stats = stats_;
   }
 
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const {
+    KeyFeatures features;
+    bool features_updated = false;
+    bool expired = false;
+
     bool result = false;
     for (size_t i = 0; i < rewriters_.size(); ++i) {
-      if (CheckCapablity(request, segments, rewriters_[i])) {
-        result |= rewriters_[i]->Rewrite(request, segments);
+      if (!CheckCapablity(request, segments, rewriters_[i])) {
+        continue;
+      }
+      // Once the request expires, the remaining optional rewriters are
+      // skipped.  The required ones still run.
+      if (optional_[i]) {
+        if (!expired && request.IsExpired()) {
+          expired = true;
+          usage_stats::UsageStats::IncrementCount(
+              "ConversionRequestExpiredInMergerRewriter");
+        }
+        if (expired) {
+          continue;
+        }
+      }
+      if (has_trigger_[i]) {
+        if (!features_updated) {
+          GetKeyFeatures(request, *segments, &features);
+          features_updated = true;
+        }
+        if (!IsTriggered(i, features)) {
+          IncrementCounter(&stats_[i].skipped);
+          continue;
+        }
+      }
+      bool rewritten = false;
+      {
+        ScopedLatencyTimer timer(histograms_[i]);
+        rewritten = rewriters_[i]->Rewrite(request, segments);
+      }
+      IncrementCounter(&stats_[i].called);
+      if (rewritten) {
+        IncrementCounter(&stats_[i].rewritten);
+        result = true;
+        // The rewriter may have resized the segments.
+        features_updated = false;
       }
     }
 
@@ -130,6 +216,18 @@ class MergerRewriter : public RewriterInterface {
 
   // Syncs internal data to local file system.
   virtual bool Sync() {
+    if (VLOG_IS_ON(1)) {
+      vector<DispatchStats> stats;
+      GetDispatchStats(&stats);
+      for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].name.empty()) {
+          continue;
+        }
+        VLOG(1) << stats[i].name << " called=" << stats[i].called
+                << " rewritten=" << stats[i].rewritten
+                << " skipped=" << stats[i].skipped;
+      }
+    }
     bool result = false;
     for (size_t i = 0; i < rewriters_.size(); ++i) {
       result |= rewriters_[i]->Sync();
@@ -154,7 +252,112 @@ class MergerRewriter : public RewriterInterface {
   }
 
  private:
+  // Summary of the conversion segment keys used to evaluate the triggers.
+  struct KeyFeatures {
+    KeyFeatures() : script_types(0), has_source_text(false) {}
+    // Bitmask of Trigger::ScriptTypeBit().
+    uint32 script_types;
+    // True if the composer has a source text.
+    bool has_source_text;
+    // Indices of the rewriters whose trigger keys match a conversion
+    // segment key.
+    vector<size_t> key_matched_rewriters;
+  };
+
+  void AddRewriterInternal(RewriterInterface *rewriter, const string &name,
+                           LatencyHistogram *histogram, bool optional) {
+    const size_t index = rewriters_.size();
+    rewriters_.push_back(rewriter);
+    histograms_.push_back(histogram);
+    optional_.push_back(optional);
+
+    // Compiles the trigger into the dispatch index.
+    Trigger trigger;
+    rewriter->GetTrigger(&trigger);
+    script_types_.push_back(trigger.script_types);
+    has_trigger_.push_back(trigger.script_types != Trigger::kAllScriptTypes ||
+                           !trigger.keys.empty());
+    has_trigger_keys_.push_back(!trigger.keys.empty());
+    triggered_by_source_text_.push_back(trigger.source_text);
+    for (size_t i = 0; i < trigger.keys.size(); ++i) {
+      vector<size_t> *indices = &trigger_key_index_[trigger.keys[i]];
+      if (indices->empty() || indices->back() != index) {
+        indices->push_back(index);
+      }
+    }
+
+    DispatchStats stats;
+    stats.name = name;
+    stats.called = 0;
+    stats.rewritten = 0;
+    stats.skipped = 0;
+    stats_.push_back(stats);
+  }
+
+  // Rewrite() may run on several threads at once.
+  static void IncrementCounter(uint64 *counter) {
+#ifdef OS_WIN
+    ::InterlockedIncrement64(reinterpret_cast<volatile LONGLONG *>(counter));
+#else
+    __sync_fetch_and_add(counter, 1);
+#endif  // OS_WIN
+  }
+
+  void GetKeyFeatures(const ConversionRequest &request,
+                      const Segments &segments, KeyFeatures *features) const {
+    features->has_source_text =
+        request.has_composer() && !request.composer().source_text().empty();
+    features->script_types = 0;
+    features->key_matched_rewriters.clear();
+    for (size_t i = 0; i < segments.conversion_segments_size(); ++i) {
+      const string &key = segments.conversion_segment(i).key();
+      for (ConstChar32Iterator iter(key); !iter.Done(); iter.Next()) {
+        features->script_types |=
+            Trigger::ScriptTypeBit(Util::GetScriptType(iter.Get()));
+      }
+      const map<string, vector<size_t> >::const_iterator it =
+          trigger_key_index_.find(key);
+      if (it != trigger_key_index_.end()) {
+        features->key_matched_rewriters.insert(
+            features->key_matched_rewriters.end(),
+            it->second.begin(), it->second.end());
+      }
+    }
+  }
+
+  bool IsTriggered(size_t index, const KeyFeatures &features) const {
+    if (triggered_by_source_text_[index] && features.has_source_text) {
+      return true;
+    }
+    if ((script_types_[index] & features.script_types) == 0) {
+      return false;
+    }
+    if (has_trigger_keys_[index] &&
+        find(features.key_matched_rewriters.begin(),
+             features.key_matched_rewriters.end(),
+             index) == features.key_matched_rewriters.end()) {
+      return false;
+    }
+    return true;
+  }
+
   vector<RewriterInterface *> rewriters_;
+  // The following vectors are parallel to |rewriters_|.
+  // NULL for a rewriter added without a name.
+  vector<LatencyHistogram *> histograms_;
+  // True for a rewriter added by AddOptionalRewriter().
+  vector<bool> optional_;
+  vector<uint32> script_types_;
+  vector<bool> has_trigger_;
+  vector<bool> has_trigger_keys_;
+  vector<bool> triggered_by_source_text_;
+
+  // Maps a trigger key to the indices of the rewriters triggered by it.
+  map<string, vector<size_t> > trigger_key_index_;
+
+  // Parallel to |rewriters_|.  The counters are updated by
+  // IncrementCounter().
+  mutable vector<DispatchStats> stats_;
 
   DISALLOW_COPY_AND_ASSIGN(MergerRewriter);
 };
@@ -30,12 +30,17 @@
 #include "rewriter/merger_rewriter.h"
 
 #include <string>
+#include <vector>
 
+#include "base/cancellation_flag.h"
 #include "base/system_util.h"
+#include "base/util.h"
+#include "composer/composer.h"
 #include "config/config.pb.h"
 #include "config/config_handler.h"
 #include "converter/conversion_request.h"
 #include "converter/segments.h"
+#include "session/commands.pb.h"
 #include "testing/base/public/gunit.h"
 
 DECLARE_string(test_tmpdir);
@@ -101,6 +106,38 @@ class TestRewriter : public RewriterInterface {
   int capability_;
 };
 
+// Raises the cancellation flag when it is called.
+class CancellingRewriter : public TestRewriter {
+ public:
+  CancellingRewriter(string *buffer, const string &name,
+                     CancellationFlag *flag)
+      : TestRewriter(buffer, name, true), flag_(flag) {}
+
+  virtual bool Rewrite(const ConversionRequest &request,
+                       Segments *segments) const {
+    flag_->Cancel();
+    return TestRewriter::Rewrite(request, segments);
+  }
+
+ private:
+  CancellationFlag *flag_;
+};
+
+// Publishes a trigger.
+class TriggeredRewriter : public TestRewriter {
+ public:
+  TriggeredRewriter(string *buffer, const string &name, bool return_value,
+                    const Trigger &trigger)
+      : TestRewriter(buffer, name, return_value), trigger_(trigger) {}
+
+  virtual void GetTrigger(Trigger *trigger) const {
+    *trigger = trigger_;
+  }
+
+ private:
+  const Trigger trigger_;
+};
+
 class MergerRewriterTest : public testing::Test {
  protected:
   virtual void SetUp() {
@@ -136,6 +173,158 @@ TEST_F(MergerRewriterTest, Rewrite) {
             call_result);
 }
 
+TEST_F(MergerRewriterTest, RewriteCancelled) {
+  string call_result;
+  MergerRewriter merger;
+  Segments segments;
+  CancellationFlag flag;
+  ConversionRequest request;
+  request.set_cancellation_flag(&flag);
+
+  segments.set_request_type(Segments::CONVERSION);
+  merger.AddOptionalRewriter(new TestRewriter(&call_result, "a", false), "a");
+  merger.AddRewriter(new CancellingRewriter(&call_result, "b", &flag), "b");
+  merger.AddOptionalRewriter(new TestRewriter(&call_result, "c", true), "c");
+  merger.AddRewriter(new TestRewriter(&call_result, "d", false), "d");
+  // The optional rewriters after "b" are skipped but the required ones
+  // still run.
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();"
+            "b.Rewrite();"
+            "d.Rewrite();",
+            call_result);
+
+  // Only the required rewriters are called for a cancelled request.
+  call_result.clear();
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("b.Rewrite();"
+            "d.Rewrite();",
+            call_result);
+
+  flag.Reset();
+  call_result.clear();
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();"
+            "b.Rewrite();"
+            "d.Rewrite();",
+            call_result);
+}
+
+TEST_F(MergerRewriterTest, RewriteWithTrigger) {
+  string call_result;
+  MergerRewriter merger;
+
+  RewriterInterface::Trigger number_trigger;
+  number_trigger.script_types =
+      RewriterInterface::Trigger::ScriptTypeBit(Util::NUMBER);
+  RewriterInterface::Trigger key_trigger;
+  key_trigger.keys.push_back("dice");
+  key_trigger.keys.push_back("fortune");
+
+  merger.AddRewriter(new TestRewriter(&call_result, "a", false), "a");
+  merger.AddRewriter(
+      new TriggeredRewriter(&call_result, "b", false, number_trigger), "b");
+  merger.AddRewriter(
+      new TriggeredRewriter(&call_result, "c", true, key_trigger), "c");
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  Segment *segment = segments.add_segment();
+  const ConversionRequest request;
+
+  segment->set_key("abc");
+  EXPECT_FALSE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();", call_result);
+
+  call_result.clear();
+  segment->set_key("abc123");
+  EXPECT_FALSE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();"
+            "b.Rewrite();",
+            call_result);
+
+  call_result.clear();
+  segment->set_key("dice");
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();"
+            "c.Rewrite();",
+            call_result);
+
+  // Trigger keys are matched against each conversion segment.
+  call_result.clear();
+  segment->set_key("1");
+  segments.add_segment()->set_key("fortune");
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();"
+            "b.Rewrite();"
+            "c.Rewrite();",
+            call_result);
+
+  // History segments are not used.
+  call_result.clear();
+  segment->set_segment_type(Segment::HISTORY);
+  segments.mutable_segment(1)->set_key("x");
+  EXPECT_FALSE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("a.Rewrite();", call_result);
+
+  vector<MergerRewriter::DispatchStats> stats;
+  merger.GetDispatchStats(&stats);
+  ASSERT_EQ(3, stats.size());
+  EXPECT_EQ("a", stats[0].name);
+  EXPECT_EQ(5, stats[0].called);
+  EXPECT_EQ(0, stats[0].rewritten);
+  EXPECT_EQ(0, stats[0].skipped);
+  EXPECT_EQ("b", stats[1].name);
+  EXPECT_EQ(2, stats[1].called);
+  EXPECT_EQ(0, stats[1].rewritten);
+  EXPECT_EQ(3, stats[1].skipped);
+  EXPECT_EQ("c", stats[2].name);
+  EXPECT_EQ(2, stats[2].called);
+  EXPECT_EQ(2, stats[2].rewritten);
+  EXPECT_EQ(3, stats[2].skipped);
+}
+
+TEST_F(MergerRewriterTest, RewriteWithSourceTextTrigger) {
+  string call_result;
+  MergerRewriter merger;
+
+  RewriterInterface::Trigger alphabet_trigger;
+  alphabet_trigger.script_types =
+      RewriterInterface::Trigger::ScriptTypeBit(Util::ALPHABET);
+  RewriterInterface::Trigger source_text_trigger = alphabet_trigger;
+  source_text_trigger.source_text = true;
+
+  merger.AddRewriter(
+      new TriggeredRewriter(&call_result, "a", false, alphabet_trigger), "a");
+  merger.AddRewriter(
+      new TriggeredRewriter(&call_result, "b", true, source_text_trigger),
+      "b");
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  // "あい"
+  segments.add_segment()->set_key("ãã");
+
+  const commands::Request default_request;
+  composer::Composer composer(NULL, &default_request);
+  const ConversionRequest request(&composer, &default_request);
+  EXPECT_FALSE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("", call_result);
+
+  // On reverse conversion, the key is the reading of the source text.
+  composer.set_source_text("æ");  // "愛"
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_EQ("b.Rewrite();", call_result);
+
+  vector<MergerRewriter::DispatchStats> stats;
+  merger.GetDispatchStats(&stats);
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ(0, stats[0].called);
+  EXPECT_EQ(2, stats[0].skipped);
+  EXPECT_EQ(1, stats[1].called);
+  EXPECT_EQ(1, stats[1].skipped);
+}
+
 TEST_F(MergerRewriterTest, RewriteSuggestion) {
   string call_result;
   MergerRewriter merger;
@@ -47,6 +47,7 @@
 #include "rewriter/focus_candidate_rewriter.h"
 #include "rewriter/fortune_rewriter.h"
 #include "rewriter/language_aware_rewriter.h"
+#include "rewriter/lazy_rewriter.h"
 #include "rewriter/merger_rewriter.h"
 #include "rewriter/normalization_rewriter.h"
 #include "rewriter/number_rewriter.h"
@@ -84,59 +85,134 @@ namespace {
 }  // namespace
 
 namespace mozc {
+namespace {
+
+class UserBoundaryHistoryRewriterFactory : public LazyRewriter::Factory {
+ public:
+  explicit UserBoundaryHistoryRewriterFactory(
+      const ConverterInterface *parent_converter)
+      : parent_converter_(parent_converter) {}
+
+  virtual RewriterInterface *Create() const {
+    return new UserBoundaryHistoryRewriter(parent_converter_);
+  }
+
+ private:
+  const ConverterInterface *parent_converter_;
+};
+
+class UserSegmentHistoryRewriterFactory : public LazyRewriter::Factory {
+ public:
+  UserSegmentHistoryRewriterFactory(const POSMatcher *pos_matcher,
+                                    const PosGroup *pos_group)
+      : pos_matcher_(pos_matcher), pos_group_(pos_group) {}
+
+  virtual RewriterInterface *Create() const {
+    return new UserSegmentHistoryRewriter(pos_matcher_, pos_group_);
+  }
+
+ private:
+  const POSMatcher *pos_matcher_;
+  const PosGroup *pos_group_;
+};
+
+#ifndef NO_USAGE_REWRITER
+class UsageRewriterFactory : public LazyRewriter::Factory {
+ public:
+  UsageRewriterFactory(const DataManagerInterface *data_manager,
+                       const DictionaryInterface *dictionary)
+      : data_manager_(data_manager), dictionary_(dictionary) {}
+
+  virtual RewriterInterface *Create() const {
+    return new UsageRewriter(data_manager_, dictionary_);
+  }
+
+ private:
+  const DataManagerInterface *data_manager_;
+  const DictionaryInterface *dictionary_;
+};
+#endif  // NO_USAGE_REWRITER
+
+}  // namespace
 
 RewriterImpl::RewriterImpl(const ConverterInterface *parent_converter,
                            const DataManagerInterface *data_manager,
                            const PosGroup *pos_group,
-                           const DictionaryInterface *dictionary) {
+                           const DictionaryInterface *dictionary,
+                           ThreadPool *init_pool) {
   DCHECK(parent_converter);
   DCHECK(data_manager);
   DCHECK(pos_group);
   const POSMatcher *pos_matcher = data_manager->GetPOSMatcher();
   DCHECK(pos_matcher);
   // |dictionary| can be NULL
+  // |init_pool| can be NULL
 
-  AddRewriter(new UserDictionaryRewriter);
-  AddRewriter(new FocusCandidateRewriter(data_manager));
-  AddRewriter(new LanguageAwareRewriter(*pos_matcher, dictionary));
-  AddRewriter(new TransliterationRewriter(*pos_matcher));
-  AddRewriter(new EnglishVariantsRewriter);
-  AddRewriter(new NumberRewriter(data_manager));
-  AddRewriter(new CollocationRewriter(data_manager));
-  AddRewriter(new SingleKanjiRewriter(*pos_matcher));
-  AddRewriter(new EmojiRewriter(
+  // The rewriters added by AddOptionalRewriter() only add or reorder
+  // candidates and are skipped once the request has expired.
+  AddRewriter(new UserDictionaryRewriter, "UserDictionaryRewriter");
+  AddRewriter(new FocusCandidateRewriter(data_manager),
+              "FocusCandidateRewriter");
+  AddRewriter(new LanguageAwareRewriter(*pos_matcher, dictionary),
+              "LanguageAwareRewriter");
+  AddRewriter(new TransliterationRewriter(*pos_matcher),
+              "TransliterationRewriter");
+  AddRewriter(new EnglishVariantsRewriter, "EnglishVariantsRewriter");
+  AddRewriter(new NumberRewriter(data_manager), "NumberRewriter");
+  AddOptionalRewriter(new CollocationRewriter(data_manager),
+                      "CollocationRewriter");
+  AddRewriter(new SingleKanjiRewriter(*pos_matcher), "SingleKanjiRewriter");
+  AddOptionalRewriter(new EmojiRewriter(
       kEmojiDataList, arraysize(kEmojiDataList),
       kEmojiTokenList, arraysize(kEmojiTokenList),
-      kEmojiValueList));
-  AddRewriter(new EmoticonRewriter);
-  AddRewriter(new CalculatorRewriter(parent_converter));
-  AddRewriter(new SymbolRewriter(parent_converter, data_manager));
-  AddRewriter(new UnicodeRewriter(parent_converter));
-  AddRewriter(new VariantsRewriter(pos_matcher));
-  AddRewriter(new ZipcodeRewriter(pos_matcher));
-  AddRewriter(new DiceRewriter);
+      kEmojiValueList), "EmojiRewriter");
+  AddOptionalRewriter(new EmoticonRewriter, "EmoticonRewriter");
+  AddOptionalRewriter(new CalculatorRewriter(parent_converter),
+                      "CalculatorRewriter");
+  AddOptionalRewriter(new SymbolRewriter(parent_converter, data_manager),
+                      "SymbolRewriter");
+  AddRewriter(new UnicodeRewriter(parent_converter), "UnicodeRewriter");
+  AddRewriter(new VariantsRewriter(pos_matcher), "VariantsRewriter");
+  AddRewriter(new ZipcodeRewriter(pos_matcher), "ZipcodeRewriter");
+  AddRewriter(new DiceRewriter, "DiceRewriter");
 
+  // The history rewriters load their storage files on construction.  They
+  // are built on |init_pool| so that the first conversion doesn't wait for
+  // the file I/O.
   if (FLAGS_use_history_rewriter) {
-    AddRewriter(new UserBoundaryHistoryRewriter(parent_converter));
-    AddRewriter(new UserSegmentHistoryRewriter(pos_matcher, pos_group));
+    AddRewriter(new LazyRewriter(
+                    new UserBoundaryHistoryRewriterFactory(parent_converter),
+                    "UserBoundaryHistoryRewriter", init_pool),
+                "UserBoundaryHistoryRewriter");
+    AddRewriter(new LazyRewriter(
+                    new UserSegmentHistoryRewriterFactory(pos_matcher,
+                                                          pos_group),
+                    "UserSegmentHistoryRewriter", init_pool),
+                "UserSegmentHistoryRewriter");
   }
 
-  AddRewriter(new DateRewriter);
-  AddRewriter(new FortuneRewriter);
+  AddRewriter(new DateRewriter, "DateRewriter");
+  AddRewriter(new FortuneRewriter, "FortuneRewriter");
 #ifndef OS_ANDROID
   // CommandRewriter is not tested well on Android.
   // So we temporarily disable it.
   // TODO(yukawa, team): Enable CommandRewriter on Android if necessary.
-  AddRewriter(new CommandRewriter);
+  AddRewriter(new CommandRewriter, "CommandRewriter");
 #endif  // OS_ANDROID
 #ifndef NO_USAGE_REWRITER
-  AddRewriter(new UsageRewriter(data_manager, dictionary));
+  // UsageRewriter expands all the conjugations of the usage data into a map.
+  AddOptionalRewriter(new LazyRewriter(
+                          new UsageRewriterFactory(data_manager, dictionary),
+                          "UsageRewriter", init_pool),
+                      "UsageRewriter");
 #endif  // NO_USAGE_REWRITER
 
-  AddRewriter(new VersionRewriter);
-  AddRewriter(CorrectionRewriter::CreateCorrectionRewriter(data_manager));
-  AddRewriter(new NormalizationRewriter);
-  AddRewriter(new RemoveRedundantCandidateRewriter);
+  AddRewriter(new VersionRewriter, "VersionRewriter");
+  AddRewriter(CorrectionRewriter::CreateCorrectionRewriter(data_manager),
+              "CorrectionRewriter");
+  AddRewriter(new NormalizationRewriter, "NormalizationRewriter");
+  AddRewriter(new RemoveRedundantCandidateRewriter,
+              "RemoveRedundantCandidateRewriter");
 }
 
 }  // namespace mozc
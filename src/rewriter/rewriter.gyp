@@ -60,6 +60,7 @@
         'focus_candidate_rewriter.cc',
         'fortune_rewriter.cc',
         'language_aware_rewriter.cc',
+        'lazy_rewriter.cc',
         'normalization_rewriter.cc',
         'number_compound_util.cc',
         'number_rewriter.cc',
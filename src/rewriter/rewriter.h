@@ -39,13 +39,19 @@ namespace mozc {
 
 class ConverterInterface;
 class DataManagerInterface;
+class ThreadPool;
 
 class RewriterImpl : public MergerRewriter {
  public:
+  // The rewriters whose construction is expensive, including the history
+  // rewriters which load their files, are wrapped by LazyRewriter.  If
+  // |init_pool| is not NULL, they are built on it in the background,
+  // otherwise on the first use.
   RewriterImpl(const ConverterInterface *parent_converter,
                const DataManagerInterface *data_manager,
                const dictionary::PosGroup *pos_group,
-               const dictionary::DictionaryInterface *dictionary);
+               const dictionary::DictionaryInterface *dictionary,
+               ThreadPool *init_pool);
 
  private:
   DISALLOW_COPY_AND_ASSIGN(RewriterImpl);
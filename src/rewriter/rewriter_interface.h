@@ -31,7 +31,10 @@
 #define MOZC_REWRITER_REWRITER_INTERFACE_H_
 
 #include <cstddef>  // for size_t
+#include <string>
+#include <vector>
 
+#include "base/util.h"
 #include "converter/conversion_request.h"
 #include "converter/segments.h"
 
@@ -56,6 +59,36 @@ class RewriterInterface {
     return CONVERSION;
   }
 
+  // Describes the conversion keys on which Rewrite() can modify segments.
+  // MergerRewriter doesn't call Rewrite() when no conversion segment
+  // satisfies the trigger, so a trigger must never be narrower than the
+  // actual behavior of Rewrite().
+  struct Trigger {
+    Trigger() : script_types(kAllScriptTypes), source_text(false) {}
+
+    static const uint32 kAllScriptTypes =
+        (1 << Util::SCRIPT_TYPE_SIZE) - 1;
+    static uint32 ScriptTypeBit(Util::ScriptType type) {
+      return 1 << type;
+    }
+
+    // Bitmask of ScriptTypeBit().  Rewrite() can modify the segments only if
+    // the conversion segment keys contain a character of these types.
+    uint32 script_types;
+
+    // If not empty, Rewrite() can modify the segments only if the key of a
+    // conversion segment is one of them.
+    vector<string> keys;
+
+    // If true, Rewrite() is also called regardless of the keys when the
+    // composer has a source text, i.e., on reverse conversion, where the
+    // keys are the readings of the source text.
+    bool source_text;
+  };
+
+  // By default, Rewrite() is called for any key.
+  virtual void GetTrigger(Trigger *trigger) const {}
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const = 0;
 
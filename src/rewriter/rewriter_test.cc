@@ -78,7 +78,8 @@ class RewriterTest : public ::testing::Test {
     rewriter_.reset(new RewriterImpl(converter_mock_.get(),
                                      &data_manager,
                                      pos_group_.get(),
-                                     kNullDictionary));
+                                     kNullDictionary,
+                                     NULL));
   }
 
   virtual void TearDown() {
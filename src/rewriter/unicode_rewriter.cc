@@ -49,6 +49,13 @@ UnicodeRewriter::UnicodeRewriter(const ConverterInterface *parent_converter)
 
 UnicodeRewriter::~UnicodeRewriter() {}
 
+void UnicodeRewriter::GetTrigger(Trigger *trigger) const {
+  // "U+xxxx" keys are converted to the characters, and on reverse conversion
+  // the source text is converted to "U+xxxx" whatever its reading is.
+  trigger->script_types = Trigger::ScriptTypeBit(Util::ALPHABET);
+  trigger->source_text = true;
+}
+
 namespace {
 
 // Checks given string is ucs4 expression or not.
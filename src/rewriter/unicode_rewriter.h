@@ -43,6 +43,8 @@ class UnicodeRewriter : public RewriterInterface {
   explicit UnicodeRewriter(const ConverterInterface *parent_converter);
   virtual ~UnicodeRewriter();
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 
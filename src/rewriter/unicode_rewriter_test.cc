@@ -43,6 +43,7 @@
 #include "converter/segments.h"
 #include "engine/engine_interface.h"
 #include "engine/mock_data_engine_factory.h"
+#include "rewriter/merger_rewriter.h"
 #include "session/commands.pb.h"
 #include "testing/base/public/gunit.h"
 
@@ -274,4 +275,23 @@ TEST_F(UnicodeRewriterTest, RewriteToUnicodeCharFormat) {
     EXPECT_TRUE(ContainCandidate(segments, "U+611B"));
   }
 }
+
+// Reverse conversion is dispatched by MergerRewriter as a conversion of the
+// reading, which is not in the "U+xxxx" format.
+TEST_F(UnicodeRewriterTest, ReverseConversionViaMergerRewriter) {
+  MergerRewriter merger;
+  merger.AddRewriter(new UnicodeRewriter(engine_->GetConverter()), "Unicode");
+
+  composer::Composer composer(NULL, &default_request());
+  composer.set_source_text("æ");  // "愛"
+  ConversionRequest request(&composer, &default_request());
+
+  Segments segments;
+  segments.set_request_type(Segments::CONVERSION);
+  // "あい"
+  AddSegment("ãã", "æ", &segments);
+
+  EXPECT_TRUE(merger.Rewrite(request, &segments));
+  EXPECT_TRUE(ContainCandidate(segments, "U+611B"));
+}
 }  // namespace mozc
@@ -155,9 +155,13 @@ void UserBoundaryHistoryRewriter::Finish(const ConversionRequest &request,
     // for now.
 #else
     // update usage stats here
-    usage_stats::UsageStats::SetInteger(
-        "UserBoundaryHistoryEntrySize",
-        static_cast<int>(storage_->used_size()));
+    int used_size = 0;
+    {
+      scoped_lock lock(&storage_mutex_);
+      used_size = static_cast<int>(storage_->used_size());
+    }
+    usage_stats::UsageStats::SetInteger("UserBoundaryHistoryEntrySize",
+                                        used_size);
 #endif
   }
 }
@@ -196,6 +200,7 @@ bool UserBoundaryHistoryRewriter::Rewrite(
 }
 
 bool UserBoundaryHistoryRewriter::Reload() {
+  scoped_lock lock(&storage_mutex_);
   const string filename = ConfigFileStream::GetFileName(kFileName);
   if (!storage_->OpenOrCreate(filename.c_str(),
                               kValueSize, kLRUSize, kSeedValue)) {
@@ -268,35 +273,42 @@ bool UserBoundaryHistoryRewriter::ResizeOrInsert(
     }
     for (int j = static_cast<int>(keys_size) - 1; j >= 0; --j) {
       if (type == RESIZE) {
-        const LengthArray *value =
-            reinterpret_cast<const LengthArray *>(storage_->Lookup(key));
-        if (value != NULL) {
-          LengthArray orig_value;
-          orig_value.CopyFromUCharArray(length_array);
-          if (!value->Equal(orig_value)) {
-            value->ToUCharArray(length_array);
-            const int old_segments_size =
-                static_cast<int>(target_segments_size);
-            VLOG(2) << "ResizeSegment key: " << key << " "
-                    << i - history_segments_size << " " << j + 1
-                    << " " << static_cast<int>(length_array[0])
-                    << " " << static_cast<int>(length_array[1])
-                    << " " << static_cast<int>(length_array[2])
-                    << " " << static_cast<int>(length_array[3])
-                    << " " << static_cast<int>(length_array[4])
-                    << " " << static_cast<int>(length_array[5])
-                    << " " << static_cast<int>(length_array[6])
-                    << " " << static_cast<int>(length_array[7]);
-            parent_converter_->ResizeSegment(segments,
-                                             request,
-                                             i - history_segments_size,
-                                             j + 1,
-                                             length_array, 8);
-            i += (j + target_segments_size - old_segments_size);
-            result = true;
-            break;
+        bool should_resize = false;
+        {
+          scoped_lock lock(&storage_mutex_);
+          const LengthArray *value =
+              reinterpret_cast<const LengthArray *>(storage_->Lookup(key));
+          if (value != NULL) {
+            LengthArray orig_value;
+            orig_value.CopyFromUCharArray(length_array);
+            if (!value->Equal(orig_value)) {
+              value->ToUCharArray(length_array);
+              should_resize = true;
+            }
           }
         }
+        if (should_resize) {
+          const int old_segments_size =
+              static_cast<int>(target_segments_size);
+          VLOG(2) << "ResizeSegment key: " << key << " "
+                  << i - history_segments_size << " " << j + 1
+                  << " " << static_cast<int>(length_array[0])
+                  << " " << static_cast<int>(length_array[1])
+                  << " " << static_cast<int>(length_array[2])
+                  << " " << static_cast<int>(length_array[3])
+                  << " " << static_cast<int>(length_array[4])
+                  << " " << static_cast<int>(length_array[5])
+                  << " " << static_cast<int>(length_array[6])
+                  << " " << static_cast<int>(length_array[7]);
+          parent_converter_->ResizeSegment(segments,
+                                           request,
+                                           i - history_segments_size,
+                                           j + 1,
+                                           length_array, 8);
+          i += (j + target_segments_size - old_segments_size);
+          result = true;
+          break;
+        }
       } else if (type == INSERT) {
         VLOG(2) << "InserteSegment key: " << key << " "
                 << i - history_segments_size << " " << j + 1
@@ -310,6 +322,7 @@ bool UserBoundaryHistoryRewriter::ResizeOrInsert(
                 << " " << static_cast<int>(length_array[7]);
         LengthArray inserted_value;
         inserted_value.CopyFromUCharArray(length_array);
+        scoped_lock lock(&storage_mutex_);
         storage_->Insert(key, reinterpret_cast<const char *>(&inserted_value));
       }
 
@@ -324,6 +337,7 @@ bool UserBoundaryHistoryRewriter::ResizeOrInsert(
 }
 
 void UserBoundaryHistoryRewriter::Clear() {
+  scoped_lock lock(&storage_mutex_);
   if (storage_.get() != NULL) {
     VLOG(1) << "Clearing user segment data";
     storage_->Clear();
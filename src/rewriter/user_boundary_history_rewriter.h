@@ -33,6 +33,7 @@
 #include <vector>
 #include <string>
 
+#include "base/mutex.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
 #include "rewriter/rewriter_interface.h"
@@ -68,6 +69,10 @@ class UserBoundaryHistoryRewriter : public RewriterInterface {
                       int type) const;
 
   const ConverterInterface *parent_converter_;
+  // Guards the contents of |storage_| as sessions on different threads may
+  // rewrite and learn at the same time.  The lock is never held while calling
+  // back into |parent_converter_|.
+  mutable Mutex storage_mutex_;
   scoped_ptr<mozc::storage::LRUStorage> storage_;
 };
 
@@ -801,6 +801,7 @@ void UserSegmentHistoryRewriter::Finish(const ConversionRequest &request,
     return;
   }
 
+  scoped_lock lock(&storage_mutex_);
   for (size_t i = segments->history_segments_size();
        i < segments->segments_size(); ++i) {
     const Segment &segment = segments->segment(i);
@@ -823,6 +824,7 @@ void UserSegmentHistoryRewriter::Finish(const ConversionRequest &request,
 }
 
 bool UserSegmentHistoryRewriter::Reload() {
+  scoped_lock lock(&storage_mutex_);
   const string filename = ConfigFileStream::GetFileName(kFileName);
   if (!storage_->OpenOrCreate(filename.c_str(),
                               kValueSize, kLRUSize, kSeedValue)) {
@@ -956,6 +958,8 @@ bool UserSegmentHistoryRewriter::Rewrite(const ConversionRequest &request,
     return false;
   }
 
+  scoped_lock lock(&storage_mutex_);
+
   // set BEST_CANDIDATE marker in advance
   for (size_t i = 0; i < segments->segments_size(); ++i) {
     Segment *segment = segments->mutable_segment(i);
@@ -1025,6 +1029,7 @@ bool UserSegmentHistoryRewriter::Rewrite(const ConversionRequest &request,
 }
 
 void UserSegmentHistoryRewriter::Clear() {
+  scoped_lock lock(&storage_mutex_);
   if (storage_.get() != NULL) {
     VLOG(1) << "Clearing user segment data";
     storage_->Clear();
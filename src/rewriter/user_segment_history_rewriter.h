@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 
+#include "base/mutex.h"
 #include "converter/segments.h"
 #include "dictionary/pos_group.h"
 #include "dictionary/pos_matcher.h"
@@ -96,6 +97,9 @@ class UserSegmentHistoryRewriter : public RewriterInterface {
                       Segment *segment) const;
 
 
+  // Guards the contents of |storage_| as sessions on different threads may
+  // rewrite and learn at the same time.
+  mutable Mutex storage_mutex_;
   scoped_ptr<storage::LRUStorage> storage_;
   const dictionary::POSMatcher *pos_matcher_;
   const dictionary::PosGroup *pos_group_;
@@ -66,6 +66,13 @@ class VersionDataImpl {
     return it->second;
   }
 
+  void GetKeys(vector<string> *keys) const {
+    for (map<string, VersionEntry *>::const_iterator it = entries_.begin();
+         it != entries_.end(); ++it) {
+      keys->push_back(it->first);
+    }
+  }
+
   VersionDataImpl() {
     static const struct {
       const char *key;
@@ -129,6 +136,10 @@ int VersionRewriter::capability(const ConversionRequest &request) const {
   return RewriterInterface::CONVERSION;
 }
 
+void VersionRewriter::GetTrigger(Trigger *trigger) const {
+  Singleton<VersionDataImpl>::get()->GetKeys(&trigger->keys);
+}
+
 bool VersionRewriter::Rewrite(const ConversionRequest &request,
                               Segments *segments) const {
   bool result = false;
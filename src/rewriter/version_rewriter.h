@@ -45,6 +45,8 @@ class VersionRewriter : public RewriterInterface  {
 
   virtual int capability(const ConversionRequest &request) const;
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 };
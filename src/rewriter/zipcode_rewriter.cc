@@ -131,6 +131,11 @@ ZipcodeRewriter::ZipcodeRewriter(const POSMatcher *pos_matcher)
 
 ZipcodeRewriter::~ZipcodeRewriter() {}
 
+void ZipcodeRewriter::GetTrigger(Trigger *trigger) const {
+  // Keys of zipcode entries are like "100-0001".
+  trigger->script_types = Trigger::ScriptTypeBit(Util::NUMBER);
+}
+
 bool ZipcodeRewriter::Rewrite(const ConversionRequest &request,
                               Segments *segments) const {
   if (segments->conversion_segments_size() != 1) {
@@ -43,6 +43,8 @@ class ZipcodeRewriter : public RewriterInterface  {
   explicit ZipcodeRewriter(const dictionary::POSMatcher *pos_matcher);
   virtual ~ZipcodeRewriter();
 
+  virtual void GetTrigger(Trigger *trigger) const;
+
   virtual bool Rewrite(const ConversionRequest &request,
                        Segments *segments) const;
 
@@ -53,9 +53,7 @@ KeyEventTransformer::~KeyEventTransformer() {
 }
 
 void KeyEventTransformer::ReloadConfig(const config::Config &config) {
-  numpad_character_form_ = config.numpad_character_form();
-
-  table_.clear();
+  Table table;
   const config::Config::PunctuationMethod punctuation =
       config.punctuation_method();
   if (punctuation == config::Config::COMMA_PERIOD ||
@@ -65,7 +63,7 @@ void KeyEventTransformer::ReloadConfig(const config::Config &config) {
     // "，"
     key_event.set_key_string("\xef\xbc\x8c");
     // "、"
-    table_.insert(make_pair("\xe3\x80\x81", key_event));
+    table.insert(make_pair("\xe3\x80\x81", key_event));
   }
   if (punctuation == config::Config::COMMA_PERIOD ||
       punctuation == config::Config::KUTEN_PERIOD) {
@@ -74,7 +72,7 @@ void KeyEventTransformer::ReloadConfig(const config::Config &config) {
     // "．"
     key_event.set_key_string("\xef\xbc\x8e");
     // "。"
-    table_.insert(make_pair("\xe3\x80\x82", key_event));
+    table.insert(make_pair("\xe3\x80\x82", key_event));
   }
 
   const config::Config::SymbolMethod symbol = config.symbol_method();
@@ -86,7 +84,7 @@ void KeyEventTransformer::ReloadConfig(const config::Config &config) {
       // "［"
       key_event.set_key_string("\xef\xbc\xbb");
       // "「"
-      table_.insert(make_pair("\xe3\x80\x8c", key_event));
+      table.insert(make_pair("\xe3\x80\x8c", key_event));
     }
     {
       commands::KeyEvent key_event;
@@ -94,7 +92,7 @@ void KeyEventTransformer::ReloadConfig(const config::Config &config) {
       // "］"
       key_event.set_key_string("\xef\xbc\xbd");
       // "」"
-      table_.insert(make_pair("\xe3\x80\x8d", key_event));
+      table.insert(make_pair("\xe3\x80\x8d", key_event));
     }
   }
   if (symbol == config::Config::SQUARE_BRACKET_SLASH ||
@@ -104,8 +102,12 @@ void KeyEventTransformer::ReloadConfig(const config::Config &config) {
     // "／"
     key_event.set_key_string("\xef\xbc\x8f");
     // "・"
-    table_.insert(make_pair("\xE3\x83\xBB", key_event));
+    table.insert(make_pair("\xE3\x83\xBB", key_event));
   }
+
+  scoped_writer_lock l(&mutex_);
+  numpad_character_form_ = config.numpad_character_form();
+  table_.swap(table);
 }
 
 bool KeyEventTransformer::TransformKeyEvent(commands::KeyEvent *key_event) {
@@ -113,6 +115,7 @@ bool KeyEventTransformer::TransformKeyEvent(commands::KeyEvent *key_event) {
     LOG(ERROR) << "key_event is NULL";
     return false;
   }
+  scoped_reader_lock l(&mutex_);
   if (TransformKeyEventForNumpad(key_event)) {
     return true;
   }
@@ -36,6 +36,7 @@
 #include <map>
 #include <string>
 
+#include "base/mutex.h"
 #include "base/port.h"
 #include "base/singleton.h"
 #include "config/config.pb.h"
@@ -68,6 +69,10 @@ class KeyEventTransformer {
   bool TransformKeyEventForKana(commands::KeyEvent *key_event);
 
   typedef map<string, commands::KeyEvent> Table;
+
+  // The transformer is shared by all sessions, which may reload the config
+  // and transform key events on different threads.
+  ReaderWriterMutex mutex_;
   Table table_;
   config::Config::NumpadCharacterForm numpad_character_form_;
 
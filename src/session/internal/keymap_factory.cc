@@ -34,30 +34,51 @@
 #include "base/port.h"
 #include "base/freelist.h"
 #include "config/config.pb.h"
+#include "config/config_handler.h"
 #include "session/internal/keymap.h"
 
 namespace mozc {
 namespace keymap {
 
 // static member variable
+Mutex KeyMapFactory::mutex_;
 ObjectPool<KeyMapManager> KeyMapFactory::pool_(6);
 KeyMapFactory::KeyMapManagerMap KeyMapFactory::keymaps_;
+string KeyMapFactory::custom_keymap_table_;
 
 KeyMapManager *KeyMapFactory::GetKeyMapManager(
     config::Config::SessionKeymap keymap) {
+  scoped_lock l(&mutex_);
   map<config::Config::SessionKeymap, KeyMapManager *>::iterator iter =
       keymaps_.find(keymap);
 
   if (iter == keymaps_.end()) {
     // create new instance
     KeyMapManager *manager = pool_.Alloc();
+    manager->ReloadWithKeymap(keymap);
+    if (keymap == config::Config::CUSTOM) {
+      custom_keymap_table_ = GET_CONFIG(custom_keymap_table);
+    }
     iter = keymaps_.insert(make_pair(keymap, manager)).first;
   }
 
-  iter->second->ReloadWithKeymap(keymap);
-
   return iter->second;
 }
 
+void KeyMapFactory::ReloadConfig() {
+  scoped_lock l(&mutex_);
+  KeyMapManagerMap::iterator iter = keymaps_.find(config::Config::CUSTOM);
+  if (iter == keymaps_.end()) {
+    // Loaded with the current config on the first use.
+    return;
+  }
+  const string &custom_keymap_table = GET_CONFIG(custom_keymap_table);
+  if (custom_keymap_table == custom_keymap_table_) {
+    return;
+  }
+  iter->second->ReloadWithKeymap(config::Config::CUSTOM);
+  custom_keymap_table_ = custom_keymap_table;
+}
+
 }  // namespace keymap
 }  // namespace mozc
@@ -31,8 +31,10 @@
 #define MOZC_SESSION_INTERNAL_KEYMAP_FACTORY_H_
 
 #include <map>
+#include <string>
 
 #include "base/freelist.h"
+#include "base/mutex.h"
 #include "config/config.pb.h"
 
 namespace mozc {
@@ -44,16 +46,29 @@ class KeyMapFactory {
  public:
   typedef map<config::Config::SessionKeymap, KeyMapManager *> KeyMapManagerMap;
 
+  // Returns the manager of |keymap|, which is loaded on the first call.
+  // This method is thread-safe and never reloads a loaded manager, so it can
+  // be called on every key event by concurrent sessions.
   static KeyMapManager *GetKeyMapManager(config::Config::SessionKeymap keymap);
 
+  // Reloads the CUSTOM keymap if the custom keymap table of the current
+  // config differs from the loaded one.  The caller must guarantee that no
+  // other thread uses the managers, e.g., SessionHandler calls this under its
+  // writer lock when the config is reloaded.
+  static void ReloadConfig();
+
  private:
   friend class TestKeyMapFactoryProxy;
 
   KeyMapFactory() {}
   ~KeyMapFactory() {}
 
+  // Guards the static members below.
+  static Mutex mutex_;
   static ObjectPool<KeyMapManager> pool_;
   static KeyMapManagerMap keymaps_;
+  // The table loaded to the CUSTOM keymap.
+  static string custom_keymap_table_;
 };
 
 }  // namespace keymap
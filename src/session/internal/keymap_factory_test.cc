@@ -53,6 +53,7 @@ class TestKeyMapFactoryProxy {
     }
 
     keymaps.clear();
+    KeyMapFactory::custom_keymap_table_.clear();
   }
 };
 
@@ -121,7 +122,7 @@ TEST_F(KeyMapFactoryTest, KeyMapFactoryTest) {
   }
 }
 
-TEST_F(KeyMapFactoryTest, ReloadWhenGetInstance) {
+TEST_F(KeyMapFactoryTest, ReloadCustomKeymapOnConfigChange) {
   commands::KeyEvent key;
   key.set_special_key(commands::KeyEvent::SPACE);
 
@@ -152,6 +153,12 @@ TEST_F(KeyMapFactoryTest, ReloadWhenGetInstance) {
   KeyMapManager *keymap = KeyMapFactory::GetKeyMapManager(
       config::Config::CUSTOM);
   ConversionState::Commands key_command;
+  // Getting the instance doesn't reload the keymap.
+  keymap->GetCommandConversion(key, &key_command);
+  EXPECT_EQ(ConversionState::CONVERT_NEXT, key_command);
+
+  KeyMapFactory::ReloadConfig();
+  EXPECT_EQ(keymap, KeyMapFactory::GetKeyMapManager(config::Config::CUSTOM));
   keymap->GetCommandConversion(key, &key_command);
   EXPECT_EQ(ConversionState::CONVERT_PREV, key_command);
 }
@@ -213,6 +213,7 @@ ImeContext::State GetEffectiveStateForTestSendKey(
 // TODO(komatsu): Remove these argument by using/making singletons.
 Session::Session(EngineInterface *engine)
     : engine_(engine), context_(new ImeContext) {
+  keymap::KeyMapFactory::ReloadConfig();
   InitContext(context_.get());
 }
 
@@ -224,6 +225,7 @@ void Session::InitContext(ImeContext *context) const {
   context->set_composer(new composer::Composer(NULL, &context->GetRequest()));
   context->set_converter(
       new SessionConverter(engine_->GetConverter(), &context->GetRequest()));
+  context->mutable_converter()->SetCancellationFlag(&cancellation_flag_);
 #ifdef OS_WIN
   // On Windows session is started with direct mode.
   // FIXME(toshiyuki): Ditto for Mac after verifying on Mac.
@@ -478,6 +480,8 @@ bool Session::TestSendKey(commands::Command *command) {
 }
 
 bool Session::SendKey(commands::Command *command) {
+  // The key events before this one have been processed.
+  cancellation_flag_.Reset();
   UpdateTime();
   UpdatePreferences(command);
   TransformInput(command->mutable_input());
@@ -1117,9 +1121,21 @@ void Session::SetTable(const composer::Table *table) {
 }
 
 void Session::ReloadConfig() {
+  keymap::KeyMapFactory::ReloadConfig();
   UpdateConfig(config::ConfigHandler::GetConfig(), context_.get());
 }
 
+void Session::ReleaseUnusedMemory() {
+  context_->mutable_converter()->ReleaseUnusedMemory();
+  if (prev_context_.get() != NULL) {
+    prev_context_->mutable_converter()->ReleaseUnusedMemory();
+  }
+}
+
+void Session::CancelPendingRequest() {
+  cancellation_flag_.Cancel();
+}
+
 void Session::SetRequest(const commands::Request *request) {
   ClearUndoContext();
   context_->SetRequest(request);
@@ -91,6 +91,7 @@
         '../dictionary/dictionary_base.gyp:user_dictionary',
         '../usage_stats/usage_stats_base.gyp:usage_stats',
         'session_base.gyp:generic_storage_manager',
+        'session_base.gyp:keymap_factory',
         'session_base.gyp:session_protocol',
       ],
       'conditions': [
@@ -34,6 +34,7 @@
 
 #include <string>
 
+#include "base/cancellation_flag.h"
 #include "base/coordinates.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
@@ -245,6 +246,10 @@ class Session : public SessionInterface {
 
   virtual void SetTable(const mozc::composer::Table *table);
 
+  virtual void ReleaseUnusedMemory();
+
+  virtual void CancelPendingRequest();
+
   // Set client capability for this session.  Used by unittest.
   virtual void set_client_capability(
       const mozc::commands::Capability &capability);
@@ -290,6 +295,10 @@ class Session : public SessionInterface {
   scoped_ptr<ImeContext> context_;
   scoped_ptr<ImeContext> prev_context_;
 
+  // Raised by CancelPendingRequest() and cleared on each key event.  Shared
+  // with the converters of |context_| and |prev_context_|.
+  CancellationFlag cancellation_flag_;
+
   void InitContext(ImeContext *context) const;
 
   void PushUndoContext();
@@ -82,6 +82,7 @@
       ],
       'dependencies': [
         '../base/base.gyp:base',
+        '../config/config.gyp:config_handler',
         '../config/config.gyp:config_protocol',
         'keymap',
         'session_protocol',
@@ -65,6 +65,11 @@ DEFINE_bool(use_actual_converter_for_realtime_conversion,
             "If true, use the actual (non-immutable) converter for real "
             "time conversion.");
 
+DEFINE_int32(suggestion_time_budget_msec, 0,
+             "Time budget of a suggestion request in milliseconds.  When the "
+             "budget runs out, the converter returns a best-effort result "
+             "skipping the remaining stages.  0 means no limit.");
+
 namespace mozc {
 namespace session {
 
@@ -106,6 +111,7 @@ SessionConverter::SessionConverter(const ConverterInterface *converter,
       candidate_list_(new CandidateList(true)),
       candidate_list_visible_(false),
       request_(request),
+      cancellation_flag_(NULL),
       client_revision_(0) {
   conversion_preferences_.use_history = true;
   conversion_preferences_.max_history_size = kDefaultMaxHistorySize;
@@ -422,6 +428,10 @@ bool SessionConverter::SuggestWithPreferences(
   SetConversionPreferences(preferences, segments_.get());
 
   ConversionRequest conversion_request(&composer, request_);
+  if (FLAGS_suggestion_time_budget_msec > 0) {
+    conversion_request.SetTimeBudgetMsec(FLAGS_suggestion_time_budget_msec);
+  }
+  conversion_request.set_cancellation_flag(cancellation_flag_);
   const size_t cursor = composer.GetCursor();
   if (cursor == composer.GetLength() || cursor == 0 ||
       !request_->mixed_conversion()) {
@@ -1158,6 +1168,7 @@ SessionConverter* SessionConverter::Clone() const {
   }
 
   session_converter->request_ = request_;
+  session_converter->cancellation_flag_ = cancellation_flag_;
   session_converter->selected_candidate_indices_ = selected_candidate_indices_;
 
   return session_converter;
@@ -1556,6 +1567,14 @@ void SessionConverter::SetRequest(const commands::Request *request) {
   candidate_list_->set_page_size(request->candidate_page_size());
 }
 
+void SessionConverter::SetCancellationFlag(const CancellationFlag *flag) {
+  cancellation_flag_ = flag;
+}
+
+void SessionConverter::ReleaseUnusedMemory() {
+  segments_->Shrink();
+}
+
 void SessionConverter::OnStartComposition(const commands::Context &context) {
   bool revision_changed = false;
   if (context.has_revision()) {
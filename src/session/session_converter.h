@@ -247,6 +247,13 @@ class SessionConverter : public SessionConverterInterface {
   // Set setting by the context.
   virtual void OnStartComposition(const commands::Context &context);
 
+  // Sets the flag which cancels the suggestion being computed.
+  virtual void SetCancellationFlag(const CancellationFlag *flag);
+
+  // Shrinks the pools of |segments_| to their high-water mark since the
+  // last call.
+  virtual void ReleaseUnusedMemory();
+
   // Fills segments with the conversion preferences.
   static void SetConversionPreferences(
       const ConversionPreferences &preferences,
@@ -374,6 +381,9 @@ class SessionConverter : public SessionConverterInterface {
 
   const commands::Request *request_;
 
+  // Not owned.  Can be NULL.
+  const CancellationFlag *cancellation_flag_;
+
   // Selected index data of each segments for usage stats.
   vector<int> selected_candidate_indices_;
 
@@ -39,6 +39,7 @@
 #include "transliteration/transliteration.h"
 
 namespace mozc {
+class CancellationFlag;
 class ConverterInterface;
 
 namespace commands {
@@ -262,6 +263,14 @@ class SessionConverterInterface {
   // Update the internal state by the context.
   virtual void OnStartComposition(const commands::Context &context) = 0;
 
+  // Sets the flag which cancels the suggestion being computed.  The caller
+  // keeps the ownership of |flag|.  |flag| can be NULL.
+  virtual void SetCancellationFlag(const CancellationFlag *flag) = 0;
+
+  // Release the memory pooled for the conversion which has not been used
+  // recently.
+  virtual void ReleaseUnusedMemory() = 0;
+
   // Clone instance.
   // Callee object doesn't have the ownership of the cloned instance.
   virtual SessionConverterInterface *Clone() const = 0;
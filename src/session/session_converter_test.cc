@@ -39,6 +39,7 @@
 #include <string>
 #include <vector>
 
+#include "base/cancellation_flag.h"
 #include "base/logging.h"
 #include "base/number_util.h"
 #include "base/system_util.h"
@@ -47,6 +48,7 @@
 #include "composer/table.h"
 #include "config/config.pb.h"
 #include "config/config_handler.h"
+#include "converter/conversion_request.h"
 #include "converter/converter_mock.h"
 #include "converter/segments.h"
 #include "session/candidates.pb.h"
@@ -128,6 +130,10 @@ class SessionConverterTest : public ::testing::Test {
     converter->segments_->CopyFrom(src);
   }
 
+  static size_t GetPoolChunkCount(const SessionConverter &converter) {
+    return converter.segments_->pool_chunk_count();
+  }
+
   static const commands::Result &GetResult(const SessionConverter &converter) {
     return *converter.result_;
   }
@@ -475,6 +481,36 @@ TEST_F(SessionConverterTest, Convert) {
   EXPECT_COUNT_STATS("ConversionCandidates0", 1);
 }
 
+TEST_F(SessionConverterTest, ReuseSegmentsMemory) {
+  SessionConverter converter(convertermock_.get(), &default_request_);
+  Segments segments;
+  SetAiueo(&segments);
+  FillT13Ns(&segments, composer_.get());
+  convertermock_->SetStartConversionForRequest(&segments, true);
+  Segments empty_segments;
+  convertermock_->SetCancelConversion(&empty_segments, true);
+
+  // After the first conversion, the same operations don't allocate memory
+  // for the segments any more.
+  size_t chunk_count = 0;
+  for (int i = 0; i < 5; ++i) {
+    composer_->InsertCharacterPreedit(kChars_Aiueo);
+    EXPECT_TRUE(converter.Convert(*composer_));
+    if (i == 0) {
+      chunk_count = GetPoolChunkCount(converter);
+    }
+    EXPECT_EQ(chunk_count, GetPoolChunkCount(converter));
+    converter.Cancel();
+    composer_->Reset();
+  }
+  EXPECT_LT(0, chunk_count);
+
+  // The memory is released while the converter is idle.
+  converter.ReleaseUnusedMemory();
+  converter.ReleaseUnusedMemory();
+  EXPECT_GE(chunk_count, GetPoolChunkCount(converter));
+}
+
 TEST_F(SessionConverterTest, ConvertWithSpellingCorrection) {
   SessionConverter converter(convertermock_.get(), &default_request_);
   Segments segments;
@@ -1982,6 +2018,26 @@ TEST_F(SessionConverterTest, PartialSuggestion) {
   EXPECT_COUNT_STATS("PredictionCandidates0", 1);
 }
 
+TEST_F(SessionConverterTest, SuggestWithCancellationFlag) {
+  SessionConverter converter(convertermock_.get(), &default_request_);
+  Segments segments;
+  SetAiueo(&segments);
+  segments.set_request_type(Segments::SUGGESTION);
+  convertermock_->SetStartSuggestionForRequest(&segments, true);
+  composer_->InsertCharacterPreedit(kChars_Aiueo);
+
+  CancellationFlag flag;
+  converter.SetCancellationFlag(&flag);
+  EXPECT_TRUE(converter.Suggest(*composer_));
+  ConversionRequest request;
+  convertermock_->GetStartSuggestionForRequest(&segments, &request);
+  EXPECT_FALSE(request.IsExpired());
+
+  // The flag is shared with the request.
+  flag.Cancel();
+  EXPECT_TRUE(request.IsExpired());
+}
+
 TEST_F(SessionConverterTest, SuggestAndPredict) {
   SessionConverter converter(convertermock_.get(), &default_request_);
   Segments segments;
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "base/init.h"
+#include "base/latency_histogram.h"
 #include "base/logging.h"
 #include "base/port.h"
 #include "base/process.h"
@@ -52,6 +53,7 @@
 #include "engine/user_data_manager_interface.h"
 #include "session/commands.pb.h"
 #include "session/generic_storage_manager.h"
+#include "session/internal/keymap_factory.h"
 #include "session/session.h"
 #include "session/session_observer_handler.h"
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
@@ -136,6 +138,15 @@ bool IsCarrierEmoji(const string &utf8_str) {
   const uint32 kMaxEmojiPuaCodePoint = 0xFEEA0;
   return kMinEmojiPuaCodePoint <= ucs4_val && ucs4_val <= kMaxEmojiPuaCodePoint;
 }
+
+// Returns true if the output of an intermediate key event of SEND_KEYS
+// requires the client to do something other than updating the preedit and
+// committing the result.
+bool RequiresClientAction(const commands::Output &output) {
+  return !output.consumed() || output.has_callback() ||
+      output.has_launch_tool_mode() || output.has_deletion_range() ||
+      output.has_url();
+}
 }  // namespace
 
 SessionHandler::SessionHandler(EngineInterface *engine)
@@ -146,7 +157,8 @@ SessionHandler::SessionHandler(EngineInterface *engine)
       last_create_session_time_(0),
       engine_(engine),
       observer_handler_(new session::SessionObserverHandler()),
-      stopwatch_(new Stopwatch),
+      eval_command_histogram_(
+          LatencyHistogram::Get("SessionHandler::EvalCommand")),
       user_dictionary_session_handler_(
           new user_dictionary::UserDictionarySessionHandler),
       table_manager_(new composer::TableManager),
@@ -223,11 +235,15 @@ bool SessionHandler::StartWatchDog() {
 }
 
 void SessionHandler::ReloadSession() {
-  observer_handler_->Reload();
+  {
+    scoped_lock l(&observer_mutex_);
+    observer_handler_->Reload();
+  }
   ReloadConfig();
 }
 
 void SessionHandler::ReloadConfig() {
+  keymap::KeyMapFactory::ReloadConfig();
   const composer::Table *table = table_manager_->GetTable(
       *request_, config::ConfigHandler::GetConfig());
   for (SessionElement *element =
@@ -244,6 +260,26 @@ void SessionHandler::ReloadConfig() {
 bool SessionHandler::SyncData(commands::Command *command) {
   VLOG(1) << "Syncing user data";
   engine_->GetUserDataManager()->Sync();
+  VLOG(1) << "Latency histograms:\n" << LatencyHistogram::DumpAllAsText();
+  return true;
+}
+
+bool SessionHandler::GetLatencyHistograms(commands::Command *command) {
+  vector<LatencyHistogram::Snapshot> snapshots;
+  LatencyHistogram::GetAllSnapshots(&snapshots);
+  commands::Output *output = command->mutable_output();
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    const LatencyHistogram::Snapshot &snapshot = snapshots[i];
+    commands::LatencyHistogram *histogram = output->add_latency_histograms();
+    histogram->set_name(snapshot.name);
+    histogram->set_count(snapshot.count);
+    histogram->set_total_usec(snapshot.total_usec);
+    for (size_t j = 0; j < snapshot.buckets.size(); ++j) {
+      commands::LatencyHistogram::Bucket *bucket = histogram->add_buckets();
+      bucket->set_lower_bound_usec(snapshot.buckets[j].lower_bound_usec);
+      bucket->set_count(snapshot.buckets[j].count);
+    }
+  }
   return true;
 }
 
@@ -444,15 +480,41 @@ bool SessionHandler::ClearStorage(commands::Command *command) {
   return storage->Clear();
 }
 
+// static
+bool SessionHandler::IsSessionCommand(int type) {
+  switch (type) {
+    case commands::Input::SEND_KEY:
+    case commands::Input::SEND_KEYS:
+    case commands::Input::TEST_SEND_KEY:
+    case commands::Input::SEND_COMMAND:
+    case commands::Input::NO_OPERATION:
+    case commands::Input::GET_LATENCY_HISTOGRAMS:
+      return true;
+    default:
+      return false;
+  }
+}
+
 bool SessionHandler::EvalCommand(commands::Command *command) {
+  if (IsSessionCommand(command->input().type())) {
+    // The engine synchronizes its learning data by itself, so commands for
+    // different sessions only need to be protected from the handler-level
+    // commands.
+    scoped_reader_lock l(&handler_mutex_);
+    return EvalCommandInternal(command);
+  }
+  scoped_writer_lock l(&handler_mutex_);
+  return EvalCommandInternal(command);
+}
+
+bool SessionHandler::EvalCommandInternal(commands::Command *command) {
   if (!is_available_) {
     LOG(ERROR) << "SessionHandler is not available.";
     return false;
   }
 
   bool eval_succeeded = false;
-  stopwatch_->Reset();
-  stopwatch_->Start();
+  Stopwatch stopwatch = Stopwatch::StartNew();
 
   switch (command->input().type()) {
     case commands::Input::CREATE_SESSION:
@@ -464,6 +526,9 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
     case commands::Input::SEND_KEY:
       eval_succeeded = SendKey(command);
       break;
+    case commands::Input::SEND_KEYS:
+      eval_succeeded = SendKeys(command);
+      break;
     case commands::Input::TEST_SEND_KEY:
       eval_succeeded = TestSendKey(command);
       break;
@@ -518,6 +583,9 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
     case commands::Input::NO_OPERATION:
       eval_succeeded = NoOperation(command);
       break;
+    case commands::Input::GET_LATENCY_HISTOGRAMS:
+      eval_succeeded = GetLatencyHistograms(command);
+      break;
     default:
       eval_succeeded = false;
   }
@@ -537,12 +605,14 @@ bool SessionHandler::EvalCommand(commands::Command *command) {
 
   if (eval_succeeded) {
     // TODO(komatsu): Make sre if checking eval_succeeded is necessary or not.
+    scoped_lock l(&observer_mutex_);
     observer_handler_->EvalCommandHandler(*command);
   }
 
-  stopwatch_->Stop();
-  UsageStats::UpdateTiming("ElapsedTimeUSec",
-                           stopwatch_->GetElapsedMicroseconds());
+  stopwatch.Stop();
+  const double elapsed_usec = stopwatch.GetElapsedMicroseconds();
+  UsageStats::UpdateTiming("ElapsedTimeUSec", elapsed_usec);
+  eval_command_histogram_->Record(static_cast<uint64>(elapsed_usec));
 
   return is_available_;
 }
@@ -552,40 +622,119 @@ session::SessionInterface *SessionHandler::NewSession() {
 }
 
 void SessionHandler::AddObserver(session::SessionObserverInterface *observer) {
+  scoped_lock l(&observer_mutex_);
   observer_handler_->AddObserver(observer);
 }
 
+session::SessionInterface *SessionHandler::LookupSession(SessionID id) {
+  scoped_lock l(&session_map_mutex_);
+  session::SessionInterface **session = session_map_->MutableLookup(id);
+  return (session == NULL) ? NULL : *session;
+}
+
+Mutex *SessionHandler::GetSessionMutex(SessionID id) {
+  return &session_mutexes_[id % kNumSessionMutexes];
+}
+
 bool SessionHandler::SendKey(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session = session_map_->MutableLookup(id);
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = LookupSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->SendKey(command);
+  // The suggestion for the previous key event is obsolete.
+  session->CancelPendingRequest();
+  scoped_lock l(GetSessionMutex(id));
+  session->SendKey(command);
+  return true;
+}
+
+bool SessionHandler::SendKeys(commands::Command *command) {
+  const SessionID id = command->input().id();
+  session::SessionInterface *session = LookupSession(id);
+  if (session == NULL) {
+    LOG(WARNING) << "SessionID " << id << " is not available";
+    return false;
+  }
+  const commands::Input &input = command->input();
+  if (input.keys_size() == 0) {
+    LOG(WARNING) << "SEND_KEYS has no key events";
+    return false;
+  }
+
+  // Each key event is evaluated as a SEND_KEY command sharing the other
+  // fields of the input.  Suggestion (including realtime conversion) is
+  // requested only for the last key event because the outputs of the others
+  // are never shown.
+  commands::Command key_command;
+  key_command.mutable_input()->CopyFrom(input);
+  key_command.mutable_input()->clear_keys();
+  key_command.mutable_input()->set_type(commands::Input::SEND_KEY);
+
+  session->CancelPendingRequest();
+  scoped_lock l(GetSessionMutex(id));
+  commands::Result result;
+  int num_processed_keys = 0;
+  while (num_processed_keys < input.keys_size()) {
+    const bool is_last = (num_processed_keys + 1 == input.keys_size());
+    key_command.clear_output();
+    key_command.mutable_input()->mutable_key()->CopyFrom(
+        input.keys(num_processed_keys));
+    if (!is_last) {
+      key_command.mutable_input()->set_request_suggestion(false);
+    } else if (input.has_request_suggestion()) {
+      key_command.mutable_input()->set_request_suggestion(
+          input.request_suggestion());
+    } else {
+      key_command.mutable_input()->clear_request_suggestion();
+    }
+    session->SendKey(&key_command);
+    ++num_processed_keys;
+
+    const commands::Output &key_output = key_command.output();
+    if (key_output.has_result()) {
+      if (!result.has_type()) {
+        result.CopyFrom(key_output.result());
+      } else {
+        result.set_value(result.value() + key_output.result().value());
+        result.set_key(result.key() + key_output.result().key());
+      }
+    }
+    if (!is_last && RequiresClientAction(key_output)) {
+      break;
+    }
+  }
+
+  command->mutable_output()->CopyFrom(key_command.output());
+  if (result.has_type()) {
+    command->mutable_output()->mutable_result()->CopyFrom(result);
+  }
+  command->mutable_output()->set_num_processed_keys(num_processed_keys);
   return true;
 }
 
 bool SessionHandler::TestSendKey(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session = session_map_->MutableLookup(id);
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = LookupSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->TestSendKey(command);
+  scoped_lock l(GetSessionMutex(id));
+  session->TestSendKey(command);
   return true;
 }
 
 bool SessionHandler::SendCommand(commands::Command *command) {
   const SessionID id = command->input().id();
-  session::SessionInterface **session =
-    const_cast<session::SessionInterface **>(session_map_->Lookup(id));
-  if (session == NULL || *session == NULL) {
+  session::SessionInterface *session = LookupSession(id);
+  if (session == NULL) {
     LOG(WARNING) << "SessionID " << id << " is not available";
     return false;
   }
-  (*session)->SendCommand(command);
+  scoped_lock l(GetSessionMutex(id));
+  session->SendCommand(command);
   return true;
 }
 
@@ -672,6 +821,7 @@ bool SessionHandler::DeleteSession(commands::Command *command) {
 // Also, if timeout is enabled, shutdown server if there is
 // no active session and client doesn't send any conversion
 // request to the server for FLAGS_timeout sec.
+// The memory pooled by the remaining sessions is trimmed as well.
 bool SessionHandler::Cleanup(commands::Command *command) {
   const uint64 current_time = Util::GetTime();
 
@@ -730,6 +880,15 @@ bool SessionHandler::Cleanup(commands::Command *command) {
     VLOG(1) << "Session ID " << remove_ids[i] << " is removed by server";
   }
 
+  // Cleanup runs periodically, so each session keeps the conversion memory
+  // it needed since the previous cleanup and an idle session shrinks to
+  // what it currently holds.
+  for (SessionElement *element =
+           const_cast<SessionElement *>(session_map_->Head());
+       element != NULL; element = element->next) {
+    element->value->ReleaseUnusedMemory();
+  }
+
   // Sync all data. This is a regression bug fix http://b/3033708
   engine_->GetUserDataManager()->Sync();
 
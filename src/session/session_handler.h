@@ -35,6 +35,7 @@
 #include <map>
 #include <string>
 
+#include "base/mutex.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
 #include "composer/table.h"
@@ -59,7 +60,7 @@ class SessionWatchDog;
 // TODO(kkojima): Remove this guard after
 // enabling session watch dog for android.
 #endif  // MOZC_DISABLE_SESSION_WATCHDOG
-class Stopwatch;
+class LatencyHistogram;
 
 namespace commands {
 class Command;
@@ -76,6 +77,11 @@ namespace user_dictionary {
 class UserDictionarySessionHandler;
 }  // namespace user_dictionary
 
+// EvalCommand() can be called from multiple threads.  Commands addressed to a
+// session (SEND_KEY, SEND_COMMAND, etc.) for different sessions run in
+// parallel; commands for the same session are serialized.  The other commands
+// change the set of sessions, the configuration or the learning data and run
+// exclusively.
 class SessionHandler : public SessionHandlerInterface {
  public:
   // This class doesn't take an ownership of |engine|.
@@ -103,6 +109,18 @@ class SessionHandler : public SessionHandlerInterface {
       SessionMap;
   typedef SessionMap::Element SessionElement;
 
+  // Number of mutexes serializing the commands for the same session.
+  static const size_t kNumSessionMutexes = 16;
+
+  // Returns true if |type| is a command evaluated by a single session.
+  static bool IsSessionCommand(int type);
+
+  bool EvalCommandInternal(commands::Command *command);
+
+  // Returns the session for |id| or NULL and moves it to the head of the LRU.
+  session::SessionInterface *LookupSession(SessionID id);
+  Mutex *GetSessionMutex(SessionID id);
+
   // Reload settings which are managed by SessionHandler
   void ReloadSession();
   // Reload the configurations on the current sessions.
@@ -112,6 +130,7 @@ class SessionHandler : public SessionHandlerInterface {
   bool DeleteSession(commands::Command *command);
   bool TestSendKey(commands::Command *command);
   bool SendKey(commands::Command *command);
+  bool SendKeys(commands::Command *command);
   bool SendCommand(commands::Command *command);
   bool SyncData(commands::Command *command);
   bool ClearUserHistory(commands::Command *command);
@@ -130,10 +149,19 @@ class SessionHandler : public SessionHandlerInterface {
   bool Cleanup(commands::Command *command);
   bool SendUserDictionaryCommand(commands::Command *command);
   bool NoOperation(commands::Command *command);
+  bool GetLatencyHistograms(commands::Command *command);
 
   SessionID CreateNewSessionID();
   bool DeleteSessionID(SessionID id);
 
+  // Session commands hold the reader lock and the other commands hold the
+  // writer lock.  Sessions are deleted only under the writer lock.
+  ReaderWriterMutex handler_mutex_;
+  // Guards the LRU order of |session_map_| under the reader lock.
+  Mutex session_map_mutex_;
+  Mutex session_mutexes_[kNumSessionMutexes];
+  Mutex observer_mutex_;
+
   scoped_ptr<SessionMap> session_map_;
 #ifndef MOZC_DISABLE_SESSION_WATCHDOG
   scoped_ptr<SessionWatchDog> session_watch_dog_;
@@ -150,7 +178,7 @@ class SessionHandler : public SessionHandlerInterface {
 
   EngineInterface *engine_;
   scoped_ptr<session::SessionObserverHandler> observer_handler_;
-  scoped_ptr<Stopwatch> stopwatch_;
+  LatencyHistogram *eval_command_histogram_;
   scoped_ptr<user_dictionary::UserDictionarySessionHandler>
       user_dictionary_session_handler_;
   scoped_ptr<composer::TableManager> table_manager_;
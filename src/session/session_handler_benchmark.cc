@@ -0,0 +1,214 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark of SessionHandler replaying reproducible corpora as key events,
+// which measures the latency the client observes for each keystroke.
+// Each input is typed in Romaji, converted with SPACE and committed with
+// ENTER.  The corpora are the test sentences of RandomKeyEventsGenerator, the
+// long inputs made by concatenating them, and optionally --corpus_file,
+// which can be a file of the quality regression test.
+//
+// The results are printed as TSV lines, see BenchmarkRecorder.
+//
+// Usage:
+//   session_handler_benchmark --iterations=3 --user_profile_dir=/tmp/mozc
+
+#include <algorithm>
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/system_util.h"
+#include "base/util.h"
+#include "config/config.pb.h"
+#include "config/config_handler.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "session/commands.pb.h"
+#include "session/random_keyevents_generator.h"
+#include "session/session_handler.h"
+
+DEFINE_int32(iterations, 3, "The number of iterations over each corpus.");
+DEFINE_int32(max_sentences, 200,
+             "The number of test sentences used as a corpus.");
+DEFINE_int32(long_input_chars, 60,
+             "The minimum number of characters of the long inputs.");
+DEFINE_string(corpus_file, "",
+              "A file of the keys or a TSV file of the quality regression "
+              "test used as an additional corpus.");
+DEFINE_string(user_profile_dir, "",
+              "The user profile directory used instead of the default one "
+              "so that the benchmark does not touch the user's data.");
+
+namespace mozc {
+namespace {
+
+struct Corpus {
+  string name;
+  vector<string> keys;
+};
+
+void MakeCorpora(vector<Corpus> *corpora) {
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  size = min(static_cast<size_t>(FLAGS_max_sentences), size);
+  CHECK_GT(size, 0);
+
+  corpora->resize(2);
+  (*corpora)[0].name = "sentences";
+  (*corpora)[0].keys.assign(sentences, sentences + size);
+  (*corpora)[1].name = "long_inputs";
+  BenchmarkCorpus::MakeLongInputs((*corpora)[0].keys, FLAGS_long_input_chars,
+                                  &(*corpora)[1].keys);
+
+  if (!FLAGS_corpus_file.empty()) {
+    corpora->resize(3);
+    (*corpora)[2].name = "corpus_file";
+    CHECK(BenchmarkCorpus::LoadKeys(FLAGS_corpus_file, &(*corpora)[2].keys));
+  }
+}
+
+// Converts |hiragana| to the key events typing it in Romaji.
+void TypeHiragana(const string &hiragana, vector<commands::KeyEvent> *keys) {
+  string romaji, tmp;
+  Util::HiraganaToRomanji(hiragana, &tmp);
+  Util::FullWidthToHalfWidth(tmp, &romaji);
+  keys->clear();
+  for (size_t i = 0; i < romaji.size(); ++i) {
+    const uint32 key_code = static_cast<uint8>(romaji[i]);
+    if (key_code < 0x20 || key_code > 0x7E) {
+      continue;
+    }
+    commands::KeyEvent key;
+    key.set_key_code(key_code);
+    keys->push_back(key);
+  }
+}
+
+bool SendKey(SessionHandler *handler, uint64 id,
+             const commands::KeyEvent &key) {
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::SEND_KEY);
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->mutable_key()->CopyFrom(key);
+  return handler->EvalCommand(&command) &&
+      command.output().error_code() == commands::Output::SESSION_SUCCESS;
+}
+
+bool SendSpecialKey(SessionHandler *handler, uint64 id,
+                    commands::KeyEvent::SpecialKey special_key) {
+  commands::KeyEvent key;
+  key.set_special_key(special_key);
+  return SendKey(handler, id, key);
+}
+
+void RunCorpus(SessionHandler *handler, const Corpus &corpus) {
+  BenchmarkRecorder typing("SendKey/" + corpus.name);
+  BenchmarkRecorder conversion("SendKey(SPACE)/" + corpus.name);
+  BenchmarkRecorder commit("SendKey(ENTER)/" + corpus.name);
+
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::CREATE_SESSION);
+  CHECK(handler->EvalCommand(&command));
+  const uint64 id = command.output().id();
+  CHECK(SendSpecialKey(handler, id, commands::KeyEvent::ON));
+
+  size_t num_failures = 0;
+  vector<commands::KeyEvent> keys;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    for (size_t i = 0; i < corpus.keys.size(); ++i) {
+      TypeHiragana(corpus.keys[i], &keys);
+      if (keys.empty()) {
+        continue;
+      }
+      for (size_t j = 0; j < keys.size(); ++j) {
+        typing.Start();
+        num_failures += !SendKey(handler, id, keys[j]);
+        typing.Stop();
+      }
+
+      conversion.Start();
+      num_failures += !SendSpecialKey(handler, id, commands::KeyEvent::SPACE);
+      conversion.Stop();
+
+      commit.Start();
+      num_failures += !SendSpecialKey(handler, id, commands::KeyEvent::ENTER);
+      commit.Stop();
+    }
+  }
+
+  command.Clear();
+  command.mutable_input()->set_type(commands::Input::DELETE_SESSION);
+  command.mutable_input()->set_id(id);
+  CHECK(handler->EvalCommand(&command));
+  LOG_IF(ERROR, num_failures > 0)
+      << corpus.name << ": " << num_failures << " key events failed";
+
+  typing.Print(&cout);
+  conversion.Print(&cout);
+  commit.Print(&cout);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  if (!FLAGS_user_profile_dir.empty()) {
+    mozc::SystemUtil::SetUserProfileDirectory(FLAGS_user_profile_dir);
+  }
+  // Uses the default config so that the results do not depend on the
+  // settings of the user.
+  mozc::config::Config config;
+  mozc::config::ConfigHandler::GetDefaultConfig(&config);
+  mozc::config::ConfigHandler::SetConfig(config);
+
+  vector<mozc::Corpus> corpora;
+  mozc::MakeCorpora(&corpora);
+
+  scoped_ptr<mozc::EngineInterface> engine(
+      mozc::MockDataEngineFactory::Create());
+  mozc::SessionHandler handler(engine.get());
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  for (size_t i = 0; i < corpora.size(); ++i) {
+    mozc::RunCorpus(&handler, corpora[i]);
+  }
+  return 0;
+}
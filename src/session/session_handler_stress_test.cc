@@ -36,6 +36,11 @@
 #include "base/file_util.h"
 #include "base/port.h"
 #include "base/scoped_ptr.h"
+#include "base/stl_util.h"
+#include "base/thread.h"
+#include "base/util.h"
+#include "config/config.pb.h"
+#include "config/config_handler.h"
 #include "engine/engine_factory.h"
 #include "session/commands.pb.h"
 #include "session/random_keyevents_generator.h"
@@ -104,6 +109,139 @@ class AndroidInitializer {
   DISALLOW_COPY_AND_ASSIGN(AndroidInitializer);
 };
 #endif  // OS_ANDROID
+
+// Serves one session on a SessionHandler shared with other threads.
+class SessionThread : public Thread {
+ public:
+  SessionThread(SessionHandler *handler,
+                const vector<commands::KeyEvent> &keys)
+      : handler_(handler), keys_(keys), num_failures_(0) {}
+
+  virtual void Run() {
+    commands::Command command;
+    command.mutable_input()->set_type(commands::Input::CREATE_SESSION);
+    if (!handler_->EvalCommand(&command)) {
+      ++num_failures_;
+      return;
+    }
+    const uint64 id = command.output().id();
+
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      if (!SendKey(commands::Input::TEST_SEND_KEY, id, keys_[i]) ||
+          !SendKey(commands::Input::SEND_KEY, id, keys_[i])) {
+        ++num_failures_;
+      }
+    }
+
+    command.Clear();
+    command.mutable_input()->set_type(commands::Input::DELETE_SESSION);
+    command.mutable_input()->set_id(id);
+    if (!handler_->EvalCommand(&command)) {
+      ++num_failures_;
+    }
+  }
+
+  int num_failures() const { return num_failures_; }
+
+ private:
+  bool SendKey(commands::Input::CommandType type, uint64 id,
+               const commands::KeyEvent &key) {
+    commands::Command command;
+    command.mutable_input()->set_type(type);
+    command.mutable_input()->set_id(id);
+    command.mutable_input()->mutable_key()->CopyFrom(key);
+    return handler_->EvalCommand(&command) &&
+        command.output().error_code() == commands::Output::SESSION_SUCCESS;
+  }
+
+  SessionHandler *handler_;
+  const vector<commands::KeyEvent> keys_;
+  int num_failures_;
+
+  DISALLOW_COPY_AND_ASSIGN(SessionThread);
+};
+
+// Periodically issues handler-level commands which reload the config of all
+// sessions and sync the learning data while the sessions are busy.  If
+// |configs| is not empty, they are also set in turn.
+class MaintenanceThread : public Thread {
+ public:
+  MaintenanceThread(SessionHandler *handler, int num_iterations,
+                    const vector<config::Config> &configs)
+      : handler_(handler), num_iterations_(num_iterations), configs_(configs),
+        num_failures_(0) {}
+
+  virtual void Run() {
+    const commands::Input::CommandType kTypes[] = {
+      commands::Input::GET_CONFIG,
+      commands::Input::SYNC_DATA,
+      commands::Input::GET_LATENCY_HISTOGRAMS,
+    };
+    for (int i = 0; i < num_iterations_; ++i) {
+      commands::Command command;
+      command.mutable_input()->set_type(kTypes[i % arraysize(kTypes)]);
+      if (!handler_->EvalCommand(&command)) {
+        ++num_failures_;
+      }
+      if (!configs_.empty()) {
+        command.Clear();
+        command.mutable_input()->set_type(commands::Input::SET_CONFIG);
+        command.mutable_input()->mutable_config()->CopyFrom(
+            configs_[i % configs_.size()]);
+        if (!handler_->EvalCommand(&command)) {
+          ++num_failures_;
+        }
+      }
+      Util::Sleep(10);
+    }
+  }
+
+  int num_failures() const { return num_failures_; }
+
+ private:
+  SessionHandler *handler_;
+  const int num_iterations_;
+  const vector<config::Config> configs_;
+  int num_failures_;
+
+  DISALLOW_COPY_AND_ASSIGN(MaintenanceThread);
+};
+
+// Runs 8 sessions on |handler| while a MaintenanceThread sets |configs|.
+void RunMultiThreadStressTest(SessionHandler *handler,
+                              const vector<config::Config> &configs) {
+  const size_t kNumSessionThreads = 8;
+  const size_t kMaxEventSizePerThread = 1000;
+
+  // The generator is not thread-safe, so the key events are prepared here.
+  const uint32 random_seed = static_cast<uint32>(FLAGS_random_seed);
+  LOG(INFO) << "Random seed: " << random_seed;
+  session::RandomKeyEventsGenerator::InitSeed(random_seed);
+  vector<SessionThread *> threads;
+  for (size_t i = 0; i < kNumSessionThreads; ++i) {
+    vector<commands::KeyEvent> keys;
+    while (keys.size() < kMaxEventSizePerThread) {
+      vector<commands::KeyEvent> sequence;
+      session::RandomKeyEventsGenerator::GenerateSequence(&sequence);
+      keys.insert(keys.end(), sequence.begin(), sequence.end());
+    }
+    threads.push_back(new SessionThread(handler, keys));
+  }
+
+  MaintenanceThread maintenance(handler, 30, configs);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Start();
+  }
+  maintenance.Start();
+
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->Join();
+    EXPECT_EQ(0, threads[i]->num_failures()) << "thread " << i;
+  }
+  maintenance.Join();
+  EXPECT_EQ(0, maintenance.num_failures());
+  STLDeleteElements(&threads);
+}
 }  // namespace
 
 class SessionHandlerStressTest : public SessionHandlerTestBase {
@@ -140,4 +278,46 @@ TEST_F(SessionHandlerStressTest, BasicStressTest) {
   EXPECT_TRUE(client.DeleteSession());
 }
 
+TEST_F(SessionHandlerStressTest, MultiThreadStressTest) {
+  scoped_ptr<EngineInterface> engine(EngineFactory::Create());
+  SessionHandler handler(engine.get());
+  RunMultiThreadStressTest(&handler, vector<config::Config>());
+}
+
+// The sessions look up the CUSTOM keymap on every key event while the
+// custom keymap table is replaced.
+TEST_F(SessionHandlerStressTest, MultiThreadStressTestWithCustomKeymap) {
+  const char *kCustomKeymapTables[] = {
+    "status\tkey\tcommand\n"
+    "DirectInput\tHenkan\tIMEOn\n"
+    "Precomposition\tSpace\tInsertSpace\n"
+    "Composition\tSpace\tConvert\n"
+    "Composition\tEnter\tCommit\n"
+    "Conversion\tSpace\tConvertNext\n"
+    "Conversion\tEnter\tCommit\n",
+    "status\tkey\tcommand\n"
+    "DirectInput\tHenkan\tIMEOn\n"
+    "Precomposition\tShift Space\tInsertFullSpace\n"
+    "Composition\tSpace\tConvert\n"
+    "Composition\tCtrl m\tCommit\n"
+    "Conversion\tSpace\tConvertPrev\n"
+    "Conversion\tCtrl m\tCommit\n",
+  };
+  vector<config::Config> configs(arraysize(kCustomKeymapTables));
+  for (size_t i = 0; i < configs.size(); ++i) {
+    config::ConfigHandler::GetDefaultConfig(&configs[i]);
+    configs[i].set_session_keymap(config::Config::CUSTOM);
+    configs[i].set_custom_keymap_table(kCustomKeymapTables[i]);
+  }
+
+  scoped_ptr<EngineInterface> engine(EngineFactory::Create());
+  SessionHandler handler(engine.get());
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::SET_CONFIG);
+  command.mutable_input()->mutable_config()->CopyFrom(configs[0]);
+  ASSERT_TRUE(handler.EvalCommand(&command));
+
+  RunMultiThreadStressTest(&handler, configs);
+}
+
 }  // namespace mozc
@@ -461,6 +461,104 @@ TEST_F(SessionHandlerTest, StorageTest) {
   }
 }
 
+TEST_F(SessionHandlerTest, SendKeysTest) {
+  scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
+  SessionHandler handler(engine.get());
+
+  vector<commands::KeyEvent> keys;
+  keys.push_back(commands::KeyEvent());
+  keys.back().set_special_key(commands::KeyEvent::ON);
+  const char kKeyCodes[] = "kyouha";
+  for (size_t i = 0; i < arraysize(kKeyCodes) - 1; ++i) {
+    keys.push_back(commands::KeyEvent());
+    keys.back().set_key_code(kKeyCodes[i]);
+  }
+
+  // Sends the keys one by one.
+  uint64 sequential_id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &sequential_id));
+  commands::Command sequential_command;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    sequential_command.Clear();
+    sequential_command.mutable_input()->set_id(sequential_id);
+    sequential_command.mutable_input()->set_type(commands::Input::SEND_KEY);
+    sequential_command.mutable_input()->mutable_key()->CopyFrom(keys[i]);
+    EXPECT_TRUE(handler.EvalCommand(&sequential_command));
+  }
+
+  // Sends the keys at once.
+  uint64 batch_id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &batch_id));
+  commands::Command batch_command;
+  batch_command.mutable_input()->set_id(batch_id);
+  batch_command.mutable_input()->set_type(commands::Input::SEND_KEYS);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    batch_command.mutable_input()->add_keys()->CopyFrom(keys[i]);
+  }
+  EXPECT_TRUE(handler.EvalCommand(&batch_command));
+  EXPECT_EQ(commands::Output::SESSION_SUCCESS,
+            batch_command.output().error_code());
+  EXPECT_EQ(keys.size(), batch_command.output().num_processed_keys());
+  EXPECT_TRUE(batch_command.output().consumed());
+  EXPECT_EQ(sequential_command.output().preedit().DebugString(),
+            batch_command.output().preedit().DebugString());
+
+  // SEND_KEYS without keys fails.
+  batch_command.Clear();
+  batch_command.mutable_input()->set_id(batch_id);
+  batch_command.mutable_input()->set_type(commands::Input::SEND_KEYS);
+  EXPECT_TRUE(handler.EvalCommand(&batch_command));
+  EXPECT_EQ(commands::Output::SESSION_FAILURE,
+            batch_command.output().error_code());
+}
+
+TEST_F(SessionHandlerTest, GetLatencyHistogramsTest) {
+  scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
+  SessionHandler handler(engine.get());
+
+  // The conversion pipeline records its stages while evaluating SEND_KEY.
+  uint64 id = 0;
+  EXPECT_TRUE(CreateSession(&handler, &id));
+  const char kKeyCodes[] = "kyouha";
+  for (size_t i = 0; i < arraysize(kKeyCodes) - 1; ++i) {
+    commands::Command command;
+    command.mutable_input()->set_id(id);
+    command.mutable_input()->set_type(commands::Input::SEND_KEY);
+    command.mutable_input()->mutable_key()->set_key_code(kKeyCodes[i]);
+    EXPECT_TRUE(handler.EvalCommand(&command));
+  }
+
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::GET_LATENCY_HISTOGRAMS);
+  EXPECT_TRUE(handler.EvalCommand(&command));
+  EXPECT_EQ(commands::Output::SESSION_SUCCESS, command.output().error_code());
+
+  bool found_eval_command = false;
+  bool found_make_lattice = false;
+  for (size_t i = 0; i < command.output().latency_histograms_size(); ++i) {
+    const commands::LatencyHistogram &histogram =
+        command.output().latency_histograms(i);
+    uint64 bucket_count = 0;
+    for (size_t j = 0; j < histogram.buckets_size(); ++j) {
+      if (j > 0) {
+        EXPECT_LT(histogram.buckets(j - 1).lower_bound_usec(),
+                  histogram.buckets(j).lower_bound_usec());
+      }
+      bucket_count += histogram.buckets(j).count();
+    }
+    EXPECT_EQ(histogram.count(), bucket_count);
+    if (histogram.name() == "SessionHandler::EvalCommand") {
+      found_eval_command = true;
+      EXPECT_LE(arraysize(kKeyCodes) - 1, histogram.count());
+    } else if (histogram.name() == "ImmutableConverter::MakeLattice") {
+      found_make_lattice = true;
+      EXPECT_LT(0, histogram.count());
+    }
+  }
+  EXPECT_TRUE(found_eval_command);
+  EXPECT_TRUE(found_make_lattice);
+}
+
 TEST_F(SessionHandlerTest, EmojiUsageStatsTest) {
   scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
   SessionHandler handler(engine.get());
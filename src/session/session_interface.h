@@ -68,6 +68,16 @@ class SessionInterface {
   // Set composition Table. Currently, this is especial for session::Session.
   virtual void SetTable(const composer::Table *table) {}
 
+  // Release the memory kept for reuse which has not been used since the
+  // last call.  Called periodically by the session handler.
+  virtual void ReleaseUnusedMemory() {}
+
+  // Cancels the suggestion being computed for the previous key event so
+  // that the next key event is processed earlier.  Unlike the other methods,
+  // this is called by the session handler without serializing the commands
+  // of this session.
+  virtual void CancelPendingRequest() {}
+
   // Set client capability for this session.  Used by unittest.
   virtual void set_client_capability(
       const commands::Capability &capability) = 0;
@@ -0,0 +1,214 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Benchmark of the startup of the conversion engine, which the user observes
+// as the latency of the first keystrokes because the server is launched on
+// demand.  Each iteration builds a new engine and SessionHandler, types a
+// test sentence in Romaji and converts it with SPACE.  The following
+// operations are reported as TSV lines, see BenchmarkRecorder:
+//  - EngineInit: the construction of the engine.
+//  - FirstConversion: from the creation of the session to the result of the
+//    first conversion, which includes the modules built in the background.
+//  - TimeToFirstConversion: the sum of the above.
+// The iterations are repeated with --parallel_engine_init disabled and
+// enabled.  The mean latency of each initialization step, i.e., the
+// histograms "EngineInit::*" and "RewriterInit::*", follows as comment lines.
+//
+// Note that process-wide singletons, e.g., the data manager, are built only
+// by the first iteration, and the data stay in the page cache afterwards.
+// Use --iterations=1 in a new process for a cold start.
+//
+// Usage:
+//   session_startup_benchmark --iterations=10 --user_profile_dir=/tmp/mozc
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/benchmark_util.h"
+#include "base/flags.h"
+#include "base/latency_histogram.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/scoped_ptr.h"
+#include "base/system_util.h"
+#include "base/util.h"
+#include "config/config.pb.h"
+#include "config/config_handler.h"
+#include "engine/engine_interface.h"
+#include "engine/mock_data_engine_factory.h"
+#include "session/commands.pb.h"
+#include "session/random_keyevents_generator.h"
+#include "session/session_handler.h"
+
+DEFINE_int32(iterations, 10, "The number of engines built for each mode.");
+DEFINE_string(user_profile_dir, "",
+              "The user profile directory used instead of the default one "
+              "so that the benchmark does not touch the user's data.");
+
+DECLARE_bool(parallel_engine_init);
+
+namespace mozc {
+namespace {
+
+// Converts |hiragana| to the key events typing it in Romaji.
+void TypeHiragana(const string &hiragana, vector<commands::KeyEvent> *keys) {
+  string romaji, tmp;
+  Util::HiraganaToRomanji(hiragana, &tmp);
+  Util::FullWidthToHalfWidth(tmp, &romaji);
+  keys->clear();
+  for (size_t i = 0; i < romaji.size(); ++i) {
+    const uint32 key_code = static_cast<uint8>(romaji[i]);
+    if (key_code < 0x20 || key_code > 0x7E) {
+      continue;
+    }
+    commands::KeyEvent key;
+    key.set_key_code(key_code);
+    keys->push_back(key);
+  }
+}
+
+bool SendKey(SessionHandler *handler, uint64 id,
+             const commands::KeyEvent &key) {
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::SEND_KEY);
+  command.mutable_input()->set_id(id);
+  command.mutable_input()->mutable_key()->CopyFrom(key);
+  return handler->EvalCommand(&command) &&
+      command.output().error_code() == commands::Output::SESSION_SUCCESS;
+}
+
+bool SendSpecialKey(SessionHandler *handler, uint64 id,
+                    commands::KeyEvent::SpecialKey special_key) {
+  commands::KeyEvent key;
+  key.set_special_key(special_key);
+  return SendKey(handler, id, key);
+}
+
+// Types |keys| to a new session of |handler| and converts them.  Returns
+// false if a command fails.
+bool ConvertFirstInput(SessionHandler *handler,
+                       const vector<commands::KeyEvent> &keys) {
+  commands::Command command;
+  command.mutable_input()->set_type(commands::Input::CREATE_SESSION);
+  if (!handler->EvalCommand(&command)) {
+    return false;
+  }
+  const uint64 id = command.output().id();
+  bool result = SendSpecialKey(handler, id, commands::KeyEvent::ON);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    result &= SendKey(handler, id, keys[i]);
+  }
+  result &= SendSpecialKey(handler, id, commands::KeyEvent::SPACE);
+
+  command.Clear();
+  command.mutable_input()->set_type(commands::Input::DELETE_SESSION);
+  command.mutable_input()->set_id(id);
+  return handler->EvalCommand(&command) && result;
+}
+
+void PrintInitSteps(ostream *os) {
+  vector<LatencyHistogram::Snapshot> snapshots;
+  LatencyHistogram::GetAllSnapshots(&snapshots);
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    const LatencyHistogram::Snapshot &snapshot = snapshots[i];
+    if (snapshot.count == 0 ||
+        (!Util::StartsWith(snapshot.name, "EngineInit::") &&
+         !Util::StartsWith(snapshot.name, "RewriterInit::"))) {
+      continue;
+    }
+    *os << "#\t" << snapshot.name << "\tmean_usec="
+        << snapshot.total_usec / snapshot.count << endl;
+  }
+}
+
+void RunStartup(bool parallel_engine_init,
+                const vector<commands::KeyEvent> &keys) {
+  FLAGS_parallel_engine_init = parallel_engine_init;
+  const string mode = parallel_engine_init ? "parallel" : "serial";
+  BenchmarkRecorder engine_init("EngineInit/" + mode);
+  BenchmarkRecorder first_conversion("FirstConversion/" + mode);
+  BenchmarkRecorder time_to_first_conversion(
+      "TimeToFirstConversion/" + mode);
+  LatencyHistogram::ResetAll();
+
+  size_t num_failures = 0;
+  for (int n = 0; n < FLAGS_iterations; ++n) {
+    time_to_first_conversion.Start();
+    engine_init.Start();
+    scoped_ptr<EngineInterface> engine(MockDataEngineFactory::Create());
+    engine_init.Stop();
+
+    first_conversion.Start();
+    {
+      SessionHandler handler(engine.get());
+      num_failures += !ConvertFirstInput(&handler, keys);
+    }
+    first_conversion.Stop();
+    time_to_first_conversion.Stop();
+  }
+  LOG_IF(ERROR, num_failures > 0)
+      << mode << ": " << num_failures << " conversions failed";
+
+  engine_init.Print(&cout);
+  first_conversion.Print(&cout);
+  time_to_first_conversion.Print(&cout);
+  PrintInitSteps(&cout);
+}
+
+}  // namespace
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+
+  CHECK_GT(FLAGS_iterations, 0);
+
+  if (!FLAGS_user_profile_dir.empty()) {
+    mozc::SystemUtil::SetUserProfileDirectory(FLAGS_user_profile_dir);
+  }
+  // Uses the default config so that the results do not depend on the
+  // settings of the user.
+  mozc::config::Config config;
+  mozc::config::ConfigHandler::GetDefaultConfig(&config);
+  mozc::config::ConfigHandler::SetConfig(config);
+
+  size_t size = 0;
+  const char **sentences =
+      mozc::session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  CHECK_GT(size, 0);
+  vector<mozc::commands::KeyEvent> keys;
+  mozc::TypeHiragana(sentences[0], &keys);
+
+  mozc::BenchmarkRecorder::PrintHeader(&cout);
+  mozc::RunStartup(false, keys);
+  mozc::RunStartup(true, keys);
+  return 0;
+}
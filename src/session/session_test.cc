@@ -526,6 +526,68 @@ class MockConverterEngineForRevert : public EngineInterface {
   scoped_ptr<ConverterMockForRevert> converter_mock_;
 };
 
+// Cancels the pending request of |session| in the middle of the suggestion
+// as if the next key event arrived.
+class ConverterMockForCancel : public ConverterMock {
+ public:
+  ConverterMockForCancel() : session_(NULL), expired_(false) {}
+
+  virtual bool StartSuggestionForRequest(const ConversionRequest &request,
+                                         Segments *segments) const {
+    if (session_ != NULL) {
+      session_->CancelPendingRequest();
+    }
+    expired_ = request.IsExpired();
+    return ConverterMock::StartSuggestionForRequest(request, segments);
+  }
+
+  void set_session(SessionInterface *session) {
+    session_ = session;
+  }
+
+  bool expired() const {
+    return expired_;
+  }
+
+ private:
+  SessionInterface *session_;
+  mutable bool expired_;
+};
+
+class MockConverterEngineForCancel : public EngineInterface {
+ public:
+  MockConverterEngineForCancel()
+      : converter_mock_(new ConverterMockForCancel) {}
+  virtual ~MockConverterEngineForCancel() {}
+
+  virtual ConverterInterface *GetConverter() const {
+    return converter_mock_.get();
+  }
+
+  virtual PredictorInterface *GetPredictor() const {
+    return NULL;
+  }
+
+  virtual dictionary::SuppressionDictionary *GetSuppressionDictionary() {
+    return NULL;
+  }
+
+  virtual bool Reload() {
+    return true;
+  }
+
+  virtual UserDataManagerInterface *GetUserDataManager() {
+    return NULL;
+  }
+
+  ConverterMockForCancel *mutable_converter_mock() {
+    return converter_mock_.get();
+  }
+
+ private:
+  scoped_ptr<ConverterMockForCancel> converter_mock_;
+};
+
 }  // namespace
 
 class SessionTest : public testing::Test {
@@ -1008,6 +1070,31 @@ TEST_F(SessionTest, SendCommand) {
   EXPECT_FALSE(command.output().consumed());
 }
 
+TEST_F(SessionTest, CancelPendingRequest) {
+  MockConverterEngineForCancel engine;
+  Session session(&engine);
+  InitSessionToPrecomposition(&session);
+  Segments segments;
+  SetAiueo(&segments);
+  engine.mutable_converter_mock()->SetStartSuggestionForRequest(&segments,
+                                                                true);
+
+  // A cancellation before the key event doesn't affect it.
+  session.CancelPendingRequest();
+  commands::Command command;
+  SendKey("a", &session, &command);
+  EXPECT_FALSE(engine.mutable_converter_mock()->expired());
+
+  // The suggestion in progress is expired by the next key event.
+  engine.mutable_converter_mock()->set_session(&session);
+  SendKey("i", &session, &command);
+  EXPECT_TRUE(engine.mutable_converter_mock()->expired());
+
+  engine.mutable_converter_mock()->set_session(NULL);
+  SendKey("u", &session, &command);
+  EXPECT_FALSE(engine.mutable_converter_mock()->expired());
+}
+
 TEST_F(SessionTest, SwitchInputMode) {
   {
     scoped_ptr<Session> session(new Session(engine_.get()));
@@ -248,6 +248,40 @@
         'test_size': 'large',
       },
     },
+    {
+      'target_name': 'session_handler_benchmark',
+      'type': 'executable',
+      'sources': [
+        'session_handler_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../base/base_test.gyp:benchmark_util',
+        '../config/config.gyp:config_handler',
+        '../config/config.gyp:config_protocol',
+        '../engine/engine.gyp:mock_data_engine_factory',
+        'session.gyp:random_keyevents_generator',
+        'session.gyp:session_handler',
+        'session_base.gyp:session_protocol',
+      ],
+    },
+    {
+      'target_name': 'session_startup_benchmark',
+      'type': 'executable',
+      'sources': [
+        'session_startup_benchmark.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../base/base_test.gyp:benchmark_util',
+        '../config/config.gyp:config_handler',
+        '../config/config.gyp:config_protocol',
+        '../engine/engine.gyp:mock_data_engine_factory',
+        'session.gyp:random_keyevents_generator',
+        'session.gyp:session_handler',
+        'session_base.gyp:session_protocol',
+      ],
+    },
     {
       'target_name': 'random_keyevents_generator_test',
       'type': 'executable',
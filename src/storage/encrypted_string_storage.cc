@@ -35,6 +35,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "base/encryptor.h"
 #include "base/file_stream.h"
@@ -53,6 +54,28 @@ const size_t kSaltSize = 32;
 
 // Maximum file size (64Mbyte)
 const size_t kMaxFileSize = 64 * 1024 * 1024;
+
+// Size of the header of a log record, which stores the size of the rest of
+// the record.
+const size_t kLogRecordHeaderSize = 4;
+
+// Size of the checksum prepended to the data before encryption.
+const size_t kLogChecksumSize = 4;
+
+void AppendUint32(uint32 value, string *output) {
+  // Output from LSB to MSB.
+  for (int i = 0; i < 4; ++i) {
+    output->push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+  }
+}
+
+uint32 ReadUint32(const char *ptr) {
+  const uint8 *p = reinterpret_cast<const uint8 *>(ptr);
+  return static_cast<uint32>(p[0]) |
+      (static_cast<uint32>(p[1]) << 8) |
+      (static_cast<uint32>(p[2]) << 16) |
+      (static_cast<uint32>(p[3]) << 24);
+}
 }  // namespace
 
 EncryptedStringStorage::EncryptedStringStorage(const string &filename)
@@ -163,6 +186,114 @@ bool EncryptedStringStorage::Save(const string &input) const {
   return true;
 }
 
+string EncryptedStringStorage::GetLogFileName() const {
+  return filename_ + ".log";
+}
+
+bool EncryptedStringStorage::AppendLog(const string &record) const {
+  string salt;
+  salt.resize(kSaltSize);
+  Util::GetRandomSequence(&salt[0], kSaltSize);
+
+  // The checksum detects a record which is broken but happens to be
+  // decrypted.
+  string data;
+  AppendUint32(Util::Fingerprint32(record), &data);
+  data.append(record);
+  if (!Encrypt(salt, &data)) {
+    return false;
+  }
+
+  string output;
+  AppendUint32(static_cast<uint32>(salt.size() + data.size()), &output);
+  output.append(salt);
+  output.append(data);
+
+  const string log_filename = GetLogFileName();
+  {
+    OutputFileStream ofs(log_filename.c_str(),
+                         ios::out | ios::app | ios::binary);
+    if (!ofs) {
+      LOG(ERROR) << "failed to write: " << log_filename;
+      return false;
+    }
+    ofs.write(output.data(), output.size());
+    if (!ofs.flush()) {
+      LOG(ERROR) << "failed to flush: " << log_filename;
+      return false;
+    }
+  }
+
+#ifdef OS_WIN
+  if (!FileUtil::HideFile(log_filename)) {
+    LOG(ERROR) << "Cannot make hidden: " << log_filename
+               << " " << ::GetLastError();
+  }
+#endif
+
+  return true;
+}
+
+bool EncryptedStringStorage::LoadLog(vector<string> *records) const {
+  DCHECK(records);
+  records->clear();
+
+  const string log_filename = GetLogFileName();
+  if (!FileUtil::FileExists(log_filename)) {
+    return true;
+  }
+
+  Mmap mmap;
+  if (!mmap.Open(log_filename.c_str(), "r")) {
+    LOG(ERROR) << "cannot open log file";
+    return false;
+  }
+  if (mmap.size() > kMaxFileSize) {
+    LOG(ERROR) << "log file size is too big.";
+    return false;
+  }
+
+  const char *ptr = mmap.begin();
+  const char *end = mmap.begin() + mmap.size();
+  while (ptr < end) {
+    if (static_cast<size_t>(end - ptr) < kLogRecordHeaderSize) {
+      LOG(WARNING) << "incomplete log record header";
+      return false;
+    }
+    const size_t size = ReadUint32(ptr);
+    ptr += kLogRecordHeaderSize;
+    if (size < kSaltSize || static_cast<size_t>(end - ptr) < size) {
+      LOG(WARNING) << "incomplete log record";
+      return false;
+    }
+    const string salt(ptr, kSaltSize);
+    string data(ptr + kSaltSize, size - kSaltSize);
+    ptr += size;
+
+    if (!Decrypt(salt, &data) || data.size() < kLogChecksumSize) {
+      LOG(WARNING) << "cannot decrypt log record";
+      return false;
+    }
+    const uint32 checksum = ReadUint32(data.data());
+    data.erase(0, kLogChecksumSize);
+    if (checksum != Util::Fingerprint32(data)) {
+      LOG(WARNING) << "log record checksum mismatch";
+      return false;
+    }
+    records->push_back(data);
+  }
+
+  return true;
+}
+
+bool EncryptedStringStorage::ClearLog() const {
+  const string log_filename = GetLogFileName();
+  if (!FileUtil::FileExists(log_filename)) {
+    return true;
+  }
+  return FileUtil::Unlink(log_filename);
+}
+
 bool EncryptedStringStorage::Encrypt(const string &salt, string *data) const {
   DCHECK(data);
 
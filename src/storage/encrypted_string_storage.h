@@ -31,6 +31,7 @@
 #define MOZC_STORAGE_ENCRYPTED_STRING_STORAGE_H_
 
 #include <string>
+#include <vector>
 
 #include "base/port.h"
 
@@ -43,6 +44,20 @@ class StringStorageInterface {
 
   virtual bool Load(string *output) const = 0;
   virtual bool Save(const string &input) const = 0;
+
+  // Appends |record| to the log kept next to the saved string. Unlike Save(),
+  // the existing data is not rewritten, so the cost is proportional to the
+  // size of |record|.
+  virtual bool AppendLog(const string &record) const = 0;
+
+  // Loads the records in the log in the order of appending. Returns false if
+  // the log is broken, e.g., the last record is incomplete because of a crash
+  // while appending. Even in that case, the records before the broken one
+  // are stored in |records|. A missing log is an empty log.
+  virtual bool LoadLog(vector<string> *records) const = 0;
+
+  // Removes the log.
+  virtual bool ClearLog() const = 0;
 };
 
 class EncryptedStringStorage : public StringStorageInterface {
@@ -53,11 +68,20 @@ class EncryptedStringStorage : public StringStorageInterface {
   virtual bool Load(string *output) const;
   virtual bool Save(const string &input) const;
 
+  // The log is stored in |filename| + ".log" as a sequence of records, each
+  // of which consists of the size, the salt and the encrypted data with its
+  // checksum.
+  virtual bool AppendLog(const string &record) const;
+  virtual bool LoadLog(vector<string> *records) const;
+  virtual bool ClearLog() const;
+
  protected:
   virtual bool Encrypt(const string &salt, string *data) const;
   virtual bool Decrypt(const string &salt, string *data) const;
 
  private:
+  string GetLogFileName() const;
+
   string filename_;
 
   DISALLOW_COPY_AND_ASSIGN(EncryptedStringStorage);
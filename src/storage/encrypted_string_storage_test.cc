@@ -30,6 +30,8 @@
 #include "storage/encrypted_string_storage.h"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "base/file_stream.h"
 #include "base/file_util.h"
@@ -86,6 +88,11 @@ class EncryptedStringStorageTest : public testing::Test {
                                    "encrypted_string_storage_for_test.db");
 
     storage_.reset(new TestEncryptedStringStorage(filename_));
+    storage_->ClearLog();
+  }
+
+  void TearDown() {
+    storage_->ClearLog();
   }
 
   string filename_;
@@ -126,6 +133,81 @@ TEST_F(EncryptedStringStorageTest, Encrypt) {
   EXPECT_LT(original_data.size(), result.size());
   EXPECT_TRUE(result.find(original_data) == string::npos);
 }
+
+// Note: The mock for Android keeps only the last encrypted data, so
+// the log, which has multiple records, cannot be tested with it.
+TEST_F(EncryptedStringStorageTest, AppendAndLoadLog) {
+  vector<string> records;
+  // Missing log is an empty log.
+  EXPECT_TRUE(storage_->LoadLog(&records));
+  EXPECT_TRUE(records.empty());
+
+  const char *kRecords[] = { "abc", "", "defghijklmnopqrstuvwxyz0123456789" };
+  for (size_t i = 0; i < arraysize(kRecords); ++i) {
+    ASSERT_TRUE(storage_->AppendLog(kRecords[i]));
+  }
+
+  // The log is independent of the main data.
+  ASSERT_TRUE(storage_->Save("main data"));
+
+  EXPECT_TRUE(storage_->LoadLog(&records));
+  ASSERT_EQ(arraysize(kRecords), records.size());
+  for (size_t i = 0; i < arraysize(kRecords); ++i) {
+    EXPECT_EQ(kRecords[i], records[i]);
+  }
+
+  string output;
+  ASSERT_TRUE(storage_->Load(&output));
+  EXPECT_EQ("main data", output);
+
+  EXPECT_TRUE(storage_->ClearLog());
+  EXPECT_TRUE(storage_->LoadLog(&records));
+  EXPECT_TRUE(records.empty());
+  EXPECT_TRUE(storage_->Load(&output));
+}
+
+TEST_F(EncryptedStringStorageTest, LoadBrokenLog) {
+  ASSERT_TRUE(storage_->AppendLog("first record"));
+  ASSERT_TRUE(storage_->AppendLog("second record"));
+  ASSERT_TRUE(storage_->AppendLog("third record"));
+
+  const string log_filename = filename_ + ".log";
+  string log;
+  {
+    InputFileStream ifs(log_filename.c_str(), ios::in | ios::binary);
+    ASSERT_TRUE(ifs);
+    log.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  }
+  EXPECT_TRUE(log.find("record") == string::npos);
+
+  // Emulates a crash while appending the last record. Only the last record
+  // is lost however the record is cut.
+  for (size_t cut = 1; cut < 64; ++cut) {
+    {
+      OutputFileStream ofs(log_filename.c_str(),
+                           ios::out | ios::trunc | ios::binary);
+      ofs.write(log.data(), log.size() - cut);
+    }
+    vector<string> records;
+    EXPECT_FALSE(storage_->LoadLog(&records)) << cut;
+    ASSERT_EQ(2, records.size()) << cut;
+    EXPECT_EQ("first record", records[0]);
+    EXPECT_EQ("second record", records[1]);
+  }
+
+  // Corrupts the encrypted data of the second record.
+  {
+    string broken = log;
+    broken[broken.size() / 2] ^= 0x01;
+    OutputFileStream ofs(log_filename.c_str(),
+                         ios::out | ios::trunc | ios::binary);
+    ofs.write(broken.data(), broken.size());
+  }
+  vector<string> records;
+  EXPECT_FALSE(storage_->LoadLog(&records));
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("first record", records[0]);
+}
 #endif  // OS_ANDROID
 
 }  // namespace storage
@@ -31,7 +31,7 @@
 #define MOZC_STORAGE_LRU_CACHE_H_
 
 #include <cstring>
-#include <map>
+#include <functional>
 #include <string>
 
 #include "base/logging.h"
@@ -42,6 +42,11 @@ namespace storage {
 
 // Note: this class keeps some resources inside of the Key/Value, even if
 // such a entry is erased. Be careful to use for such classes.
+// Key must be hashable by std::hash and comparable by operator==.
+// Elements are indexed by an open addressing hash table with linear probing,
+// which holds pointers to the preallocated elements. The table is kept at
+// most half full and grows together with the element blocks, so lookup and
+// insertion don't allocate except when a new block is added.
 // TODO(yukawa): Make this class final once we stop supporting GCC 4.6.
 template<typename Key, typename Value>
 class LRUCache {
@@ -60,6 +65,8 @@ class LRUCache {
     Element* prev;
     Key key;
     Value value;
+    // Hash value of |key|, cached for probing and rehashing.
+    uint32 hash;
   };
 
   // Adds the specified key/value pair into the cache, putting it at the head
@@ -126,6 +133,21 @@ class LRUCache {
   // key is found.
   Element* LookupInternal(const Key &key) const;
 
+  // Returns the hash value of |key|. The result of std::hash is mixed since
+  // it is the identity for integers on some platforms and the table uses the
+  // lower bits.
+  static uint32 HashKey(const Key &key);
+
+  // Inserts |element| to the hash table. |element| must not be in the table.
+  void InsertToTable(Element* element);
+
+  // Removes |element| from the hash table. Returns false if |element| is not
+  // in the table.
+  bool RemoveFromTable(Element* element);
+
+  // Resizes the hash table so that it can hold |capacity| elements.
+  void ReserveTable(size_t capacity);
+
   // Removes the specified element from the LRU list.
   void RemoveFromLRU(Element* element);
 
@@ -137,9 +159,9 @@ class LRUCache {
   // lookup is not necessary.
   bool Evict(Element* element);
 
-  typedef map<Key, Element*> Table;
-
-  Table* table_;
+  Element** table_;        // open addressing hash table of Element
+  size_t table_mask_;       // size of table_ - 1, where the size is 2^n
+  size_t size_;             // number of elements in table_
   Element* free_list_;     // singly linked list of Element
   Element* lru_head_;      // head of doubly linked list of Element
   Element* lru_tail_;      // tail of doubly linked list of Element
@@ -166,6 +188,7 @@ void LRUCache<Key, Value>::AddBlock() {
   if (block_count_ < max_blocks && block_capacity_ < max_elements_) {
     blocks_[block_count_] = new Element[next_block_size_];
     block_capacity_ += next_block_size_;
+    ReserveTable(block_capacity_);
     // Add new elements to free list
     for (size_t i = 0; i < next_block_size_; ++i) {
       Element* e = &((blocks_[block_count_])[i]);
@@ -221,16 +244,96 @@ LRUCache<Key, Value>::NextFreeElement() {
   return r;
 }
 
+template<typename Key, typename Value>
+uint32 LRUCache<Key, Value>::HashKey(const Key &key) {
+  const uint64 hash = std::hash<Key>()(key);
+  // Finalizer of MurmurHash3 applied to the folded hash value.
+  uint32 h = static_cast<uint32>(hash ^ (hash >> 32));
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
 template<typename Key, typename Value>
 typename LRUCache<Key, Value>::Element*
 LRUCache<Key, Value>::LookupInternal(const Key &key) const {
-  typename Table::iterator iter = table_->find(key);
-  if (iter != table_->end()) {
-    return iter->second;
+  if (size_ == 0) {
+    return NULL;
+  }
+  const uint32 hash = HashKey(key);
+  for (size_t i = hash & table_mask_; table_[i] != NULL;
+       i = (i + 1) & table_mask_) {
+    if (table_[i]->hash == hash && table_[i]->key == key) {
+      return table_[i];
+    }
   }
   return NULL;
 }
 
+template<typename Key, typename Value>
+void LRUCache<Key, Value>::InsertToTable(Element* element) {
+  size_t i = element->hash & table_mask_;
+  while (table_[i] != NULL) {
+    i = (i + 1) & table_mask_;
+  }
+  table_[i] = element;
+  ++size_;
+}
+
+template<typename Key, typename Value>
+bool LRUCache<Key, Value>::RemoveFromTable(Element* element) {
+  size_t i = element->hash & table_mask_;
+  while (table_[i] != element) {
+    if (table_[i] == NULL) {
+      return false;
+    }
+    i = (i + 1) & table_mask_;
+  }
+  // Shifts the following elements in the same cluster back so that lookup
+  // doesn't need tombstones.
+  for (size_t j = (i + 1) & table_mask_; table_[j] != NULL;
+       j = (j + 1) & table_mask_) {
+    const size_t home = table_[j]->hash & table_mask_;
+    // Moves table_[j] to the hole at i unless its home slot lies cyclically
+    // in (i, j].
+    const bool home_in_range =
+        (i < j) ? (i < home && home <= j) : (i < home || home <= j);
+    if (!home_in_range) {
+      table_[i] = table_[j];
+      i = j;
+    }
+  }
+  table_[i] = NULL;
+  --size_;
+  return true;
+}
+
+template<typename Key, typename Value>
+void LRUCache<Key, Value>::ReserveTable(size_t capacity) {
+  size_t table_size = 1;
+  while (table_size < capacity * 2) {
+    table_size <<= 1;
+  }
+  if (table_ != NULL && table_size <= table_mask_ + 1) {
+    return;
+  }
+  Element** old_table = table_;
+  const size_t old_table_size = (old_table == NULL) ? 0 : table_mask_ + 1;
+  table_ = new Element*[table_size];
+  ::memset(table_, 0, sizeof(table_[0]) * table_size);
+  table_mask_ = table_size - 1;
+  size_ = 0;
+  for (size_t i = 0; i < old_table_size; ++i) {
+    if (old_table[i] != NULL) {
+      InsertToTable(old_table[i]);
+    }
+  }
+  delete [] old_table;
+}
+
 template<typename Key, typename Value>
 void LRUCache<Key, Value>::RemoveFromLRU(Element* element) {
   if (lru_head_ == element) {
@@ -269,8 +372,8 @@ void LRUCache<Key, Value>::PushLRUHead(Element* element) {
 template<typename Key, typename Value>
 bool LRUCache<Key, Value>::Evict(Element* e) {
   if (e != NULL) {
-    int erased = table_->erase(e->key);
-    CHECK_EQ(erased, 1);
+    const bool erased = RemoveFromTable(e);
+    CHECK(erased);
     RemoveFromLRU(e);
     PushFreeList(e);
     return true;
@@ -280,15 +383,16 @@ bool LRUCache<Key, Value>::Evict(Element* e) {
 
 template<typename Key, typename Value>
 LRUCache<Key, Value>::LRUCache(size_t max_elements)
-  : free_list_(NULL),
+  : table_(NULL),
+    table_mask_(0),
+    size_(0),
+    free_list_(NULL),
     lru_head_(NULL),
     lru_tail_(NULL),
     block_count_(0),
     block_capacity_(0),
     max_elements_(max_elements) {
   ::memset(blocks_, 0, sizeof(blocks_));
-  table_ = new Table;
-  CHECK(table_);
   if (max_elements_ <= 128) {
     next_block_size_ = max_elements_;
   } else {
@@ -309,7 +413,7 @@ template<typename Key, typename Value>
 LRUCache<Key, Value>::~LRUCache() {
   // To free all the memory that I have allocated I need to delete table_ and
   // any used entries in blocks_.
-  delete table_;
+  delete [] table_;
   for (size_t i = 0; i < block_count_; ++i) {
     delete [] blocks_[i];
   }
@@ -344,7 +448,8 @@ LRUCache<Key, Value>::Insert(const Key& key) {
     CHECK(e != NULL);
   }
   e->key = key;
-  (*table_)[key] = e;
+  e->hash = HashKey(key);
+  InsertToTable(e);
   PushLRUHead(e);
 
   return e;
@@ -387,7 +492,10 @@ bool LRUCache<Key, Value>::Erase(const Key& key) {
 
 template<typename Key, typename Value>
 void LRUCache<Key, Value>::Clear() {
-  table_->clear();
+  if (table_ != NULL) {
+    ::memset(table_, 0, sizeof(table_[0]) * (table_mask_ + 1));
+  }
+  size_ = 0;
   Element* e = lru_head_;
   while (e != NULL) {
     Element* next = e->next;
@@ -399,12 +507,12 @@ void LRUCache<Key, Value>::Clear() {
 
 template<typename Key, typename Value>
 bool LRUCache<Key, Value>::HasKey(const Key& key) const {
-  return (table_->find(key) != table_->end());
+  return LookupInternal(key) != NULL;
 }
 
 template<typename Key, typename Value>
 size_t LRUCache<Key, Value>::Size() const {
-  return table_->size();
+  return size_;
 }
 
 }  // namespace storage
@@ -27,16 +27,124 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+
+// Without --benchmark, reads commands from stdin:
+//   i <key> <value> : inserts the pair
+//   f <key>         : prints the value for the key, or NULL
+// With --benchmark, measures Insert/Lookup/Erase of LRUCache with the key
+// types and sizes of its main users, e.g. UserHistoryPredictor's DicCache
+// (uint32 fingerprints, 10000 entries) and SessionHandler's session map.
+
 #include "storage/lru_cache.h"
 
 #include <string>
 #include <iostream>  // NOLINT
+#include <vector>
 
 #include "base/flags.h"
+#include "base/port.h"
+#include "base/stopwatch.h"
 #include "base/util.h"
 
+DEFINE_bool(benchmark, false, "run benchmark instead of reading stdin.");
+DEFINE_int32(cache_size, 10000, "max elements of the cache for benchmark.");
+DEFINE_int32(iterations, 1000000, "number of operations for each benchmark.");
+
+namespace mozc {
+namespace storage {
+namespace {
+
+void Report(const string &name, double elapsed_nsec) {
+  cout << name << ": "
+       << Util::StringPrintf("%.1f nsec/op", elapsed_nsec / FLAGS_iterations)
+       << endl;
+}
+
+// Returns the sum of the looked up values so that the loops are not
+// optimized out.
+template<typename Key>
+uint32 RunBenchmark(const string &name, const vector<Key> &keys) {
+  const size_t cache_size = FLAGS_cache_size;
+  LRUCache<Key, uint32> cache(cache_size);
+  uint32 sum = 0;
+
+  // Keys in [0, cache_size) are in the cache after this loop.
+  for (size_t i = 0; i < cache_size; ++i) {
+    cache.Insert(keys[i], i);
+  }
+  {
+    // Lookup hits, like probing DicCache for each history entry.
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      const uint32 *value = cache.Lookup(keys[(i * 7919) % cache_size]);
+      sum += (value == NULL) ? 0 : *value;
+    }
+    stopwatch.Stop();
+    Report(name + " Lookup (hit)", stopwatch.GetElapsedNanoseconds());
+  }
+  {
+    // Lookup misses with keys in [cache_size, 2 * cache_size).
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      sum += cache.HasKey(keys[cache_size + (i * 7919) % cache_size]);
+    }
+    stopwatch.Stop();
+    Report(name + " HasKey (miss)", stopwatch.GetElapsedNanoseconds());
+  }
+  {
+    // Inserts new keys into the full cache, each of which evicts the LRU.
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      cache.Insert(keys[i % keys.size()], i);
+    }
+    stopwatch.Stop();
+    Report(name + " Insert (evict)", stopwatch.GetElapsedNanoseconds());
+  }
+  {
+    // Erases and inserts back, like removing a closed session.
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      const Key &key = cache.Tail()->key;
+      const Key key_copy = key;
+      sum += cache.Erase(key_copy);
+      cache.Insert(key_copy, i);
+    }
+    stopwatch.Stop();
+    Report(name + " Erase + Insert", stopwatch.GetElapsedNanoseconds());
+  }
+  return sum;
+}
+
+void RunBenchmarks() {
+  const size_t num_keys = FLAGS_cache_size * 2;
+  vector<uint32> fingerprints;
+  vector<uint64> session_ids;
+  vector<string> strings;
+  for (size_t i = 0; i < num_keys; ++i) {
+    const string key = Util::StringPrintf("key%d", static_cast<int>(i));
+    fingerprints.push_back(Util::Fingerprint32(key));
+    session_ids.push_back(Util::Fingerprint(key));
+    strings.push_back(key);
+  }
+  uint32 sum = 0;
+  sum += RunBenchmark("uint32", fingerprints);
+  sum += RunBenchmark("uint64", session_ids);
+  sum += RunBenchmark("string", strings);
+  cout << "checksum: " << sum << endl;
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace mozc
+
 int main(int argc, char **argv) {
   InitGoogle(argv[0], &argc, &argv, false);
+
+  if (FLAGS_benchmark) {
+    mozc::storage::RunBenchmarks();
+    return 0;
+  }
+
   mozc::storage::LRUCache<string, string> cache(5);
 
   string line;
@@ -0,0 +1,234 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "storage/lru_cache.h"
+
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/port.h"
+#include "base/util.h"
+#include "testing/base/public/gunit.h"
+
+namespace mozc {
+namespace storage {
+namespace {
+
+// Key whose hash values collide heavily, to exercise probing and deletion.
+struct CollidingKey {
+  explicit CollidingKey(int v) : value(v) {}
+  CollidingKey() : value(0) {}
+  bool operator==(const CollidingKey &other) const {
+    return value == other.value;
+  }
+  int value;
+};
+
+}  // namespace
+}  // namespace storage
+}  // namespace mozc
+
+namespace std {
+template<>
+struct hash<mozc::storage::CollidingKey> {
+  size_t operator()(const mozc::storage::CollidingKey &key) const {
+    return key.value % 3;
+  }
+};
+}  // namespace std
+
+namespace mozc {
+namespace storage {
+namespace {
+
+template<typename Key>
+void ExpectLRUOrder(const LRUCache<Key, int> &cache,
+                    const list<pair<Key, int> > &expected) {
+  ASSERT_EQ(expected.size(), cache.Size());
+  const typename LRUCache<Key, int>::Element *e = cache.Head();
+  for (typename list<pair<Key, int> >::const_iterator it = expected.begin();
+       it != expected.end(); ++it) {
+    ASSERT_TRUE(e != NULL);
+    EXPECT_TRUE(it->first == e->key);
+    EXPECT_EQ(it->second, e->value);
+    e = e->next;
+  }
+  EXPECT_TRUE(e == NULL);
+}
+
+// Runs random operations on both LRUCache and a simple reference model.
+template<typename Key>
+void RunRandomOperations(size_t max_elements, int key_range, int num_ops) {
+  LRUCache<Key, int> cache(max_elements);
+  // Most recently used first.
+  list<pair<Key, int> > model;
+
+  for (int n = 0; n < num_ops; ++n) {
+    const Key key(Util::Random(key_range));
+    typename list<pair<Key, int> >::iterator it = model.begin();
+    while (it != model.end() && !(it->first == key)) {
+      ++it;
+    }
+    const bool in_model = (it != model.end());
+    switch (Util::Random(4)) {
+      case 0:
+      case 1: {
+        cache.Insert(key, n);
+        if (in_model) {
+          model.erase(it);
+        } else if (model.size() == max_elements) {
+          model.pop_back();
+        }
+        model.push_front(make_pair(key, n));
+        break;
+      }
+      case 2: {
+        const int *value = cache.Lookup(key);
+        ASSERT_EQ(in_model, value != NULL);
+        if (in_model) {
+          EXPECT_EQ(it->second, *value);
+          model.splice(model.begin(), model, it);
+        }
+        break;
+      }
+      case 3: {
+        EXPECT_EQ(in_model, cache.Erase(key));
+        if (in_model) {
+          model.erase(it);
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(model.size(), cache.Size());
+  }
+  ExpectLRUOrder(cache, model);
+  for (typename list<pair<Key, int> >::const_iterator it = model.begin();
+       it != model.end(); ++it) {
+    EXPECT_TRUE(cache.HasKey(it->first));
+  }
+}
+
+TEST(LRUCacheTest, InsertAndLookup) {
+  LRUCache<string, string> cache(3);
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_TRUE(cache.Lookup("a") == NULL);
+
+  cache.Insert("a", "A");
+  cache.Insert("b", "B");
+  cache.Insert("c", "C");
+  EXPECT_EQ(3, cache.Size());
+  ASSERT_TRUE(cache.Lookup("a") != NULL);
+  EXPECT_EQ("A", *cache.Lookup("a"));
+
+  // "b" is the least recently used.
+  cache.Insert("d", "D");
+  EXPECT_EQ(3, cache.Size());
+  EXPECT_FALSE(cache.HasKey("b"));
+  EXPECT_TRUE(cache.HasKey("a"));
+  EXPECT_TRUE(cache.HasKey("c"));
+  EXPECT_TRUE(cache.HasKey("d"));
+  EXPECT_EQ("d", cache.Head()->key);
+  EXPECT_EQ("c", cache.Tail()->key);
+
+  // Overwrites the existing entry.
+  cache.Insert("c", "CC");
+  EXPECT_EQ(3, cache.Size());
+  EXPECT_EQ("CC", *cache.LookupWithoutInsert("c"));
+  EXPECT_EQ("c", cache.Head()->key);
+  EXPECT_EQ("a", cache.Tail()->key);
+
+  // LookupWithoutInsert doesn't change the order.
+  EXPECT_EQ("A", *cache.LookupWithoutInsert("a"));
+  EXPECT_EQ("a", cache.Tail()->key);
+}
+
+TEST(LRUCacheTest, EraseAndClear) {
+  LRUCache<int, int> cache(10);
+  for (int i = 0; i < 10; ++i) {
+    cache.Insert(i, i * 10);
+  }
+  EXPECT_EQ(10, cache.Size());
+  EXPECT_TRUE(cache.Erase(5));
+  EXPECT_FALSE(cache.Erase(5));
+  EXPECT_FALSE(cache.HasKey(5));
+  EXPECT_EQ(9, cache.Size());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_TRUE(cache.Head() == NULL);
+  EXPECT_TRUE(cache.Tail() == NULL);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_FALSE(cache.HasKey(i));
+  }
+
+  // The elements are reused after Clear().
+  for (int i = 0; i < 20; ++i) {
+    cache.Insert(i, i);
+  }
+  EXPECT_EQ(10, cache.Size());
+  for (int i = 10; i < 20; ++i) {
+    ASSERT_TRUE(cache.Lookup(i) != NULL);
+    EXPECT_EQ(i, *cache.Lookup(i));
+  }
+}
+
+TEST(LRUCacheTest, MutableLookup) {
+  LRUCache<uint32, int> cache(2);
+  cache.Insert(1, 1);
+  cache.Insert(2, 2);
+  *cache.MutableLookup(1) = 100;
+  EXPECT_EQ(1, cache.Head()->key);
+  EXPECT_EQ(100, *cache.Lookup(1));
+
+  LRUCache<uint32, int>::Element *e = cache.Insert(3);
+  ASSERT_TRUE(e != NULL);
+  e->value = 300;
+  EXPECT_FALSE(cache.HasKey(2));
+  EXPECT_EQ(300, *cache.Lookup(3));
+}
+
+TEST(LRUCacheTest, RandomOperations) {
+  // Small caches fit in one block and large ones grow over several blocks.
+  RunRandomOperations<int>(5, 10, 1000);
+  RunRandomOperations<int>(100, 300, 10000);
+  RunRandomOperations<int>(1000, 1500, 50000);
+}
+
+TEST(LRUCacheTest, RandomOperationsWithCollisions) {
+  RunRandomOperations<CollidingKey>(50, 100, 10000);
+  RunRandomOperations<CollidingKey>(300, 400, 20000);
+}
+
+}  // namespace
+}  // namespace storage
+}  // namespace mozc
@@ -63,6 +63,20 @@
         '../../storage/storage.gyp:storage',
       ],
     },
+    {
+      'target_name': 'mozc_emacs_helper_benchmark',
+      'type': 'executable',
+      'sources': [
+        'mozc_emacs_helper_benchmark.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../client/client.gyp:client',
+        '../../session/session.gyp:random_keyevents_generator',
+        '../../session/session_base.gyp:session_protocol',
+        'mozc_emacs_helper_lib',
+      ],
+    },
     {
       'target_name': 'mozc_emacs_helper_lib_test',
       'type': 'executable',
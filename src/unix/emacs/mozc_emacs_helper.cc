@@ -44,6 +44,8 @@
 
 DEFINE_bool(suppress_stderr, false,
             "Discards all the output to stderr.");
+DEFINE_bool(compact_output, false,
+            "Prints only the fields of the output which mozc.el refers to.");
 
 namespace {
 
@@ -76,6 +78,7 @@ void ProcessLoop() {
   mozc::emacs::ClientPool client_pool;
   mozc::commands::Command command;
   string line;
+  string output;
 
   while (getline(cin, line)) {
     command.clear_input();
@@ -110,11 +113,13 @@ void ProcessLoop() {
 
     mozc::emacs::RemoveUsageData(command.mutable_output());
 
-    // Output results.
-    vector<string> buffer;
-    mozc::emacs::PrintMessage(command.output(), &buffer);
-    string output;
-    mozc::Util::JoinStrings(buffer, "", &output);
+    // Output results.  |output| is reused to keep its capacity.
+    output.clear();
+    if (FLAGS_compact_output) {
+      mozc::emacs::PrintCompactOutput(command.output(), &output);
+    } else {
+      mozc::emacs::PrintOutput(command.output(), &output);
+    }
     fprintf(stdout,
             "((emacs-event-id . %u)(emacs-session-id . %u)(output . %s))\n",
             event_id, session_id, output.c_str());
@@ -0,0 +1,220 @@
+// Copyright 2010-2015, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Benchmark of the per-key work which mozc_emacs_helper does besides IPC.
+// A recorded session (lines sent from mozc.el to mozc_emacs_helper) is
+// replayed against the server once, and then parsing of the input lines and
+// printing of the outputs are measured with the reflection-based printer and
+// the non-reflective printers.
+//
+// Usage:
+//   mozc_emacs_helper_benchmark --session_file=recorded_session.txt
+// If --session_file is not given, a session is generated from
+// RandomKeyEventsGenerator::GetTestSentences().
+
+#include <iostream>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/file_stream.h"
+#include "base/flags.h"
+#include "base/logging.h"
+#include "base/port.h"
+#include "base/stopwatch.h"
+#include "base/util.h"
+#include "client/client.h"
+#include "session/commands.pb.h"
+#include "session/random_keyevents_generator.h"
+#include "unix/emacs/client_pool.h"
+#include "unix/emacs/mozc_emacs_helper_lib.h"
+
+DEFINE_string(session_file, "",
+              "File of the input lines sent to mozc_emacs_helper.");
+DEFINE_int32(iterations, 100, "The number of iterations of each printer.");
+DEFINE_int32(max_sentences, 200,
+             "The number of generated sentences when --session_file is empty.");
+
+namespace mozc {
+namespace emacs {
+namespace {
+
+// Generates SendKey lines as mozc.el does for the test sentences.
+void GenerateSession(vector<string> *lines) {
+  size_t size = 0;
+  const char **sentences =
+      session::RandomKeyEventsGenerator::GetTestSentences(&size);
+  size = min(static_cast<size_t>(FLAGS_max_sentences), size);
+  uint32 event_id = 0;
+  lines->push_back(Util::StringPrintf("(%u CreateSession)", event_id++));
+  for (size_t i = 0; i < size; ++i) {
+    string romanji;
+    Util::HiraganaToRomanji(sentences[i], &romanji);
+    for (size_t j = 0; j < romanji.size(); ++j) {
+      if (romanji[j] < 'a' || romanji[j] > 'z') {
+        continue;
+      }
+      lines->push_back(Util::StringPrintf("(%u SendKey 0 %d)", event_id++,
+                                          static_cast<int>(romanji[j])));
+    }
+    lines->push_back(Util::StringPrintf("(%u SendKey 0 space)", event_id++));
+    lines->push_back(Util::StringPrintf("(%u SendKey 0 enter)", event_id++));
+  }
+}
+
+void LoadSession(vector<string> *lines) {
+  InputFileStream ifs(FLAGS_session_file.c_str());
+  CHECK(ifs) << "Cannot open " << FLAGS_session_file;
+  string line;
+  while (getline(ifs, line)) {
+    if (!line.empty()) {
+      lines->push_back(line);
+    }
+  }
+}
+
+// Replays the session and collects the outputs as mozc_emacs_helper does.
+void Replay(const vector<string> &lines, vector<commands::Output> *outputs) {
+  ClientPool client_pool;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    commands::Command command;
+    uint32 event_id = 0;
+    uint32 session_id = 0;
+    ParseInputLine(lines[i], &event_id, &session_id, command.mutable_input());
+    switch (command.input().type()) {
+      case commands::Input::CREATE_SESSION:
+        client_pool.CreateClient();
+        break;
+      case commands::Input::DELETE_SESSION:
+        client_pool.DeleteClient(session_id);
+        break;
+      case commands::Input::SEND_KEY:
+        CHECK(client_pool.GetClient(session_id)->SendKey(
+            command.input().key(), command.mutable_output()));
+        break;
+      default:
+        break;
+    }
+    RemoveUsageData(command.mutable_output());
+    outputs->push_back(command.output());
+  }
+}
+
+void Report(const char *name, double elapsed_usec, size_t events,
+            size_t bytes) {
+  cout << name << ": "
+       << Util::StringPrintf("%.3f usec/event, %.1f bytes/event",
+                             elapsed_usec / events,
+                             static_cast<double>(bytes) / events)
+       << endl;
+}
+
+void Run() {
+  vector<string> lines;
+  if (FLAGS_session_file.empty()) {
+    GenerateSession(&lines);
+  } else {
+    LoadSession(&lines);
+  }
+  CHECK(!lines.empty());
+
+  vector<commands::Output> outputs;
+  Replay(lines, &outputs);
+  const size_t events = lines.size() * FLAGS_iterations;
+
+  {
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (size_t i = 0; i < lines.size(); ++i) {
+        commands::Input input;
+        uint32 event_id = 0;
+        uint32 session_id = 0;
+        ParseInputLine(lines[i], &event_id, &session_id, &input);
+      }
+    }
+    stopwatch.Stop();
+    Report("ParseInputLine", stopwatch.GetElapsedMicroseconds(), events, 0);
+  }
+
+  {
+    size_t bytes = 0;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        vector<string> buffer;
+        PrintMessage(outputs[i], &buffer);
+        string result;
+        Util::JoinStrings(buffer, "", &result);
+        bytes += result.size();
+      }
+    }
+    stopwatch.Stop();
+    Report("PrintMessage", stopwatch.GetElapsedMicroseconds(), events, bytes);
+  }
+
+  {
+    size_t bytes = 0;
+    string result;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        result.clear();
+        PrintOutput(outputs[i], &result);
+        bytes += result.size();
+      }
+    }
+    stopwatch.Stop();
+    Report("PrintOutput", stopwatch.GetElapsedMicroseconds(), events, bytes);
+  }
+
+  {
+    size_t bytes = 0;
+    string result;
+    Stopwatch stopwatch = Stopwatch::StartNew();
+    for (int n = 0; n < FLAGS_iterations; ++n) {
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        result.clear();
+        PrintCompactOutput(outputs[i], &result);
+        bytes += result.size();
+      }
+    }
+    stopwatch.Stop();
+    Report("PrintCompactOutput", stopwatch.GetElapsedMicroseconds(), events,
+           bytes);
+  }
+}
+
+}  // namespace
+}  // namespace emacs
+}  // namespace mozc
+
+int main(int argc, char **argv) {
+  InitGoogle(argv[0], &argc, &argv, false);
+  mozc::emacs::Run();
+  return 0;
+}
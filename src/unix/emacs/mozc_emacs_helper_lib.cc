@@ -58,6 +58,12 @@ void PrintFieldValue(
     const protobuf::FieldDescriptor &field,
     int index,
     vector<string>* output);
+void PrintReflectedField(const protobuf::Message &message, int number,
+                         string *output);
+void PrintFieldsAfter(const protobuf::Message &message, int last_number,
+                      string *output);
+void PrintCommandsOutput(const commands::Output &output, bool compact,
+                         string *result);
 }  // namespace
 
 
@@ -195,6 +201,16 @@ void PrintMessage(
   output->push_back(")");
 }
 
+void PrintOutput(const mozc::commands::Output &output, string *result) {
+  DCHECK(result);
+  PrintCommandsOutput(output, false, result);
+}
+
+void PrintCompactOutput(const mozc::commands::Output &output, string *result) {
+  DCHECK(result);
+  PrintCommandsOutput(output, true, result);
+}
+
 
 // Utilities
 
@@ -478,6 +494,593 @@ void PrintFieldValue(
 #undef GET_FIELD_VALUE
 }
 
+
+// Non-reflective printers for commands::Output.
+//
+// Each printer below emits the fields in the order of their field numbers,
+// which is the order protobuf::Reflection::ListFields() returns, so that the
+// result is identical to PrintMessage().  Set fields which a printer does not
+// know are printed by PrintFieldsAfter() in the full output, but they go
+// through reflection, so keep the printers in sync with
+// session/commands.proto and session/candidates.proto.
+
+// Appends a symbol normalized in the same way as NormalizeSymbol().
+void AppendSymbol(const string &symbol, string *output) {
+  for (size_t i = 0; i < symbol.size(); ++i) {
+    const char c = symbol[i];
+    if (c == '_') {
+      output->push_back('-');
+    } else if ('A' <= c && c <= 'Z') {
+      output->push_back(c - 'A' + 'a');
+    } else {
+      output->push_back(c);
+    }
+  }
+}
+
+// Appends a string literal quoted in the same way as QuoteString().
+void AppendQuotedString(const string &str, string *output) {
+  output->push_back('\"');
+  for (size_t i = 0; i < str.size(); ++i) {
+    const char c = str[i];
+    if (c == '\\' || c == '\"') {
+      output->push_back('\\');
+    }
+    output->push_back(c);
+  }
+  output->push_back('\"');
+}
+
+void AppendInt32(int32 value, string *output) {
+  char buf[16];
+  const int len = snprintf(buf, sizeof(buf), "%d", value);
+  output->append(buf, len);
+}
+
+void AppendUInt32(uint32 value, string *output) {
+  char buf[16];
+  const int len = snprintf(buf, sizeof(buf), "%u", value);
+  output->append(buf, len);
+}
+
+// 64-bit integers are printed as strings.  See PrintFieldValue().
+void AppendUInt64(uint64 value, string *output) {
+  char buf[32];
+  const int len = snprintf(buf, sizeof(buf), "\"%" GG_LL_FORMAT "u\"", value);
+  output->append(buf, len);
+}
+
+void AppendBool(bool value, string *output) {
+  output->append(value ? "t" : "nil");
+}
+
+// Helpers to print a single entry "(name . value)".
+void BeginEntry(const char *name, string *output) {
+  output->push_back('(');
+  output->append(name);
+  output->append(" . ");
+}
+
+void EndEntry(string *output) {
+  output->push_back(')');
+}
+
+void PrintUInt32Entry(const char *name, uint32 value, string *output) {
+  BeginEntry(name, output);
+  AppendUInt32(value, output);
+  EndEntry(output);
+}
+
+void PrintInt32Entry(const char *name, int32 value, string *output) {
+  BeginEntry(name, output);
+  AppendInt32(value, output);
+  EndEntry(output);
+}
+
+void PrintBoolEntry(const char *name, bool value, string *output) {
+  BeginEntry(name, output);
+  AppendBool(value, output);
+  EndEntry(output);
+}
+
+void PrintStringEntry(const char *name, const string &value, string *output) {
+  BeginEntry(name, output);
+  AppendQuotedString(value, output);
+  EndEntry(output);
+}
+
+void PrintSymbolEntry(const char *name, const string &value, string *output) {
+  BeginEntry(name, output);
+  AppendSymbol(value, output);
+  EndEntry(output);
+}
+
+void PrintAnnotation(const commands::Annotation &annotation, bool compact,
+                     string *output) {
+  output->push_back('(');
+  if (annotation.has_prefix()) {
+    PrintStringEntry("prefix", annotation.prefix(), output);
+  }
+  if (annotation.has_suffix()) {
+    PrintStringEntry("suffix", annotation.suffix(), output);
+  }
+  if (annotation.has_description()) {
+    PrintStringEntry("description", annotation.description(), output);
+  }
+  if (annotation.has_shortcut()) {
+    PrintStringEntry("shortcut", annotation.shortcut(), output);
+  }
+  if (!compact) {
+    if (annotation.has_deletable()) {
+      PrintBoolEntry("deletable", annotation.deletable(), output);
+    }
+    PrintFieldsAfter(annotation, commands::Annotation::kDeletableFieldNumber,
+                     output);
+  }
+  output->push_back(')');
+}
+
+void PrintResult(const commands::Result &result, bool compact,
+                 string *output) {
+  output->push_back('(');
+  if (result.has_type()) {
+    PrintSymbolEntry("type",
+                     commands::Result::ResultType_Name(result.type()), output);
+  }
+  if (result.has_value()) {
+    PrintStringEntry("value", result.value(), output);
+  }
+  if (!compact) {
+    if (result.has_key()) {
+      PrintStringEntry("key", result.key(), output);
+    }
+    if (result.has_cursor_offset()) {
+      PrintInt32Entry("cursor-offset", result.cursor_offset(), output);
+    }
+    PrintFieldsAfter(result, commands::Result::kCursorOffsetFieldNumber,
+                     output);
+  }
+  output->push_back(')');
+}
+
+void PrintPreedit(const commands::Preedit &preedit, bool compact,
+                  string *output) {
+  output->push_back('(');
+  if (preedit.has_cursor()) {
+    PrintUInt32Entry("cursor", preedit.cursor(), output);
+  }
+  if (preedit.segment_size() > 0) {
+    output->append("(segment ");
+    for (int i = 0; i < preedit.segment_size(); ++i) {
+      const commands::Preedit::Segment &segment = preedit.segment(i);
+      output->push_back('(');
+      if (segment.has_annotation()) {
+        PrintSymbolEntry(
+            "annotation",
+            commands::Preedit::Segment::Annotation_Name(segment.annotation()),
+            output);
+      }
+      if (segment.has_value()) {
+        PrintStringEntry("value", segment.value(), output);
+      }
+      if (!compact) {
+        if (segment.has_value_length()) {
+          PrintUInt32Entry("value-length", segment.value_length(), output);
+        }
+        if (segment.has_key()) {
+          PrintStringEntry("key", segment.key(), output);
+        }
+        PrintFieldsAfter(segment, commands::Preedit::Segment::kKeyFieldNumber,
+                         output);
+      }
+      output->push_back(')');
+    }
+    output->push_back(')');
+  }
+  if (!compact) {
+    if (preedit.has_highlighted_position()) {
+      PrintUInt32Entry("highlighted-position", preedit.highlighted_position(),
+                       output);
+    }
+    PrintFieldsAfter(preedit,
+                     commands::Preedit::kHighlightedPositionFieldNumber,
+                     output);
+  }
+  output->push_back(')');
+}
+
+void PrintFooter(const commands::Footer &footer, bool compact,
+                 string *output) {
+  output->push_back('(');
+  if (!compact && footer.has_label()) {
+    PrintStringEntry("label", footer.label(), output);
+  }
+  if (footer.has_index_visible()) {
+    PrintBoolEntry("index-visible", footer.index_visible(), output);
+  }
+  if (!compact) {
+    if (footer.has_logo_visible()) {
+      PrintBoolEntry("logo-visible", footer.logo_visible(), output);
+    }
+    if (footer.has_sub_label()) {
+      PrintStringEntry("sub-label", footer.sub_label(), output);
+    }
+    PrintFieldsAfter(footer, commands::Footer::kSubLabelFieldNumber, output);
+  }
+  output->push_back(')');
+}
+
+void PrintCandidates(const commands::Candidates &candidates, bool compact,
+                     string *output) {
+  output->push_back('(');
+  if (candidates.has_focused_index()) {
+    PrintUInt32Entry("focused-index", candidates.focused_index(), output);
+  }
+  if (candidates.has_size()) {
+    PrintUInt32Entry("size", candidates.size(), output);
+  }
+  if (candidates.candidate_size() > 0) {
+    output->append("(candidate ");
+    for (int i = 0; i < candidates.candidate_size(); ++i) {
+      const commands::Candidates::Candidate &candidate =
+          candidates.candidate(i);
+      output->push_back('(');
+      if (candidate.has_index()) {
+        PrintUInt32Entry("index", candidate.index(), output);
+      }
+      if (candidate.has_value()) {
+        PrintStringEntry("value", candidate.value(), output);
+      }
+      if (candidate.has_annotation()) {
+        BeginEntry("annotation", output);
+        PrintAnnotation(candidate.annotation(), compact, output);
+        EndEntry(output);
+      }
+      if (!compact) {
+        if (candidate.has_id()) {
+          PrintInt32Entry("id", candidate.id(), output);
+        }
+        if (candidate.has_information_id()) {
+          PrintInt32Entry("information-id", candidate.information_id(),
+                          output);
+        }
+        PrintFieldsAfter(
+            candidate,
+            commands::Candidates::Candidate::kInformationIdFieldNumber,
+            output);
+      }
+      output->push_back(')');
+    }
+    output->push_back(')');
+  }
+  if (!compact) {
+    if (candidates.has_position()) {
+      PrintUInt32Entry("position", candidates.position(), output);
+    }
+    if (candidates.has_subcandidates()) {
+      BeginEntry("subcandidates", output);
+      PrintCandidates(candidates.subcandidates(), compact, output);
+      EndEntry(output);
+    }
+    if (candidates.has_usages()) {
+      PrintReflectedField(candidates, commands::Candidates::kUsagesFieldNumber,
+                          output);
+    }
+  }
+  if (candidates.has_category()) {
+    PrintSymbolEntry("category",
+                     commands::Category_Name(candidates.category()), output);
+  }
+  if (!compact && candidates.has_display_type()) {
+    PrintSymbolEntry("display-type",
+                     commands::DisplayType_Name(candidates.display_type()),
+                     output);
+  }
+  if (candidates.has_footer()) {
+    BeginEntry("footer", output);
+    PrintFooter(candidates.footer(), compact, output);
+    EndEntry(output);
+  }
+  if (!compact) {
+    if (candidates.has_direction()) {
+      PrintSymbolEntry(
+          "direction",
+          commands::Candidates::Direction_Name(candidates.direction()),
+          output);
+    }
+    if (candidates.has_composition_rectangle()) {
+      PrintReflectedField(
+          candidates, commands::Candidates::kCompositionRectangleFieldNumber,
+          output);
+    }
+    if (candidates.has_caret_rectangle()) {
+      PrintReflectedField(
+          candidates, commands::Candidates::kCaretRectangleFieldNumber,
+          output);
+    }
+    if (candidates.has_window_location()) {
+      PrintSymbolEntry(
+          "window-location",
+          commands::Candidates::CandidateWindowLocation_Name(
+              candidates.window_location()),
+          output);
+    }
+    if (candidates.has_page_size()) {
+      PrintUInt32Entry("page-size", candidates.page_size(), output);
+    }
+    PrintFieldsAfter(candidates, commands::Candidates::kPageSizeFieldNumber,
+                     output);
+  }
+  output->push_back(')');
+}
+
+void PrintKeyEvent(const commands::KeyEvent &key, string *output) {
+  output->push_back('(');
+  if (key.has_key_code()) {
+    PrintUInt32Entry("key-code", key.key_code(), output);
+  }
+  if (key.has_modifiers()) {
+    PrintUInt32Entry("modifiers", key.modifiers(), output);
+  }
+  if (key.has_special_key()) {
+    PrintSymbolEntry("special-key",
+                     commands::KeyEvent::SpecialKey_Name(key.special_key()),
+                     output);
+  }
+  if (key.modifier_keys_size() > 0) {
+    output->append("(modifier-keys ");
+    for (int i = 0; i < key.modifier_keys_size(); ++i) {
+      if (i != 0) {
+        output->push_back(' ');
+      }
+      AppendSymbol(commands::KeyEvent::ModifierKey_Name(key.modifier_keys(i)),
+                   output);
+    }
+    output->push_back(')');
+  }
+  if (key.has_key_string()) {
+    PrintStringEntry("key-string", key.key_string(), output);
+  }
+  if (key.has_input_style()) {
+    PrintSymbolEntry("input-style",
+                     commands::KeyEvent::InputStyle_Name(key.input_style()),
+                     output);
+  }
+  if (key.has_mode()) {
+    PrintSymbolEntry("mode", commands::CompositionMode_Name(key.mode()),
+                     output);
+  }
+  if (key.probable_key_event_size() > 0) {
+    PrintReflectedField(key, commands::KeyEvent::kProbableKeyEventFieldNumber,
+                        output);
+  }
+  if (key.has_activated()) {
+    PrintBoolEntry("activated", key.activated(), output);
+  }
+  PrintFieldsAfter(key, commands::KeyEvent::kActivatedFieldNumber, output);
+  output->push_back(')');
+}
+
+void PrintStatus(const commands::Status &status, string *output) {
+  output->push_back('(');
+  if (status.has_activated()) {
+    PrintBoolEntry("activated", status.activated(), output);
+  }
+  if (status.has_mode()) {
+    PrintSymbolEntry("mode", commands::CompositionMode_Name(status.mode()),
+                     output);
+  }
+  if (status.has_comeback_mode()) {
+    PrintSymbolEntry("comeback-mode",
+                     commands::CompositionMode_Name(status.comeback_mode()),
+                     output);
+  }
+  PrintFieldsAfter(status, commands::Status::kComebackModeFieldNumber, output);
+  output->push_back(')');
+}
+
+void PrintCandidateList(const commands::CandidateList &candidate_list,
+                        string *output) {
+  output->push_back('(');
+  if (candidate_list.has_focused_index()) {
+    PrintUInt32Entry("focused-index", candidate_list.focused_index(), output);
+  }
+  if (candidate_list.candidates_size() > 0) {
+    output->append("(candidates ");
+    for (int i = 0; i < candidate_list.candidates_size(); ++i) {
+      const commands::CandidateWord &word = candidate_list.candidates(i);
+      output->push_back('(');
+      if (word.has_id()) {
+        PrintInt32Entry("id", word.id(), output);
+      }
+      if (word.has_index()) {
+        PrintUInt32Entry("index", word.index(), output);
+      }
+      if (word.has_key()) {
+        PrintStringEntry("key", word.key(), output);
+      }
+      if (word.has_value()) {
+        PrintStringEntry("value", word.value(), output);
+      }
+      if (word.has_annotation()) {
+        BeginEntry("annotation", output);
+        PrintAnnotation(word.annotation(), false, output);
+        EndEntry(output);
+      }
+      PrintFieldsAfter(word, commands::CandidateWord::kAnnotationFieldNumber,
+                       output);
+      output->push_back(')');
+    }
+    output->push_back(')');
+  }
+  if (candidate_list.has_category()) {
+    PrintSymbolEntry("category",
+                     commands::Category_Name(candidate_list.category()),
+                     output);
+  }
+  PrintFieldsAfter(candidate_list,
+                   commands::CandidateList::kCategoryFieldNumber, output);
+  output->push_back(')');
+}
+
+void PrintCommandsOutput(const commands::Output &output, bool compact,
+                         string *result) {
+  result->push_back('(');
+  if (!compact) {
+    if (output.has_id()) {
+      BeginEntry("id", result);
+      AppendUInt64(output.id(), result);
+      EndEntry(result);
+    }
+    if (output.has_mode()) {
+      PrintSymbolEntry("mode", commands::CompositionMode_Name(output.mode()),
+                       result);
+    }
+  }
+  if (output.has_consumed()) {
+    PrintBoolEntry("consumed", output.consumed(), result);
+  }
+  if (output.has_result()) {
+    BeginEntry("result", result);
+    PrintResult(output.result(), compact, result);
+    EndEntry(result);
+  }
+  if (output.has_preedit()) {
+    BeginEntry("preedit", result);
+    PrintPreedit(output.preedit(), compact, result);
+    EndEntry(result);
+  }
+  if (output.has_candidates()) {
+    BeginEntry("candidates", result);
+    PrintCandidates(output.candidates(), compact, result);
+    EndEntry(result);
+  }
+  if (compact) {
+    result->push_back(')');
+    return;
+  }
+  if (output.has_key()) {
+    BeginEntry("key", result);
+    PrintKeyEvent(output.key(), result);
+    EndEntry(result);
+  }
+  if (output.has_url()) {
+    PrintStringEntry("url", output.url(), result);
+  }
+  if (output.has_config()) {
+    PrintReflectedField(output, commands::Output::kConfigFieldNumber, result);
+  }
+  if (output.has_preedit_method()) {
+    PrintSymbolEntry(
+        "preedit-method",
+        commands::Output::PreeditMethod_Name(output.preedit_method()),
+        result);
+  }
+  if (output.has_error_code()) {
+    PrintSymbolEntry("error-code",
+                     commands::Output::ErrorCode_Name(output.error_code()),
+                     result);
+  }
+  if (output.has_status()) {
+    BeginEntry("status", result);
+    PrintStatus(output.status(), result);
+    EndEntry(result);
+  }
+  if (output.has_all_candidate_words()) {
+    BeginEntry("all-candidate-words", result);
+    PrintCandidateList(output.all_candidate_words(), result);
+    EndEntry(result);
+  }
+  if (output.has_deletion_range()) {
+    BeginEntry("deletion-range", result);
+    result->push_back('(');
+    if (output.deletion_range().has_offset()) {
+      PrintInt32Entry("offset", output.deletion_range().offset(), result);
+    }
+    if (output.deletion_range().has_length()) {
+      PrintInt32Entry("length", output.deletion_range().length(), result);
+    }
+    PrintFieldsAfter(output.deletion_range(),
+                     commands::DeletionRange::kLengthFieldNumber, result);
+    result->push_back(')');
+    EndEntry(result);
+  }
+  if (output.has_launch_tool_mode()) {
+    PrintSymbolEntry(
+        "launch-tool-mode",
+        commands::Output::ToolMode_Name(output.launch_tool_mode()), result);
+  }
+  if (output.has_callback()) {
+    PrintReflectedField(output, commands::Output::kCallbackFieldNumber,
+                        result);
+  }
+  if (output.has_storage_entry()) {
+    PrintReflectedField(output, commands::Output::kStorageEntryFieldNumber,
+                        result);
+  }
+  if (output.has_user_dictionary_command_status()) {
+    PrintReflectedField(
+        output, commands::Output::kUserDictionaryCommandStatusFieldNumber,
+        result);
+  }
+  PrintFieldsAfter(output,
+                   commands::Output::kUserDictionaryCommandStatusFieldNumber,
+                   result);
+  result->push_back(')');
+}
+
+// Prints a field, which the printers above do not cover, with reflection.
+void PrintReflectedField(const protobuf::Message &message, int number,
+                         string *output) {
+  const protobuf::FieldDescriptor *field =
+      message.GetDescriptor()->FindFieldByNumber(number);
+  DCHECK(field);
+  vector<string> buffer;
+  PrintField(message, *message.GetReflection(), *field, &buffer);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    output->append(buffer[i]);
+  }
+}
+
+struct FieldNumberLess {
+  bool operator()(const protobuf::FieldDescriptor *lhs,
+                  const protobuf::FieldDescriptor *rhs) const {
+    return lhs->number() < rhs->number();
+  }
+};
+
+// Prints the set fields of |message| whose numbers are greater than
+// |last_number| with reflection.  The printers above call this after the
+// last field they handle so that fields added to the protos later are not
+// dropped and are printed at the same position as PrintMessage() does.
+void PrintFieldsAfter(const protobuf::Message &message, int last_number,
+                      string *output) {
+  const protobuf::Descriptor *descriptor = message.GetDescriptor();
+  const protobuf::Reflection *reflection = message.GetReflection();
+  vector<const protobuf::FieldDescriptor *> fields;
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const protobuf::FieldDescriptor *field = descriptor->field(i);
+    if (field->number() <= last_number) {
+      continue;
+    }
+    if (field->is_repeated() ? reflection->FieldSize(message, field) > 0 :
+                               reflection->HasField(message, field)) {
+      fields.push_back(field);
+    }
+  }
+  if (fields.empty()) {
+    return;
+  }
+  sort(fields.begin(), fields.end(), FieldNumberLess());
+  vector<string> buffer;
+  for (size_t i = 0; i < fields.size(); ++i) {
+    PrintField(message, *reflection, *fields[i], &buffer);
+  }
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    output->append(buffer[i]);
+  }
+}
+
 }  // namespace
 }  // namespace emacs
 }  // namespace mozc
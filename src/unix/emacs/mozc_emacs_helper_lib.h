@@ -82,6 +82,21 @@ void ParseInputLine(
 void PrintMessage(const mozc::protobuf::Message &message,
                   vector<string>* output);
 
+// Prints the content of commands::Output in S-expression without using
+// protocol buffer reflection.  The printed string is the same as the one
+// PrintMessage() generates, but this function appends everything into a single
+// string buffer and is much cheaper since it is called on every key event.
+// Rarely used fields (e.g. config) fall back to the reflection-based printer.
+//
+// 'result' is appended, not cleared.
+void PrintOutput(const mozc::commands::Output &output, string *result);
+
+// Same as PrintOutput() but prints only the fields which mozc.el refers to,
+// i.e. consumed, result, preedit and candidates with their essential
+// sub-fields.  This reduces both the formatting cost in the helper and the
+// reading cost in Emacs.
+void PrintCompactOutput(const mozc::commands::Output &output, string *result);
+
 
 // Utilities
 
@@ -62,6 +62,17 @@ class MozcEmacsHelperLibTest : public testing::Test {
     EXPECT_EQ(sexpr, output);
   }
 
+  // Tests that PrintOutput() prints exactly the same as PrintMessage().
+  void PrintOutputAndCompare(const mozc::commands::Output &output) {
+    vector<string> buffer;
+    mozc::emacs::PrintMessage(output, &buffer);
+    string expected;
+    mozc::Util::JoinStrings(buffer, "", &expected);
+    string actual;
+    mozc::emacs::PrintOutput(output, &actual);
+    EXPECT_EQ(expected, actual);
+  }
+
   void TestUnquoteString(const string &expected, const string &input) {
     string output;
     EXPECT_TRUE(mozc::emacs::UnquoteString("\"" + input + "\"", &output));
@@ -220,6 +231,250 @@ TEST_F(MozcEmacsHelperLibTest, PrintMessage) {
              "(modifier-keys key-down shift))))");
 }
 
+TEST_F(MozcEmacsHelperLibTest, PrintOutput) {
+  mozc::commands::Output output;
+  PrintOutputAndCompare(output);
+
+  output.set_id(0xFFFFFFFFFFFFFFFFULL);
+  output.set_mode(mozc::commands::FULL_KATAKANA);
+  output.set_consumed(true);
+  mozc::commands::Result *result = output.mutable_result();
+  result->set_type(mozc::commands::Result::STRING);
+  result->set_value("\"quoted\\value\"");
+  result->set_key("key");
+  result->set_cursor_offset(-1);
+  PrintOutputAndCompare(output);
+
+  mozc::commands::Preedit *preedit = output.mutable_preedit();
+  preedit->set_cursor(2);
+  preedit->set_highlighted_position(1);
+  for (int i = 0; i < 2; ++i) {
+    mozc::commands::Preedit::Segment *segment = preedit->add_segment();
+    segment->set_annotation(mozc::commands::Preedit::Segment::HIGHLIGHT);
+    // "なし"
+    segment->set_value("\xe3\x81\xaa\xe3\x81\x97");
+    segment->set_value_length(2);
+    segment->set_key("nasi");
+  }
+  PrintOutputAndCompare(output);
+
+  mozc::commands::Candidates *candidates = output.mutable_candidates();
+  candidates->set_focused_index(1);
+  candidates->set_size(3);
+  candidates->set_position(0);
+  for (int i = 0; i < 3; ++i) {
+    mozc::commands::Candidates::Candidate *candidate =
+        candidates->add_candidate();
+    candidate->set_index(i);
+    candidate->set_value("value");
+    candidate->set_id(-i);
+    candidate->mutable_annotation()->set_description("description");
+    candidate->mutable_annotation()->set_shortcut("1");
+    candidate->mutable_annotation()->set_deletable(true);
+  }
+  candidates->set_category(mozc::commands::PREDICTION);
+  candidates->set_display_type(mozc::commands::CASCADE);
+  candidates->mutable_footer()->set_index_visible(true);
+  candidates->mutable_footer()->set_label("label");
+  candidates->set_direction(mozc::commands::Candidates::HORIZONTAL);
+  candidates->set_window_location(mozc::commands::Candidates::COMPOSITION);
+  candidates->set_page_size(9);
+  candidates->mutable_caret_rectangle()->set_x(1);
+  candidates->mutable_caret_rectangle()->set_y(2);
+  candidates->mutable_caret_rectangle()->set_width(3);
+  candidates->mutable_caret_rectangle()->set_height(4);
+  candidates->mutable_subcandidates()->set_size(0);
+  candidates->mutable_subcandidates()->set_position(1);
+  PrintOutputAndCompare(output);
+
+  mozc::commands::KeyEvent *key = output.mutable_key();
+  key->set_key_code('a');
+  key->set_special_key(mozc::commands::KeyEvent::PAGE_UP);
+  key->add_modifier_keys(mozc::commands::KeyEvent::SHIFT);
+  key->add_modifier_keys(mozc::commands::KeyEvent::CTRL);
+  key->set_key_string("a");
+  key->set_mode(mozc::commands::HIRAGANA);
+  key->add_probable_key_event()->set_key_code('b');
+  key->set_activated(true);
+  output.set_url("http://example.com/");
+  output.set_preedit_method(mozc::commands::Output::KANA);
+  output.set_error_code(mozc::commands::Output::SESSION_FAILURE);
+  output.mutable_status()->set_activated(true);
+  output.mutable_status()->set_mode(mozc::commands::HALF_ASCII);
+  mozc::commands::CandidateWord *word =
+      output.mutable_all_candidate_words()->add_candidates();
+  word->set_id(1);
+  word->set_index(0);
+  word->set_value("value");
+  output.mutable_all_candidate_words()->set_category(
+      mozc::commands::SUGGESTION);
+  output.mutable_deletion_range()->set_offset(-1);
+  output.mutable_deletion_range()->set_length(1);
+  output.set_launch_tool_mode(mozc::commands::Output::CONFIG_DIALOG);
+  output.mutable_callback()->set_delay_millisec(100);
+  PrintOutputAndCompare(output);
+}
+
+TEST_F(MozcEmacsHelperLibTest, PrintOutputWithAllFields) {
+  // Sets every field including the ones which PrintOutput() does not print
+  // by itself, e.g. num_processed_keys and latency_histograms.
+  mozc::commands::Output output;
+  output.set_id(1);
+  output.set_mode(mozc::commands::HIRAGANA);
+  output.set_consumed(true);
+  mozc::commands::Result *result = output.mutable_result();
+  result->set_type(mozc::commands::Result::STRING);
+  result->set_value("value");
+  result->set_key("key");
+  result->set_cursor_offset(1);
+  mozc::commands::Preedit *preedit = output.mutable_preedit();
+  preedit->set_cursor(1);
+  preedit->set_highlighted_position(0);
+  mozc::commands::Preedit::Segment *segment = preedit->add_segment();
+  segment->set_annotation(mozc::commands::Preedit::Segment::UNDERLINE);
+  segment->set_value("value");
+  segment->set_value_length(5);
+  segment->set_key("key");
+
+  mozc::commands::Candidates *candidates = output.mutable_candidates();
+  candidates->set_focused_index(0);
+  candidates->set_size(1);
+  candidates->set_position(0);
+  mozc::commands::Candidates::Candidate *candidate =
+      candidates->add_candidate();
+  candidate->set_index(0);
+  candidate->set_value("value");
+  candidate->set_id(1);
+  candidate->set_information_id(2);
+  mozc::commands::Annotation *annotation = candidate->mutable_annotation();
+  annotation->set_prefix("prefix");
+  annotation->set_suffix("suffix");
+  annotation->set_description("description");
+  annotation->set_shortcut("1");
+  annotation->set_deletable(false);
+  candidates->mutable_subcandidates()->set_size(0);
+  candidates->mutable_subcandidates()->set_position(0);
+  mozc::commands::Information *information =
+      candidates->mutable_usages()->add_information();
+  information->set_id(2);
+  information->set_title("title");
+  information->set_description("description");
+  information->add_candidate_id(1);
+  candidates->set_category(mozc::commands::CONVERSION);
+  candidates->set_display_type(mozc::commands::MAIN);
+  mozc::commands::Footer *footer = candidates->mutable_footer();
+  footer->set_label("label");
+  footer->set_index_visible(true);
+  footer->set_logo_visible(false);
+  footer->set_sub_label("sub label");
+  candidates->set_direction(mozc::commands::Candidates::VERTICAL);
+  mozc::commands::Rectangle *rectangle =
+      candidates->mutable_composition_rectangle();
+  rectangle->set_x(1);
+  rectangle->set_y(2);
+  rectangle->set_width(3);
+  rectangle->set_height(4);
+  candidates->mutable_caret_rectangle()->CopyFrom(*rectangle);
+  candidates->set_window_location(mozc::commands::Candidates::CARET);
+  candidates->set_page_size(9);
+
+  mozc::commands::KeyEvent *key = output.mutable_key();
+  key->set_key_code('a');
+  key->set_modifiers(mozc::commands::KeyEvent::SHIFT);
+  key->set_special_key(mozc::commands::KeyEvent::ENTER);
+  key->add_modifier_keys(mozc::commands::KeyEvent::SHIFT);
+  key->set_key_string("a");
+  key->set_input_style(mozc::commands::KeyEvent::AS_IS);
+  key->set_mode(mozc::commands::HIRAGANA);
+  key->add_probable_key_event()->set_key_code('b');
+  key->set_activated(true);
+  output.set_url("http://example.com/");
+  output.mutable_config()->set_incognito_mode(true);
+  output.set_preedit_method(mozc::commands::Output::ASCII);
+  output.set_error_code(mozc::commands::Output::SESSION_SUCCESS);
+  output.mutable_status()->set_activated(true);
+  output.mutable_status()->set_mode(mozc::commands::HIRAGANA);
+  output.mutable_status()->set_comeback_mode(mozc::commands::HIRAGANA);
+  mozc::commands::CandidateList *candidate_list =
+      output.mutable_all_candidate_words();
+  candidate_list->set_focused_index(0);
+  mozc::commands::CandidateWord *word = candidate_list->add_candidates();
+  word->set_id(1);
+  word->set_index(0);
+  word->set_key("key");
+  word->set_value("value");
+  word->mutable_annotation()->set_description("description");
+  candidate_list->set_category(mozc::commands::CONVERSION);
+  output.mutable_deletion_range()->set_offset(-1);
+  output.mutable_deletion_range()->set_length(1);
+  output.set_launch_tool_mode(mozc::commands::Output::DICTIONARY_TOOL);
+  output.mutable_callback()->set_delay_millisec(100);
+  output.mutable_storage_entry()->set_type(
+      mozc::commands::GenericStorageEntry::SYMBOL_HISTORY);
+  output.mutable_storage_entry()->set_key("key");
+  output.mutable_user_dictionary_command_status()->set_status(
+      mozc::user_dictionary::UserDictionaryCommandStatus::
+      USER_DICTIONARY_COMMAND_SUCCESS);
+  output.set_num_processed_keys(2);
+  mozc::commands::LatencyHistogram *histogram =
+      output.add_latency_histograms();
+  histogram->set_name("SendKey");
+  histogram->set_count(2);
+  histogram->set_total_usec(300);
+  histogram->add_buckets()->set_lower_bound_usec(100);
+  histogram->mutable_buckets(0)->set_count(2);
+
+  PrintOutputAndCompare(output);
+
+  string actual;
+  mozc::emacs::PrintOutput(output, &actual);
+  EXPECT_NE(string::npos, actual.find("(num-processed-keys . 2)"));
+  EXPECT_NE(string::npos, actual.find("(latency-histograms ((name . "));
+}
+
+TEST_F(MozcEmacsHelperLibTest, PrintCompactOutput) {
+  mozc::commands::Output output;
+  output.set_id(1234);
+  output.set_mode(mozc::commands::HIRAGANA);
+  output.set_consumed(true);
+  output.mutable_result()->set_type(mozc::commands::Result::STRING);
+  output.mutable_result()->set_value("RESULT_STRING");
+  output.mutable_result()->set_key("key");
+  mozc::commands::Preedit::Segment *segment =
+      output.mutable_preedit()->add_segment();
+  output.mutable_preedit()->set_cursor(1);
+  segment->set_annotation(mozc::commands::Preedit::Segment::UNDERLINE);
+  segment->set_value("a");
+  segment->set_value_length(1);
+  mozc::commands::Candidates *candidates = output.mutable_candidates();
+  candidates->set_size(1);
+  candidates->set_position(0);
+  candidates->set_category(mozc::commands::CONVERSION);
+  mozc::commands::Candidates::Candidate *candidate =
+      candidates->add_candidate();
+  candidate->set_index(0);
+  candidate->set_value("A");
+  candidate->set_id(0);
+  candidate->mutable_annotation()->set_shortcut("1");
+  output.mutable_key()->set_key_code('a');
+
+  string actual;
+  mozc::emacs::PrintCompactOutput(output, &actual);
+  EXPECT_EQ(
+      "((consumed . t)"
+       "(result . ((type . string)"
+                  "(value . \"RESULT_STRING\")))"
+       "(preedit . ((cursor . 1)"
+                   "(segment ((annotation . underline)"
+                             "(value . \"a\")))))"
+       "(candidates . ((size . 1)"
+                      "(candidate ((index . 0)"
+                                  "(value . \"A\")"
+                                  "(annotation . ((shortcut . \"1\")))))"
+                      "(category . conversion))))",
+      actual);
+}
+
 TEST_F(MozcEmacsHelperLibTest, NormalizeSymbol) {
   using mozc::emacs::NormalizeSymbol;
   EXPECT_EQ("page-up", NormalizeSymbol("PAGE_UP"));
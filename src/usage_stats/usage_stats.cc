@@ -33,6 +33,7 @@
 #include <numeric>
 
 #include "base/logging.h"
+#include "base/mutex.h"
 #include "config/stats_config_util.h"
 #include "storage/registry.h"
 #include "usage_stats/usage_stats.pb.h"
@@ -43,6 +44,10 @@ namespace usage_stats {
 namespace {
 const char kRegistryPrefix[] = "usage_stats.";
 
+// Serializes the read-modify-write updates below so that concurrent sessions
+// don't lose counts.  The registry itself has its own lock.
+Mutex g_update_mutex;
+
 #include "usage_stats/usage_stats_list.h"
 
 void AddDoubleValueStats(
@@ -151,6 +156,7 @@ void UsageStats::IncrementCountBy(const string &name, uint32 val) {
     return;
   }
 
+  scoped_lock l(&g_update_mutex);
   Stats stats;
   if (GetterInternal(name, Stats::COUNT, &stats)) {
     stats.set_count(stats.count() + val);
@@ -169,6 +175,7 @@ void UsageStats::UpdateTiming(const string &name, uint32 val) {
     return;
   }
 
+  scoped_lock l(&g_update_mutex);
   Stats stats;
   if (GetterInternal(name, Stats::TIMING, &stats)) {
     stats.set_num_timings(stats.num_timings() + 1);
@@ -326,6 +333,7 @@ void UsageStats::StoreTouchEventStats(
     return;
   }
 
+  scoped_lock l(&g_update_mutex);
   Stats stats;
   map<string, TouchEventStatsMap> tmp_stats(touch_stats);
   if (GetterInternal(name, Stats::VIRTUAL_KEYBOARD, &stats)) {